@@ -6,6 +6,7 @@
 #include <algorithm> // For std::sort and std::swap
 #include <cstdint>
 #include <utility>  // For std::move
+#include <type_traits>
 
 template <typename T, size_t capacity_>
 class ArrayList {
@@ -114,10 +115,37 @@ public:
 
 		// Shift elements after the removed index
 		for (size_t i = index; i < count_ - 1; ++i) {
-			data_[i] = data_[i + 1];
+			data_[i] = std::move(data_[i + 1]);
 		}
 
 		--count_;
+		releaseSlot(count_);
+	}
+
+	// O(1) removal that does not preserve order: the last element takes the removed slot
+	void removeUnordered(size_t index) {
+		if (index >= count_) {
+			return; // Do nothing if index is out of bounds
+		}
+
+		--count_;
+		if (index != count_) {
+			data_[index] = std::move(data_[count_]);
+		}
+		releaseSlot(count_);
+	}
+
+	// Remove all items satisfying a predicate, filling the holes from the back (order not preserved)
+	template <typename Predicate>
+	void removeIfUnordered(Predicate pred) {
+		size_t i = 0;
+		while (i < count_) {
+			if (pred(data_[i])) {
+				removeUnordered(i);
+			} else {
+				++i;
+			}
+		}
 	}
 
 	// Remove all items satisfying a predicate
@@ -127,7 +155,7 @@ public:
         for (size_t readIndex = 0; readIndex < count_; ++readIndex) {
             if (!pred(data_[readIndex])) {
                 if (writeIndex != readIndex) { // Avoid self-assignment
-                    data_[writeIndex] = data_[readIndex];
+                    data_[writeIndex] = std::move(data_[readIndex]);
                 }
                 writeIndex++;
             }
@@ -135,7 +163,7 @@ public:
 
         // Clear the remaining elements after writeIndex
         for (size_t i = writeIndex; i < count_; ++i) {
-            data_[i] = T{}; // Destruct existing object
+            releaseSlot(i);
         }
         count_ = writeIndex;
     }
@@ -317,6 +345,15 @@ public:
 		bool operator>=(const const_iterator& other) const {return index >= other.index;}
 	};
 
+private:
+	// Drop whatever a vacated slot still owns (e.g. shared_ptr); trivial types are left as they are
+	void releaseSlot(size_t index) {
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			data_[index] = T{};
+		}
+	}
+
+public:
 	iterator begin() { return iterator(0, this); }
 	iterator end() { return iterator(count_, this); }
 
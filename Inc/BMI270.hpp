@@ -2,8 +2,10 @@
 #ifndef INC_BMI270_H_
 #define INC_BMI270_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include "au.hpp"
 #include "IMU.hpp"
 #include "Transport.hpp"
@@ -51,6 +53,10 @@ enum class BMI270_REGISTERS : uint8_t
 	TMP_DATA_LSB = 0x22,
 	TMP_DATA_MSB = 0x23,
 
+	FIFO_LENGTH_0 = 0x24,
+	FIFO_LENGTH_1 = 0x25,
+	FIFO_DATA = 0x26,
+
 	FEAT_PAGE = 0x2F,
 	FEATURES_START = 0x30,
 	FEATURES_0 = 0x30,
@@ -77,6 +83,11 @@ enum class BMI270_REGISTERS : uint8_t
 	GYR_RANGE = 0x43,
 
 	AUX_CONF = 0x44,
+	FIFO_DOWNS = 0x45,
+	FIFO_WTM_0 = 0x46,
+	FIFO_WTM_1 = 0x47,
+	FIFO_CONFIG_0 = 0x48,
+	FIFO_CONFIG_1 = 0x49,
 	SATURATION = 0x4A,
 	AUX_DEV_ID = 0x4B,
 	AUX_IF_CONF = 0x4C,
@@ -125,6 +136,23 @@ struct BMI270_STATUS
 	uint8_t internal_status;
 };
 
+// One FIFO frame; sensor_time is in 39.0625 us ticks and wraps at 24 bits
+struct BMI270_FIFO_SAMPLE
+{
+	AngularVelocityInBodyFrame gyr;
+	AccelerationInBodyFrame acc;
+	uint32_t sensor_time;
+	bool has_gyr;
+	bool has_acc;
+};
+
+struct BMI270_FIFO_PARSE
+{
+	size_t samples;					  // frames written to the output
+	uint16_t consumed;				  // bytes of whole frames, partial frames are re-read by the sensor
+	std::optional<uint32_t> sensor_time; // sensortime frame, present when the read drained the FIFO
+};
+
 template <typename Transport>
 	requires RegisterModeTransport<Transport>
 class BMI270
@@ -138,6 +166,21 @@ public:
 	BMI270_STATUS readStatus() const;
 	std::optional<ChipID> readChipID() const;
 
+	using FifoSample = BMI270_FIFO_SAMPLE;
+
+	// Header mode FIFO with accelerometer, gyroscope and a sensortime frame after the last sample
+	bool configureFifo() const;
+	std::optional<uint16_t> readFifoLength() const;
+	// Drains up to samples.size() frames in a single burst of FIFO_DATA, oldest first. Each frame
+	// is stamped with its sensortime; read_time is the sensortime at the read.
+	size_t readFifo(std::span<FifoSample> samples, uint32_t &read_time) const;
+	size_t readFifo(std::span<FifoSample> samples) const
+	{
+		uint32_t read_time = 0;
+		return readFifo(samples, read_time);
+	}
+	BMI270_FIFO_PARSE parseFifo(const uint8_t *data, uint16_t len, std::span<FifoSample> samples) const;
+
 	std::optional<AccelerationInBodyFrame> readAccelerometer() const;
 	std::optional<AngularVelocityInBodyFrame> readGyroscope() const;
 	std::optional<Temperature> readThermometer() const;
@@ -185,6 +228,54 @@ public:
 		return au::make_quantity<au::Celsius>(TMP_SHIFT + toInt16(lsb, msb) * LSB_PER_TMP);
 	}
 
+	// Accelerometer is front (+0.91), left/west (+9.81). up (+9.81)
+	// wanted NED (front east down) to have positive +9.81 when oriented
+	// Orientation	Axis Rotation Positive Direction
+	// front		X	-9.81 when x back points
+	// right/east	Y	+9.81 when y points up
+	// down			Z	+9.81
+	AccelerationInBodyFrame convertAccXYZ(const uint8_t *xyz) const
+	{
+		return AccelerationInBodyFrame{
+			-convertAcc(xyz[0], xyz[1]),
+			convertAcc(xyz[2], xyz[3]),
+			convertAcc(xyz[4], xyz[5])};
+	}
+
+	// Gyroscope is front, left/west. up
+	// wanted
+	// Orientation	Axis Rotation Positive Direction
+	// front		X	Roll	Right wing down
+	// right/east	Y	Pitch	Nose up
+	// down		Z	Yaw		Nose right
+	AngularVelocityInBodyFrame convertGyrXYZ(const uint8_t *xyz) const
+	{
+		return AngularVelocityInBodyFrame{
+			convertGyr(xyz[0], xyz[1]),
+			-convertGyr(xyz[2], xyz[3]),
+			-convertGyr(xyz[4], xyz[5])};
+	}
+
+	// ODR code n of ACC_CONF/GYR_CONF samples at 25/32 * 2^(n-1) Hz, i.e. every 2^(16-n) sensortime ticks
+	static constexpr uint32_t odrPeriodTicks(uint8_t odr) { return 1U << (16U - odr); }
+
+	static constexpr uint8_t BMI270_ODR_100HZ = 0x08;
+	static constexpr float SENSOR_TIME_TICK = 39.0625e-6f;
+	static constexpr uint32_t SENSOR_TIME_MASK = 0xFFFFFF;
+	static constexpr uint32_t FIFO_FRAME_TICKS = odrPeriodTicks(BMI270_ODR_100HZ);
+	static constexpr float FIFO_SAMPLE_PERIOD = static_cast<float>(FIFO_FRAME_TICKS) * SENSOR_TIME_TICK;
+
+	static constexpr uint16_t FIFO_ACC_GYR_FRAME_BYTES = 13; // header + gyro + accel
+	static constexpr uint16_t FIFO_SENSORTIME_FRAME_BYTES = 4;
+	// One burst, dummy byte included, bounded by the transport's transfer buffer
+	static constexpr uint16_t FIFO_BURST_BYTES = []
+	{
+		if constexpr (requires { Transport::config_type::max_transfer_size; })
+			return static_cast<uint16_t>(std::min<std::size_t>(Transport::config_type::max_transfer_size, 512));
+		else
+			return static_cast<uint16_t>(512);
+	}();
+
 protected:
 	const Transport &transport_;
 
@@ -204,6 +295,20 @@ protected:
 	static constexpr uint8_t BMI270_CHIP_ID = 0x24;
 	static constexpr uint8_t BMI270_FIFO_ACC_EN = 0x40;
 	static constexpr uint8_t BMI270_FIFO_GYR_EN = 0x80;
+	static constexpr uint8_t BMI270_FIFO_HEADER_EN = 0x10;
+	static constexpr uint8_t BMI270_FIFO_TIME_EN = 0x02;
+
+	// FIFO frame headers, fh_mode in bits 7:6, fh_parm in 5:2
+	static constexpr uint8_t FIFO_HEADER_REGULAR = 0x80;
+	static constexpr uint8_t FIFO_HEADER_REGULAR_MASK = 0xC0;
+	static constexpr uint8_t FIFO_HEADER_AUX = 0x10;
+	static constexpr uint8_t FIFO_HEADER_GYR = 0x08;
+	static constexpr uint8_t FIFO_HEADER_ACC = 0x04;
+	static constexpr uint8_t FIFO_HEADER_EMPTY = 0x80;
+	static constexpr uint8_t FIFO_HEADER_SKIP = 0x40;
+	static constexpr uint8_t FIFO_HEADER_SENSORTIME = 0x44;
+	static constexpr uint8_t FIFO_HEADER_INPUT_CONFIG = 0x48;
+	static constexpr uint8_t FIFO_HEADER_SAMPLE_DROP = 0x50;
 };
 
 template <typename Transport>
@@ -343,7 +448,7 @@ template <typename Transport>
 	requires RegisterModeTransport<Transport>
 bool BMI270<Transport>::configure() const
 {
-	if (!writeRegisterWithCheck(BMI270_REGISTERS::ACC_CONF, 0x08))
+	if (!writeRegisterWithCheck(BMI270_REGISTERS::ACC_CONF, BMI270_ODR_100HZ))
 	{
 		return false;
 	}
@@ -352,7 +457,7 @@ bool BMI270<Transport>::configure() const
 		return false;
 	}
 
-	if (!writeRegisterWithCheck(BMI270_REGISTERS::GYR_CONF, 0x08))
+	if (!writeRegisterWithCheck(BMI270_REGISTERS::GYR_CONF, BMI270_ODR_100HZ))
 	{
 		return false;
 	}
@@ -367,7 +472,8 @@ bool BMI270<Transport>::configure() const
 	}
 	log(LOG_LEVEL_DEBUG, "BMI270 configured for ACC, GYR, TMP\r\n");
 
-	return true;
+	// HasGyroscopeFifo consumers read the FIFO every tick, so it is enabled with the sensors
+	return configureFifo();
 }
 
 template <typename Transport>
@@ -405,17 +511,7 @@ std::optional<AccelerationInBodyFrame> BMI270<Transport>::readAccelerometer() co
 		return std::nullopt;
 	}
 
-	// Accelerometer is front (+0.91), left/west (+9.81). up (+9.81)
-	// wanted NED (front east down) to have positive +9.81 when oriented
-	// Orientation	Axis Rotation Positive Direction
-	// front		X	-9.81 when x back points
-	// right/east	Y	+9.81 when y points up
-	// down			Z	+9.81
-
-	return AccelerationInBodyFrame{
-		-convertAcc(rx[1], rx[2]),
-		convertAcc(rx[3], rx[4]),
-		convertAcc(rx[5], rx[6])};
+	return convertAccXYZ(&rx[1]);
 }
 
 template <typename Transport>
@@ -429,17 +525,7 @@ std::optional<AngularVelocityInBodyFrame> BMI270<Transport>::readGyroscope() con
 		return std::nullopt;
 	}
 
-	// Gyroscope is front, left/west. up
-	// wanted
-	// Orientation	Axis Rotation Positive Direction
-	// front		X	Roll	Right wing down
-	// right/east	Y	Pitch	Nose up
-	// down		Z	Yaw		Nose right
-
-	return AngularVelocityInBodyFrame{
-		convertGyr(rx[1], rx[2]),
-		-convertGyr(rx[3], rx[4]),
-		-convertGyr(rx[5], rx[6])};
+	return convertGyrXYZ(&rx[1]);
 }
 
 template <typename Transport>
@@ -502,4 +588,180 @@ uint16_t BMI270<Transport>::readRawThermometer() const
 	return toUInt16(rx[1], rx[2]);
 }
 
+template <typename Transport>
+	requires RegisterModeTransport<Transport>
+bool BMI270<Transport>::configureFifo() const
+{
+	if (!writeRegisterWithCheck(BMI270_REGISTERS::FIFO_CONFIG_0, BMI270_FIFO_TIME_EN))
+	{
+		return false;
+	}
+	if (!writeRegisterWithCheck(BMI270_REGISTERS::FIFO_CONFIG_1, BMI270_FIFO_GYR_EN | BMI270_FIFO_ACC_EN | BMI270_FIFO_HEADER_EN))
+	{
+		return false;
+	}
+	if (!writeRegister(BMI270_REGISTERS::CMD, BMI270_CMD_FIFO_FLUSH))
+	{
+		return false;
+	}
+	log(LOG_LEVEL_DEBUG, "BMI270 FIFO configured for ACC, GYR, sensortime\r\n");
+
+	return true;
+}
+
+template <typename Transport>
+	requires RegisterModeTransport<Transport>
+std::optional<uint16_t> BMI270<Transport>::readFifoLength() const
+{
+	uint8_t rx[3]{}; // rx[0] is a dummy byte to give the BMI time to respond
+
+	if (!readRegisters(BMI270_REGISTERS::FIFO_LENGTH_0, rx, sizeof(rx)))
+	{
+		return std::nullopt;
+	}
+
+	return static_cast<uint16_t>(toUInt16(rx[1], rx[2]) & 0x3FFF);
+}
+
+template <typename Transport>
+	requires RegisterModeTransport<Transport>
+BMI270_FIFO_PARSE BMI270<Transport>::parseFifo(const uint8_t *data, uint16_t len, std::span<FifoSample> samples) const
+{
+	BMI270_FIFO_PARSE result{0, 0, std::nullopt};
+	uint16_t pos = 0;
+
+	while (pos < len)
+	{
+		const uint8_t header = data[pos];
+		uint16_t payload = 0;
+
+		if (header == FIFO_HEADER_EMPTY)
+		{
+			break; // read past the last frame
+		}
+		else if ((header & FIFO_HEADER_REGULAR_MASK) == FIFO_HEADER_REGULAR)
+		{
+			// Payload order is aux, gyro, accel; bits 1:0 carry interrupt tags
+			payload = static_cast<uint16_t>(((header & FIFO_HEADER_AUX) ? 8 : 0) +
+											((header & FIFO_HEADER_GYR) ? 6 : 0) +
+											((header & FIFO_HEADER_ACC) ? 6 : 0));
+			if (pos + 1U + payload > len || result.samples == samples.size())
+			{
+				break;
+			}
+
+			const uint8_t *frame = &data[pos + 1U + ((header & FIFO_HEADER_AUX) ? 8U : 0U)];
+			FifoSample &sample = samples[result.samples++];
+			sample = FifoSample{};
+			if (header & FIFO_HEADER_GYR)
+			{
+				sample.gyr = convertGyrXYZ(frame);
+				sample.has_gyr = true;
+				frame += 6;
+			}
+			if (header & FIFO_HEADER_ACC)
+			{
+				sample.acc = convertAccXYZ(frame);
+				sample.has_acc = true;
+			}
+		}
+		else if (header == FIFO_HEADER_SENSORTIME)
+		{
+			payload = 3;
+			if (pos + 1U + payload > len)
+			{
+				break;
+			}
+			result.sensor_time = static_cast<uint32_t>(data[pos + 1]) |
+								 (static_cast<uint32_t>(data[pos + 2]) << 8) |
+								 (static_cast<uint32_t>(data[pos + 3]) << 16);
+		}
+		else if (header == FIFO_HEADER_SKIP || header == FIFO_HEADER_SAMPLE_DROP)
+		{
+			payload = 1;
+		}
+		else if (header == FIFO_HEADER_INPUT_CONFIG)
+		{
+			payload = 4;
+		}
+		else
+		{
+			log(LOG_LEVEL_ERROR, "BMI270: unknown FIFO header %02x\r\n", header);
+			break;
+		}
+
+		if (pos + 1U + payload > len)
+		{
+			break;
+		}
+		pos = static_cast<uint16_t>(pos + 1U + payload);
+		result.consumed = pos;
+	}
+
+	return result;
+}
+
+template <typename Transport>
+	requires RegisterModeTransport<Transport>
+size_t BMI270<Transport>::readFifo(std::span<FifoSample> samples, uint32_t &read_time) const
+{
+	if (samples.empty())
+	{
+		return 0;
+	}
+
+	auto length = readFifoLength();
+	if (!length.has_value() || length.value() == 0)
+	{
+		return 0;
+	}
+
+	// Whole frames the caller can take, plus the sensortime frame that follows a drained FIFO
+	const std::size_t wanted = std::min<std::size_t>(length.value(), samples.size() * FIFO_ACC_GYR_FRAME_BYTES) + FIFO_SENSORTIME_FRAME_BYTES;
+	const uint16_t bytes = static_cast<uint16_t>(std::min<std::size_t>(wanted, FIFO_BURST_BYTES - 1U));
+
+	uint8_t rx[FIFO_BURST_BYTES]{}; // rx[0] is a dummy byte to give the BMI time to respond
+	if (!readRegisters(BMI270_REGISTERS::FIFO_DATA, rx, static_cast<uint16_t>(bytes + 1U)))
+	{
+		return 0;
+	}
+
+	const BMI270_FIFO_PARSE parsed = parseFifo(&rx[1], bytes, samples);
+	if (parsed.samples == 0)
+	{
+		return 0;
+	}
+
+	// Without a sensortime frame the burst stopped early; the newest frame read is then
+	// older than the current sensortime by the frames still waiting in the FIFO
+	uint32_t last_time = 0;
+	if (parsed.sensor_time.has_value())
+	{
+		last_time = parsed.sensor_time.value();
+		read_time = last_time;
+	}
+	else
+	{
+		uint8_t time_rx[4]{};
+		if (!readRegisters(BMI270_REGISTERS::SENSOR_TIME_0, time_rx, sizeof(time_rx)))
+		{
+			return 0;
+		}
+		const uint32_t now = static_cast<uint32_t>(time_rx[1]) |
+							 (static_cast<uint32_t>(time_rx[2]) << 8) |
+							 (static_cast<uint32_t>(time_rx[3]) << 16);
+		const uint32_t pending = length.value() > parsed.consumed ? static_cast<uint32_t>(length.value() - parsed.consumed) / FIFO_ACC_GYR_FRAME_BYTES : 0U;
+		last_time = now - pending * FIFO_FRAME_TICKS;
+		read_time = now;
+	}
+
+	for (size_t i = 0; i < parsed.samples; ++i)
+	{
+		const uint32_t age = static_cast<uint32_t>(parsed.samples - 1U - i) * FIFO_FRAME_TICKS;
+		samples[i].sensor_time = (last_time - age) & SENSOR_TIME_MASK;
+	}
+
+	return parsed.samples;
+}
+
 #endif /* INC_BMI270_H_ */
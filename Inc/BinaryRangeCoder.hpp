@@ -0,0 +1,180 @@
+#ifndef BINARY_RANGE_CODER_HPP
+#define BINARY_RANGE_CODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Adaptive binary range coder in the style of LZMA: 11-bit probabilities that move 1/32 of the
+// way towards every coded bit, carry propagation through a cached byte. The encoder writes
+// into a caller-provided bounded buffer and reports an overflow instead of writing past it.
+namespace range_coder
+{
+    using Probability = uint16_t;
+
+    constexpr uint32_t PROB_BITS = 11;
+    constexpr Probability PROB_INIT = 1u << (PROB_BITS - 1);
+    constexpr uint32_t MOVE_BITS = 5;
+    constexpr uint32_t TOP = 1u << 24;
+
+    class Encoder
+    {
+    public:
+        Encoder(uint8_t *out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+        void encode(Probability &p, uint32_t bit)
+        {
+            const uint32_t bound = (range_ >> PROB_BITS) * p;
+            if (bit == 0)
+            {
+                range_ = bound;
+                p = static_cast<Probability>(p + (((1u << PROB_BITS) - p) >> MOVE_BITS));
+            }
+            else
+            {
+                low_ += bound;
+                range_ -= bound;
+                p = static_cast<Probability>(p - (p >> MOVE_BITS));
+            }
+            normalize();
+        }
+
+        // Equiprobable bit, e.g. a sign
+        void encodeDirect(uint32_t bit)
+        {
+            range_ >>= 1;
+            if (bit != 0)
+                low_ += range_;
+            normalize();
+        }
+
+        // Flushes the coder; returns the number of bytes written, 0 after an overflow
+        size_t finish()
+        {
+            for (int i = 0; i < 5; ++i)
+                shiftLow();
+            return overflow_ ? 0 : size_;
+        }
+
+        bool overflow() const { return overflow_; }
+
+    private:
+        void normalize()
+        {
+            while (range_ < TOP)
+            {
+                range_ <<= 8;
+                shiftLow();
+            }
+        }
+
+        void shiftLow()
+        {
+            if (static_cast<uint32_t>(low_) < 0xFF000000u || (low_ >> 32) != 0)
+            {
+                const uint8_t carry = static_cast<uint8_t>(low_ >> 32);
+                uint8_t byte = cache_;
+                do
+                {
+                    put(static_cast<uint8_t>(byte + carry));
+                    byte = 0xFF;
+                } while (--pending_ != 0);
+                cache_ = static_cast<uint8_t>(low_ >> 24);
+            }
+            ++pending_;
+            low_ = (low_ & 0x00FFFFFFu) << 8;
+        }
+
+        void put(uint8_t byte)
+        {
+            // The first byte out is always the initial zero cache: it is not stored
+            if (first_)
+            {
+                first_ = false;
+                return;
+            }
+            if (size_ < capacity_)
+                out_[size_++] = byte;
+            else
+                overflow_ = true;
+        }
+
+        uint8_t *out_;
+        size_t capacity_;
+        size_t size_ = 0;
+        uint64_t low_ = 0;
+        uint32_t range_ = 0xFFFFFFFFu;
+        uint32_t pending_ = 1;
+        uint8_t cache_ = 0;
+        bool first_ = true;
+        bool overflow_ = false;
+    };
+
+    class Decoder
+    {
+    public:
+        // Reads past the end return zeros, so a truncated stream decodes to something instead
+        // of reading out of bounds
+        Decoder(const uint8_t *in, size_t size) : in_(in), size_(size)
+        {
+            for (int i = 0; i < 4; ++i)
+                code_ = (code_ << 8) | next();
+        }
+
+        uint32_t decode(Probability &p)
+        {
+            const uint32_t bound = (range_ >> PROB_BITS) * p;
+            uint32_t bit;
+            if (code_ < bound)
+            {
+                range_ = bound;
+                p = static_cast<Probability>(p + (((1u << PROB_BITS) - p) >> MOVE_BITS));
+                bit = 0;
+            }
+            else
+            {
+                code_ -= bound;
+                range_ -= bound;
+                p = static_cast<Probability>(p - (p >> MOVE_BITS));
+                bit = 1;
+            }
+            normalize();
+            return bit;
+        }
+
+        uint32_t decodeDirect()
+        {
+            range_ >>= 1;
+            uint32_t bit = 0;
+            if (code_ >= range_)
+            {
+                code_ -= range_;
+                bit = 1;
+            }
+            normalize();
+            return bit;
+        }
+
+        // More bytes were consumed than the stream holds
+        bool overrun() const { return pos_ > size_ + 4; }
+
+    private:
+        uint8_t next() { return pos_ < size_ ? in_[pos_++] : (++pos_, uint8_t(0)); }
+
+        void normalize()
+        {
+            while (range_ < TOP)
+            {
+                range_ <<= 8;
+                code_ = (code_ << 8) | next();
+            }
+        }
+
+        const uint8_t *in_;
+        size_t size_;
+        size_t pos_ = 0;
+        uint32_t range_ = 0xFFFFFFFFu;
+        uint32_t code_ = 0;
+    };
+} // namespace range_coder
+
+#endif // BINARY_RANGE_CODER_HPP
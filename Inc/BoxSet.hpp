@@ -6,6 +6,26 @@
 #include <limits>
 #include <algorithm>
 #include <stdexcept>
+#include <bit>
+#include <functional>
+
+/**
+ * @brief Key extractor for BoxSets of Cyphal subscriptions, keyed by their port id.
+ */
+struct PortIdKey
+{
+    template <typename S>
+    constexpr auto operator()(const S &item) const { return item.port_id; }
+};
+
+/**
+ * @brief Key extractor for BoxSets of plain integral values.
+ */
+struct IdentityKey
+{
+    template <typename S>
+    constexpr S operator()(const S &item) const { return item; }
+};
 
 /**
  * @brief A container that stores elements in a fixed-size array,
@@ -13,8 +33,12 @@
  *
  * @tparam CONTENT The type of the elements to store.
  * @tparam N The size of the fixed-size array (must be 8, 16, 32, or 64).
+ * @tparam KeyOf Optional key extractor (e.g. PortIdKey). When given, the BoxSet keeps
+ *         a hashed index from integral key to slot so find_by_key() and
+ *         find_or_create_by_key() compare only the few slots sharing a hash bucket.
+ *         Keys must not be modified through the returned pointers.
  */
-template <typename CONTENT, uint8_t N>
+template <typename CONTENT, uint8_t N, typename KeyOf = void>
 class BoxSet
 {
 private:
@@ -25,8 +49,18 @@ private:
 
     static_assert(!std::is_same_v<UType, void>, "N must be 8, 16, 32, or 64");
 
+    static constexpr bool Keyed = !std::is_void_v<KeyOf>;
+    static constexpr size_t Buckets = N / 4;
+    static constexpr int BucketShift = 32 - std::countr_zero(Buckets);
+
+    struct NoIndex
+    {
+    };
+    using Index = typename std::conditional<Keyed, std::array<UType, Buckets>, NoIndex>::type;
+
     std::array<CONTENT, N> content;
     UType active = {};
+    [[no_unique_address]] Index buckets = {};
 
 public:
     /**
@@ -43,7 +77,10 @@ public:
      */
     BoxSet(const std::array<CONTENT, N> &init_content) : content(init_content)
     {
-        active = std::numeric_limits<UType>::max();
+        for (uint8_t i = 0; i < N; ++i)
+        {
+            activate(i);
+        }
     }
 
     /**
@@ -74,14 +111,7 @@ public:
      */
     uint8_t size() const
     {
-        UType temp = active;
-        uint8_t count = 0;
-        while (temp != 0)
-        {
-            temp &= (temp - 1);
-            count++;
-        }
-        return count;
+        return static_cast<uint8_t>(std::popcount(active));
     }
 
     /**
@@ -104,16 +134,13 @@ public:
      */
     CONTENT *add(const CONTENT &item)
     {
-        for (uint8_t i = 0; i < N; ++i)
-        {
-            if (!is_used(i))
-            {
-                content[i] = item;
-                activate(i);
-                return &content[i];
-            }
-        }
-        return nullptr;
+        if (is_full())
+            return nullptr;
+
+        uint8_t i = first_free();
+        content[i] = item;
+        activate(i);
+        return &content[i];
     }
 
     /**
@@ -137,13 +164,13 @@ public:
      */
     void remove(CONTENT *itemPtr)
     {
-        for (uint8_t i = 0; i < N; ++i)
+        if (itemPtr < content.data() || itemPtr >= content.data() + N)
+            return;
+
+        uint8_t i = static_cast<uint8_t>(itemPtr - content.data());
+        if (is_used(i))
         {
-            if (is_used(i) && &content[i] == itemPtr)
-            {
-                deactivate(i);
-                return; // Exit once item is removed
-            }
+            deactivate(i);
         }
     }
 
@@ -155,6 +182,10 @@ public:
     void clear()
     {
         active = 0;
+        if constexpr (Keyed)
+        {
+            buckets = {};
+        }
     }
     
     /**
@@ -168,11 +199,13 @@ public:
     template <typename Comparator>
     CONTENT *find(const CONTENT &item, Comparator comp) const
     {
-        auto it = std::find_if(cbegin(), cend(), [&](const CONTENT &storedItem)
-                            { return comp(item, storedItem); });
-        if (it != cend())
+        for (UType remaining = active; remaining != 0; remaining &= static_cast<UType>(remaining - 1))
         {
-            return &(*it);
+            uint8_t i = static_cast<uint8_t>(std::countr_zero(remaining));
+            if (comp(item, content[i]))
+            {
+                return const_cast<CONTENT *>(&content[i]);
+            }
         }
         return nullptr;
     }
@@ -193,17 +226,45 @@ public:
         if (it) return it;
 
         // Item not found, lets find a free slot
-        for (uint8_t i = 0; i < N; ++i)
+        return add(item);
+    }
+
+    /**
+     * @brief Finds an item by key through the hashed index. Only available with a KeyOf extractor.
+     *
+     * @param key The key to search for.
+     * @return A pointer to the item if found, or nullptr if not found.
+     */
+    template <typename Key>
+        requires Keyed
+    CONTENT *find_by_key(const Key &key) const
+    {
+        UType candidates = static_cast<UType>(buckets[bucket_of(key)] & active);
+        for (; candidates != 0; candidates &= static_cast<UType>(candidates - 1))
         {
-            if (!is_used(i))
+            uint8_t i = static_cast<uint8_t>(std::countr_zero(candidates));
+            if (KeyOf{}(content[i]) == key)
             {
-                content[i] = item;
-                activate(i);
-                return &content[i]; // Return the newly created item
+                return const_cast<CONTENT *>(&content[i]);
             }
         }
+        return nullptr;
+    }
 
-        return nullptr; // Container is full
+    /**
+     * @brief Finds the item with the key of the given item, or adds the item if there is none.
+     *        Only available with a KeyOf extractor.
+     *
+     * @param item The item to search for or to add.
+     * @return A pointer to the item if found, or a pointer to the new item or nullptr if container is full.
+     */
+    CONTENT *find_or_create_by_key(const CONTENT &item)
+        requires Keyed
+    {
+        auto it = find_by_key(KeyOf{}(item));
+        if (it) return it;
+
+        return add(item);
     }
 
     /**
@@ -276,10 +337,14 @@ public:
 
         void _findNextActive()
         {
-            while (m_index < m_boxSet->content.size() && !m_boxSet->is_used(static_cast<uint8_t>(m_index)))
+            if (m_index >= N)
             {
-                m_index++;
+                m_index = N;
+                return;
             }
+
+            UType remaining = static_cast<UType>(m_boxSet->active >> m_index);
+            m_index = (remaining == 0) ? N : m_index + static_cast<size_t>(std::countr_zero(remaining));
         }
     };
 
@@ -312,6 +377,25 @@ public:
     const iterator cend() const { return iterator(const_cast<BoxSet &>(*this), N); }
 
 private:
+    /**
+     * @brief Returns the lowest unused slot. The BoxSet must not be full.
+     */
+    uint8_t first_free() const
+    {
+        return static_cast<uint8_t>(std::countr_zero(static_cast<UType>(~active)));
+    }
+
+    /**
+     * @brief Maps a key to its hash bucket (Fibonacci hashing).
+     * @param key The key to hash.
+     */
+    template <typename Key>
+    static size_t bucket_of(const Key &key)
+    {
+        static_assert(std::is_integral_v<Key>, "BoxSet keys must be integral");
+        return static_cast<size_t>((static_cast<uint32_t>(key) * 0x9E3779B1u) >> BucketShift);
+    }
+
     /**
      * @brief Sets the bit at the given index in the active bitset.
      * @param index The index of the bit to set.
@@ -319,6 +403,10 @@ private:
     void activate(uint8_t index)
     {
         active |= static_cast<UType>(static_cast<UType>(1) << index);
+        if constexpr (Keyed)
+        {
+            buckets[bucket_of(KeyOf{}(content[index]))] |= static_cast<UType>(static_cast<UType>(1) << index);
+        }
     }
     /**
      * @brief Resets the bit at the given index in the active bitset.
@@ -327,5 +415,13 @@ private:
     void deactivate(uint8_t index)
     {
         active &= static_cast<UType>(~(static_cast<UType>(1) << index));
+        if constexpr (Keyed)
+        {
+            // Clear the slot from every bucket: the transport libraries may have rewritten the key meanwhile
+            for (UType &bucket : buckets)
+            {
+                bucket &= static_cast<UType>(~(static_cast<UType>(1) << index));
+            }
+        }
     }
 };
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include <cstddef>
 #include <utility>
 #include <atomic>
+#include <span>
+#include <algorithm>
+#include <bit>
 #include "BufferLikeConcept.hpp"
 
 //
@@ -19,6 +22,16 @@ class SPSCBuffer
     static constexpr size_t RealCapacity = capacity_ + 1;
 
 public:
+    // Readable region of the ring: up to two contiguous runs, oldest first
+    struct ReadSpans
+    {
+        std::span<T> first;
+        std::span<T> second;
+
+        size_t size() const { return first.size() + second.size(); }
+        bool empty() const { return first.empty() && second.empty(); }
+    };
+
     SPSCBuffer() : head_(0), tail_(0) {}
 
     bool is_empty() const
@@ -65,8 +78,64 @@ public:
     {
         size_t h = head_.load(std::memory_order_acquire);
         size_t t = tail_.load(std::memory_order_acquire);
-        if (h >= t) return h - t;
-        return RealCapacity - (t - h);
+        return distance(t, h);
+    }
+
+    // Producer side: copies up to n values into free slots with a single
+    // release of head_. Unlike begin_write() it never drops unread entries,
+    // it returns the number actually written.
+    size_t push_n(const T *values, size_t n)
+    {
+        size_t h = head_.load(std::memory_order_relaxed);
+        size_t t = tail_.load(std::memory_order_acquire);
+        size_t count = std::min(n, capacity_ - distance(t, h));
+
+        size_t run = std::min(count, RealCapacity - h);
+        std::copy_n(values, run, data_.begin() + static_cast<std::ptrdiff_t>(h));
+        std::copy_n(values + run, count - run, data_.begin());
+
+        head_.store(wrap(h + count), std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side: moves up to n of the oldest entries into out with a
+    // single acquire of head_ and a single release of tail_.
+    size_t pop_n(T *out, size_t n)
+    {
+        size_t t = tail_.load(std::memory_order_relaxed);
+        size_t h = head_.load(std::memory_order_acquire);
+        size_t count = std::min(n, distance(t, h));
+
+        size_t run = std::min(count, RealCapacity - t);
+        std::move(data_.begin() + static_cast<std::ptrdiff_t>(t),
+                  data_.begin() + static_cast<std::ptrdiff_t>(t + run), out);
+        std::move(data_.begin(), data_.begin() + static_cast<std::ptrdiff_t>(count - run), out + run);
+
+        tail_.store(wrap(t + count), std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side: exposes all readable entries in place. They stay owned
+    // by the buffer until release(). Only for rings whose producer never
+    // overruns (push_n): begin_write() on a full ring recycles the oldest
+    // slot under the reader and moves tail_, so release() would then skip
+    // unread entries. ISR-fed rings are drained with pop()/pop_n().
+    ReadSpans read_span()
+    {
+        size_t t = tail_.load(std::memory_order_relaxed);
+        size_t h = head_.load(std::memory_order_acquire);
+
+        if (h >= t)
+            return ReadSpans{std::span<T>(data_.data() + t, h - t), std::span<T>()};
+        return ReadSpans{std::span<T>(data_.data() + t, RealCapacity - t), std::span<T>(data_.data(), h)};
+    }
+
+    // Consumer side: retires the n oldest entries obtained from read_span().
+    void release(size_t n)
+    {
+        size_t t = tail_.load(std::memory_order_relaxed);
+        size_t h = head_.load(std::memory_order_acquire);
+        tail_.store(wrap(t + std::min(n, distance(t, h))), std::memory_order_release);
     }
 
 void clear()
@@ -87,6 +156,16 @@ void clear()
     static constexpr size_t capacity() { return capacity_; }
 
 protected:
+    static constexpr size_t wrap(size_t index)
+    {
+        return (index >= RealCapacity) ? index - RealCapacity : index;
+    }
+
+    static constexpr size_t distance(size_t from, size_t to)
+    {
+        return (to >= from) ? to - from : RealCapacity - (from - to);
+    }
+
     // Safe front access for peek()
     T& front()
     {
@@ -109,14 +188,214 @@ protected:
 
 //
 // ─────────────────────────────────────────────
-//   HIGH‑LEVEL: CircularBuffer (old API)
+//   LOW‑LEVEL: PaddedSPSCBuffer (multi-core hosts)
 // ─────────────────────────────────────────────
 //
+// Same interface and capacity semantics as SPSCBuffer, laid out for a producer
+// and a consumer running on different cores (e.g. the ground-station gateway):
+// - head_ and tail_ live on separate cache lines, so the two sides do not
+//   invalidate each other's line on every update
+// - indices run freely and are masked with a power-of-two storage size
+//   instead of taking a modulo on every step
+// - each side keeps a private copy of the opposite index and only reloads the
+//   shared atomic when the copy says the ring is full (producer) or empty
+//   (consumer)
+// begin_write() keeps the drop-oldest behaviour of SPSCBuffer, which moves
+// tail_ from the producer side; cross-core producers should use push_n().
+//
+
+inline constexpr size_t SPSC_CACHE_LINE_SIZE = 64;
 
 template <typename T, size_t capacity_>
-class CircularBuffer : private SPSCBuffer<T, capacity_>
+class PaddedSPSCBuffer
+{
+    static constexpr size_t StorageSize = std::bit_ceil(capacity_);
+    static constexpr size_t Mask = StorageSize - 1;
+
+public:
+    struct ReadSpans
+    {
+        std::span<T> first;
+        std::span<T> second;
+
+        size_t size() const { return first.size() + second.size(); }
+        bool empty() const { return first.empty() && second.empty(); }
+    };
+
+    PaddedSPSCBuffer() : head_(0), cached_tail_(0), tail_(0), cached_head_(0) {}
+
+    bool is_empty() const
+    {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire);
+    }
+
+    bool is_full() const
+    {
+        size_t h = head_.load(std::memory_order_acquire);
+        size_t t = tail_.load(std::memory_order_acquire);
+        return h - t == capacity_;
+    }
+
+    T& begin_write()
+    {
+        size_t h = head_.load(std::memory_order_relaxed);
+        if (h - tail_.load(std::memory_order_acquire) == capacity_)
+        {
+            size_t t = tail_.load(std::memory_order_relaxed);
+            tail_.store(t + 1, std::memory_order_release);
+        }
+        return data_[h & Mask];
+    }
+
+    void commit_write()
+    {
+        size_t h = head_.load(std::memory_order_relaxed);
+        head_.store(h + 1, std::memory_order_release);
+    }
+
+    T pop()
+    {
+        size_t t = tail_.load(std::memory_order_relaxed);
+        if (readable(t) == 0)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (t == cached_head_)
+                return T{};
+        }
+
+        T out = std::move(data_[t & Mask]);
+        tail_.store(t + 1, std::memory_order_release);
+        return out;
+    }
+
+    size_t size() const
+    {
+        size_t h = head_.load(std::memory_order_acquire);
+        size_t t = tail_.load(std::memory_order_acquire);
+        return h - t;
+    }
+
+    size_t push_n(const T *values, size_t n)
+    {
+        size_t h = head_.load(std::memory_order_relaxed);
+        if (writable(h) < n)
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        size_t count = std::min(n, writable(h));
+
+        size_t start = h & Mask;
+        size_t run = std::min(count, StorageSize - start);
+        std::copy_n(values, run, data_.begin() + static_cast<std::ptrdiff_t>(start));
+        std::copy_n(values + run, count - run, data_.begin());
+
+        head_.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t pop_n(T *out, size_t n)
+    {
+        size_t t = tail_.load(std::memory_order_relaxed);
+        if (readable(t) < n)
+            cached_head_ = head_.load(std::memory_order_acquire);
+        size_t count = std::min(n, readable(t));
+
+        size_t start = t & Mask;
+        size_t run = std::min(count, StorageSize - start);
+        std::move(data_.begin() + static_cast<std::ptrdiff_t>(start),
+                  data_.begin() + static_cast<std::ptrdiff_t>(start + run), out);
+        std::move(data_.begin(), data_.begin() + static_cast<std::ptrdiff_t>(count - run), out + run);
+
+        tail_.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    ReadSpans read_span()
+    {
+        size_t t = tail_.load(std::memory_order_relaxed);
+        cached_head_ = head_.load(std::memory_order_acquire);
+        size_t count = cached_head_ - t;
+
+        size_t start = t & Mask;
+        size_t run = std::min(count, StorageSize - start);
+        return ReadSpans{std::span<T>(data_.data() + start, run), std::span<T>(data_.data(), count - run)};
+    }
+
+    void release(size_t n)
+    {
+        size_t t = tail_.load(std::memory_order_relaxed);
+        size_t h = head_.load(std::memory_order_acquire);
+        tail_.store(t + std::min(n, h - t), std::memory_order_release);
+    }
+
+    void clear()
+    {
+        size_t t = tail_.load(std::memory_order_relaxed);
+        size_t h = head_.load(std::memory_order_relaxed);
+
+        while (t != h)
+        {
+            data_[t & Mask] = T{};
+            ++t;
+        }
+
+        head_.store(0, std::memory_order_release);
+        tail_.store(0, std::memory_order_release);
+        cached_tail_ = 0;
+        cached_head_ = 0;
+    }
+
+    static constexpr size_t capacity() { return capacity_; }
+
+protected:
+    // Free slots as seen through the producer's copy of tail_. The copy may lag
+    // behind (never ahead of) the real tail_, which only under-reports space.
+    size_t writable(size_t h) const
+    {
+        size_t used = h - cached_tail_;
+        return (used >= capacity_) ? 0 : capacity_ - used;
+    }
+
+    // Readable entries as seen through the consumer's copy of head_. begin_write()
+    // dropping the oldest entry can move tail_ past a stale copy.
+    size_t readable(size_t t) const
+    {
+        size_t avail = cached_head_ - t;
+        return (avail > capacity_) ? 0 : avail;
+    }
+
+    T& front()
+    {
+        size_t t = tail_.load(std::memory_order_acquire);
+        return data_[t & Mask];
+    }
+
+    const T& front() const
+    {
+        size_t t = tail_.load(std::memory_order_acquire);
+        return data_[t & Mask];
+    }
+
+protected:
+    // producer line
+    alignas(SPSC_CACHE_LINE_SIZE) std::atomic<size_t> head_;
+    size_t cached_tail_;
+    // consumer line
+    alignas(SPSC_CACHE_LINE_SIZE) std::atomic<size_t> tail_;
+    size_t cached_head_;
+    alignas(SPSC_CACHE_LINE_SIZE) std::array<T, StorageSize> data_;
+};
+
+
+//
+// ─────────────────────────────────────────────
+//   HIGH‑LEVEL: CircularBuffer (old API)
+// ─────────────────────────────────────────────
+//
+
+template <typename T, size_t capacity_, typename Storage = SPSCBuffer<T, capacity_>>
+class CircularBuffer : private Storage
 {
-    using Base = SPSCBuffer<T, capacity_>;
+    using Base = Storage;
 
 public:
     using Base::is_empty;
@@ -126,6 +405,11 @@ public:
     using Base::clear;
     using Base::begin_write;
     using Base::commit_write;
+    using Base::push_n;
+    using Base::pop_n;
+    using Base::read_span;
+    using Base::release;
+    using typename Base::ReadSpans;
 
     T& next()
     {
@@ -157,7 +441,13 @@ public:
     }
 };
 
+// CircularBuffer over the cache-line padded storage, for multi-core host builds
+template <typename T, size_t capacity_>
+using PaddedCircularBuffer = CircularBuffer<T, capacity_, PaddedSPSCBuffer<T, capacity_>>;
+
 static_assert(BufferLike<CircularBuffer<int, 8>, int>,
               "CircularBuffer must satisfy BufferLike concept");
+static_assert(BufferLike<PaddedCircularBuffer<int, 8>, int>,
+              "PaddedCircularBuffer must satisfy BufferLike concept");
 
 #endif /* INC_CIRCULARBUFFER_HPP_ */
@@ -0,0 +1,318 @@
+#ifndef __CONTEXT_HEAP_ALLOCATION_HPP__
+#define __CONTEXT_HEAP_ALLOCATION_HPP__
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "o1heap.h"
+#include "IRQLock.hpp"
+#include "HeapAllocation.hpp"
+
+// Lock-free single-producer/single-consumer queue of pointers.
+// One execution context pushes, the other pops; neither side masks interrupts.
+template <size_t Depth>
+class CrossContextFreeQueue
+{
+	static constexpr size_t RealCapacity = Depth + 1;
+
+public:
+	bool push(void *const pointer)
+	{
+		const size_t h = head_.load(std::memory_order_relaxed);
+		const size_t next = (h + 1) % RealCapacity;
+		if (next == tail_.load(std::memory_order_acquire))
+			return false;
+
+		slots_[h] = pointer;
+		head_.store(next, std::memory_order_release);
+		return true;
+	}
+
+	void *pop()
+	{
+		const size_t t = tail_.load(std::memory_order_relaxed);
+		if (t == head_.load(std::memory_order_acquire))
+			return nullptr;
+
+		void *pointer = slots_[t];
+		tail_.store((t + 1) % RealCapacity, std::memory_order_release);
+		return pointer;
+	}
+
+	bool is_empty() const
+	{
+		return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+	}
+
+	void clear()
+	{
+		head_.store(0, std::memory_order_relaxed);
+		tail_.store(0, std::memory_order_relaxed);
+	}
+
+	static constexpr size_t capacity() { return Depth; }
+
+private:
+	std::array<void *, RealCapacity> slots_{};
+	std::atomic<size_t> head_{0};
+	std::atomic<size_t> tail_{0};
+};
+
+typedef struct
+{
+	HeapDiagnostics main;
+	HeapDiagnostics isr;
+	uint32_t deferred_to_main;
+	uint32_t deferred_to_isr;
+	uint32_t masked_fallbacks;
+	uint32_t lost_frees;
+} ContextHeapDiagnostics;
+
+// Drop-in replacement for HeapAllocation with one o1heap per execution context.
+//
+// The main loop allocates from the main heap and ISRs allocate from the ISR heap,
+// so neither path masks interrupts. A block freed in the other context is handed
+// back through a lock-free queue and released by its owner on its next allocation.
+// Only when the main->ISR queue is full does the main loop fall back to masking the
+// interrupts in IsrLocks for a single o1heapFree.
+//
+// All allocating ISRs must run at the same preemption priority, i.e. they must not
+// nest, because the ISR heap itself is not reentrant. IsrLocks must name every IRQ
+// whose handler allocates or frees through this heap; the default covers the CAN
+// handlers, the only allocating ISRs of a CAN node.
+#if !defined(__arm__) || defined(HAL_CAN_MODULE_ENABLED)
+using DefaultIsrHeapLocks = CanIrqLocks;
+#else
+using DefaultIsrHeapLocks = IrqLockSet<>;
+#endif // !defined(__arm__) || defined(HAL_CAN_MODULE_ENABLED)
+
+template <size_t MainHeapSize = 49152, size_t IsrHeapSize = 16384, size_t FreeQueueDepth = 64,
+		  typename IsrLocks = DefaultIsrHeapLocks>
+class ContextHeapAllocation
+{
+private:
+	static uint8_t main_buffer[MainHeapSize] __attribute__((aligned(O1HEAP_ALIGNMENT)));
+	static uint8_t isr_buffer[IsrHeapSize] __attribute__((aligned(O1HEAP_ALIGNMENT)));
+	static O1HeapInstance *main_heap;
+	static O1HeapInstance *isr_heap;
+
+	static CrossContextFreeQueue<FreeQueueDepth> to_main; // ISR produces, main loop consumes
+	static CrossContextFreeQueue<FreeQueueDepth> to_isr;  // main loop produces, ISR consumes
+
+	static inline uint32_t deferred_to_main = 0;
+	static inline uint32_t deferred_to_isr = 0;
+	static inline uint32_t masked_fallbacks = 0;
+	static inline uint32_t lost_frees = 0;
+
+	static bool ownedByIsrHeap(const void *const pointer)
+	{
+		const uint8_t *p = static_cast<const uint8_t *>(pointer);
+		return p >= isr_buffer && p < isr_buffer + IsrHeapSize;
+	}
+
+	static void drainToMain()
+	{
+		while (void *p = to_main.pop())
+			o1heapFree(main_heap, p);
+	}
+
+	static void drainToIsr()
+	{
+		while (void *p = to_isr.pop())
+			o1heapFree(isr_heap, p);
+	}
+
+	static void *contextAllocate(const size_t size)
+	{
+		if (inInterruptContext())
+		{
+			drainToIsr();
+			return o1heapAllocate(isr_heap, size);
+		}
+
+		drainToMain();
+		return o1heapAllocate(main_heap, size);
+	}
+
+	static void contextDeallocate(void *const pointer)
+	{
+		if (pointer == nullptr)
+			return;
+
+		const bool isr_block = ownedByIsrHeap(pointer);
+		if (inInterruptContext())
+		{
+			if (isr_block)
+			{
+				o1heapFree(isr_heap, pointer);
+			}
+			else if (to_main.push(pointer))
+			{
+				++deferred_to_main;
+			}
+			else
+			{
+				// The main loop may be inside o1heap right now; the block is leaked
+				// rather than corrupting the heap. Size FreeQueueDepth to avoid this.
+				++lost_frees;
+			}
+			return;
+		}
+
+		if (!isr_block)
+		{
+			o1heapFree(main_heap, pointer);
+		}
+		else if (to_isr.push(pointer))
+		{
+			++deferred_to_isr;
+		}
+		else
+		{
+			++masked_fallbacks;
+			maskedIsrFree(pointer);
+		}
+	}
+
+	static void maskedIsrFree(void *const pointer)
+	{
+		IsrLocks::lock();
+		drainToIsr();
+		o1heapFree(isr_heap, pointer);
+		IsrLocks::unlock();
+	}
+
+	static HeapDiagnostics toDiagnostics(const O1HeapInstance *inst)
+	{
+		if (inst == nullptr)
+		{
+			return HeapDiagnostics{0, 0, 0, 0, 0};
+		}
+
+		const O1HeapDiagnostics o1diag = o1heapGetDiagnostics(inst);
+		return HeapDiagnostics{
+			o1diag.capacity,
+			o1diag.allocated,
+			o1diag.peak_allocated,
+			o1diag.peak_request_size,
+			o1diag.oom_count};
+	}
+
+public:
+	static void initialize()
+	{
+		main_heap = o1heapInit(main_buffer, MainHeapSize);
+		isr_heap = o1heapInit(isr_buffer, IsrHeapSize);
+		to_main.clear();
+		to_isr.clear();
+		deferred_to_main = 0;
+		deferred_to_isr = 0;
+		masked_fallbacks = 0;
+		lost_frees = 0;
+	}
+
+	// Releases blocks that ISRs handed back to the main heap; call from the main loop.
+	static void collect()
+	{
+		if (!inInterruptContext())
+			drainToMain();
+	}
+
+	static void *heapAllocate(void *const /*handle*/, const size_t amount)
+	{
+		return contextAllocate(amount);
+	}
+
+	static void heapFree(void *const /*handle*/, void *const pointer)
+	{
+		contextDeallocate(pointer);
+	}
+
+	static void *canardMemoryAllocate(CanardInstance *const /*canard*/, const size_t size)
+	{
+		return contextAllocate(size);
+	}
+
+	static void canardMemoryDeallocate(CanardInstance *const /*canard*/, void *const pointer)
+	{
+		contextDeallocate(pointer);
+	}
+
+	static void *serardMemoryAllocate(void *const /*user_reference*/, const size_t size)
+	{
+		return contextAllocate(size);
+	}
+
+	static void serardMemoryDeallocate(void *const /*user_reference*/, const size_t /*size*/, void *const pointer)
+	{
+		contextDeallocate(pointer);
+	}
+
+	static void *udpardMemoryAllocate(void *const /*user_reference*/, const size_t size)
+	{
+		return contextAllocate(size);
+	}
+
+	static void udpardMemoryDeallocate(void *const /*user_reference*/, const size_t /*size*/, void *const pointer)
+	{
+		contextDeallocate(pointer);
+	}
+
+	static void *loopardMemoryAllocate(const size_t size)
+	{
+		return contextAllocate(size);
+	}
+
+	static void loopardMemoryDeallocate(void *const pointer)
+	{
+		contextDeallocate(pointer);
+	}
+
+	// The main-loop heap, for TaskCheckMemory and other existing diagnostics consumers
+	static O1HeapInstance *getO1Heap()
+	{
+		return main_heap;
+	}
+
+	static O1HeapInstance *getIsrO1Heap()
+	{
+		return isr_heap;
+	}
+
+	static HeapDiagnostics getDiagnostics()
+	{
+		return toDiagnostics(main_heap);
+	}
+
+	static ContextHeapDiagnostics getContextDiagnostics()
+	{
+		return ContextHeapDiagnostics{
+			toDiagnostics(main_heap),
+			toDiagnostics(isr_heap),
+			deferred_to_main,
+			deferred_to_isr,
+			masked_fallbacks,
+			lost_frees};
+	}
+};
+
+template <size_t MainHeapSize, size_t IsrHeapSize, size_t FreeQueueDepth, typename IsrLocks>
+uint8_t ContextHeapAllocation<MainHeapSize, IsrHeapSize, FreeQueueDepth, IsrLocks>::main_buffer[MainHeapSize];
+
+template <size_t MainHeapSize, size_t IsrHeapSize, size_t FreeQueueDepth, typename IsrLocks>
+uint8_t ContextHeapAllocation<MainHeapSize, IsrHeapSize, FreeQueueDepth, IsrLocks>::isr_buffer[IsrHeapSize];
+
+template <size_t MainHeapSize, size_t IsrHeapSize, size_t FreeQueueDepth, typename IsrLocks>
+O1HeapInstance *ContextHeapAllocation<MainHeapSize, IsrHeapSize, FreeQueueDepth, IsrLocks>::main_heap = nullptr;
+
+template <size_t MainHeapSize, size_t IsrHeapSize, size_t FreeQueueDepth, typename IsrLocks>
+O1HeapInstance *ContextHeapAllocation<MainHeapSize, IsrHeapSize, FreeQueueDepth, IsrLocks>::isr_heap = nullptr;
+
+template <size_t MainHeapSize, size_t IsrHeapSize, size_t FreeQueueDepth, typename IsrLocks>
+CrossContextFreeQueue<FreeQueueDepth> ContextHeapAllocation<MainHeapSize, IsrHeapSize, FreeQueueDepth, IsrLocks>::to_main;
+
+template <size_t MainHeapSize, size_t IsrHeapSize, size_t FreeQueueDepth, typename IsrLocks>
+CrossContextFreeQueue<FreeQueueDepth> ContextHeapAllocation<MainHeapSize, IsrHeapSize, FreeQueueDepth, IsrLocks>::to_isr;
+
+#endif // __CONTEXT_HEAP_ALLOCATION_HPP__
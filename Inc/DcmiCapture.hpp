@@ -11,6 +11,7 @@
 #endif
 
 #include "CameraDriver.hpp"
+#include "DcmiStripStream.hpp"
 
 class DcmiCapture
 {
@@ -66,6 +67,69 @@ public:
         return true;
     }
 
+    // Strip streaming: circular DMA over the stream's two strips with half and complete
+    // interrupts, and the DCMI frame interrupt to flush the last, partial strip. The DMA2
+    // channel 6 and DCMI IRQ handlers call handleDmaInterrupt() and handleFrameInterrupt().
+    template <size_t STRIP_WORDS>
+    bool startStreaming(DcmiStripStream<STRIP_WORDS> &stream)
+    {
+        uint32_t *ring = stream.begin();
+
+        DMA2_Channel6->CCR = 0;
+        DMA2->IFCR = DMA_IFCR_CGIF6;
+        DMA2_Channel6->CPAR = (uint32_t)&DCMI->DR;
+        DMA2_Channel6->CMAR = (uint32_t)ring;
+        DMA2_Channel6->CNDTR = DcmiStripStream<STRIP_WORDS>::RING_WORDS;
+
+        DMA2_Channel6->CCR =
+            DMA_CCR_MINC |
+            DMA_CCR_CIRC |
+            DMA_CCR_PSIZE_1 | // 32-bit
+            DMA_CCR_MSIZE_1 | // 32-bit
+            DMA_CCR_HTIE |
+            DMA_CCR_TCIE;
+
+        DMA2_Channel6->CCR |= DMA_CCR_EN;
+
+        // One frame per start: snapshot mode stops the capture at VSYNC
+        DCMI->CR |= DCMI_CR_CM;
+        DCMI->ICR = DCMI_ICR_FRAME_ISC;
+        DCMI->IER |= DCMI_IER_FRAME_IE;
+
+        DCMI->CR |= DCMI_CR_CAPTURE;
+
+        return true;
+    }
+
+    template <size_t STRIP_WORDS>
+    void handleDmaInterrupt(DcmiStripStream<STRIP_WORDS> &stream)
+    {
+        const uint32_t isr = DMA2->ISR;
+        if (isr & DMA_ISR_HTIF6)
+        {
+            DMA2->IFCR = DMA_IFCR_CHTIF6;
+            stream.onHalfTransfer();
+        }
+        if (isr & DMA_ISR_TCIF6)
+        {
+            DMA2->IFCR = DMA_IFCR_CTCIF6;
+            stream.onTransferComplete();
+        }
+    }
+
+    template <size_t STRIP_WORDS>
+    void handleFrameInterrupt(DcmiStripStream<STRIP_WORDS> &stream)
+    {
+        if ((DCMI->MISR & DCMI_MIS_FRAME_MIS) == 0)
+            return;
+        DCMI->ICR = DCMI_ICR_FRAME_ISC;
+        DCMI->IER &= ~DCMI_IER_FRAME_IE;
+        // A strip completed by the last words must be published before the frame end
+        handleDmaInterrupt(stream);
+        stream.onFrameEnd(DMA2_Channel6->CNDTR);
+        DMA2_Channel6->CCR &= ~DMA_CCR_EN;
+    }
+
     bool stop()
     {
         DCMI->CR &= ~DCMI_CR_CAPTURE;
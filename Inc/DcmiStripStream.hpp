@@ -0,0 +1,164 @@
+#ifndef DCMI_STRIP_STREAM_HPP
+#define DCMI_STRIP_STREAM_HPP
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#include "ImageBufferConcept.hpp"
+
+// Receives a filled strip; returns false to abort the frame
+template <typename T>
+concept StripConsumerConcept = requires(T t, const uint8_t *data, size_t size) {
+    { t(data, size) } -> std::convertible_to<bool>;
+};
+
+// Double-buffered capture ring for the DCMI. The DMA runs in circular mode over two strips of
+// STRIP_WORDS words: while it fills one half, the task drains the other into its consumer, so a
+// frame only has to fit the storage, not RAM, and storing overlaps the capture.
+//
+// The on*() calls come from the DMA half/complete and DCMI frame interrupts, drain() from the
+// task. Each half carries the number of valid words, 0 once it has been drained. When the DMA
+// starts refilling a half that was not drained yet, the frame is marked as overrun.
+template <size_t STRIP_WORDS>
+class DcmiStripStream
+{
+public:
+    static_assert(STRIP_WORDS > 0, "a strip holds at least one word");
+
+    static constexpr size_t RING_WORDS = 2 * STRIP_WORDS;
+    static constexpr size_t STRIP_BYTES = STRIP_WORDS * sizeof(uint32_t);
+
+    // Resets the stream for a new frame; returns the DMA target of RING_WORDS words
+    uint32_t *begin()
+    {
+        filled_[0].store(0, std::memory_order_relaxed);
+        filled_[1].store(0, std::memory_order_relaxed);
+        overrun_.store(false, std::memory_order_relaxed);
+        frameEnded_.store(false, std::memory_order_relaxed);
+        next_ = 0;
+        bytes_ = 0;
+        failed_ = false;
+        return ring_.data();
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // Interrupt side
+    // ─────────────────────────────────────────────────────────────────────────
+
+    // First half filled, the DMA continues into the second
+    void onHalfTransfer() { stripFilled(0, STRIP_WORDS); }
+
+    // Second half filled, the DMA wraps to the first
+    void onTransferComplete() { stripFilled(1, STRIP_WORDS); }
+
+    // End of frame. dmaRemaining is the DMA counter (CNDTR): the words left before the wrap,
+    // which locates the partial strip the DMA was filling when VSYNC arrived.
+    void onFrameEnd(uint32_t dmaRemaining)
+    {
+        const size_t position = (RING_WORDS - (dmaRemaining % RING_WORDS)) % RING_WORDS;
+        const size_t words = position % STRIP_WORDS;
+        if (words != 0)
+        {
+            const size_t half = position / STRIP_WORDS;
+            if (filled_[half].load(std::memory_order_relaxed) != 0)
+                overrun_.store(true, std::memory_order_relaxed);
+            filled_[half].store(static_cast<uint32_t>(words), std::memory_order_release);
+        }
+        frameEnded_.store(true, std::memory_order_release);
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // Task side
+    // ─────────────────────────────────────────────────────────────────────────
+
+    // Hands the filled strips to the consumer in capture order. Returns false once the frame
+    // overran or the consumer failed.
+    template <StripConsumerConcept ConsumerT>
+    bool drain(ConsumerT &consumer)
+    {
+        while (!failed())
+        {
+            const uint32_t words = filled_[next_].load(std::memory_order_acquire);
+            if (words == 0)
+                break;
+
+            const size_t size = words * sizeof(uint32_t);
+            if (!consumer(reinterpret_cast<const uint8_t *>(&ring_[next_ * STRIP_WORDS]), size))
+            {
+                failed_ = true;
+                break;
+            }
+            bytes_ += size;
+            filled_[next_].store(0, std::memory_order_release);
+            next_ ^= 1u;
+        }
+        return !failed();
+    }
+
+    // The frame has ended and every strip has been drained
+    bool complete() const
+    {
+        return frameEnded_.load(std::memory_order_acquire) &&
+               filled_[0].load(std::memory_order_acquire) == 0 &&
+               filled_[1].load(std::memory_order_acquire) == 0;
+    }
+
+    bool frameEnded() const { return frameEnded_.load(std::memory_order_acquire); }
+    bool overrun() const { return overrun_.load(std::memory_order_acquire); }
+    bool failed() const { return failed_ || overrun(); }
+
+    // Bytes handed to the consumer in this frame, whole words
+    size_t bytes() const { return bytes_; }
+
+private:
+    void stripFilled(size_t half, size_t words)
+    {
+        // The DMA now writes into the other half: it must have been drained
+        if (filled_[half ^ 1u].load(std::memory_order_relaxed) != 0)
+            overrun_.store(true, std::memory_order_relaxed);
+        filled_[half].store(static_cast<uint32_t>(words), std::memory_order_release);
+    }
+
+    alignas(4) std::array<uint32_t, RING_WORDS> ring_{};
+    std::atomic<uint32_t> filled_[2] = {0, 0};
+    std::atomic<bool> overrun_{false};
+    std::atomic<bool> frameEnded_{false};
+    size_t next_ = 0;
+    size_t bytes_ = 0;
+    bool failed_ = false;
+};
+
+// Strip consumer appending to the open image of an ImageBuffer. The DCMI packs whole words, so
+// the padding past meta.payload_size is dropped.
+template <ImageBufferConcept BufferT>
+class ImageBufferStripWriter
+{
+public:
+    ImageBufferStripWriter(BufferT &buffer, size_t payloadSize)
+        : buffer_(buffer), remaining_(payloadSize) {}
+
+    bool operator()(const uint8_t *data, size_t size)
+    {
+        size_t chunk = size < remaining_ ? size : remaining_;
+        if (chunk == 0)
+            return true;
+        error_ = buffer_.add_data_chunk(data, chunk);
+        if (error_ != ImageBufferError::NO_ERROR)
+            return false;
+        remaining_ -= chunk;
+        return true;
+    }
+
+    size_t remaining() const { return remaining_; }
+    ImageBufferError error() const { return error_; }
+
+private:
+    BufferT &buffer_;
+    size_t remaining_;
+    ImageBufferError error_ = ImageBufferError::NO_ERROR;
+};
+
+#endif // DCMI_STRIP_STREAM_HPP
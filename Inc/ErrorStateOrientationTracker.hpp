@@ -0,0 +1,352 @@
+#ifndef __ERROR_STATE_ORIENTATION_TRACKER_HPP__
+#define __ERROR_STATE_ORIENTATION_TRACKER_HPP__
+
+#include <Eigen/Dense>
+#include <cmath>
+#include <span>
+#include "Kalman.hpp"
+#include "Quaternion.hpp"
+#include "au.hpp"
+
+// Error-state (multiplicative) EKF for attitude, an alternative to the additive quaternion
+// filters in OrientationTracker.hpp with the same interface.
+//
+// The nominal orientation q (body to NED, as in OrientationTracker.hpp) and the gyro bias b
+// are kept outside the filter. The filter estimates the small error
+//     δx = [δθ, δb],  q_true = q ⊗ Exp(δθ),  b_true = b + δb
+// so its covariance is 6x6 and has no direction along the unit-norm constraint. After each
+// update δx is folded into q and b and reset to zero.
+
+// Closed-form discrete transition of the error state over one gyro step:
+//     δθ' = Exp(-ω dt) δθ - dt δb,  δb' = δb
+// applied to the 3x3 covariance blocks instead of two dense 6x6 products.
+struct AttitudeErrorTransition
+{
+    AttitudeErrorTransition(const Eigen::Vector3f &omega, float step) : dt(step)
+    {
+        const Eigen::Vector3f phi = omega * step;
+        const float angle = phi.norm();
+        if (angle > 1e-6f)
+            rotation = Eigen::AngleAxisf(angle, phi / angle).toRotationMatrix().transpose();
+        else
+            rotation = Eigen::Matrix3f::Identity() - skew(phi);
+    }
+
+    static Eigen::Matrix3f skew(const Eigen::Vector3f &v)
+    {
+        Eigen::Matrix3f m;
+        m << 0.f, -v(2), v(1),
+            v(2), 0.f, -v(0),
+            -v(1), v(0), 0.f;
+        return m;
+    }
+
+    template <typename State, typename Covariance>
+    void propagate(State &x, Covariance &P) const
+    {
+        x.template head<3>() = rotation * x.template head<3>() - dt * x.template tail<3>();
+
+        const Eigen::Matrix3f attitude = P.template topLeftCorner<3, 3>();
+        const Eigen::Matrix3f cross = P.template topRightCorner<3, 3>();
+        const Eigen::Matrix3f bias = P.template bottomRightCorner<3, 3>();
+
+        const Eigen::Matrix3f new_cross = rotation * cross - dt * bias;
+        const Eigen::Matrix3f new_attitude = (rotation * attitude - dt * cross.transpose()) * rotation.transpose() - dt * new_cross;
+        P.template topLeftCorner<3, 3>() = 0.5f * (new_attitude + new_attitude.transpose());
+        P.template topRightCorner<3, 3>() = new_cross;
+        P.template bottomLeftCorner<3, 3>() = new_cross.transpose();
+    }
+
+    Eigen::Matrix3f rotation; // Exp(-ω dt)
+    float dt;
+};
+
+template <int MeasurementSize>
+class BaseErrorStateOrientationTracker
+{
+public:
+    static constexpr int StateSize = 6;
+    using Measurement = Eigen::Matrix<float, MeasurementSize, 1>;
+
+    // Gyro white noise and bias random walk, as variances per second
+    BaseErrorStateOrientationTracker(float gyro_noise, float bias_noise,
+                                     float initial_attitude_variance, float initial_bias_variance)
+        : ekf(Eigen::Matrix<float, StateSize, StateSize>::Zero(),
+              Eigen::Matrix<float, MeasurementSize, MeasurementSize>::Identity(),
+              [&]
+              {
+                  Eigen::Matrix<float, StateSize, 1> p;
+                  p << Eigen::Vector3f::Constant(initial_attitude_variance), Eigen::Vector3f::Constant(initial_bias_variance);
+                  return Eigen::Matrix<float, StateSize, StateSize>(p.asDiagonal());
+              }(),
+              Eigen::Matrix<float, StateSize, 1>::Zero()),
+          orientation(Eigen::Quaternionf::Identity()),
+          gyro_bias(Eigen::Vector3f::Zero()),
+          angular_rate(Eigen::Vector3f::Zero()),
+          gyro_noise(gyro_noise),
+          bias_noise(bias_noise),
+          last_timestamp(au::make_quantity<au::Milli<au::Seconds>>(0))
+    {
+    }
+
+    void predictTo(au::QuantityU64<au::Milli<au::Seconds>> new_timestamp)
+    {
+        float dt = 0.001f * static_cast<float>((new_timestamp - last_timestamp).in(au::milli(au::seconds)));
+        if (dt <= 0.f)
+            return;
+
+        const Eigen::Vector3f omega = angular_rate - gyro_bias;
+        rotate(omega * dt);
+        propagateCovariance(omega, dt);
+        last_timestamp = new_timestamp;
+    }
+
+    // Burst of gyro samples sample_period apart, oldest first; see BaseOrientationTracker
+    void predictTo(std::span<const Eigen::Vector3f> gyro_rates, float sample_period,
+                   au::QuantityU64<au::Milli<au::Seconds>> new_timestamp)
+    {
+        integrateRates(gyro_rates, [sample_period](size_t) { return sample_period; }, new_timestamp);
+    }
+
+    // As above with the period of each sample; sizes must match
+    void predictTo(std::span<const Eigen::Vector3f> gyro_rates, std::span<const float> sample_periods,
+                   au::QuantityU64<au::Milli<au::Seconds>> new_timestamp)
+    {
+        integrateRates(gyro_rates, [sample_periods](size_t k) { return sample_periods[k]; }, new_timestamp);
+    }
+
+    void updateGyro(const Eigen::Vector3f &gyro, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        predictTo(timestamp);
+        angular_rate = gyro;
+    }
+
+    void updateSensorFusion(const Eigen::Vector3f &gyro, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        updateGyro(gyro, timestamp);
+    }
+
+    void setGyroAngularRate(const Eigen::Vector3f &omega)
+    {
+        angular_rate = omega;
+    }
+
+    void setOrientation(const Eigen::Quaternionf &q)
+    {
+        orientation = q.normalized();
+    }
+
+    void setGyroBias(const Eigen::Vector3f &bias)
+    {
+        gyro_bias = bias;
+    }
+
+    Eigen::Quaternionf getOrientation() const
+    {
+        return orientation;
+    }
+
+    Eigen::Vector3f getGyroBias() const
+    {
+        return gyro_bias;
+    }
+
+    const Eigen::Matrix<float, StateSize, StateSize> &getCovariance() const
+    {
+        return ekf.stateCovarianceMatrix;
+    }
+
+    Eigen::Vector3f getYawPitchRoll() const
+    {
+        return quaternionToYawPitchRoll(orientation);
+    }
+
+protected:
+    template <typename PeriodOf>
+    void integrateRates(std::span<const Eigen::Vector3f> gyro_rates, PeriodOf period_of,
+                        au::QuantityU64<au::Milli<au::Seconds>> new_timestamp)
+    {
+        if (gyro_rates.empty())
+            return;
+
+        Eigen::Vector3f previous = (angular_rate - gyro_bias) * period_of(0);
+        for (size_t k = 0; k < gyro_rates.size(); ++k)
+        {
+            const float dt = period_of(k);
+            const Eigen::Vector3f omega = gyro_rates[k] - gyro_bias;
+            const Eigen::Vector3f alpha = omega * dt;
+            rotate(alpha + previous.cross(alpha) / 12.f);
+            propagateCovariance(omega, dt);
+            previous = alpha;
+        }
+
+        angular_rate = gyro_rates.back();
+        last_timestamp = new_timestamp;
+    }
+
+    void rotate(const Eigen::Vector3f &phi)
+    {
+        const float angle = phi.norm();
+        if (angle > 1e-6f)
+            orientation = (orientation * Eigen::Quaternionf(Eigen::AngleAxisf(angle, phi / angle))).normalized();
+    }
+
+    void propagateCovariance(const Eigen::Vector3f &omega, float dt)
+    {
+        ekf.processNoiseCovarianceMatrix.diagonal() << Eigen::Vector3f::Constant(gyro_noise * dt), Eigen::Vector3f::Constant(bias_noise * dt);
+        ekf.predictWith(AttitudeErrorTransition(omega, dt));
+    }
+
+    // Rows of H and the residual for a unit reference vector observed in the body frame:
+    // z = q* v_ned, and a small rotation δθ changes it by [z]x δθ
+    void observeDirection(const Eigen::Vector3f &reference_ned, const Eigen::Vector3f &direction_body, int row,
+                          Eigen::Matrix<float, MeasurementSize, StateSize> &H, Measurement &residual) const
+    {
+        const Eigen::Vector3f predicted = orientation.conjugate() * reference_ned;
+        H.template block<3, 3>(row, 0) = AttitudeErrorTransition::skew(predicted);
+        H.template block<3, 3>(row, 3).setZero();
+        residual.template segment<3>(row) = direction_body.normalized() - predicted;
+    }
+
+    // δx starts at zero, so the residual is the innovation; fold the estimate back into q and b
+    bool correct(const Eigen::Matrix<float, MeasurementSize, StateSize> &H, const Measurement &residual)
+    {
+        auto &dx = ekf.stateVector;
+        dx.setZero();
+        const bool applied = ekf.update(H, residual);
+
+        const Eigen::Vector3f half_theta = 0.5f * dx.template head<3>();
+        orientation = (orientation * Eigen::Quaternionf(1.f, half_theta.x(), half_theta.y(), half_theta.z())).normalized();
+        gyro_bias += dx.template tail<3>();
+        dx.setZero();
+        return applied;
+    }
+
+    KalmanFilter<StateSize, MeasurementSize> ekf;
+    Eigen::Quaternionf orientation;
+    Eigen::Vector3f gyro_bias;
+    Eigen::Vector3f angular_rate;
+    float gyro_noise;
+    float bias_noise;
+    au::QuantityU64<au::Milli<au::Seconds>> last_timestamp;
+};
+
+class ErrorStateGyrMagOrientationTracker : public BaseErrorStateOrientationTracker<3>
+{
+protected:
+    Eigen::Vector3f magnetic_ned;
+
+public:
+    ErrorStateGyrMagOrientationTracker() : BaseErrorStateOrientationTracker<3>(1e-4f, 1e-8f, 1e-2f, 1e-4f),
+                                           magnetic_ned(Eigen::Vector3f(0.3f, 0.5f, 0.8f).normalized())
+    {
+        ekf.measurementNoiseCovarianceMatrix = Eigen::Matrix3f::Identity() * 0.01f;
+    }
+
+    void updateMagnetometer(const Eigen::Vector3f &mag_body, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        predictTo(timestamp);
+
+        Eigen::Matrix<float, 3, StateSize> H;
+        Measurement residual;
+        observeDirection(magnetic_ned, mag_body, 0, H, residual);
+        correct(H, residual);
+    }
+
+    void updateSensorFusion(const Eigen::Vector3f &gyro,
+                            const Eigen::Vector3f &mag_body,
+                            au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        updateGyro(gyro, timestamp);
+        updateMagnetometer(mag_body, timestamp);
+    }
+
+    void setReferenceVectors(const Eigen::Vector3f &magnetic_ned_in)
+    {
+        magnetic_ned = magnetic_ned_in.normalized();
+    }
+};
+
+class ErrorStateAccGyrMagOrientationTracker : public BaseErrorStateOrientationTracker<6>
+{
+private:
+    Eigen::Vector3f accel_ned;
+    Eigen::Vector3f magnetic_ned;
+
+public:
+    ErrorStateAccGyrMagOrientationTracker() : BaseErrorStateOrientationTracker<6>(1e-4f, 1e-8f, 1e-2f, 1e-4f),
+                                              accel_ned(0.f, 0.f, 1.f),
+                                              magnetic_ned(Eigen::Vector3f(0.51f, 0.04f, 0.89f).normalized())
+    {
+        ekf.measurementNoiseCovarianceMatrix = Eigen::Matrix<float, 6, 6>::Identity() * 0.001f;
+    }
+
+    void updateAccelerometerMagnetometer(const Eigen::Vector3f &accel_body,
+                                         const Eigen::Vector3f &mag_body,
+                                         au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        predictTo(timestamp);
+
+        Eigen::Matrix<float, 6, StateSize> H;
+        Measurement residual;
+        observeDirection(accel_ned, accel_body, 0, H, residual);
+        observeDirection(magnetic_ned, mag_body, 3, H, residual);
+        correct(H, residual);
+    }
+
+    void updateSensorFusion(const Eigen::Vector3f &gyro,
+                            const Eigen::Vector3f &accel_body,
+                            const Eigen::Vector3f &mag_body,
+                            au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        updateGyro(gyro, timestamp);
+        updateAccelerometerMagnetometer(accel_body, mag_body, timestamp);
+    }
+
+    // Both references are directions; the accelerometer is compared after normalisation
+    void setReferenceVectors(const Eigen::Vector3f &accel_ned_in,
+                             const Eigen::Vector3f &magnetic_ned_in)
+    {
+        magnetic_ned = magnetic_ned_in.normalized();
+        accel_ned = accel_ned_in.normalized();
+    }
+};
+
+class ErrorStateAccGyrOrientationTracker : public BaseErrorStateOrientationTracker<3>
+{
+private:
+    Eigen::Vector3f accel_ned;
+
+public:
+    ErrorStateAccGyrOrientationTracker() : BaseErrorStateOrientationTracker<3>(1e-4f, 1e-8f, 1e-2f, 1e-4f),
+                                           accel_ned(0.f, 0.f, 1.f)
+    {
+        ekf.measurementNoiseCovarianceMatrix = Eigen::Matrix3f::Identity() * 0.01f;
+    }
+
+    void updateAccelerometer(const Eigen::Vector3f &accel_body,
+                             au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        predictTo(timestamp);
+
+        Eigen::Matrix<float, 3, StateSize> H;
+        Measurement residual;
+        observeDirection(accel_ned, accel_body, 0, H, residual);
+        correct(H, residual);
+    }
+
+    void updateSensorFusion(const Eigen::Vector3f &gyro,
+                            const Eigen::Vector3f &accel_body,
+                            au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        updateGyro(gyro, timestamp);
+        updateAccelerometer(accel_body, timestamp);
+    }
+
+    void setReferenceVectors(const Eigen::Vector3f &accel_ned_in)
+    {
+        accel_ned = accel_ned_in.normalized();
+    }
+};
+
+#endif // __ERROR_STATE_ORIENTATION_TRACKER_HPP__
@@ -17,6 +17,12 @@ concept FileAccessConcept = requires(Accessor& a, const std::array<char, NAME_LE
     { a.read(path, offset, buffer, size) } -> std::convertible_to<bool>;
 };
 
+// Directory listing by index, as served by uavcan.file.List: false past the last entry
+template <typename Lister>
+concept FileListConcept = requires(Lister& l, size_t index, std::array<char, NAME_LENGTH>& name) {
+    { l.list(index, name) } -> std::convertible_to<bool>;
+};
+
 class POSIXFileAccess {
 public:
     bool read(const std::array<char, NAME_LENGTH>& path, size_t offset, uint8_t* buffer, size_t& size) {
@@ -0,0 +1,75 @@
+#ifndef FLOAT_VECTOR_HPP
+#define FLOAT_VECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Four-lane float vector for per-pixel loops. GCC lowers the arithmetic to SSE, NEON or
+// Helium where available and to scalar FPU code elsewhere, so callers need no intrinsics.
+namespace float_vector
+{
+    using Float4 = float __attribute__((vector_size(16)));
+    using UInt4 = uint32_t __attribute__((vector_size(16)));
+    using Int4 = int32_t __attribute__((vector_size(16)));
+
+    constexpr std::size_t LANES = sizeof(Float4) / sizeof(float);
+
+    inline Float4 load(const float *p)
+    {
+        Float4 v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline void store(float *p, Float4 v)
+    {
+        std::memcpy(p, &v, sizeof(v));
+    }
+
+    inline Float4 broadcast(float value)
+    {
+        return Float4{} + value;
+    }
+
+    // x^(1/4) using only multiplies: x^(-1/4) is seeded from the exponent bits and refined by
+    // three Newton steps (relative error < 1e-6), then x (x^(-1/4))^3. Negative lanes give NaN.
+    inline Float4 fourthRootNewton(Float4 x)
+    {
+        UInt4 bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        // Seeded from |x| so negative lanes cannot run the iteration into denormals
+        bits = 0x4F5A0000u - ((bits & 0x7FFFFFFFu) >> 2);
+        Float4 y;
+        std::memcpy(&y, &bits, sizeof(y));
+
+        const Float4 magnitude = x < 0.0f ? -x : x;
+        for (int i = 0; i < 3; ++i)
+        {
+            const Float4 y2 = y * y;
+            y = y * (1.25f - 0.25f * magnitude * y2 * y2);
+        }
+        const Float4 root = magnitude * y * y * y;
+        return x < 0.0f ? broadcast(std::numeric_limits<float>::quiet_NaN()) : root;
+    }
+
+    // x^(1/4) per lane, NaN for negative lanes. Two vector square roots where the target has
+    // them (SSE, AArch64 NEON); Cortex-M4F and Helium have none, so the Newton form is used.
+    inline Float4 fourthRoot(Float4 x)
+    {
+#if defined(__SSE__)
+        return __builtin_ia32_sqrtps(__builtin_ia32_sqrtps(x));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        return vsqrtq_f32(vsqrtq_f32(x));
+#else
+        return fourthRootNewton(x);
+#endif
+    }
+}
+
+#endif // FLOAT_VECTOR_HPP
@@ -5,6 +5,7 @@
 #include <optional>
 #include <cmath>
 #include <array>
+#include <span>
 #include "au.hpp"
 
 typedef uint8_t ChipID;
@@ -42,6 +43,18 @@ concept HasEcefGyroscope = requires(T t) {
     { t.readGyroscope() } -> std::same_as<std::optional<AngularVelocityInEcefFrame>>;
 };
 
+// Concept for a FIFO read out in bursts of frames stamped with the sensor clock: sensor_time
+// and the read time count SENSOR_TIME_TICK seconds and wrap at SENSOR_TIME_MASK.
+// FIFO_SAMPLE_PERIOD is the nominal frame spacing.
+template<typename T>
+concept HasGyroscopeFifo = requires(T t, std::span<typename T::FifoSample> samples, uint32_t read_time) {
+    { t.readFifo(samples, read_time) } -> std::same_as<size_t>;
+    { samples[0].sensor_time } -> std::convertible_to<uint32_t>;
+    { T::FIFO_SAMPLE_PERIOD } -> std::convertible_to<float>;
+    { T::SENSOR_TIME_TICK } -> std::convertible_to<float>;
+    { T::SENSOR_TIME_MASK } -> std::convertible_to<uint32_t>;
+};
+
 // Concept for readMagnetometer method
 template<typename T>
 concept HasBodyMagnetometer = requires(T t) {
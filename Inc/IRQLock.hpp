@@ -34,11 +34,30 @@ private:
     static inline uint32_t counter_ = 0;
 };
 
+// Masks several IRQs as one, e.g. every handler that shares a resource
+template <typename... Locks>
+struct IrqLockSet
+{
+    static void lock() { (Locks::lock(), ...); }
+    static void unlock() { (Locks::unlock(), ...); }
+};
+
+// True while executing an exception handler (IPSR holds the active exception number)
+inline bool inInterruptContext()
+{
+#ifdef __arm__
+    return __get_IPSR() != 0U;
+#else
+    return get_isr_context();
+#endif
+}
+
 #if !defined(__arm__) || defined(HAL_CAN_MODULE_ENABLED)
 
 using CanTxIrqLock = IrqLock<CAN1_TX_IRQn>;
 using CanRx0IrqLock = IrqLock<CAN1_RX0_IRQn>;
 using CanRx1IrqLock = IrqLock<CAN1_RX1_IRQn>;
+using CanIrqLocks = IrqLockSet<CanTxIrqLock, CanRx0IrqLock, CanRx1IrqLock>;
 
 #endif // !defined(__arm__) || defined(HAL_CAN_MODULE_ENABLED)
 
@@ -59,6 +59,14 @@ public:
     ImageBufferError pop_image();
     ImageBufferError initialize_from_flash();
 
+    // ---------------------------------------------------------------------
+    // Read-only access by index, 0 = oldest, e.g. to serve a listing. The
+    // consumer stream above is left where it is; the payload CRC is not
+    // checked, as a peek may cover part of the payload only.
+    // ---------------------------------------------------------------------
+    ImageBufferError peek_image(size_t index, ImageMetadata &meta);
+    ImageBufferError peek_data(size_t index, size_t offset, uint8_t *data, size_t &size);
+
 protected:
     void test_set_tail(size_t t) { buffer_state_.tail_ = t; }
     ImageBufferError validate_entry(size_t offset,
@@ -211,6 +219,11 @@ ImageBufferError ring_io(EntryState &s,
         return ImageBufferError::NO_ERROR;
     }
 
+    // ---------------------------------------------------------------------
+    // Positions s at the payload of entry `index`, walking the headers from head_
+    // ---------------------------------------------------------------------
+    ImageBufferError seek_entry(size_t index, EntryState &s, ImageMetadata &meta);
+
     // ---------------------------------------------------------------------
     // Erase all erase-blocks touched by an entry
     // ---------------------------------------------------------------------
@@ -555,6 +568,77 @@ ImageBufferError ImageBuffer<A, C>::initialize_from_flash()
     return first_err;
 }
 
+// ==========================================================================
+// peek_image / peek_data
+// ==========================================================================
+template <typename A, typename C>
+ImageBufferError ImageBuffer<A, C>::peek_image(size_t index, ImageMetadata &meta)
+{
+    EntryState s{};
+    return seek_entry(index, s, meta);
+}
+
+template <typename A, typename C>
+ImageBufferError ImageBuffer<A, C>::peek_data(size_t index, size_t offset, uint8_t *data, size_t &size)
+{
+    EntryState s{};
+    ImageMetadata meta{};
+    auto err = seek_entry(index, s, meta);
+    if (err != ImageBufferError::NO_ERROR)
+    {
+        size = 0;
+        return err;
+    }
+
+    size = (offset < meta.payload_size) ? std::min(size, meta.payload_size - offset) : 0;
+    s.offset = (s.offset + offset) % buffer_state_.TOTAL_BUFFER_CAPACITY_;
+
+    return ring_io(s,
+                   data,
+                   size,
+                   false,
+                   false);
+}
+
+// ==========================================================================
+// seek_entry
+// ==========================================================================
+template <typename A, typename C>
+ImageBufferError ImageBuffer<A, C>::seek_entry(size_t index, EntryState &s, ImageMetadata &meta)
+{
+    if (index >= count())
+        return ImageBufferError::OUT_OF_BOUNDS;
+
+    const size_t cap = buffer_state_.TOTAL_BUFFER_CAPACITY_;
+    size_t offset = buffer_state_.head_;
+
+    for (size_t i = 0;; ++i)
+    {
+        s = { offset, 0, 0, 0 };
+        StorageHeader hdr{};
+        auto err = process_struct(s,
+                                  hdr,
+                                  offsetof(StorageHeader, header_crc),
+                                  false);
+        if (err != ImageBufferError::NO_ERROR ||
+            hdr.magic != STORAGE_MAGIC)
+            return ImageBufferError::CHECKSUM_ERROR;
+
+        if (i == index)
+        {
+            s.entry_size = header_size() + hdr.total_size;
+            err = process_struct(s,
+                                 meta,
+                                 METADATA_SIZE_WO_CRC,
+                                 false);
+            s.payload_size = meta.payload_size;
+            return err;
+        }
+
+        offset = align_up_wrapped((offset + header_size() + hdr.total_size) % cap);
+    }
+}
+
 // ==========================================================================
 // validate_entry
 // ==========================================================================
@@ -45,4 +45,18 @@ concept ImageBufferConcept =
     { b.pop_image() }            -> std::same_as<ImageBufferError>;
 };
 
+// A buffer whose entries can also be read in place by index, 0 = oldest, without consuming them
+template<typename BufferType>
+concept ImageBufferPeekConcept =
+    ImageBufferConcept<BufferType> &&
+    requires(BufferType b,
+             ImageMetadata meta,
+             uint8_t* data,
+             size_t index,
+             size_t size)
+{
+    { b.peek_image(index, meta) }             -> std::same_as<ImageBufferError>;
+    { b.peek_data(index, index, data, size) } -> std::same_as<ImageBufferError>;
+};
+
 #endif // IMAGE_BUFFER_CONCEPT_HPP
\ No newline at end of file
@@ -73,6 +73,11 @@ template <ImageBufferConcept ImageBufferT>
 class ImageInputStream
 {
 public:
+    // Hex dump buffers placed on the caller's stack by initialize() and getChunk()
+    static constexpr size_t INITIALIZE_HEX_BUFFER_SIZE = 2048;
+    static constexpr size_t CHUNK_HEX_BUFFER_SIZE = 1024;
+    static constexpr size_t STACK_BUFFER_BYTES = 2 * INITIALIZE_HEX_BUFFER_SIZE;
+
     ImageInputStream(ImageBufferT &buffer) : buffer_(buffer) {}
     ~ImageInputStream() = default;
 
@@ -91,12 +96,11 @@ public:
         std::memcpy(data, reinterpret_cast<uint8_t *>(&metadata), sizeof(ImageMetadata));
 
 
-    	constexpr size_t BUFFER_SIZE = 2048;
-    	char name_hex_string_buffer[BUFFER_SIZE];
-    	uchar_buffer_to_hex(reinterpret_cast<unsigned char*>(name_.data()), NAME_LENGTH, name_hex_string_buffer, BUFFER_SIZE);
+    	char name_hex_string_buffer[INITIALIZE_HEX_BUFFER_SIZE];
+    	uchar_buffer_to_hex(reinterpret_cast<unsigned char*>(name_.data()), NAME_LENGTH, name_hex_string_buffer, INITIALIZE_HEX_BUFFER_SIZE);
 
-    	char meta_hex_string_buffer[BUFFER_SIZE];
-    	uchar_buffer_to_hex(reinterpret_cast<unsigned char*>(&metadata), sizeof(metadata), meta_hex_string_buffer, BUFFER_SIZE);
+    	char meta_hex_string_buffer[INITIALIZE_HEX_BUFFER_SIZE];
+    	uchar_buffer_to_hex(reinterpret_cast<unsigned char*>(&metadata), sizeof(metadata), meta_hex_string_buffer, INITIALIZE_HEX_BUFFER_SIZE);
 
         log(LOG_LEVEL_DEBUG, "ImageInputStream::initialize %s with %s\r\n", name_hex_string_buffer, meta_hex_string_buffer);
         return true;
@@ -130,9 +134,8 @@ public:
             return false;
         }
 
-    	constexpr size_t BUFFER_SIZE = 1024;
-    	char data_hex_string_buffer[BUFFER_SIZE];
-    	uchar_buffer_to_hex(data, size, data_hex_string_buffer, BUFFER_SIZE);
+    	char data_hex_string_buffer[CHUNK_HEX_BUFFER_SIZE];
+    	uchar_buffer_to_hex(data, size, data_hex_string_buffer, CHUNK_HEX_BUFFER_SIZE);
     	log(LOG_LEVEL_DEBUG, "ImageInputStream::getChunk %s\r\n", data_hex_string_buffer);
 
     	return true;
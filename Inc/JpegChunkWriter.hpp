@@ -0,0 +1,267 @@
+#ifndef JPEG_CHUNK_WRITER_HPP
+#define JPEG_CHUNK_WRITER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ImageBufferConcept.hpp"
+
+// Strip consumer for the variable-length JPEG stream of a sensor in JPEG mode. The stream is
+// parsed on the fly:
+//
+//   - bytes before SOI are skipped, the frame ends at EOI and the DCMI padding after it is dropped
+//   - marker segments are skipped by their length, so table bytes are never taken for markers
+//   - in the entropy-coded data, FF 00 is stuffing and FF D0..D7 are restart markers
+//
+// The JPEG is stored as a series of ImageBuffer records of at most CHUNK_BYTES, each cut just
+// before a restart marker: the headers stay in part 0 and every later part starts with an RSTn.
+// A downlink that stops after any part still decodes, and a decoder can resynchronise at the
+// next part if one is lost. Without a restart marker in a full chunk the cut falls where the
+// chunk ends and the record is flagged METADATA_PART_UNALIGNED.
+template <ImageBufferConcept BufferT, size_t CHUNK_BYTES>
+class JpegChunkWriter
+{
+public:
+    static_assert(CHUNK_BYTES >= 64, "a chunk must hold the JPEG markers around a cut");
+
+    explicit JpegChunkWriter(BufferT &buffer) : buffer_(buffer) {}
+
+    // Starts a new frame; meta supplies the timestamp, position, dimensions and producer
+    void begin(const ImageMetadata &meta)
+    {
+        meta_ = meta;
+        meta_.format = METADATA_FORMAT::JPEG;
+        state_ = State::SeekSoi;
+        prevFF_ = false;
+        fill_ = 0;
+        restart_ = 0;
+        parts_ = 0;
+        bytes_ = 0;
+        error_ = ImageBufferError::NO_ERROR;
+    }
+
+    // StripConsumerConcept
+    bool operator()(const uint8_t *data, size_t size)
+    {
+        while (size > 0 && state_ != State::Done && error_ == ImageBufferError::NO_ERROR)
+        {
+            if (state_ == State::SeekSoi)
+            {
+                const uint8_t b = *data++;
+                --size;
+                if (prevFF_ && b == 0xD8)
+                {
+                    buf_[0] = 0xFF;
+                    buf_[1] = 0xD8;
+                    fill_ = 2;
+                    prevFF_ = false;
+                    state_ = State::Marker;
+                }
+                else
+                {
+                    prevFF_ = b == 0xFF;
+                }
+                continue;
+            }
+
+            if (fill_ == CHUNK_BYTES && !flush(false, 0))
+                return false;
+
+            const size_t n = size < CHUNK_BYTES - fill_ ? size : CHUNK_BYTES - fill_;
+            std::memcpy(&buf_[fill_], data, n);
+            fill_ = scan(fill_, fill_ + n);
+            data += n;
+            size -= n;
+
+            if (state_ == State::Done)
+                return flush(true, 0);
+        }
+        return error_ == ImageBufferError::NO_ERROR;
+    }
+
+    // Frame end (VSYNC). Stores what is left of a stream that never reached EOI as a truncated
+    // last part. Returns false if the frame held no JPEG or could not be stored.
+    bool finish()
+    {
+        if (error_ != ImageBufferError::NO_ERROR)
+            return false;
+        if (state_ == State::Done)
+            return true;
+        if (state_ == State::SeekSoi)
+            return false;
+        state_ = State::Done;
+        return flush(true, METADATA_PART_TRUNCATED);
+    }
+
+    // EOI seen: the capture can stop before VSYNC
+    bool done() const { return state_ == State::Done; }
+
+    uint16_t parts() const { return parts_; }
+    size_t bytes() const { return bytes_; }
+    ImageBufferError error() const { return error_; }
+
+private:
+    enum class State : uint8_t
+    {
+        SeekSoi,
+        Marker,     // between segments, expecting FF
+        MarkerCode,
+        LengthHi,
+        LengthLo,
+        Segment,    // skipping a segment's payload
+        Entropy,    // entropy-coded data after SOS
+        Done,
+    };
+
+    // Parses buf_[i, end) and returns the new fill level: end, or just past EOI
+    size_t scan(size_t i, size_t end)
+    {
+        while (i < end)
+        {
+            const uint8_t b = buf_[i];
+            switch (state_)
+            {
+            case State::Marker:
+                if (b == 0xFF)
+                    state_ = State::MarkerCode;
+                ++i;
+                break;
+
+            case State::MarkerCode:
+                ++i;
+                if (b == 0xD9)
+                {
+                    state_ = State::Done;
+                    return i;
+                }
+                if (b == 0xFF)
+                    break; // fill byte
+                if (b == 0xD8 || b == 0x01 || (b >= 0xD0 && b <= 0xD7))
+                {
+                    state_ = State::Marker; // no length
+                    break;
+                }
+                sos_ = b == 0xDA;
+                state_ = State::LengthHi;
+                break;
+
+            case State::LengthHi:
+                remaining_ = size_t(b) << 8;
+                state_ = State::LengthLo;
+                ++i;
+                break;
+
+            case State::LengthLo:
+                remaining_ |= b;
+                // The length counts its own two bytes
+                remaining_ = remaining_ > 2 ? remaining_ - 2 : 0;
+                state_ = remaining_ > 0 ? State::Segment : afterSegment();
+                ++i;
+                break;
+
+            case State::Segment:
+            {
+                const size_t skip = remaining_ < end - i ? remaining_ : end - i;
+                i += skip;
+                remaining_ -= skip;
+                if (remaining_ == 0)
+                    state_ = afterSegment();
+                break;
+            }
+
+            case State::Entropy:
+                if (prevFF_)
+                {
+                    prevFF_ = b == 0xFF;
+                    if (b >= 0xD0 && b <= 0xD7)
+                    {
+                        // Cut before the FF, never at the very start of the chunk
+                        if (i > 1)
+                            restart_ = i - 1;
+                    }
+                    else if (b == 0xD9)
+                    {
+                        state_ = State::Done;
+                        return i + 1;
+                    }
+                    else if (b != 0x00 && b != 0xFF)
+                    {
+                        // Another segment, e.g. DNL or the next scan
+                        sos_ = b == 0xDA;
+                        state_ = State::LengthHi;
+                    }
+                    ++i;
+                    break;
+                }
+                else
+                {
+                    const void *ff = std::memchr(&buf_[i], 0xFF, end - i);
+                    if (ff == nullptr)
+                        return end;
+                    i = size_t(static_cast<const uint8_t *>(ff) - buf_.data()) + 1;
+                    prevFF_ = true;
+                }
+                break;
+
+            case State::SeekSoi:
+            case State::Done:
+                return end;
+            }
+        }
+        return end;
+    }
+
+    State afterSegment() const { return sos_ ? State::Entropy : State::Marker; }
+
+    // Stores buf_ up to the last restart marker, or everything for the last part
+    bool flush(bool last, uint8_t flags)
+    {
+        size_t cut = fill_;
+        if (last)
+            flags |= METADATA_PART_LAST;
+        else if (restart_ > 0)
+            cut = restart_;
+        else
+            flags |= METADATA_PART_UNALIGNED;
+
+        ImageMetadata meta = meta_;
+        meta.payload_size = static_cast<uint32_t>(cut);
+        meta.part = parts_;
+        meta.part_flags = flags;
+
+        error_ = buffer_.add_image(meta);
+        if (error_ == ImageBufferError::NO_ERROR)
+        {
+            size_t size = cut;
+            error_ = buffer_.add_data_chunk(buf_.data(), size);
+        }
+        if (error_ == ImageBufferError::NO_ERROR)
+            error_ = buffer_.push_image();
+        if (error_ != ImageBufferError::NO_ERROR)
+            return false;
+
+        ++parts_;
+        bytes_ += cut;
+        std::memmove(buf_.data(), buf_.data() + cut, fill_ - cut);
+        fill_ -= cut;
+        restart_ = 0;
+        return true;
+    }
+
+    BufferT &buffer_;
+    ImageMetadata meta_{};
+    std::array<uint8_t, CHUNK_BYTES> buf_{};
+    size_t fill_ = 0;
+    size_t restart_ = 0;   // offset of the last restart marker in buf_, 0 = none
+    size_t remaining_ = 0; // segment bytes left to skip
+    size_t bytes_ = 0;
+    uint16_t parts_ = 0;
+    State state_ = State::SeekSoi;
+    bool prevFF_ = false;
+    bool sos_ = false;
+    ImageBufferError error_ = ImageBufferError::NO_ERROR;
+};
+
+#endif // JPEG_CHUNK_WRITER_HPP
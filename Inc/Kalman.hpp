@@ -3,6 +3,17 @@
 #include <cmath>
 #include <iostream>
 #include <array>
+#include <concepts>
+#include <type_traits>
+
+// A state transition applied in place, for models whose structure makes A x and
+// A P A^T cheaper to evaluate than two dense StateSize^3 products.
+template <typename Model, int StateSize>
+concept StateTransitionModel = requires(const Model &model,
+                                        Eigen::Matrix<float, StateSize, 1> &x,
+                                        Eigen::Matrix<float, StateSize, StateSize> &P) {
+    model.propagate(x, P); // x <- A x, P <- A P A^T
+};
 
 // Generic Kalman Filter (Template)
 template <int StateSize, int MeasurementSize>
@@ -15,6 +26,10 @@ public:
     Eigen::Matrix<float, StateSize, StateSize> stateCovarianceMatrix;
     Eigen::Matrix<float, StateSize, 1> stateVector;
 
+    // With a diagonal measurement noise matrix, process the measurement as MeasurementSize
+    // scalar updates: no factorisation, only scalar divisions.
+    bool sequentialWhenDiagonal = true;
+
     // Constructor for the KalmanFilter
     /**
      * @brief Constructor for the Kalman Filter.
@@ -62,6 +77,19 @@ public:
         stateVector = predictedStateVector;
     }
 
+    /**
+     * @brief Prediction step with a structured transition model instead of a dense matrix.
+     *
+     * @param model Applies x <- A x and P <- A P A^T in place; process noise is added here.
+     */
+    template <typename Model>
+        requires StateTransitionModel<Model, StateSize>
+    void predictWith(const Model &model)
+    {
+        model.propagate(stateVector, stateCovarianceMatrix);
+        stateCovarianceMatrix += processNoiseCovarianceMatrix;
+    }
+
     template <typename ControlMatrix, typename ControlVector>
     void predictWithControl(const Eigen::Matrix<float, StateSize, StateSize> &A,
                             const ControlMatrix &B,
@@ -80,88 +108,96 @@ public:
      * @param measurementMatrix The matrix to indicate which state variables are measured.
      * @param measurementVector The measurement of the current state.
      *
+     * @return false if the innovation covariance is not positive definite; the state is left untouched.
+     *
      * @note This method updates the internal state vector and state covariance matrix.
      */
-    void update(const Eigen::Matrix<float, MeasurementSize, StateSize> &measurementMatrix,
+    bool update(const Eigen::Matrix<float, MeasurementSize, StateSize> &measurementMatrix,
                 const Eigen::Matrix<float, MeasurementSize, 1> &measurementVector)
     {
-
-        // std::cout << "Kalman::update - Before Update" << std::endl;
-        // std::cout << "stateVector:\n"<< stateVector << std::endl;
-        // std::cout << "stateCovarianceMatrix:\n" << stateCovarianceMatrix << std::endl;
-        // std::cout << "measurementMatrix:\n" << measurementMatrix << std::endl;
-        // std::cout << "measurementVector:\n" << measurementVector << std::endl;
-
         // Compute the innovation, which is the difference between the measurement and the predicted state in measurement space
-        Eigen::Matrix<float, MeasurementSize, 1> innovation = measurementVector - (measurementMatrix * stateVector);
+        const Eigen::Matrix<float, MeasurementSize, 1> innovation = measurementVector - (measurementMatrix * stateVector);
 
-        // std::cout << "Kalman::update - After Innovation" << std::endl;
-        // std::cout << "innovation:\n" << innovation << std::endl;
+        if (useSequential(measurementNoiseCovarianceMatrix))
+            return correctSequential<MeasurementSize>(measurementMatrix, innovation, measurementNoiseCovarianceMatrix.diagonal());
 
-        // Calculate the covariance of the innovation
-        Eigen::Matrix<float, MeasurementSize, MeasurementSize> innovationCovariance = measurementMatrix * stateCovarianceMatrix * measurementMatrix.transpose() + measurementNoiseCovarianceMatrix;
+        // P H^T is shared by the innovation covariance, the gain and the covariance update
+        const Eigen::Matrix<float, StateSize, MeasurementSize> PHt = stateCovarianceMatrix * measurementMatrix.transpose();
+        const Eigen::Matrix<float, MeasurementSize, MeasurementSize> innovationCovariance = measurementMatrix * PHt + measurementNoiseCovarianceMatrix;
 
-        // std::cout << "Kalman::update - After Innovation Covariance" << std::endl;
-        // std::cout << "innovationCovariance:\n" << innovationCovariance << std::endl;
-
-        // Calculate the Kalman gain, which determines how much to correct the state based on the measurement
-        Eigen::Matrix<float, StateSize, MeasurementSize> kalmanGain = stateCovarianceMatrix * measurementMatrix.transpose() * innovationCovariance.inverse();
+        return correct<MeasurementSize>(PHt, innovationCovariance, measurementNoiseCovarianceMatrix, innovation,
+                                        [&measurementMatrix](const Eigen::Matrix<float, StateSize, StateSize> &M)
+                                            -> Eigen::Matrix<float, StateSize, MeasurementSize>
+                                        { return M * measurementMatrix.transpose(); });
+    }
 
-        // std::cout << "Kalman::update - After Kalman Gain" << std::endl;
-        // std::cout << "kalmanGain:\n" << kalmanGain << std::endl;
+    /**
+     * @brief Update for a selector measurement matrix H = [0 I 0], i.e. the measurement
+     * observes state elements Offset .. Offset + Size - 1 directly.
+     *
+     * Equivalent to update() with such an H but works on the P sub-blocks only:
+     * H x, P H^T and H P H^T become a segment, a column block and a diagonal block.
+     *
+     * @tparam Offset Index of the first measured state element.
+     * @tparam Size   Number of measured state elements, MeasurementSize by default.
+     */
+    template <int Offset, int Size = MeasurementSize>
+    bool updateSelected(const Eigen::Matrix<float, Size, 1> &measurementVector,
+                        const Eigen::Matrix<float, Size, Size> &measurementNoise)
+    {
+        static_assert(Offset >= 0 && Offset + Size <= StateSize, "Selected block must lie inside the state vector");
 
-        // Update the state estimate using the innovation and the Kalman gain
-        stateVector = stateVector + (kalmanGain * innovation);
+        const Eigen::Matrix<float, Size, 1> innovation = measurementVector - stateVector.template segment<Size>(Offset);
+        if (useSequential(measurementNoise))
+            return correctSelectedSequential<Offset, Size>(innovation, measurementNoise.diagonal());
 
-        // std::cout << "Kalman::update - After State Vector Update" << std::endl;
-        // std::cout << "stateVector:\n" << stateVector << std::endl;
+        const Eigen::Matrix<float, StateSize, Size> PHt = stateCovarianceMatrix.template middleCols<Size>(Offset);
+        const Eigen::Matrix<float, Size, Size> innovationCovariance =
+            stateCovarianceMatrix.template block<Size, Size>(Offset, Offset) + measurementNoise;
 
-        // Update the state covariance matrix using the Kalman gain
-        stateCovarianceMatrix = (Eigen::Matrix<float, StateSize, StateSize>::Identity() - kalmanGain * measurementMatrix) * stateCovarianceMatrix;
+        return correct<Size>(PHt, innovationCovariance, measurementNoise, innovation,
+                             [](const Eigen::Matrix<float, StateSize, StateSize> &M) -> Eigen::Matrix<float, StateSize, Size>
+                             { return M.template middleCols<Size>(Offset); });
+    }
 
-        // std::cout << "Kalman::update - After State Covariance Update" << std::endl;
-        // std::cout << "stateCovarianceMatrix:\n" << stateCovarianceMatrix << std::endl;
+    template <int Offset>
+    bool updateSelected(const Eigen::Matrix<float, MeasurementSize, 1> &measurementVector)
+    {
+        return updateSelected<Offset, MeasurementSize>(measurementVector, measurementNoiseCovarianceMatrix);
     }
 
     /**
      * @brief Extended Kalman Filter update for nonlinear measurement models.
      *
-     * @param h      Nonlinear measurement function: z = h(x)
+     * @param h      Nonlinear measurement function: z = h(x). Taken as a template parameter so
+     *               that lambdas are inlined rather than called through std::function.
      * @param H_jac  Measurement Jacobian: ∂h/∂x at current x
      * @param z      Actual measurement
+     *
+     * @return false if the innovation covariance is not positive definite; the state is left untouched.
      */
-    void updateEKF(
-        const std::function<Eigen::Matrix<float, MeasurementSize, 1>(const Eigen::Matrix<float, StateSize, 1> &)> &h,
+    template <typename MeasurementFunction>
+        requires std::convertible_to<std::invoke_result_t<const MeasurementFunction &, const Eigen::Matrix<float, StateSize, 1> &>,
+                                     Eigen::Matrix<float, MeasurementSize, 1>>
+    bool updateEKF(
+        const MeasurementFunction &h,
         const Eigen::Matrix<float, MeasurementSize, StateSize> &H_jac,
         const Eigen::Matrix<float, MeasurementSize, 1> &z)
     {
-        // std::cout << "Kalman::EKF update - Begin\n";
-        // std::cout << "stateVector:\n" << stateVector << std::endl;
-
         // Nonlinear measurement prediction
-        Eigen::Matrix<float, MeasurementSize, 1> z_pred = h(stateVector);
-
-        // Innovation
-        Eigen::Matrix<float, MeasurementSize, 1> innovation = z - z_pred;
-        // std::cout << "innovation:\n" << innovation << std::endl;
-
-        // Innovation covariance
-        Eigen::Matrix<float, MeasurementSize, MeasurementSize> S = H_jac * stateCovarianceMatrix * H_jac.transpose() + measurementNoiseCovarianceMatrix;
-        // std::cout << "innovationCovariance:\n" << S << std::endl;
-
-        // Kalman gain
-        Eigen::Matrix<float, StateSize, MeasurementSize> K = stateCovarianceMatrix * H_jac.transpose() * S.inverse();
-        // std::cout << "kalmanGain:\n" << K << std::endl;
+        const Eigen::Matrix<float, MeasurementSize, 1> innovation = z - h(stateVector);
 
-        // State update
-        stateVector = stateVector + K * innovation;
-        // std::cout << "updatedStateVector:\n" << stateVector << std::endl;
+        // Linearised about the prior, so the scalar updates reproduce the batch update
+        if (useSequential(measurementNoiseCovarianceMatrix))
+            return correctSequential<MeasurementSize>(H_jac, innovation, measurementNoiseCovarianceMatrix.diagonal());
 
-        // Covariance update
-        Eigen::Matrix<float, StateSize, StateSize> I = Eigen::Matrix<float, StateSize, StateSize>::Identity();
-        stateCovarianceMatrix = (I - K * H_jac) * stateCovarianceMatrix;
+        const Eigen::Matrix<float, StateSize, MeasurementSize> PHt = stateCovarianceMatrix * H_jac.transpose();
+        const Eigen::Matrix<float, MeasurementSize, MeasurementSize> S = H_jac * PHt + measurementNoiseCovarianceMatrix;
 
-        // std::cout << "updatedStateCovariance:\n" << stateCovarianceMatrix << std::endl;
+        return correct<MeasurementSize>(PHt, S, measurementNoiseCovarianceMatrix, innovation,
+                                        [&H_jac](const Eigen::Matrix<float, StateSize, StateSize> &M)
+                                            -> Eigen::Matrix<float, StateSize, MeasurementSize>
+                                        { return M * H_jac.transpose(); });
     }
 
     // Method to get the state estimate
@@ -184,4 +220,141 @@ public:
     {
         stateCovarianceMatrix = newCovariance;
     }
-};
\ No newline at end of file
+
+private:
+    template <int Size>
+    bool useSequential(const Eigen::Matrix<float, Size, Size> &measurementNoise) const
+    {
+        return Size > 1 && sequentialWhenDiagonal && measurementNoise.isDiagonal(0.f);
+    }
+
+    /**
+     * @brief Joseph form P <- (I - K H) P (I - K H)^T + K R K^T, evaluated as products.
+     *
+     * M = (I - K H) P = P - K (P H^T)^T, then P = M - (M H^T) K^T + K R K^T. M H^T is taken
+     * from M itself rather than expanded algebraically, so rounding in K cannot pull P below
+     * semi-definite as it can with P - K S K^T. applyHt(M) returns M H^T; O(n^2 m).
+     */
+    template <int Size, typename ApplyHt>
+    void josephUpdate(const Eigen::Matrix<float, StateSize, Size> &K,
+                      const Eigen::Matrix<float, StateSize, Size> &PHt,
+                      const Eigen::Matrix<float, Size, Size> &R,
+                      const ApplyHt &applyHt)
+    {
+        Eigen::Matrix<float, StateSize, StateSize> M = stateCovarianceMatrix;
+        M.noalias() -= K * PHt.transpose();
+        const Eigen::Matrix<float, StateSize, Size> MHt = applyHt(M);
+        const Eigen::Matrix<float, StateSize, Size> KR = K * R;
+
+        stateCovarianceMatrix = M;
+        stateCovarianceMatrix.noalias() -= MHt * K.transpose();
+        stateCovarianceMatrix.noalias() += KR * K.transpose();
+        stateCovarianceMatrix = 0.5f * (stateCovarianceMatrix + stateCovarianceMatrix.transpose()).eval();
+    }
+
+    // One scalar measurement with P h^T = PHt, variance s = h P h^T + r and residual;
+    // applyHt(M) returns M h^T.
+    template <typename ApplyHt>
+    void correctScalar(const Eigen::Matrix<float, StateSize, 1> &PHt, float s, float r, float residual,
+                       const ApplyHt &applyHt, Eigen::Matrix<float, StateSize, 1> &correction)
+    {
+        const Eigen::Matrix<float, StateSize, 1> k = PHt / s;
+        correction.noalias() += k * residual;
+        josephUpdate<1>(k, PHt, Eigen::Matrix<float, 1, 1>::Constant(r), applyHt);
+    }
+
+    /**
+     * @brief Processes a measurement with diagonal noise as Size scalar updates.
+     *
+     * Each row i sees the covariance left by rows 0..i-1, and its residual is corrected by
+     * the state change those rows produced, so the result equals the batch update. A row
+     * variance is only known once the rows before it are applied, so P is restored when one
+     * turns out negative: the update then returns false with the state untouched, as the
+     * batch update does.
+     */
+    template <int Size>
+    bool correctSequential(const Eigen::Matrix<float, Size, StateSize> &H,
+                           const Eigen::Matrix<float, Size, 1> &innovation,
+                           const Eigen::Matrix<float, Size, 1> &variances)
+    {
+        const Eigen::Matrix<float, StateSize, StateSize> prior = stateCovarianceMatrix;
+        Eigen::Matrix<float, StateSize, 1> correction = Eigen::Matrix<float, StateSize, 1>::Zero();
+        for (int i = 0; i < Size; ++i)
+        {
+            const Eigen::Matrix<float, StateSize, 1> PHt = stateCovarianceMatrix * H.row(i).transpose();
+            const float s = H.row(i).dot(PHt) + variances(i);
+            if (s == 0.f)
+                continue; // Nothing uncertain is observed by this row
+            if (!(s > 0.f))
+            {
+                stateCovarianceMatrix = prior;
+                return false;
+            }
+            const auto applyHt = [&H, i](const Eigen::Matrix<float, StateSize, StateSize> &M) -> Eigen::Matrix<float, StateSize, 1>
+            { return M * H.row(i).transpose(); };
+            correctScalar(PHt, s, variances(i), innovation(i) - H.row(i).dot(correction), applyHt, correction);
+        }
+        stateVector += correction;
+        return true;
+    }
+
+    // correctSequential() for H = [0 I 0]: P h^T is a column of P and h P h^T a diagonal entry
+    template <int Offset, int Size>
+    bool correctSelectedSequential(const Eigen::Matrix<float, Size, 1> &innovation,
+                                   const Eigen::Matrix<float, Size, 1> &variances)
+    {
+        const Eigen::Matrix<float, StateSize, StateSize> prior = stateCovarianceMatrix;
+        Eigen::Matrix<float, StateSize, 1> correction = Eigen::Matrix<float, StateSize, 1>::Zero();
+        for (int i = 0; i < Size; ++i)
+        {
+            const Eigen::Matrix<float, StateSize, 1> PHt = stateCovarianceMatrix.col(Offset + i);
+            const float s = PHt(Offset + i) + variances(i);
+            if (s == 0.f)
+                continue; // Nothing uncertain is observed by this row
+            if (!(s > 0.f))
+            {
+                stateCovarianceMatrix = prior;
+                return false;
+            }
+            const auto applyHt = [i](const Eigen::Matrix<float, StateSize, StateSize> &M) -> Eigen::Matrix<float, StateSize, 1>
+            { return M.col(Offset + i); };
+            correctScalar(PHt, s, variances(i), innovation(i) - correction(Offset + i), applyHt, correction);
+        }
+        stateVector += correction;
+        return true;
+    }
+
+    /**
+     * @brief Applies a measurement given P H^T, the innovation covariance S, the measurement
+     * noise R and the innovation; applyHt(M) returns M H^T.
+     *
+     * S is factorised as L L^T and never inverted: K = P H^T S^-1 comes from two triangular
+     * solves. A semi-definite S (e.g. R = 0) falls back to LDLT. Both paths update P in the
+     * Joseph form, see josephUpdate().
+     */
+    template <int Size, typename ApplyHt>
+    bool correct(const Eigen::Matrix<float, StateSize, Size> &PHt,
+                 const Eigen::Matrix<float, Size, Size> &S,
+                 const Eigen::Matrix<float, Size, Size> &R,
+                 const Eigen::Matrix<float, Size, 1> &innovation,
+                 const ApplyHt &applyHt)
+    {
+        Eigen::Matrix<float, StateSize, Size> K;
+        const Eigen::LLT<Eigen::Matrix<float, Size, Size>> llt(S);
+        if (llt.info() == Eigen::Success)
+        {
+            K = llt.solve(PHt.transpose()).transpose();
+        }
+        else
+        {
+            const Eigen::LDLT<Eigen::Matrix<float, Size, Size>> ldlt(S);
+            if (ldlt.info() != Eigen::Success || !ldlt.isPositive())
+                return false;
+            K = ldlt.solve(PHt.transpose()).transpose();
+        }
+
+        stateVector.noalias() += K * innovation;
+        josephUpdate<Size>(K, PHt, R, applyHt);
+        return true;
+    }
+};
@@ -228,24 +228,34 @@ public:
         subpage = static_cast<int>(status & 0x0001u); // bit 0 = subpage ID
         log(LOG_LEVEL_DEBUG, "MLX90640::readSubpage: STATUS=0x%04X, subpage=%d\r\n", status, subpage);
 
-        // 2. Read RAM snapshot
-        if (!readBlock(
-                static_cast<uint16_t>(MLX90640_REGISTERS::RAM_START),
-                reinterpret_cast<uint8_t *>(buf),
-                MLX90640_SUBPAGE_SIZE))
-        {
-            log(LOG_LEVEL_ERROR, "MLX90640::readSubpage: read RAM failed\r\n");
+        return readRamAndClear(buf);
+    }
+
+    // ─────────────────────────────────────────────
+    // Read the current subpage straight into its slot of a full frame
+    // ─────────────────────────────────────────────
+    //
+    // Same sequence as readSubpage, but the RAM snapshot lands at
+    // frame + subpage * MLX90640_SUBPAGE_WORDS. A frame is assembled by two
+    // calls with no intermediate subpage buffers and no createFrame copy;
+    // a repeated subpage overwrites its own slot with the newer data.
+    //
+    bool readSubpageIntoFrame(uint16_t *frame, int &subpage)
+    {
+        if (!frame)
             return false;
-        }
 
-        // 3. Clear NEW_DATA (write‑1‑to‑clear)
-        if (!clearStatus())
+        uint16_t status = 0;
+        if (!readStatus(status))
         {
-            log(LOG_LEVEL_ERROR, "MLX90640::readSubpage: clearStatus failed\r\n");
+            log(LOG_LEVEL_ERROR, "MLX90640::readSubpageIntoFrame: read STATUS failed\r\n");
             return false;
         }
 
-        return true;
+        subpage = static_cast<int>(status & 0x0001u);
+        log(LOG_LEVEL_DEBUG, "MLX90640::readSubpageIntoFrame: STATUS=0x%04X, subpage=%d\r\n", status, subpage);
+
+        return readRamAndClear(frame + static_cast<std::size_t>(subpage) * MLX90640_SUBPAGE_WORDS);
     }
 
     // ─────────────────────────────────────────────
@@ -270,8 +280,6 @@ public:
         if (!frame)
             return false;
 
-        uint16_t sub0[MLX90640_SUBPAGE_WORDS];
-        uint16_t sub1[MLX90640_SUBPAGE_WORDS];
         int spA = -1;
         int spB = -1;
 
@@ -281,7 +289,7 @@ public:
             log(LOG_LEVEL_ERROR, "MLX90640::readFrame: waitUntilReady A failed\r\n");
             return false;
         }
-        if (!readSubpage(sub0, spA))
+        if (!readSubpageIntoFrame(frame, spA))
         {
             log(LOG_LEVEL_ERROR, "MLX90640::readFrame: readSubpage A failed\r\n");
             return false;
@@ -293,7 +301,7 @@ public:
             log(LOG_LEVEL_ERROR, "MLX90640::readFrame: waitUntilReady B failed\r\n");
             return false;
         }
-        if (!readSubpage(sub1, spB))
+        if (!readSubpageIntoFrame(frame, spB))
         {
             log(LOG_LEVEL_ERROR, "MLX90640::readFrame: readSubpage B failed\r\n");
             return false;
@@ -307,11 +315,6 @@ public:
             return false;
         }
 
-        if (spA == 0)
-            createFrame(sub0, sub1, frame);
-        else
-            createFrame(sub1, sub0, frame);
-
         return true;
     }
 
@@ -382,6 +385,27 @@ private:
         return transport.write_reg(reg, buf, sizeof(buf));
     }
 
+    // RAM snapshot of one subpage, then NEW_DATA cleared (write‑1‑to‑clear)
+    bool readRamAndClear(uint16_t *dest)
+    {
+        if (!readBlock(
+                static_cast<uint16_t>(MLX90640_REGISTERS::RAM_START),
+                reinterpret_cast<uint8_t *>(dest),
+                MLX90640_SUBPAGE_SIZE))
+        {
+            log(LOG_LEVEL_ERROR, "MLX90640::readSubpage: read RAM failed\r\n");
+            return false;
+        }
+
+        if (!clearStatus())
+        {
+            log(LOG_LEVEL_ERROR, "MLX90640::readSubpage: clearStatus failed\r\n");
+            return false;
+        }
+
+        return true;
+    }
+
     bool readBlock(uint16_t startReg, uint8_t *dest, std::size_t bytes)
     {
         if (!dest || bytes == 0)
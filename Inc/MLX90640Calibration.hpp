@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <array>
+#include <limits>
 #include "MLX90640EEPROM.h"
 
 struct MLX90640_Calibration
@@ -730,3 +731,57 @@ constexpr MLX90640_Calibration parse_eeprom()
 }
 
 constexpr MLX90640_Calibration MLX90640_CAL = parse_eeprom<MLX90640_EEPROM>();
+
+// ------------------------------------------------------------
+// Per-pixel constants of MLX90640_CalculateTo, folded from the calibration at compile time
+// ------------------------------------------------------------
+struct MLX90640_PixelConstants
+{
+    float offset[768];
+    float kta[768];              // kta / 2^ktaScale
+    float kv[768];               // kv / 2^kvScale
+    float alpha[768];            // SCALEALPHA 2^alphaScale / alpha
+    float ilChessCorrection[768]; // added when the measurement mode differs from calibration
+
+    float alphaCorrR[4];         // sensitivity correction per ksTo range
+
+    // Pixels measured in each subpage: [chess mode][subpage][n]
+    uint16_t subpagePixels[2][2][384];
+};
+
+constexpr MLX90640_PixelConstants fold_pixel_constants(const MLX90640_Calibration& c)
+{
+    MLX90640_PixelConstants k{};
+
+    const float ktaScale = pow2f(c.ktaScale);
+    const float kvScale = pow2f(c.kvScale);
+    const double alphaScale = double(pow2f(c.alphaScale));
+
+    uint16_t counts[2][2] = {};
+    for (int pix = 0; pix < 768; ++pix)
+    {
+        const int ilPattern = pix / 32 - (pix / 64) * 2;
+        const int chessPattern = ilPattern ^ (pix - (pix / 2) * 2);
+        const int conversionPattern = ((pix + 2) / 4 - (pix + 3) / 4 + (pix + 1) / 4 - pix / 4) * (1 - 2 * ilPattern);
+
+        k.offset[pix] = float(c.offset[pix]);
+        k.kta[pix] = float(c.kta[pix]) / ktaScale;
+        k.kv[pix] = float(c.kv[pix]) / kvScale;
+        // Broken pixels have no alpha; Melexis divides by zero and reports NaN for them
+        k.alpha[pix] = c.alpha[pix] == 0 ? std::numeric_limits<float>::infinity()
+                                         : float(0.000001 * alphaScale / double(c.alpha[pix]));
+        k.ilChessCorrection[pix] = c.ilChessC[2] * float(2 * ilPattern - 1) - c.ilChessC[1] * float(conversionPattern);
+
+        k.subpagePixels[0][ilPattern][counts[0][ilPattern]++] = uint16_t(pix);
+        k.subpagePixels[1][chessPattern][counts[1][chessPattern]++] = uint16_t(pix);
+    }
+
+    k.alphaCorrR[0] = 1.0f / (1.0f + c.ksTo[0] * 40.0f);
+    k.alphaCorrR[1] = 1.0f;
+    k.alphaCorrR[2] = 1.0f + c.ksTo[1] * float(c.ct[2]);
+    k.alphaCorrR[3] = k.alphaCorrR[2] * (1.0f + c.ksTo[2] * float(c.ct[3] - c.ct[2]));
+
+    return k;
+}
+
+constexpr MLX90640_PixelConstants MLX90640_PIXEL_CONSTANTS = fold_pixel_constants(MLX90640_CAL);
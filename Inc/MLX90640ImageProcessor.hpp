@@ -14,6 +14,19 @@ public:
     using RawImage  = std::array<int16_t, PIXELS>;
     using TempImage = std::array<float,   PIXELS>;
 
+    // Width of the Ta bucket the cached coefficients are evaluated for, centred on multiples of it
+    static constexpr float TA_BUCKET = 0.1f;
+
+    // Per-pixel factors of computeTemperatures that depend only on the EEPROM calibration
+    // and on Ta / Vdd, stored as separate arrays so the pixel loop runs on whole vectors
+    struct PixelCoefficients
+    {
+        alignas(16) std::array<float, PIXELS> offset;    // offset[i]
+        alignas(16) std::array<float, PIXELS> scale;     // 1 / (gainEE (1 + kta dTa) (1 + kv dVdd))
+        alignas(16) std::array<float, PIXELS> alphaTgc;  // alphaComp (1 - tgc)
+        alignas(16) std::array<float, PIXELS> sxFactor;  // ksTo[1] alphaComp^(1/4)
+    };
+
     MLX90640ImageProcessor() = default;
 
     bool demultiplexFrame(const uint16_t* frame, RawImage& outRaw) const;
@@ -21,4 +34,33 @@ public:
     bool computeTemperatures(const RawImage& raw,
                              TempImage& outTemps,
                              float Ta = 25.0f) const;
+
+    // Same model as computeTemperatures with the per-pixel factors taken from the cache,
+    // leaving one division and two polynomial fourth roots per pixel
+    bool computeTemperaturesFast(const RawImage& raw,
+                                 TempImage& outTemps,
+                                 float Ta = 25.0f);
+
+    // Full Melexis compensation (MLX90640_CalculateTo) of one 834-word subpage: pixel words,
+    // auxiliary words, control register and subpage number. Ta and Vdd come from the PTAT and
+    // Vdd words; CP/TGC, IL-chess, multi-range ksTo, emissivity and the reflected temperature
+    // tr (degC) are applied. Only the pixels measured in that subpage are written, in degC.
+    bool computeObjectTemperatures(const uint16_t* subpage,
+                                   TempImage& outTemps,
+                                   float emissivity,
+                                   float tr) const;
+
+    static float supplyVoltage(const uint16_t* subpage);
+    static float ambientTemperature(const uint16_t* subpage);
+
+    // Coefficients for the bucket containing Ta, rebuilt only when the bucket changes
+    const PixelCoefficients& coefficients(float Ta);
+
+    uint32_t coefficientUpdates() const { return coefficientUpdates_; }
+
+private:
+    PixelCoefficients coefficients_{};
+    int32_t bucket_ = 0;
+    bool coefficientsValid_ = false;
+    uint32_t coefficientUpdates_ = 0;
 };
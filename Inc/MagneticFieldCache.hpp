@@ -0,0 +1,323 @@
+#ifndef MAGNETIC_FIELD_CACHE_HPP
+#define MAGNETIC_FIELD_CACHE_HPP
+
+#include "magnetic_model.hpp"
+#include "sgp4_tle.hpp"
+#include "au.hpp"
+#include <Eigen/Core>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+
+// Precomputed reference field for consumers that evaluate the model at a high rate
+// (detumbling, attitude control). Values are north/east/down in nT like magnetic_model.
+
+namespace magnetic_model
+{
+    using FieldNED = Eigen::Vector3f;
+
+    // Geocentric position as used by calculateMagneticField
+    struct GeocentricPosition
+    {
+        float latitude_deg;
+        float longitude_deg;
+        float radius_m;
+    };
+
+    // Latitudes closer to the poles than this are clamped; the east component divides by cos(latitude)
+    constexpr float MAX_CACHE_LATITUDE_DEG = 89.9f;
+
+    template <size_t NMAX>
+    FieldNED calculateFieldNED(const GeocentricPosition &position, int year, const std::array<GaussCoefficient, (NMAX + 1) * (NMAX + 2) / 2 - 1> &coefficients)
+    {
+        const float latitude_deg = std::clamp(position.latitude_deg, -MAX_CACHE_LATITUDE_DEG, MAX_CACHE_LATITUDE_DEG);
+        const MagneticField field = calculateMagneticField<NMAX>(latitude_deg, position.longitude_deg, position.radius_m, year, coefficients);
+        return FieldNED(field.X, field.Y, field.Z);
+    }
+
+    // Field on a regular latitude/longitude/radius grid with trilinear interpolation.
+    // Nodes are stored scaled by (r / R_EARTH)^3 so the dominant dipole falloff is removed
+    // before interpolating along the radius. Lookups outside the radius range, or while the
+    // grid misses its error bound, fall back to the full model.
+    template <size_t NMAX, size_t LAT_NODES, size_t LON_NODES, size_t RADIUS_NODES>
+    class MagneticFieldGrid
+    {
+    public:
+        static_assert(LAT_NODES >= 2 && LON_NODES >= 2 && RADIUS_NODES >= 2, "grid needs at least two nodes per axis");
+
+        using Coefficients = std::array<GaussCoefficient, (NMAX + 1) * (NMAX + 2) / 2 - 1>;
+
+        struct Config
+        {
+            float min_radius_m;
+            float max_radius_m;
+            int year;
+            float max_error_nT; // largest component error accepted at the cell centres
+        };
+
+        MagneticFieldGrid(const Config &config, const Coefficients &coefficients) : config_(config), coefficients_(coefficients) {}
+
+        // Evaluates the model at every node, then checks the interpolation at the cell centres
+        void build()
+        {
+            for (size_t k = 0; k < RADIUS_NODES; ++k)
+            {
+                for (size_t i = 0; i < LAT_NODES; ++i)
+                {
+                    for (size_t j = 0; j < LON_NODES; ++j)
+                    {
+                        const GeocentricPosition position{latitudeAt(static_cast<float>(i)), longitudeAt(static_cast<float>(j)), radiusAt(static_cast<float>(k))};
+                        nodes_[index(i, j, k)] = calculateFieldNED<NMAX>(position, config_.year, coefficients_) * dipoleScale(position.radius_m);
+                    }
+                }
+            }
+            built_ = true;
+            max_error_nT_ = validate();
+        }
+
+        // Largest component difference to calculateMagneticField at the cell centres, where
+        // trilinear interpolation is furthest from the nodes
+        float validate() const
+        {
+            float max_error = 0.0f;
+            for (size_t k = 0; k + 1 < RADIUS_NODES; ++k)
+            {
+                for (size_t i = 0; i + 1 < LAT_NODES; ++i)
+                {
+                    for (size_t j = 0; j < LON_NODES; ++j)
+                    {
+                        const GeocentricPosition position{latitudeAt(static_cast<float>(i) + 0.5f), longitudeAt(static_cast<float>(j) + 0.5f), radiusAt(static_cast<float>(k) + 0.5f)};
+                        const FieldNED error = interpolate(position) - calculateFieldNED<NMAX>(position, config_.year, coefficients_);
+                        max_error = std::max(max_error, error.cwiseAbs().maxCoeff());
+                    }
+                }
+            }
+            return max_error;
+        }
+
+        bool withinBound() const
+        {
+            return built_ && max_error_nT_ <= config_.max_error_nT;
+        }
+
+        float maxError() const
+        {
+            return max_error_nT_;
+        }
+
+        FieldNED field(const GeocentricPosition &position) const
+        {
+            if (!withinBound() || position.radius_m < config_.min_radius_m || position.radius_m > config_.max_radius_m)
+            {
+                return calculateFieldNED<NMAX>(position, config_.year, coefficients_);
+            }
+            return interpolate(position);
+        }
+
+    private:
+        static constexpr float LAT_STEP_DEG = 180.0f / static_cast<float>(LAT_NODES - 1);
+        static constexpr float LON_STEP_DEG = 360.0f / static_cast<float>(LON_NODES);
+
+        static size_t index(size_t i, size_t j, size_t k)
+        {
+            return (k * LAT_NODES + i) * LON_NODES + j;
+        }
+
+        static float dipoleScale(float radius_m)
+        {
+            const float ratio = radius_m / R_EARTH;
+            return ratio * ratio * ratio;
+        }
+
+        float latitudeAt(float i) const { return -90.0f + i * LAT_STEP_DEG; }
+        float longitudeAt(float j) const { return -180.0f + j * LON_STEP_DEG; }
+        float radiusAt(float k) const
+        {
+            return config_.min_radius_m + k * (config_.max_radius_m - config_.min_radius_m) / static_cast<float>(RADIUS_NODES - 1);
+        }
+
+        // Splits a continuous grid coordinate into a cell index and the fraction within it
+        static size_t cell(float coordinate, size_t cells, float &fraction)
+        {
+            coordinate = std::clamp(coordinate, 0.0f, static_cast<float>(cells));
+            const size_t i = std::min(static_cast<size_t>(coordinate), cells - 1);
+            fraction = coordinate - static_cast<float>(i);
+            return i;
+        }
+
+        FieldNED interpolate(const GeocentricPosition &position) const
+        {
+            float lon = std::fmod(position.longitude_deg + 180.0f, 360.0f);
+            if (lon < 0.0f)
+                lon += 360.0f;
+
+            float u, v, w;
+            const size_t i = cell((position.latitude_deg + 90.0f) / LAT_STEP_DEG, LAT_NODES - 1, u);
+            const size_t j = cell(lon / LON_STEP_DEG, LON_NODES, v);
+            const size_t k = cell((position.radius_m - config_.min_radius_m) / (config_.max_radius_m - config_.min_radius_m) * static_cast<float>(RADIUS_NODES - 1), RADIUS_NODES - 1, w);
+            const size_t j1 = (j + 1) % LON_NODES; // longitude wraps around
+
+            auto layer = [&](size_t kk)
+            {
+                const FieldNED south = nodes_[index(i, j, kk)] * (1.0f - v) + nodes_[index(i, j1, kk)] * v;
+                const FieldNED north = nodes_[index(i + 1, j, kk)] * (1.0f - v) + nodes_[index(i + 1, j1, kk)] * v;
+                return FieldNED(south * (1.0f - u) + north * u);
+            };
+
+            const FieldNED scaled = layer(k) * (1.0f - w) + layer(k + 1) * w;
+            return scaled / dipoleScale(position.radius_m);
+        }
+
+        Config config_;
+        const Coefficients &coefficients_;
+        std::array<FieldNED, LAT_NODES * LON_NODES * RADIUS_NODES> nodes_{};
+        float max_error_nT_ = 0.0f;
+        bool built_ = false;
+    };
+
+    // Field sampled along a predicted ground track (typically the next orbit from SGP4) and
+    // interpolated in time with cubic Hermite splines whose tangents are central differences of
+    // the samples. The track is resampled lazily when the element set changes or a lookup
+    // leaves the sampled window.
+    //
+    // Track is a callable bool(au::QuantityU64<au::Milli<au::Seconds>>, GeocentricPosition &).
+    template <size_t NMAX, size_t SAMPLES>
+    class MagneticFieldTrackCache
+    {
+    public:
+        static_assert(SAMPLES >= 4, "Hermite interpolation needs at least four samples");
+
+        using Coefficients = std::array<GaussCoefficient, (NMAX + 1) * (NMAX + 2) / 2 - 1>;
+        using Timestamp = au::QuantityU64<au::Milli<au::Seconds>>;
+
+        struct Config
+        {
+            uint32_t step_ms;   // spacing of the track samples
+            int year;
+            float max_error_nT; // largest component error accepted at the sample midpoints
+        };
+
+        MagneticFieldTrackCache(const Config &config, const Coefficients &coefficients) : config_(config), coefficients_(coefficients) {}
+
+        // Resamples the track starting at start, regardless of the current window
+        template <typename Track>
+        bool refresh(const SGP4TwoLineElement &tle, Timestamp start, Track &&track)
+        {
+            valid_ = false;
+            tle_ = tle;
+            start_ms_ = start.in(au::milli(au::seconds));
+            for (size_t i = 0; i < SAMPLES; ++i)
+            {
+                GeocentricPosition position;
+                if (!track(timestampAt(static_cast<float>(i)), position))
+                    return false;
+                samples_[i] = calculateFieldNED<NMAX>(position, config_.year, coefficients_);
+            }
+            ++refreshes_;
+
+            max_error_nT_ = 0.0f;
+            for (size_t i = 0; i + 1 < SAMPLES; ++i)
+            {
+                GeocentricPosition position;
+                if (!track(timestampAt(static_cast<float>(i) + 0.5f), position))
+                    return false;
+                const FieldNED error = interpolate(i, 0.5f) - calculateFieldNED<NMAX>(position, config_.year, coefficients_);
+                max_error_nT_ = std::max(max_error_nT_, error.cwiseAbs().maxCoeff());
+            }
+            valid_ = true;
+            return true;
+        }
+
+        // Field at timestamp; resamples first if the TLE differs from the cached one or the
+        // timestamp is outside the window. Falls back to the full model at track(timestamp)
+        // while the samples miss the error bound.
+        template <typename Track>
+        std::optional<FieldNED> field(const SGP4TwoLineElement &tle, Timestamp timestamp, Track &&track)
+        {
+            const uint64_t t_ms = timestamp.in(au::milli(au::seconds));
+            if (!valid_ || !sameElementSet(tle, tle_) || t_ms < start_ms_ || t_ms >= endMs())
+            {
+                if (!refresh(tle, timestamp, track))
+                    return std::nullopt;
+            }
+
+            if (!withinBound())
+            {
+                GeocentricPosition position;
+                if (!track(timestamp, position))
+                    return std::nullopt;
+                return calculateFieldNED<NMAX>(position, config_.year, coefficients_);
+            }
+
+            const float s = static_cast<float>(t_ms - start_ms_) / static_cast<float>(config_.step_ms);
+            const size_t i = std::min(static_cast<size_t>(s), SAMPLES - 2);
+            return interpolate(i, s - static_cast<float>(i));
+        }
+
+        bool withinBound() const
+        {
+            return valid_ && max_error_nT_ <= config_.max_error_nT;
+        }
+
+        float maxError() const
+        {
+            return max_error_nT_;
+        }
+
+        uint32_t refreshCount() const
+        {
+            return refreshes_;
+        }
+
+        static bool sameElementSet(const SGP4TwoLineElement &a, const SGP4TwoLineElement &b)
+        {
+            return a.satelliteNumber == b.satelliteNumber && a.elementNumber == b.elementNumber &&
+                   a.epochYear == b.epochYear && a.epochDay == b.epochDay;
+        }
+
+    private:
+        Timestamp timestampAt(float sample) const
+        {
+            return au::make_quantity<au::Milli<au::Seconds>>(start_ms_ + static_cast<uint64_t>(sample * static_cast<float>(config_.step_ms)));
+        }
+
+        uint64_t endMs() const
+        {
+            return start_ms_ + static_cast<uint64_t>(config_.step_ms) * (SAMPLES - 1);
+        }
+
+        FieldNED tangent(size_t i) const
+        {
+            if (i == 0)
+                return samples_[1] - samples_[0];
+            if (i == SAMPLES - 1)
+                return samples_[SAMPLES - 1] - samples_[SAMPLES - 2];
+            return 0.5f * (samples_[i + 1] - samples_[i - 1]);
+        }
+
+        FieldNED interpolate(size_t i, float u) const
+        {
+            const float u2 = u * u;
+            const float u3 = u2 * u;
+            const float h00 = 2.0f * u3 - 3.0f * u2 + 1.0f;
+            const float h10 = u3 - 2.0f * u2 + u;
+            const float h01 = -2.0f * u3 + 3.0f * u2;
+            const float h11 = u3 - u2;
+            return h00 * samples_[i] + h10 * tangent(i) + h01 * samples_[i + 1] + h11 * tangent(i + 1);
+        }
+
+        Config config_;
+        const Coefficients &coefficients_;
+        std::array<FieldNED, SAMPLES> samples_{};
+        SGP4TwoLineElement tle_{};
+        uint64_t start_ms_ = 0;
+        float max_error_nT_ = 0.0f;
+        uint32_t refreshes_ = 0;
+        bool valid_ = false;
+    };
+
+} // namespace magnetic_model
+
+#endif // MAGNETIC_FIELD_CACHE_HPP
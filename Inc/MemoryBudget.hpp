@@ -0,0 +1,135 @@
+#ifndef INC_MEMORYBUDGET_HPP_
+#define INC_MEMORYBUDGET_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Logger.hpp"
+
+// Compile-time registry of the statically configured memory of a node.
+//
+// A node composition lists every buffer, task and adapter it instantiates:
+//
+//   constexpr auto node_budget = makeMemoryBudget(96 * 1024,
+//       MEMORY_BUDGET_STATIC(CyphalBuffer64),
+//       MEMORY_BUDGET_STATIC(CircularBuffer<SerialFrame, 8>),
+//       MEMORY_BUDGET_STATIC_N(2, TaskBlinkLED),
+//       MEMORY_BUDGET_STACK("ImageInputStream::initialize", ImageInputStream<Buffer>::STACK_BUFFER_BYTES));
+//   STATIC_ASSERT_MEMORY_BUDGET(node_budget);
+//
+// The static_assert fails to compile with the used and available byte counts in
+// the diagnostic, and report() logs the breakdown at start-up.
+
+enum class MemoryRegion : uint8_t
+{
+	STATIC = 0, // .bss/.data: globals, task objects, buffers
+	STACK = 1   // Largest stack frame contributed by a call path
+};
+
+struct MemoryBudgetEntry
+{
+	const char *name;
+	size_t size;
+	size_t count;
+	MemoryRegion region;
+
+	constexpr size_t bytes() const { return size * count; }
+};
+
+template <size_t N>
+class MemoryBudget
+{
+public:
+	constexpr MemoryBudget(size_t budget, const std::array<MemoryBudgetEntry, N> &entries)
+		: budget_(budget), entries_(entries) {}
+
+	constexpr size_t budget() const { return budget_; }
+	constexpr const std::array<MemoryBudgetEntry, N> &entries() const { return entries_; }
+
+	constexpr size_t total(MemoryRegion region) const
+	{
+		size_t sum = 0;
+		for (const MemoryBudgetEntry &entry : entries_)
+			if (entry.region == region)
+				sum += entry.bytes();
+		return sum;
+	}
+
+	constexpr size_t total() const
+	{
+		return total(MemoryRegion::STATIC) + total(MemoryRegion::STACK);
+	}
+
+	constexpr bool fits() const { return total() <= budget_; }
+
+	constexpr size_t headroom() const { return fits() ? budget_ - total() : 0; }
+
+	constexpr const MemoryBudgetEntry &largest() const
+	{
+		static_assert(N > 0, "MemoryBudget::largest, empty budget");
+		size_t index = 0;
+		for (size_t i = 1; i < N; ++i)
+			if (entries_[i].bytes() > entries_[index].bytes())
+				index = i;
+		return entries_[index];
+	}
+
+	void report(uint8_t level = LOG_LEVEL_INFO) const
+	{
+		for (const MemoryBudgetEntry &entry : entries_)
+		{
+			log(level, "memory %s %s: %u x %u = %u bytes\r\n",
+				entry.region == MemoryRegion::STATIC ? "static" : "stack ",
+				entry.name,
+				static_cast<unsigned>(entry.size),
+				static_cast<unsigned>(entry.count),
+				static_cast<unsigned>(entry.bytes()));
+		}
+		log(level, "memory total: static %u + stack %u = %u of %u bytes (%s)\r\n",
+			static_cast<unsigned>(total(MemoryRegion::STATIC)),
+			static_cast<unsigned>(total(MemoryRegion::STACK)),
+			static_cast<unsigned>(total()),
+			static_cast<unsigned>(budget_),
+			fits() ? "ok" : "OVER BUDGET");
+	}
+
+private:
+	size_t budget_;
+	std::array<MemoryBudgetEntry, N> entries_;
+};
+
+template <typename... Entries>
+constexpr MemoryBudget<sizeof...(Entries)> makeMemoryBudget(size_t budget, Entries... entries)
+{
+	return MemoryBudget<sizeof...(Entries)>(budget, std::array<MemoryBudgetEntry, sizeof...(Entries)>{entries...});
+}
+
+template <typename T>
+constexpr MemoryBudgetEntry memoryBudgetEntry(const char *name, size_t count = 1)
+{
+	return MemoryBudgetEntry{name, sizeof(T), count, MemoryRegion::STATIC};
+}
+
+constexpr MemoryBudgetEntry memoryBudgetStack(const char *name, size_t bytes)
+{
+	return MemoryBudgetEntry{name, bytes, 1, MemoryRegion::STACK};
+}
+
+// Instantiated only to carry the numbers into the compiler diagnostic,
+// e.g. "MemoryBudgetCheck<101376, 98304>" when the node is 3 KiB over.
+template <size_t Used, size_t Available>
+struct MemoryBudgetCheck
+{
+	static_assert(Used <= Available, "static memory budget exceeded: MemoryBudgetCheck<used, available>");
+	static constexpr bool value = Used <= Available;
+};
+
+// Variadic so that template arguments containing commas need no extra parentheses
+#define MEMORY_BUDGET_STATIC(...) memoryBudgetEntry<__VA_ARGS__>(#__VA_ARGS__)
+#define MEMORY_BUDGET_STATIC_N(COUNT, ...) memoryBudgetEntry<__VA_ARGS__>(#__VA_ARGS__, COUNT)
+#define MEMORY_BUDGET_STACK(NAME, BYTES) memoryBudgetStack(NAME, BYTES)
+#define STATIC_ASSERT_MEMORY_BUDGET(BUDGET) \
+	static_assert(MemoryBudgetCheck<(BUDGET).total(), (BUDGET).budget()>::value, "static memory budget exceeded")
+
+#endif // INC_MEMORYBUDGET_HPP_
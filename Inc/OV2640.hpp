@@ -25,6 +25,8 @@ public:
     // ────────────────────────────────────────────────────────────────
     //
 
+// One write per entry: the OV2640 does not auto-increment the register address, so the
+// sequential writes of OV5640::writeTable() do not apply
 void apply_table(const Word_Byte_t *tbl, size_t n)
 {
     for (size_t i = 0; i < n; ++i) {
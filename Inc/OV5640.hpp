@@ -27,12 +27,7 @@ public:
 
     bool init()
     {
-    	static constexpr auto& Initialization = cfg_init_;
-    	for (auto& w : Initialization) {
-    	    if (!writeRegister(w.addr, w.data)) return false;
-    	}
-
-        return true;
+        return writeTable<cfg_init_>();
     }
 
     bool setResolution(uint16_t width, uint16_t height)
@@ -57,15 +52,70 @@ public:
         switch (fmt)
         {
         case PixelFormat::YUV422:
-            return writeRegister(OV5640_Register::FORMAT_CONTROL00, 0x30);
+            return enableJpeg(false) &&
+                   writeRegister(OV5640_Register::ISP_FORMAT_MUX_CTRL, 0x00) &&
+                   writeRegister(OV5640_Register::FORMAT_CONTROL00, 0x30);
         case PixelFormat::RGB565:
-            return writeRegister(OV5640_Register::FORMAT_CONTROL00, 0x61);
+            return enableJpeg(false) &&
+                   writeRegister(OV5640_Register::ISP_FORMAT_MUX_CTRL, 0x01) &&
+                   writeRegister(OV5640_Register::FORMAT_CONTROL00, 0x61);
         case PixelFormat::JPEG:
-            return writeRegister(OV5640_Register::JPG_MODE_SELECT, 0x03);
+            // The compressor takes YUV422 from the ISP. Mode 3 streams variable-length frames
+            // that end at EOI; the DCMI captures them in JPEG mode.
+            return writeRegister(OV5640_Register::FORMAT_CONTROL00, 0x30) &&
+                   writeRegister(OV5640_Register::ISP_FORMAT_MUX_CTRL, 0x00) &&
+                   enableJpeg(true) &&
+                   setJpegQuality(jpegQuality_) &&
+                   writeRegister(OV5640_Register::JPG_MODE_SELECT, 0x03);
         }
         return false;
     }
 
+    //
+    // ────────────────────────────────────────────────────────────────
+    //  JPEG compression
+    // ────────────────────────────────────────────────────────────────
+    //
+
+    static constexpr uint8_t JPEG_QUALITY_MIN = 1;  // finest quantisation, largest frames
+    static constexpr uint8_t JPEG_QUALITY_MAX = 63; // coarsest quantisation, smallest frames
+
+    // Quantisation scale of JPEG_CTRL07[5:0]; the frame size is roughly inversely proportional
+    bool setJpegQuality(uint8_t scale)
+    {
+        if (scale < JPEG_QUALITY_MIN)
+            scale = JPEG_QUALITY_MIN;
+        if (scale > JPEG_QUALITY_MAX)
+            scale = JPEG_QUALITY_MAX;
+        if (!writeRegister(OV5640_Register::JPEG_CTRL07, scale))
+            return false;
+        jpegQuality_ = scale;
+        return true;
+    }
+
+    uint8_t jpegQuality() const { return jpegQuality_; }
+
+    // Size control: rescales the quantisation so the next frames approach targetBytes. Frames
+    // within 1/8 of the target leave the setting alone, so it does not hunt on scene noise.
+    bool adjustJpegQuality(size_t lastFrameBytes, size_t targetBytes)
+    {
+        if (lastFrameBytes == 0 || targetBytes == 0)
+            return false;
+        const size_t tolerance = targetBytes / 8;
+        if (lastFrameBytes + tolerance >= targetBytes && lastFrameBytes <= targetBytes + tolerance)
+            return true;
+
+        size_t scale = (size_t(jpegQuality_) * lastFrameBytes + targetBytes / 2) / targetBytes;
+        // Always move at least one step towards the target
+        if (lastFrameBytes > targetBytes && scale <= jpegQuality_)
+            scale = size_t(jpegQuality_) + 1;
+        if (lastFrameBytes < targetBytes && scale >= jpegQuality_)
+            scale = jpegQuality_ > JPEG_QUALITY_MIN ? size_t(jpegQuality_) - 1 : JPEG_QUALITY_MIN;
+        if (scale > JPEG_QUALITY_MAX)
+            scale = JPEG_QUALITY_MAX;
+        return scale == jpegQuality_ || setJpegQuality(static_cast<uint8_t>(scale));
+    }
+
     bool setExposure(uint32_t exposure_us)
     {
         uint32_t exp = exposure_us;
@@ -182,8 +232,56 @@ public:
         return true;
     }
 
+    //
+    // ────────────────────────────────────────────────────────────────
+    //  Register tables
+    // ────────────────────────────────────────────────────────────────
+    //
+
+    // Registers per sequential write
+    static constexpr size_t MAX_BURST = 32;
+
+    // The sensor auto-increments the register address, so each run of consecutive registers
+    // in the table goes out as one transfer: cfg_init_ takes 43 instead of 63
+    template <const auto &Table>
+    bool writeTable()
+    {
+        for (const Register_Run &run : Register_Runs<Table, MAX_BURST>::runs)
+        {
+            std::array<uint8_t, MAX_BURST> tx{};
+            for (size_t i = 0; i < run.count; ++i)
+                tx[i] = Table[run.first + i].data;
+
+            if (!transport_.write_reg(run.addr, tx.data(), run.count))
+                return false;
+        }
+        return true;
+    }
+
 private:
+    // TIMING_TC_REG21[5] selects the compressor; it and the JFIFO/SFIFO need their reset
+    // released (SYS_RESET02[4:2]) and their clocks running (SYS_CLOCK_ENABLE02[5,3])
+    bool enableJpeg(bool enable)
+    {
+        constexpr uint8_t TC_JPEG = 1u << 5;
+        constexpr uint8_t RESET_JPEG = (1u << 4) | (1u << 3) | (1u << 2);
+        constexpr uint8_t CLOCK_JPEG = (1u << 5) | (1u << 3);
+
+        uint8_t tc = readRegister(OV5640_Register::TIMING_TC_REG21);
+        tc = enable ? uint8_t(tc | TC_JPEG) : uint8_t(tc & ~TC_JPEG);
+        if (!writeRegister(OV5640_Register::TIMING_TC_REG21, tc))
+            return false;
+        if (!enable)
+            return true;
+
+        const uint8_t reset = readRegister(OV5640_Register::SYS_RESET02);
+        const uint8_t clock = readRegister(OV5640_Register::SYS_CLOCK_ENABLE02);
+        return writeRegister(OV5640_Register::SYS_RESET02, uint8_t(reset & ~RESET_JPEG)) &&
+               writeRegister(OV5640_Register::SYS_CLOCK_ENABLE02, uint8_t(clock | CLOCK_JPEG));
+    }
+
     Transport &transport_;
+    uint8_t jpegQuality_ = 4; // JPEG_CTRL07 of the init table
 };
 
 #endif // _OV5640_HPP_
@@ -75,6 +75,9 @@ enum class OV5640_Register : uint16_t
     FRAME_CTRL01             = 0x4202,
     FORMAT_CONTROL00         = 0x4300,
 
+    // JPEG compression
+    JPEG_CTRL07              = 0x4407,
+
     // VFIFO and JPEG
     VFIFO_HSIZE              = 0x4602,
     VFIFO_VSIZE              = 0x4604,
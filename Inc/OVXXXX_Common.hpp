@@ -1,6 +1,8 @@
 #ifndef __OVXXXX_Common_HPP__
 #define __OVXXXX_Common_HPP__
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 
@@ -10,6 +12,56 @@ using Word_Byte_t = struct
     uint8_t data;
 };
 
+// A run of table entries at consecutive register addresses, written as one sequential
+// (auto-increment) transfer
+struct Register_Run
+{
+    uint16_t addr;  // first register of the run
+    uint16_t first; // index of its entry in the table
+    uint16_t count;
+};
+
+// Length of the run starting at entry i, at most max_burst registers
+template <size_t N>
+constexpr size_t register_run_length(const Word_Byte_t (&table)[N], size_t i, size_t max_burst)
+{
+    size_t n = 1;
+    while (i + n < N && n < max_burst && table[i + n].addr == table[i].addr + n)
+        ++n;
+    return n;
+}
+
+template <size_t N>
+constexpr size_t count_register_runs(const Word_Byte_t (&table)[N], size_t max_burst)
+{
+    size_t runs = 0;
+    for (size_t i = 0; i < N; i += register_run_length(table, i, max_burst))
+        ++runs;
+    return runs;
+}
+
+// A register table split into runs at compile time. The writes keep their order, so a table
+// written run by run leaves the sensor as it would entry by entry.
+template <const auto &Table, size_t MaxBurst>
+struct Register_Runs
+{
+    static_assert(MaxBurst > 0, "a run holds at least one register");
+
+    static constexpr size_t size = count_register_runs(Table, MaxBurst);
+
+    static constexpr std::array<Register_Run, size> runs = [] {
+        std::array<Register_Run, size> out{};
+        size_t i = 0;
+        for (auto &run : out)
+        {
+            const size_t n = register_run_length(Table, i, MaxBurst);
+            run = {Table[i].addr, static_cast<uint16_t>(i), static_cast<uint16_t>(n)};
+            i += n;
+        }
+        return out;
+    }();
+};
+
 static inline void word_byte_to_string(char *buffer,
                          size_t buf_size,
                          const Word_Byte_t *registers,
@@ -1,7 +1,10 @@
 #ifndef __ORIENTATION_SERVICE_HPP__
 #define __ORIENTATION_SERVICE_HPP__
 
+#include <algorithm>
 #include <functional>
+#include <optional>
+#include <span>
 #include "IMU.hpp"
 #include "au.hpp"
 #include "TimeUtils.hpp"
@@ -39,6 +42,64 @@ Eigen::Vector3f gyrVector(const AngularVelocityInBodyFrame &angular_velocity)
         angular_velocity[2].in(au::radiansPerSecondInBodyFrame));
 }
 
+// Trackers that integrate a burst of gyro samples, each over its own period, before the next
+// measurement update
+template <typename Tracker>
+concept BatchGyroTracker = requires(Tracker tracker, std::span<const Eigen::Vector3f> rates, std::span<const float> periods,
+                                    au::QuantityU64<au::Milli<au::Seconds>> timestamp) {
+    tracker.predictTo(rates, periods, timestamp);
+};
+
+// FIFO frames integrated per service tick; any excess stays in the sensor for the next tick
+constexpr size_t ORIENTATION_FIFO_BATCH = 16;
+
+// Integrates every gyro frame buffered in the IMU since the previous tick and returns the
+// newest frame for the measurement update, or nothing when the FIFO is off or empty.
+// Each frame covers the sensortime since the frame before it, last_sensor_time carrying the
+// newest one between ticks, so a different ODR or frames lost to an overflow keep the
+// integrated angle; only the very first frame falls back to FIFO_SAMPLE_PERIOD. The tracker
+// ends at frame_timestamp, the time of the newest frame: older than timestamp, the time of the
+// read, by the frames left in the FIFO.
+template <typename Tracker, typename IMU>
+    requires HasGyroscopeFifo<IMU> && BatchGyroTracker<Tracker>
+std::optional<typename IMU::FifoSample> predictFromFifo(Tracker &tracker, IMU &imu, std::optional<uint32_t> &last_sensor_time,
+                                                        au::QuantityU64<au::Milli<au::Seconds>> timestamp,
+                                                        au::QuantityU64<au::Milli<au::Seconds>> &frame_timestamp)
+{
+    std::array<typename IMU::FifoSample, ORIENTATION_FIFO_BATCH> samples;
+    uint32_t read_time = 0;
+    const size_t count = imu.readFifo(samples, read_time);
+
+    std::array<Eigen::Vector3f, ORIENTATION_FIFO_BATCH> rates;
+    std::array<float, ORIENTATION_FIFO_BATCH> periods;
+    size_t n_rates = 0;
+    size_t latest = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (samples[i].has_gyr)
+        {
+            const uint32_t sensor_time = samples[i].sensor_time;
+            periods[n_rates] = last_sensor_time.has_value()
+                                   ? static_cast<float>((sensor_time - last_sensor_time.value()) & IMU::SENSOR_TIME_MASK) * IMU::SENSOR_TIME_TICK
+                                   : IMU::FIFO_SAMPLE_PERIOD;
+            last_sensor_time = sensor_time;
+            rates[n_rates++] = gyrVector(samples[i].gyr);
+            latest = i;
+        }
+    }
+    if (n_rates == 0)
+    {
+        return std::nullopt;
+    }
+
+    const float age_s = static_cast<float>((read_time - samples[latest].sensor_time) & IMU::SENSOR_TIME_MASK) * IMU::SENSOR_TIME_TICK;
+    const uint64_t now_ms = timestamp.in(au::milli(au::seconds));
+    const uint64_t age_ms = std::min(static_cast<uint64_t>(1000.f * age_s + 0.5f), now_ms);
+    frame_timestamp = au::make_quantity<au::Milli<au::Seconds>>(now_ms - age_ms);
+    tracker.predictTo(std::span<const Eigen::Vector3f>(rates.data(), n_rates), std::span<const float>(periods.data(), n_rates), frame_timestamp);
+    return samples[latest];
+}
+
 struct OrientationSolution
 {
     enum class Orientation : uint8_t { YAW = 0, ROLL = 1, PITCH = 2 };
@@ -95,10 +156,15 @@ public:
     void update(au::QuantityU64<au::Milli<au::Seconds>> &timestamp);
 
 private:
+    void fuse(au::QuantityU64<au::Milli<au::Seconds>> &timestamp,
+              const std::optional<AngularVelocityInBodyFrame> &angular,
+              const std::optional<MagneticFieldInBodyFrame> &magnetic);
+
     RTC_HandleTypeDef *hrtc_;
     Tracker &tracker_;
     IMU &imu_;
     MAG &mag_;
+    std::optional<uint32_t> fifo_time_; // sensortime of the newest FIFO frame integrated
 };
 
 template <typename Tracker, typename IMU, typename MAG>
@@ -131,7 +197,7 @@ OrientationSolution GyrMagOrientation<Tracker, IMU, MAG>::predict()
     result.timestamp = TimeUtils::from_rtc(rtc, hrtc_->Init.SynchPrediv);
 
     auto optional_angular = imu_.readGyroscope();
-    auto optional_magnetic = imu_.readMagnetometer();
+    auto optional_magnetic = mag_.readMagnetometer();
 
     if (optional_angular.has_value()) {
         result.angular_velocity = optional_angular.value();
@@ -143,7 +209,7 @@ OrientationSolution GyrMagOrientation<Tracker, IMU, MAG>::predict()
         result.validity_flags |= static_cast<uint8_t>(OrientationSolution::Validity::MAGNETIC_FIELD);
     }
 
-    update(result.timestamp);  // updates tracker
+    fuse(result.timestamp, optional_angular, optional_magnetic);  // updates tracker
     auto q_ = tracker_.getOrientation();
     result.q = { q_.w(), q_.x(), q_.y(), q_.z() };
     result.validity_flags |= static_cast<uint8_t>(OrientationSolution::Validity::QUATERNION);
@@ -158,11 +224,32 @@ template <typename Tracker, typename IMU, typename MAG>
     requires HasBodyGyroscope<IMU> && HasBodyMagnetometer<MAG>
 void GyrMagOrientation<Tracker, IMU, MAG>::update(au::QuantityU64<au::Milli<au::Seconds>> &timestamp)
 {
-    auto optional_angular = imu_.readGyroscope();
-    auto optional_magnetic = imu_.readMagnetometer();
-    if (optional_angular.has_value() && optional_magnetic.has_value())
+    fuse(timestamp, imu_.readGyroscope(), mag_.readMagnetometer());
+}
+
+// The FIFO backlog is integrated first and its newest frame, at its own time, replaces the register-read rate
+template <typename Tracker, typename IMU, typename MAG>
+    requires HasBodyGyroscope<IMU> && HasBodyMagnetometer<MAG>
+void GyrMagOrientation<Tracker, IMU, MAG>::fuse(au::QuantityU64<au::Milli<au::Seconds>> &timestamp,
+                                                const std::optional<AngularVelocityInBodyFrame> &angular,
+                                                const std::optional<MagneticFieldInBodyFrame> &magnetic)
+{
+    if constexpr (HasGyroscopeFifo<IMU> && BatchGyroTracker<Tracker>)
+    {
+        au::QuantityU64<au::Milli<au::Seconds>> frame_timestamp;
+        if (auto latest = predictFromFifo(tracker_, imu_, fifo_time_, timestamp, frame_timestamp))
+        {
+            if (magnetic.has_value())
+            {
+                tracker_.updateSensorFusion(gyrVector(latest->gyr), magVector(magnetic.value()), frame_timestamp);
+            }
+            return;
+        }
+    }
+
+    if (angular.has_value() && magnetic.has_value())
     {
-        tracker_.updateSensorFusion(gyrVector(optional_angular.value()), magVector(optional_magnetic.value()), timestamp);
+        tracker_.updateSensorFusion(gyrVector(angular.value()), magVector(magnetic.value()), timestamp);
     }
 }
 
@@ -179,10 +266,16 @@ public:
     void update(au::QuantityU64<au::Milli<au::Seconds>> &timestamp);
 
 private:
+    void fuse(au::QuantityU64<au::Milli<au::Seconds>> &timestamp,
+              const std::optional<AngularVelocityInBodyFrame> &angular,
+              const std::optional<AccelerationInBodyFrame> &accel,
+              const std::optional<MagneticFieldInBodyFrame> &magnetic);
+
     RTC_HandleTypeDef *hrtc_;
     Tracker &tracker_;
     IMU &imu_;
     MAG &mag_;
+    std::optional<uint32_t> fifo_time_; // sensortime of the newest FIFO frame integrated
 };
 
 template <typename Tracker, typename IMU, typename MAG>
@@ -219,7 +312,7 @@ OrientationSolution AccGyrMagOrientation<Tracker, IMU, MAG>::predict()
     // Sensor reads
     auto optional_angular   = imu_.readGyroscope();
     auto optional_accel     = imu_.readAccelerometer();
-    auto optional_magnetic  = imu_.readMagnetometer();
+    auto optional_magnetic  = mag_.readMagnetometer();
 
     if (optional_angular.has_value()) {
         result.angular_velocity = optional_angular.value();
@@ -232,13 +325,7 @@ OrientationSolution AccGyrMagOrientation<Tracker, IMU, MAG>::predict()
     }
 
     // Update tracker if all required data is present
-    if (optional_angular && optional_accel && optional_magnetic) {
-        tracker_.updateSensorFusion(
-            gyrVector(optional_angular.value()),
-            accVector(optional_accel.value()),
-            magVector(optional_magnetic.value()),
-            result.timestamp);
-    }
+    fuse(result.timestamp, optional_angular, optional_accel, optional_magnetic);
 
     // Orientation from tracker
     auto q_ = tracker_.getOrientation();
@@ -255,13 +342,34 @@ template <typename Tracker, typename IMU, typename MAG>
     requires HasBodyGyroscope<IMU> && HasBodyMagnetometer<MAG> && HasBodyAccelerometer<IMU>
 void AccGyrMagOrientation<Tracker, IMU, MAG>::update(au::QuantityU64<au::Milli<au::Seconds>> &timestamp)
 {
-    auto optional_angular = imu_.readGyroscope();
-    auto optional_accel = imu_.readAccelerometer();
-    auto optional_magnetic = imu_.readMagnetometer();
+    fuse(timestamp, imu_.readGyroscope(), imu_.readAccelerometer(), mag_.readMagnetometer());
+}
+
+// The FIFO backlog is integrated first and its newest frame, at its own time, replaces the register-read rate and acceleration
+template <typename Tracker, typename IMU, typename MAG>
+    requires HasBodyGyroscope<IMU> && HasBodyMagnetometer<MAG> && HasBodyAccelerometer<IMU>
+void AccGyrMagOrientation<Tracker, IMU, MAG>::fuse(au::QuantityU64<au::Milli<au::Seconds>> &timestamp,
+                                                   const std::optional<AngularVelocityInBodyFrame> &angular,
+                                                   const std::optional<AccelerationInBodyFrame> &accel,
+                                                   const std::optional<MagneticFieldInBodyFrame> &magnetic)
+{
+    if constexpr (HasGyroscopeFifo<IMU> && BatchGyroTracker<Tracker>)
+    {
+        au::QuantityU64<au::Milli<au::Seconds>> frame_timestamp;
+        if (auto latest = predictFromFifo(tracker_, imu_, fifo_time_, timestamp, frame_timestamp))
+        {
+            auto latest_accel = latest->has_acc ? std::optional<AccelerationInBodyFrame>(latest->acc) : accel;
+            if (latest_accel.has_value() && magnetic.has_value())
+            {
+                tracker_.updateSensorFusion(gyrVector(latest->gyr), accVector(latest_accel.value()), magVector(magnetic.value()), frame_timestamp);
+            }
+            return;
+        }
+    }
 
-    if (optional_angular.has_value() && optional_accel.has_value() && optional_magnetic.has_value())
+    if (angular.has_value() && accel.has_value() && magnetic.has_value())
     {
-        tracker_.updateSensorFusion(gyrVector(optional_angular.value()), accVector(optional_accel.value()), magVector(optional_magnetic.value()), timestamp);
+        tracker_.updateSensorFusion(gyrVector(angular.value()), accVector(accel.value()), magVector(magnetic.value()), timestamp);
     }
 }
 
@@ -279,9 +387,14 @@ public:
     void update(au::QuantityU64<au::Milli<au::Seconds>> &timestamp);
 
 private:
+    void fuse(au::QuantityU64<au::Milli<au::Seconds>> &timestamp,
+              const std::optional<AngularVelocityInBodyFrame> &angular,
+              const std::optional<AccelerationInBodyFrame> &accel);
+
     RTC_HandleTypeDef *hrtc_;
     Tracker &tracker_;
     IMU &imu_;
+    std::optional<uint32_t> fifo_time_; // sensortime of the newest FIFO frame integrated
 };
 
 template <typename Tracker, typename IMU>
@@ -325,12 +438,7 @@ OrientationSolution AccGyrOrientation<Tracker, IMU>::predict()
     }
 
     // Update tracker if both sensors are available
-    if (optional_angular && optional_accel) {
-        tracker_.updateSensorFusion(
-            gyrVector(optional_angular.value()),
-            accVector(optional_accel.value()),
-            result.timestamp);
-    }
+    fuse(result.timestamp, optional_angular, optional_accel);
 
     // Orientation from tracker
     auto q_ = tracker_.getOrientation();
@@ -347,12 +455,33 @@ template <typename Tracker, typename IMU>
     requires HasBodyGyroscope<IMU> && HasBodyAccelerometer<IMU>
 void AccGyrOrientation<Tracker, IMU>::update(au::QuantityU64<au::Milli<au::Seconds>> &timestamp)
 {
-    auto optional_angular = imu_.readGyroscope();
-    auto optional_accel = imu_.readAccelerometer();
+    fuse(timestamp, imu_.readGyroscope(), imu_.readAccelerometer());
+}
+
+// The FIFO backlog is integrated first and its newest frame, at its own time, replaces the register-read rate and acceleration
+template <typename Tracker, typename IMU>
+    requires HasBodyGyroscope<IMU> && HasBodyAccelerometer<IMU>
+void AccGyrOrientation<Tracker, IMU>::fuse(au::QuantityU64<au::Milli<au::Seconds>> &timestamp,
+                                           const std::optional<AngularVelocityInBodyFrame> &angular,
+                                           const std::optional<AccelerationInBodyFrame> &accel)
+{
+    if constexpr (HasGyroscopeFifo<IMU> && BatchGyroTracker<Tracker>)
+    {
+        au::QuantityU64<au::Milli<au::Seconds>> frame_timestamp;
+        if (auto latest = predictFromFifo(tracker_, imu_, fifo_time_, timestamp, frame_timestamp))
+        {
+            auto latest_accel = latest->has_acc ? std::optional<AccelerationInBodyFrame>(latest->acc) : accel;
+            if (latest_accel.has_value())
+            {
+                tracker_.updateSensorFusion(gyrVector(latest->gyr), accVector(latest_accel.value()), frame_timestamp);
+            }
+            return;
+        }
+    }
 
-    if (optional_angular.has_value() && optional_accel.has_value())
+    if (angular.has_value() && accel.has_value())
     {
-        tracker_.updateSensorFusion(gyrVector(optional_angular.value()), accVector(optional_accel.value()), timestamp);
+        tracker_.updateSensorFusion(gyrVector(angular.value()), accVector(accel.value()), timestamp);
     }
 }
 
@@ -3,6 +3,7 @@
 
 #include <Eigen/Dense>
 #include <functional>
+#include <span>
 #include "Kalman.hpp"
 #include "Quaternion.hpp"
 #include "au.hpp"
@@ -94,6 +95,26 @@ public:
         last_timestamp = new_timestamp;
     }
 
+    /**
+     * @brief Integrates a burst of gyro samples, e.g. a sensor FIFO, ending at new_timestamp.
+     *
+     * Sample k holds the rate over the k-th sample_period, oldest first. Each step rotates by
+     * the coning-corrected vector phi_k = a_k + 1/12 a_(k-1) x a_k with a_k = w_k dt, and the
+     * process noise of one predictTo() is added per sample.
+     */
+    void predictTo(std::span<const Eigen::Vector3f> gyro_rates, float sample_period,
+                   au::QuantityU64<au::Milli<au::Seconds>> new_timestamp)
+    {
+        integrateRates(gyro_rates, [sample_period](size_t) { return sample_period; }, new_timestamp);
+    }
+
+    // As above with the period of each sample, e.g. from sensor timestamps; sizes must match
+    void predictTo(std::span<const Eigen::Vector3f> gyro_rates, std::span<const float> sample_periods,
+                   au::QuantityU64<au::Milli<au::Seconds>> new_timestamp)
+    {
+        integrateRates(gyro_rates, [sample_periods](size_t k) { return sample_periods[k]; }, new_timestamp);
+    }
+
     void updateGyro(const Eigen::Vector3f &gyro, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
     {
         predictTo(timestamp);
@@ -129,16 +150,7 @@ public:
 
     Eigen::Vector3f getYawPitchRoll() const
     {
-        const auto &q = getOrientation();
-        float sinp = 2.f * (q.w() * q.y() - q.z() * q.x());
-        sinp = std::clamp(sinp, -1.f, 1.f);
-
-        float yaw = std::atan2(2.f * (q.w() * q.z() + q.x() * q.y()),
-                               1.f - 2.f * (q.y() * q.y() + q.z() * q.z()));
-        float pitch = std::asin(sinp);
-        float roll = std::atan2(2.f * (q.w() * q.x() + q.y() * q.z()),
-                                1.f - 2.f * (q.x() * q.x() + q.y() * q.y()));
-        return Eigen::Vector3f(yaw, pitch, roll);
+        return quaternionToYawPitchRoll(getOrientation());
     }
 
     void printDebugState(const std::string &label = "") const
@@ -152,6 +164,41 @@ public:
     }
 
 protected:
+    template <typename PeriodOf>
+    void integrateRates(std::span<const Eigen::Vector3f> gyro_rates, PeriodOf period_of,
+                        au::QuantityU64<au::Milli<au::Seconds>> new_timestamp)
+    {
+        if (gyro_rates.empty())
+            return;
+
+        auto &x = ekf.stateVector;
+        Eigen::Quaternionf q(x(3), x(0), x(1), x(2));
+        Eigen::Vector3f previous = x.template segment<3>(4) * period_of(0);
+
+        for (size_t k = 0; k < gyro_rates.size(); ++k)
+        {
+            const Eigen::Vector3f alpha = gyro_rates[k] * period_of(k);
+            const Eigen::Vector3f phi = alpha + previous.cross(alpha) / 12.f;
+            const float angle = phi.norm();
+            if (angle > 1e-6f)
+                q = q * Eigen::Quaternionf(Eigen::AngleAxisf(angle, phi / angle));
+            previous = alpha;
+        }
+
+        q.normalize();
+        if (q.dot(prev_orientation) < 0.f)
+            q.coeffs() *= -1.f;
+
+        prev_orientation = q;
+        x(0) = q.x();
+        x(1) = q.y();
+        x(2) = q.z();
+        x(3) = q.w();
+        x.template segment<3>(4) = gyro_rates.back();
+        ekf.stateCovarianceMatrix += static_cast<float>(gyro_rates.size()) * ekf.processNoiseCovarianceMatrix;
+        last_timestamp = new_timestamp;
+    }
+
     KalmanFilter<StateSize, MeasurementSize> ekf;
     au::QuantityU64<au::Milli<au::Seconds>> last_timestamp;
     Eigen::Quaternionf prev_orientation;
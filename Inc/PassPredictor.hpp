@@ -0,0 +1,285 @@
+#ifndef PASS_PREDICTOR_HPP
+#define PASS_PREDICTOR_HPP
+
+#include "SGP4Propagator.hpp"
+#include "coordinate_transformations.hpp"
+#include "au.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+
+// Contact window over a ground station, timestamps in milliseconds since the TimeUtils epoch
+struct PassWindow
+{
+    au::QuantityU64<au::Milli<au::Seconds>> aos;              // acquisition of signal
+    au::QuantityU64<au::Milli<au::Seconds>> los;              // loss of signal
+    au::QuantityU64<au::Milli<au::Seconds>> max_elevation_at; // culmination
+    float max_elevation_deg;
+};
+
+// Predicts passes over one ground station. The orbit is propagated in batches into an
+// SGP4Ephemeris of NODES nodes, elevation is scanned at the nodes, and the horizon crossings
+// and culminations are then refined by bisection / golden-section search on the interpolated
+// ephemeris. Up to MAX_PASSES windows are kept, in time order.
+template <size_t NODES, size_t MAX_PASSES>
+class PassPredictor
+{
+public:
+    using Timestamp = au::QuantityU64<au::Milli<au::Seconds>>;
+
+    static constexpr uint64_t REFINE_TOLERANCE_MS = 500;
+
+    PassPredictor(const coordinate_transformations::Geodetic &station, float min_elevation_deg = 0.f)
+        : min_elevation_deg_(min_elevation_deg)
+    {
+        const coordinate_transformations::ECEF ecef = coordinate_transformations::geodeticToECEF(station);
+        station_km_ = {0.001f * ecef.x.in(au::meters * au::ecefs), 0.001f * ecef.y.in(au::meters * au::ecefs), 0.001f * ecef.z.in(au::meters * au::ecefs)};
+
+        // Geodetic zenith
+        const float lat = station.latitude.in(au::degreesInGeodeticFrame) * coordinate_transformations::DEG_TO_RAD;
+        const float lon = station.longitude.in(au::degreesInGeodeticFrame) * coordinate_transformations::DEG_TO_RAD;
+        up_ = {cosf(lat) * cosf(lon), cosf(lat) * sinf(lon), sinf(lat)};
+    }
+
+    // Predicts the passes in [start, start + orbits revolutions), replacing any earlier prediction
+    size_t predict(SGP4Propagator &propagator, Timestamp start, float orbits, uint32_t step_ms = 60000)
+    {
+        count_ = 0;
+        if (!propagator.hasTLE() || step_ms == 0 || propagator.getTLE().meanMotion <= 0.f)
+        {
+            return 0;
+        }
+
+        const uint64_t start_ms = start.in(au::milli(au::seconds));
+        const uint64_t end_ms = start_ms + static_cast<uint64_t>(orbits * 86400000.f / propagator.getTLE().meanMotion);
+        const uint64_t chunk_ms = static_cast<uint64_t>(step_ms) * (NODES - 1);
+
+        // Elevation of the previous two nodes, carried across chunks
+        std::optional<float> before_previous, previous;
+        uint64_t previous_ms = start_ms;
+        std::optional<PassWindow> open;
+
+        for (uint64_t chunk_start = start_ms; chunk_start < end_ms; chunk_start += chunk_ms)
+        {
+            if (!ephemeris_.generate(propagator, ms(chunk_start), step_ms))
+            {
+                return count_;
+            }
+
+            // The first node repeats the last node of the previous chunk
+            for (size_t node = (chunk_start == start_ms ? 0 : 1); node < NODES; ++node)
+            {
+                const uint64_t t_ms = ephemeris_.timestampAt(node).in(au::milli(au::seconds));
+                if (t_ms > end_ms)
+                {
+                    break;
+                }
+                const float elevation = elevationAt(ephemeris_.position(node), t_ms);
+                const bool visible = elevation >= min_elevation_deg_;
+
+                if (!previous.has_value())
+                {
+                    if (visible)
+                    {
+                        // Already in contact at the start of the window
+                        open = PassWindow{ms(t_ms), ms(t_ms), ms(t_ms), elevation};
+                    }
+                }
+                else
+                {
+                    const bool was_visible = *previous >= min_elevation_deg_;
+                    if (visible && !was_visible)
+                    {
+                        const uint64_t aos = crossing(propagator, previous_ms, t_ms, true);
+                        open = PassWindow{ms(aos), ms(aos), ms(t_ms), elevation};
+                    }
+                    if (open.has_value() && before_previous.has_value() && *previous >= *before_previous && *previous >= elevation)
+                    {
+                        // The previous node is a local maximum: refine the culmination around it
+                        refineMaximum(propagator, previous_ms - step_ms, t_ms, *open);
+                    }
+                    if (!visible && was_visible && open.has_value())
+                    {
+                        open->los = ms(crossing(propagator, previous_ms, t_ms, false));
+                        store(*open);
+                        open.reset();
+                    }
+                }
+
+                if (open.has_value() && elevation > open->max_elevation_deg)
+                {
+                    open->max_elevation_deg = elevation;
+                    open->max_elevation_at = ms(t_ms);
+                }
+                before_previous = previous;
+                previous = elevation;
+                previous_ms = t_ms;
+            }
+        }
+
+        if (open.has_value())
+        {
+            // Still in contact at the end of the window
+            open->los = ms(previous_ms);
+            store(*open);
+        }
+        return count_;
+    }
+
+    // Elevation of the satellite above the station's horizon in degrees
+    float elevation(SGP4Propagator &propagator, Timestamp timestamp)
+    {
+        return elevationAt(propagator, timestamp.in(au::milli(au::seconds)));
+    }
+
+    // First window that has not ended at now
+    std::optional<PassWindow> nextPass(Timestamp now) const
+    {
+        for (size_t i = 0; i < count_; ++i)
+        {
+            if (passes_[i].los > now)
+            {
+                return passes_[i];
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool inContact(Timestamp now) const
+    {
+        const std::optional<PassWindow> pass = nextPass(now);
+        return pass.has_value() && pass->aos <= now;
+    }
+
+    // Milliseconds until the next contact starts, 0 while in contact, nullopt if none is predicted.
+    // Tasks moving bulk data use this to sleep until the station is in view.
+    std::optional<uint64_t> timeUntilContact(Timestamp now) const
+    {
+        const std::optional<PassWindow> pass = nextPass(now);
+        if (!pass.has_value())
+        {
+            return std::nullopt;
+        }
+        return pass->aos <= now ? 0 : (pass->aos - now).in(au::milli(au::seconds));
+    }
+
+    size_t size() const
+    {
+        return count_;
+    }
+
+    const PassWindow &operator[](size_t i) const
+    {
+        return passes_[i];
+    }
+
+private:
+    static Timestamp ms(uint64_t value)
+    {
+        return au::make_quantity<au::Milli<au::Seconds>>(value);
+    }
+
+    float elevationAt(const SGP4Propagator::Vector &teme_km, uint64_t t_ms)
+    {
+        // The rotation keeps GMST in step with the millisecond timestamp, a float jd2000 would
+        // quantise it to about a minute and make the elevation flicker near the mask
+        rotation_.update(t_ms);
+        const SGP4Propagator::Vector ecef = rotation_.apply(teme_km);
+
+        float range2 = 0.f, up = 0.f;
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const float rho = ecef[axis] - station_km_[axis];
+            range2 += rho * rho;
+            up += rho * up_[axis];
+        }
+        return asinf(up / sqrtf(range2)) * coordinate_transformations::RAD_TO_DEG;
+    }
+
+    // Interpolated inside the current ephemeris chunk, propagated directly outside of it
+    float elevationAt(SGP4Propagator &propagator, uint64_t t_ms)
+    {
+        SGP4Propagator::Vector r, v;
+        if (!ephemeris_.interpolate(ms(t_ms), r, v) && !propagator.propagate(ms(t_ms), r, v))
+        {
+            return -90.f;
+        }
+        return elevationAt(r, t_ms);
+    }
+
+    // Bisection for the horizon crossing between a and b
+    uint64_t crossing(SGP4Propagator &propagator, uint64_t a, uint64_t b, bool rising)
+    {
+        while (b - a > REFINE_TOLERANCE_MS)
+        {
+            const uint64_t mid = a + (b - a) / 2;
+            const bool visible = elevationAt(propagator, mid) >= min_elevation_deg_;
+            if (visible == rising)
+            {
+                b = mid;
+            }
+            else
+            {
+                a = mid;
+            }
+        }
+        return rising ? b : a;
+    }
+
+    // Golden-section search for the culmination inside [a, b]
+    void refineMaximum(SGP4Propagator &propagator, uint64_t a, uint64_t b, PassWindow &pass)
+    {
+        constexpr double inv_phi = 0.6180339887498949;
+        uint64_t c = b - static_cast<uint64_t>(static_cast<double>(b - a) * inv_phi);
+        uint64_t d = a + static_cast<uint64_t>(static_cast<double>(b - a) * inv_phi);
+        float fc = elevationAt(propagator, c);
+        float fd = elevationAt(propagator, d);
+        while (b - a > REFINE_TOLERANCE_MS)
+        {
+            if (fc > fd)
+            {
+                b = d;
+                d = c;
+                fd = fc;
+                c = b - static_cast<uint64_t>(static_cast<double>(b - a) * inv_phi);
+                fc = elevationAt(propagator, c);
+            }
+            else
+            {
+                a = c;
+                c = d;
+                fc = fd;
+                d = a + static_cast<uint64_t>(static_cast<double>(b - a) * inv_phi);
+                fd = elevationAt(propagator, d);
+            }
+        }
+        const uint64_t best = fc > fd ? c : d;
+        const float best_elevation = std::max(fc, fd);
+        if (best_elevation > pass.max_elevation_deg)
+        {
+            pass.max_elevation_deg = best_elevation;
+            pass.max_elevation_at = ms(best);
+        }
+    }
+
+    void store(const PassWindow &pass)
+    {
+        if (count_ < MAX_PASSES)
+        {
+            passes_[count_++] = pass;
+        }
+    }
+
+    float min_elevation_deg_;
+    std::array<float, 3> station_km_{};
+    std::array<float, 3> up_{};
+    SGP4Ephemeris<NODES> ephemeris_;
+    coordinate_transformations::TemeToEcefRotation rotation_;
+    std::array<PassWindow, MAX_PASSES> passes_{};
+    size_t count_ = 0;
+};
+
+#endif // PASS_PREDICTOR_HPP
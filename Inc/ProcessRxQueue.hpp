@@ -3,6 +3,7 @@
 
 #include <tuple>
 #include <memory>
+#include <algorithm>
 
 #include "cyphal.hpp"
 #include "canard_adapter.hpp"
@@ -73,25 +74,39 @@ public:
     }
 
 #if defined(HAL_CAN_MODULE_ENABLED) || defined(MOCK_HAL_CAN_ENABLED)
+    // The RX rings are filled from ISRs with push(), which recycles the oldest frame of a full
+    // ring. Frames are therefore copied out (pop_n/pop) before they are processed, never
+    // processed in place.
     template <size_t N, typename... Adapters>
     void CanProcessRxQueue(Cyphal<CanardAdapter> *cyphal, ServiceManager *service_manager, std::tuple<Adapters...> &adapters, CircularBuffer<CanRxFrame, N> &can_rx_buffer)
     {
+        constexpr size_t BATCH = 8;
+        CanRxFrame frames[BATCH];
+
         size_t num_frames = can_rx_buffer.size();
-        for (uint32_t n = 0; n < num_frames; ++n)
+        while (num_frames > 0)
         {
-            CanRxFrame frame = can_rx_buffer.pop();
-            size_t frame_size = frame.header.DLC;
-
-//        	constexpr size_t BUFFER_SIZE = 256;
-//        	char hex_string_buffer[BUFFER_SIZE];
-//        	uchar_buffer_to_hex(frame.data, frame_size, hex_string_buffer, BUFFER_SIZE);
-//            log(LOG_LEVEL_DEBUG, "LoopManager::CanProcessRxQueue dump: %4x %s\r\n", frame.header.ExtId, hex_string_buffer);
+            size_t count = can_rx_buffer.pop_n(frames, std::min(num_frames, BATCH));
+            if (count == 0)
+                break;
+            num_frames -= count;
 
-            CyphalTransfer transfer;
-            int32_t result = cyphal->cyphalRxReceive(frame.header.ExtId, &frame_size, frame.data, &transfer);
-            if (result == 1)
+            for (size_t n = 0; n < count; ++n)
             {
-                processTransfer(transfer, service_manager, adapters);
+                CanRxFrame &frame = frames[n];
+                size_t frame_size = frame.header.DLC;
+
+//        	    constexpr size_t BUFFER_SIZE = 256;
+//        	    char hex_string_buffer[BUFFER_SIZE];
+//        	    uchar_buffer_to_hex(frame.data, frame_size, hex_string_buffer, BUFFER_SIZE);
+//              log(LOG_LEVEL_DEBUG, "LoopManager::CanProcessRxQueue dump: %4x %s\r\n", frame.header.ExtId, hex_string_buffer);
+
+                CyphalTransfer transfer;
+                int32_t result = cyphal->cyphalRxReceive(frame.header.ExtId, &frame_size, frame.data, &transfer);
+                if (result == 1)
+                {
+                    processTransfer(transfer, service_manager, adapters);
+                }
             }
         }
     }
@@ -2,6 +2,7 @@
 #define __QUATERION_HPP__ 
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <cmath>
 
 Eigen::Matrix<float, 3, 4> computeNumericalJacobian(const Eigen::Quaternionf &q, const Eigen::Vector3f &v);
@@ -10,4 +11,18 @@ Eigen::Matrix<float, 3, 4> computeAnalyticalJacobian(const Eigen::Quaternionf &q
 
 Eigen::Matrix<float, 3, 4> normalizeAnalyticalJacobian(const Eigen::Matrix<float, 3, 4>& J_analytical, const Eigen::Quaternionf& q, const Eigen::Vector3f& v);
 
+// ZYX Euler angles [yaw, pitch, roll] in radians of a body-to-NED orientation
+inline Eigen::Vector3f quaternionToYawPitchRoll(const Eigen::Quaternionf &q)
+{
+    float sinp = 2.f * (q.w() * q.y() - q.z() * q.x());
+    sinp = std::clamp(sinp, -1.f, 1.f);
+
+    float yaw = std::atan2(2.f * (q.w() * q.z() + q.x() * q.y()),
+                           1.f - 2.f * (q.y() * q.y() + q.z() * q.z()));
+    float pitch = std::asin(sinp);
+    float roll = std::atan2(2.f * (q.w() * q.x() + q.y() * q.z()),
+                            1.f - 2.f * (q.x() * q.x() + q.y() * q.y()));
+    return Eigen::Vector3f(yaw, pitch, roll);
+}
+
 #endif // __QUATERION_HPP__
\ No newline at end of file
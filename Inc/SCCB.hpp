@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include "GpioPin.hpp"
 
@@ -13,56 +14,81 @@
 // 1. Stateless SCCB core (protocol only)
 //
 
+// A bus paces the clock through delay() unless it declares paced = false; such a bus relies
+// on its pin writes alone being slow enough for the sensor, and no delay is compiled in.
+template <typename Bus>
+constexpr bool sccb_paced()
+{
+    if constexpr (requires { Bus::paced; })
+        return Bus::paced;
+    else
+        return true;
+}
+
 struct SCCB_Core
 {
+    template <typename Bus>
+    static void pace(Bus &bus)
+    {
+        if constexpr (sccb_paced<Bus>())
+            bus.delay();
+    }
+
+    // Leaves SDA an open-drain output, as write_byte() expects it
     template <typename Bus>
     static void start(Bus &bus)
     {
         bus.sda_as_output_od();
         bus.sda_high();
         bus.scl_high();
-        bus.delay();
+        pace(bus);
         bus.sda_low();
-        bus.delay();
+        pace(bus);
         bus.scl_low();
     }
 
     template <typename Bus>
     static void stop(Bus &bus)
     {
-        bus.sda_as_output_od();
         bus.sda_low();
-        bus.delay();
+        pace(bus);
         bus.scl_high();
-        bus.delay();
+        pace(bus);
         bus.sda_high();
-        bus.delay();
+        pace(bus);
     }
 
+    // One pacing per clock phase: SDA changes at the start of the low phase, so it needs no
+    // wait of its own. SDA stays an output between the bytes of a transaction.
     template <typename Bus>
     static void write_byte(Bus &bus, uint8_t b)
     {
-        bus.sda_as_output_od();
-
         for (int i = 0; i < 8; ++i)
         {
             (b & 0x80) ? bus.sda_high() : bus.sda_low();
-            bus.delay();
+            pace(bus);
             bus.scl_high();
-            bus.delay();
+            pace(bus);
             bus.scl_low();
-            bus.delay();
-            b <<= 1;
+            b = static_cast<uint8_t>(b << 1);
         }
 
         // ACK ignored
         bus.sda_high();
-        bus.delay();
+        pace(bus);
         bus.scl_high();
-        bus.delay();
+        pace(bus);
         bus.scl_low();
     }
 
+    // The bytes of a sequential write, after the register address
+    template <typename Bus>
+    static void write_bytes(Bus &bus, const uint8_t *data, size_t len)
+    {
+        for (size_t i = 0; i < len; ++i)
+            write_byte(bus, data[i]);
+    }
+
     template <typename Bus>
     static uint8_t read_byte(Bus &bus)
     {
@@ -74,19 +100,19 @@ struct SCCB_Core
         {
             v <<= 1;
             bus.scl_high();
-            bus.delay();
+            pace(bus);
             if (bus.sda_read())
                 v |= 1;
             bus.scl_low();
-            bus.delay();
+            pace(bus);
         }
 
         // NACK
         bus.sda_as_output_od();
         bus.sda_high();
-        bus.delay();
+        pace(bus);
         bus.scl_high();
-        bus.delay();
+        pace(bus);
         bus.scl_low();
 
         return v;
@@ -97,10 +123,14 @@ struct SCCB_Core
 // 2. Concrete STM32 SCCB bus using GpioPin<PortAddr, Pin>
 //
 
+// DelayCycles = 0 is the fast path: no delay() in the bit loop, the clock rate set by the
+// GPIO writes alone. Only for core clocks at which that stays within the sensor's SCCB timing.
 template <typename SCLPin, typename SDAPin, uint32_t DelayCycles = 200>
 class STM32_SCCB_Bus
 {
 public:
+    static constexpr bool paced = DelayCycles > 0;
+
     STM32_SCCB_Bus()
         : scl_{}, sda_{} {}
 
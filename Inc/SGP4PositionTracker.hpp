@@ -24,10 +24,8 @@ public:
     Sgp4PositionTracker()
         : Q(Eigen::Matrix<float, StateSize, StateSize>::Identity() * 0.01f),
           R(Eigen::Matrix3f::Identity() * 0.1f),
-          H(Eigen::Matrix<float, MeasurementSize, StateSize>::Zero()),
           kf(Q, R, Q, StateVector::Zero())
     {
-        H.block<3, 3>(0, 0) = Eigen::Matrix3f::Identity();
     }
 
     void setPrediction(const Eigen::Vector3f &pos, const Eigen::Vector3f &vel)
@@ -40,7 +38,8 @@ public:
 
     void updateWithGps(const Eigen::Vector3f &gps_measurement)
     {
-        kf.update(H, gps_measurement);
+        // H = [I 0], GPS observes the position block directly
+        kf.updateSelected<0>(gps_measurement);
     }
 
     StateVector getState() const
@@ -51,7 +50,6 @@ public:
 private:
     Eigen::Matrix<float, StateSize, StateSize> Q;
     Eigen::Matrix3f R;
-    Eigen::Matrix<float, MeasurementSize, StateSize> H;
     KalmanFilter<StateSize, MeasurementSize> kf;
 };
 
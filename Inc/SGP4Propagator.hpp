@@ -0,0 +1,263 @@
+#ifndef SGP4_PROPAGATOR_HPP
+#define SGP4_PROPAGATOR_HPP
+
+#include "sgp4_tle.hpp"
+#include "SGP4.h"
+#include "TimeUtils.hpp"
+#include "au.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+
+// SGP4 state initialised once per element set. sgp4init (via satrec2rv) is far more
+// expensive than a propagation step, so the elsetrec is kept until the TLE changes.
+class SGP4Propagator
+{
+public:
+    using Timestamp = au::QuantityU64<au::Milli<au::Seconds>>;
+    using Vector = std::array<float, 3>; // TEME, km or km/s
+
+    SGP4Propagator() = default;
+
+    void setTLE(const SGP4TwoLineElement &tle)
+    {
+        tle_ = tle;
+        initialised_ = false;
+    }
+
+    const SGP4TwoLineElement &getTLE() const
+    {
+        return tle_;
+    }
+
+    bool hasTLE() const
+    {
+        return tle_.satelliteNumber != 0;
+    }
+
+    // Propagates to minutes since the TLE epoch
+    bool propagate(float minutes_since_epoch, Vector &r, Vector &v)
+    {
+        if (!initialise())
+        {
+            return false;
+        }
+        return SGP4Funcs::sgp4(satrec_, minutes_since_epoch, r.data(), v.data());
+    }
+
+    // Propagates to a timestamp in milliseconds since the TimeUtils epoch
+    bool propagate(Timestamp timestamp, Vector &r, Vector &v)
+    {
+        if (!initialise())
+        {
+            return false;
+        }
+        return SGP4Funcs::sgp4(satrec_, minutesSinceEpoch(timestamp), r.data(), v.data());
+    }
+
+    // Integer millisecond difference to the TLE epoch, so the float result only rounds once
+    float minutesSinceEpoch(Timestamp timestamp)
+    {
+        (void)initialise();
+        const int64_t elapsed_ms = static_cast<int64_t>(timestamp.in(au::milli(au::seconds))) - epoch_ms_;
+        return static_cast<float>(elapsed_ms) / 60000.f;
+    }
+
+    // Number of sgp4init runs, for checking that the cache holds
+    uint32_t initialisations() const
+    {
+        return initialisations_;
+    }
+
+private:
+    bool initialise()
+    {
+        // sgp4 overwrites satrec_.error on every step, so only the sgp4init result is kept
+        if (initialised_)
+        {
+            return init_ok_;
+        }
+        if (!hasTLE())
+        {
+            return false;
+        }
+
+        satrec_ = elsetrec{};
+        snprintf(satrec_.satnum, sizeof(satrec_.satnum), "%05u", static_cast<unsigned>(std::abs(tle_.satelliteNumber) % 100000));
+        satrec_.epochyr = tle_.epochYear;
+        satrec_.epochdays = tle_.epochDay;
+        satrec_.ndot = tle_.meanMotionDerivative1;
+        satrec_.nddot = tle_.meanMotionDerivative2;
+        satrec_.bstar = tle_.bStarDrag;
+        satrec_.ephtype = tle_.ephemerisType;
+        satrec_.elnum = tle_.elementNumber;
+        satrec_.inclo = tle_.inclination;
+        satrec_.nodeo = tle_.rightAscensionAscendingNode;
+        satrec_.ecco = tle_.eccentricity;
+        satrec_.argpo = tle_.argumentOfPerigee;
+        satrec_.mo = tle_.meanAnomaly;
+        satrec_.no_kozai = tle_.meanMotion;
+        satrec_.revnum = tle_.revolutionNumberAtEpoch;
+
+        gravconsttype whichconst = wgs84; // Choose the gravity model (wgs72old, wgs72, wgs84)
+        char opsmode = 'i';               // Operation mode ('a' for AFSPC, 'i' for improved)
+        SGP4Funcs::satrec2rv(opsmode, whichconst, satrec_);
+
+        const auto epoch = TimeUtils::to_timepoint(static_cast<uint16_t>(tle_.epochYear + TimeUtils::EPOCH_YEAR), tle_.epochDay);
+        epoch_ms_ = TimeUtils::to_epoch_duration(epoch).count();
+
+        initialised_ = true;
+        init_ok_ = satrec_.error == 0;
+        ++initialisations_;
+        return init_ok_;
+    }
+
+    SGP4TwoLineElement tle_{};
+    elsetrec satrec_{};
+    int64_t epoch_ms_ = 0;
+    uint32_t initialisations_ = 0;
+    bool initialised_ = false;
+    bool init_ok_ = false;
+};
+
+// Positions and velocities propagated for a window of equally spaced epochs in one batch.
+// Queries between nodes use cubic Hermite interpolation on position with the SGP4 velocity
+// as the exact derivative, which stays within metres for node spacings of a minute in LEO.
+template <size_t NODES>
+class SGP4Ephemeris
+{
+public:
+    static_assert(NODES >= 2, "an ephemeris needs at least two nodes");
+
+    using Timestamp = SGP4Propagator::Timestamp;
+    using Vector = SGP4Propagator::Vector;
+
+    // Propagates NODES epochs starting at start, step_ms apart
+    bool generate(SGP4Propagator &propagator, Timestamp start, uint32_t step_ms)
+    {
+        valid_ = false;
+        if (step_ms == 0)
+        {
+            return false;
+        }
+        start_ms_ = start.in(au::milli(au::seconds));
+        step_ms_ = step_ms;
+        const float start_minutes = propagator.minutesSinceEpoch(start);
+        const float step_minutes = static_cast<float>(step_ms) / 60000.f;
+        for (size_t i = 0; i < NODES; ++i)
+        {
+            if (!propagator.propagate(start_minutes + static_cast<float>(i) * step_minutes, positions_[i], velocities_[i]))
+            {
+                return false;
+            }
+        }
+        valid_ = true;
+        return true;
+    }
+
+    bool covers(Timestamp timestamp) const
+    {
+        const uint64_t t_ms = timestamp.in(au::milli(au::seconds));
+        return valid_ && t_ms >= start_ms_ && t_ms <= endMs();
+    }
+
+    bool interpolate(Timestamp timestamp, Vector &r, Vector &v) const
+    {
+        if (!covers(timestamp))
+        {
+            return false;
+        }
+        const uint64_t offset_ms = timestamp.in(au::milli(au::seconds)) - start_ms_;
+        const size_t i = std::min(static_cast<size_t>(offset_ms / step_ms_), NODES - 2);
+        const float u = static_cast<float>(offset_ms - i * step_ms_) / static_cast<float>(step_ms_);
+        const float h = 0.001f * static_cast<float>(step_ms_); // seconds, velocities are km/s
+
+        const float u2 = u * u;
+        const float u3 = u2 * u;
+        const float h00 = 2.f * u3 - 3.f * u2 + 1.f;
+        const float h10 = (u3 - 2.f * u2 + u) * h;
+        const float h01 = -2.f * u3 + 3.f * u2;
+        const float h11 = (u3 - u2) * h;
+        // d/dt of the basis functions
+        const float d00 = (6.f * u2 - 6.f * u) / h;
+        const float d10 = 3.f * u2 - 4.f * u + 1.f;
+        const float d01 = (-6.f * u2 + 6.f * u) / h;
+        const float d11 = 3.f * u2 - 2.f * u;
+
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const float p0 = positions_[i][axis], p1 = positions_[i + 1][axis];
+            const float v0 = velocities_[i][axis], v1 = velocities_[i + 1][axis];
+            r[axis] = h00 * p0 + h10 * v0 + h01 * p1 + h11 * v1;
+            v[axis] = d00 * p0 + d10 * v0 + d01 * p1 + d11 * v1;
+        }
+        return true;
+    }
+
+    bool interpolate(Timestamp timestamp, std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r, std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v) const
+    {
+        Vector r_, v_;
+        if (!interpolate(timestamp, r_, v_))
+        {
+            return false;
+        }
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            r[axis] = au::make_quantity<au::Kilo<au::MetersInTemeFrame>>(r_[axis]);
+            v[axis] = au::make_quantity<au::Kilo<au::MetersPerSecondInTemeFrame>>(v_[axis]);
+        }
+        return true;
+    }
+
+    bool valid() const
+    {
+        return valid_;
+    }
+
+    Timestamp start() const
+    {
+        return au::make_quantity<au::Milli<au::Seconds>>(start_ms_);
+    }
+
+    Timestamp end() const
+    {
+        return au::make_quantity<au::Milli<au::Seconds>>(endMs());
+    }
+
+    Timestamp timestampAt(size_t node) const
+    {
+        return au::make_quantity<au::Milli<au::Seconds>>(start_ms_ + node * step_ms_);
+    }
+
+    const Vector &position(size_t node) const
+    {
+        return positions_[node];
+    }
+
+    const Vector &velocity(size_t node) const
+    {
+        return velocities_[node];
+    }
+
+    static constexpr size_t size()
+    {
+        return NODES;
+    }
+
+private:
+    uint64_t endMs() const
+    {
+        return start_ms_ + static_cast<uint64_t>(step_ms_) * (NODES - 1);
+    }
+
+    std::array<Vector, NODES> positions_{};
+    std::array<Vector, NODES> velocities_{};
+    uint64_t start_ms_ = 0;
+    uint32_t step_ms_ = 0;
+    bool valid_ = false;
+};
+
+#endif // SGP4_PROPAGATOR_HPP
@@ -0,0 +1,23 @@
+#ifndef SAMPLE_LAYOUT_HPP
+#define SAMPLE_LAYOUT_HPP
+
+#include <cstddef>
+
+// One channel of a raw frame: sample (x, y) is the byte at offset + y * rowBytes + x * stride
+struct SampleLayout
+{
+    size_t width;
+    size_t height;
+    size_t rowBytes;
+    size_t stride;
+    size_t offset;
+
+    static constexpr SampleLayout gray8(size_t width, size_t height) { return {width, height, width, 1, 0}; }
+
+    // YUYV (the OV5640 YUV422 output): Y at every even byte, Cb and Cr at half the width
+    static constexpr SampleLayout yuv422Luma(size_t width, size_t height) { return {width, height, 2 * width, 2, 0}; }
+    static constexpr SampleLayout yuv422Cb(size_t width, size_t height) { return {width / 2, height, 2 * width, 4, 1}; }
+    static constexpr SampleLayout yuv422Cr(size_t width, size_t height) { return {width / 2, height, 2 * width, 4, 3}; }
+};
+
+#endif // SAMPLE_LAYOUT_HPP
@@ -11,6 +11,7 @@
 #include "RegistrationManager.hpp"
 #include "ImageBufferConcept.hpp"
 #include "Trigger.hpp"
+#include "ThermalEventDetector.hpp"
 
 // ─────────────────────────────────────────────
 // MLX90640 Task State Machine
@@ -51,18 +52,22 @@ enum class MLXMode : uint8_t
 // ─────────────────────────────────────────────
 // TaskMLX90640
 // ─────────────────────────────────────────────
-template <typename PowerSwitchT, typename MLXT, ImageBufferConcept ImageBufferT, typename TriggerT = OnceTrigger>
+template <typename PowerSwitchT, typename MLXT, ImageBufferConcept ImageBufferT, typename TriggerT = OnceTrigger,
+          FrameSelectorConcept SelectorT = KeepAllFrames>
 class TaskMLX90640 : public Task, private TaskPacing
 {
 public:
+    // The selector sees every complete frame before it is stored and may drop it
     TaskMLX90640(PowerSwitchT &pwr, CIRCUITS circuit, MLXT &mlx, ImageBufferT &buffer, TriggerT &trigger,
-                 MLXMode mode, uint32_t burstCount, uint32_t sleep_interval, uint32_t operate_interval, uint32_t tick)
+                 MLXMode mode, uint32_t burstCount, uint32_t sleep_interval, uint32_t operate_interval, uint32_t tick,
+                 SelectorT &selector)
         : Task(sleep_interval, tick), TaskPacing(sleep_interval, operate_interval),
           power_(pwr),
           circuit_(circuit),
           sensor_(mlx),
           image_buffer_(buffer),
           trigger_(trigger),
+          selector_(selector),
           t0_(0),
           state_(MLXState::Off),
           mode_(mode),
@@ -73,6 +78,13 @@ public:
     {
     }
 
+    TaskMLX90640(PowerSwitchT &pwr, CIRCUITS circuit, MLXT &mlx, ImageBufferT &buffer, TriggerT &trigger,
+                 MLXMode mode, uint32_t burstCount, uint32_t sleep_interval, uint32_t operate_interval, uint32_t tick)
+        requires std::same_as<SelectorT, KeepAllFrames>
+        : TaskMLX90640(pwr, circuit, mlx, buffer, trigger, mode, burstCount, sleep_interval, operate_interval, tick, keep_all_)
+    {
+    }
+
     virtual ~TaskMLX90640() = default;
 
     void registerTask(RegistrationManager *manager, std::shared_ptr<Task> task) override
@@ -87,6 +99,7 @@ public:
     MLXState getState() const { return state_; }
     MLXMode getMode() const { return mode_; }
     uint32_t getBurstRemaining() const { return burstRemaining_; }
+    uint32_t getFramesDropped() const { return framesDropped_; }
 
 protected:
     void handleTaskImpl() override
@@ -225,7 +238,7 @@ private:
 
     void stateReadSubpageA()
     {
-        if (sensor_.readSubpage(subA_, spA_))
+        if (sensor_.readSubpageIntoFrame(frame_, spA_))
         {
             // spA_ is now 0 or 1 (or something bogus)
             if (spA_ != 0 && spA_ != 1)
@@ -257,7 +270,7 @@ private:
     void stateReadSubpageB()
     {
         int new_sp = -1;
-        if (sensor_.readSubpage(subB_, new_sp))
+        if (sensor_.readSubpageIntoFrame(frame_, new_sp))
         {
             if (new_sp != 0 && new_sp != 1)
             {
@@ -274,8 +287,7 @@ private:
                     "TaskMLX90640: same subpage twice (sp=%d) - restarting pair\r\n",
                     new_sp);
 
-                // Move B -> A, just to reuse the buffers.
-                std::memcpy(subA_, subB_, sizeof(subA_));
+                // The newer read already replaced A in its frame slot.
                 spA_ = new_sp;
 
                 // Wait for the other subpage again.
@@ -300,11 +312,7 @@ private:
     {
         if (spA_ != spB_ && spA_ >= 0 && spB_ >= 0)
         {
-            if (spA_ == 0)
-                sensor_.createFrame(subA_, subB_, frame_);
-            else
-                sensor_.createFrame(subB_, subA_, frame_);
-
+            // Both subpages were read into their slots of frame_
             publishFrame();
         }
         else
@@ -365,6 +373,13 @@ private:
         meta.producer = METADATA_PRODUCER::CAMERA_1;
         meta.format = METADATA_FORMAT::UNKN;
 
+        if (!selector_.select(frame_, meta))
+        {
+            ++framesDropped_;
+            log(LOG_LEVEL_DEBUG, "MLX90640: frame below significance threshold, not stored\r\n");
+            return;
+        }
+
         log(LOG_LEVEL_INFO, "MLX90640: Publishing frame to ImageBuffer\r\n");
         if (image_buffer_.add_image(meta) != ImageBufferError::NO_ERROR)
         {
@@ -402,6 +417,7 @@ private:
     MLXT &sensor_;
     ImageBufferT &image_buffer_;
     TriggerT &trigger_;
+    SelectorT &selector_;
 
     uint32_t t0_;
 
@@ -410,11 +426,13 @@ private:
     uint32_t burstCount_;
     uint32_t burstRemaining_;
 
-    uint16_t subA_[MLX90640_SUBPAGE_WORDS];
-    uint16_t subB_[MLX90640_SUBPAGE_WORDS];
+    // Subpage 0 then subpage 1, each written in place by readSubpageIntoFrame
     uint16_t frame_[MLX90640_FRAME_WORDS];
     int spA_;
     int spB_;
+    uint32_t framesDropped_ = 0;
+
+    static inline KeepAllFrames keep_all_{};
 
     constexpr static MLX90640_RefreshRate REFRESH_RATE = MLX90640_RefreshRate::Hz4;
     constexpr static uint32_t REFRESH_INTERVAL = getRefreshIntervalMs(REFRESH_RATE);
@@ -0,0 +1,97 @@
+#ifndef __TASKRESPONDLIST_HPP_
+#define __TASKRESPONDLIST_HPP_
+
+#include <cstring>
+
+#include "Task.hpp"
+#include "RegistrationManager.hpp"
+#include "InputOutputStream.hpp" // For NAME_LENGTH
+#include "FileAccess.hpp"
+#include "nunavut_assert.h"
+#include "uavcan/file/List_0_2.h"
+
+// Serves uavcan.file.List from a flat listing, e.g. the ThumbnailCatalogue over the thumbnail
+// records of an ImageBuffer: entry i of the lister is returned for entry_index i, an empty name
+// past the end. The directory path of the
+// request is not looked at.
+template <FileListConcept Lister, typename... Adapters>
+class TaskRespondList : public TaskForServer<CyphalBuffer8, Adapters...>
+{
+public:
+    TaskRespondList() = delete;
+    TaskRespondList(Lister& lister, uint32_t interval, uint32_t tick, std::tuple<Adapters...> &adapters)
+        : TaskForServer<CyphalBuffer8, Adapters...>(interval, tick, adapters), lister_(lister) {}
+
+    virtual void registerTask(RegistrationManager *manager, std::shared_ptr<Task> task) override;
+    virtual void unregisterTask(RegistrationManager *manager, std::shared_ptr<Task> task) override;
+    virtual void handleTaskImpl() override;
+
+protected:
+    bool respond();
+
+protected:
+    Lister& lister_;
+};
+
+template <FileListConcept Lister, typename... Adapters>
+void TaskRespondList<Lister, Adapters...>::handleTaskImpl()
+{
+    (void)respond();
+}
+
+template <FileListConcept Lister, typename... Adapters>
+bool TaskRespondList<Lister, Adapters...>::respond()
+{
+    if (TaskForServer<CyphalBuffer8, Adapters...>::buffer_.is_empty())
+        return true;
+
+    std::shared_ptr<CyphalTransfer> transfer = TaskForServer<CyphalBuffer8, Adapters...>::buffer_.pop();
+    if (transfer->metadata.transfer_kind != CyphalTransferKindRequest)
+    {
+        log(LOG_LEVEL_ERROR, "TaskRespondList: Expected Request transfer kind\r\n");
+        return false;
+    }
+
+    uavcan_file_List_Request_0_2 request_data;
+    size_t payload_size = transfer->payload_size;
+    int8_t deserialization_result = uavcan_file_List_Request_0_2_deserialize_(&request_data, static_cast<const uint8_t *>(transfer->payload), &payload_size);
+    if (deserialization_result < 0)
+    {
+        log(LOG_LEVEL_ERROR, "TaskRespondList: Deserialization Error\r\n");
+        return false;
+    }
+
+    uavcan_file_List_Response_0_2 response_data = {}; // Empty name: end of the listing
+
+    std::array<char, NAME_LENGTH> name = {};
+    if (lister_.list(request_data.entry_index, name))
+    {
+        const size_t length = strnlen(name.data(), NAME_LENGTH);
+        std::memcpy(response_data.entry_base_name.path.elements, name.data(), length);
+        response_data.entry_base_name.path.count = length;
+    }
+
+    constexpr size_t PAYLOAD_SIZE = uavcan_file_List_Response_0_2_SERIALIZATION_BUFFER_SIZE_BYTES_;
+    uint8_t payload[PAYLOAD_SIZE];
+    TaskForServer<CyphalBuffer8, Adapters...>::publish(PAYLOAD_SIZE, payload, &response_data,
+                                         reinterpret_cast<int8_t (*)(const void *const, uint8_t *const, size_t *const)>(uavcan_file_List_Response_0_2_serialize_),
+                                         transfer->metadata.port_id, transfer->metadata.remote_node_id, transfer->metadata.transfer_id);
+
+    log(LOG_LEVEL_DEBUG, "TaskRespondList: Sent entry %u, name length %zu\r\n", static_cast<unsigned>(request_data.entry_index), response_data.entry_base_name.path.count);
+
+    return true;
+}
+
+template <FileListConcept Lister, typename... Adapters>
+void TaskRespondList<Lister, Adapters...>::registerTask(RegistrationManager *manager, std::shared_ptr<Task> task)
+{
+    manager->server(uavcan_file_List_0_2_FIXED_PORT_ID_, task);
+}
+
+template <FileListConcept Lister, typename... Adapters>
+void TaskRespondList<Lister, Adapters...>::unregisterTask(RegistrationManager *manager, std::shared_ptr<Task> task)
+{
+    manager->unserver(uavcan_file_List_0_2_FIXED_PORT_ID_, task);
+}
+
+#endif // __TASKRESPONDLIST_HPP_
@@ -9,6 +9,7 @@
 
 #include "sgp4_tle.hpp"
 #include "SGP4.h"
+#include "SGP4Propagator.hpp"
 #include "au.hpp"
 
 #include "nunavut_assert.h"
@@ -24,16 +25,25 @@ class SGP4
 {
 public:
     SGP4() = delete;
-    SGP4(RTC_HandleTypeDef *hrtc, SGP4TwoLineElement tle = {}) : hrtc_(hrtc), tle_(tle) {}
+    SGP4(RTC_HandleTypeDef *hrtc, SGP4TwoLineElement tle = {}) : hrtc_(hrtc)
+    {
+        propagator_.setTLE(tle);
+    }
 
     void setSGP4TLE(const SGP4TwoLineElement &tle)
     {
-        tle_ = tle;
+        propagator_.setTLE(tle);
     }
 
     SGP4TwoLineElement getSGP4TLE() const
     {
-        return tle_;
+        return propagator_.getTLE();
+    }
+
+    // Initialised SGP4 state for the current TLE, for batch ephemeris generation
+    SGP4Propagator &propagator()
+    {
+        return propagator_;
     }
 
     bool predict_teme(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r, std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v, au::QuantityU64<au::Milli<au::Seconds>> &timestamp);
@@ -41,33 +51,16 @@ public:
 
 private:
     RTC_HandleTypeDef *hrtc_;
-    SGP4TwoLineElement tle_;
+    SGP4Propagator propagator_;
 };
 
 bool SGP4::predict_teme(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r, std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v, au::QuantityU64<au::Milli<au::Seconds>> &timestamp)
 {
-    if (tle_.satelliteNumber == 0)
+    if (!propagator_.hasTLE())
     {
         return false;
     }
 
-    elsetrec satrec{};
-    sprintf(satrec.satnum, "%05d", tle_.satelliteNumber);
-    satrec.epochyr = tle_.epochYear;
-    satrec.epochdays = tle_.epochDay;
-    satrec.ndot = tle_.meanMotionDerivative1;
-    satrec.nddot = tle_.meanMotionDerivative2;
-    satrec.bstar = tle_.bStarDrag;
-    satrec.ephtype = tle_.ephemerisType;
-    satrec.elnum = tle_.elementNumber;
-    satrec.inclo = tle_.inclination;
-    satrec.nodeo = tle_.rightAscensionAscendingNode;
-    satrec.ecco = tle_.eccentricity;
-    satrec.argpo = tle_.argumentOfPerigee;
-    satrec.mo = tle_.meanAnomaly;
-    satrec.no_kozai = tle_.meanMotion;
-    satrec.revnum = tle_.revolutionNumberAtEpoch;
-
     TimeUtils::RTCDateTimeSubseconds rtc;
     HAL_RTC_GetTime(hrtc_, &rtc.time, RTC_FORMAT_BIN);
     HAL_RTC_GetDate(hrtc_, &rtc.date, RTC_FORMAT_BIN);
@@ -82,14 +75,12 @@ bool SGP4::predict_teme(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>
         .millisecond = static_cast<uint16_t>(static_cast<uint64_t>(1000 * (rtc.time.SecondFraction - rtc.time.SubSeconds) / (rtc.time.SecondFraction + 1)))};
 
     std::chrono::system_clock::time_point now = TimeUtils::to_timepoint(dtc);
-    std::chrono::system_clock::time_point epoch = TimeUtils::to_timepoint(static_cast<uint16_t>(tle_.epochYear) + TimeUtils::EPOCH_YEAR, tle_.epochDay);
+    const SGP4TwoLineElement &tle = propagator_.getTLE();
+    std::chrono::system_clock::time_point epoch = TimeUtils::to_timepoint(static_cast<uint16_t>(tle.epochYear) + TimeUtils::EPOCH_YEAR, tle.epochDay);
     float fractional_minutes_since_epoch = TimeUtils::to_fractional_days(epoch, now) * 60.f * 24.f;
 
-    float r_[3], v_[3];
-    gravconsttype whichconst = wgs84; // Choose the gravity model (wgs72old, wgs72, wgs84)
-    char opsmode = 'i';               // Operation mode ('a' for AFSPC, 'i' for improved)
-    SGP4Funcs::satrec2rv(opsmode, whichconst, satrec);
-    bool result = SGP4Funcs::sgp4(satrec, fractional_minutes_since_epoch, r_, v_);
+    SGP4Propagator::Vector r_, v_;
+    bool result = propagator_.propagate(fractional_minutes_since_epoch, r_, v_);
 
     std::chrono::milliseconds milliseconds = TimeUtils::from_rtc(rtc, hrtc_->Init.SynchPrediv);
     timestamp = milliseconds;
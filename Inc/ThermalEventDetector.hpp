@@ -0,0 +1,180 @@
+#ifndef THERMAL_EVENT_DETECTOR_HPP
+#define THERMAL_EVENT_DETECTOR_HPP
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#include "MLX90640.hpp"
+#include "imagebuffer/metadata.hpp"
+
+// Frame selection hook of TaskMLX90640: tags the metadata of a complete frame and returns
+// whether the frame should be stored
+template <typename T>
+concept FrameSelectorConcept = requires(T t, const uint16_t *frame, ImageMetadata &meta) {
+    { t.select(frame, meta) } -> std::convertible_to<bool>;
+};
+
+// Stores every frame, leaving the metadata untouched
+struct KeepAllFrames
+{
+    bool select(const uint16_t *, ImageMetadata &) { return true; }
+};
+
+// Incremental analytics on raw MLX90640 frames (subpage 0 then subpage 1, as assembled by
+// readSubpageIntoFrame). Every pixel keeps an exponentially weighted mean and variance of its
+// raw ADC value, so a frame is scored against the scene's own noise in one pass:
+//
+//   hot spot   strongest positive deviation in sigma, counted only when at least
+//              minHotPixels pixels exceed hotSigma
+//   change     RMS difference to the previous frame over the RMS expected from noise alone,
+//              about 1 for a static scene
+//
+// The significance is the larger of the two. select() writes it to ImageMetadata and keeps a
+// frame when it reaches the threshold, or as a baseline every baselineEvery frames otherwise.
+class ThermalEventDetector
+{
+public:
+    static constexpr std::size_t WIDTH = 32;
+    static constexpr std::size_t HEIGHT = 24;
+    static constexpr std::size_t PIXELS = WIDTH * HEIGHT;
+
+    // ImageMetadata::significance unit
+    static constexpr float SIGNIFICANCE_SCALE = 100.0f;
+
+    struct Config
+    {
+        float alpha = 1.0f / 16.0f;  // weight of a new frame in the running statistics
+        float minVariance = 4.0f;    // counts^2, floor for pixels that have not seen noise yet
+        float hotSigma = 5.0f;       // deviation of a hot pixel
+        uint16_t minHotPixels = 2;   // fewer hot pixels is treated as noise
+        float threshold = 6.0f;      // significance for keeping a frame
+        uint32_t baselineEvery = 32; // keep at least one frame in this many
+        uint32_t warmupFrames = 8;   // frames scored as 0 while the statistics settle
+    };
+
+    struct Score
+    {
+        float significance;
+        float peakSigma;    // strongest positive deviation
+        float changeSigma;  // frame difference relative to noise
+        uint16_t hotPixels; // pixels above hotSigma
+        uint16_t peakPixel; // row-major index of the strongest deviation
+    };
+
+    ThermalEventDetector() = default;
+    explicit ThermalEventDetector(const Config &config) : config_(config) {}
+
+    // Scores the frame against the running statistics, then folds it into them
+    Score update(const uint16_t *frame)
+    {
+        Score score{};
+        const float alpha = config_.alpha;
+        const float hot2 = config_.hotSigma * config_.hotSigma;
+        float peak2 = 0.0f;
+        float change2 = 0.0f;
+        float noise2 = 0.0f;
+
+        for (std::size_t row = 0; row < HEIGHT; ++row)
+        {
+            // Same checkerboard selection as MLX90640ImageProcessor::demultiplexFrame
+            for (std::size_t col = 0; col < WIDTH; ++col)
+            {
+                const std::size_t i = row * WIDTH + col;
+                const int16_t raw = int16_t(frame[i + ((row + col) & 1u) * MLX90640_SUBPAGE_WORDS]);
+                const float x = float(raw);
+
+                if (frames_ == 0)
+                {
+                    mean_[i] = x;
+                    variance_[i] = config_.minVariance;
+                    previous_[i] = raw;
+                    continue;
+                }
+
+                const float d = x - mean_[i];
+                const float v = variance_[i] + config_.minVariance;
+                const float z2 = d * d / v;
+                if (d > 0.0f && z2 > hot2)
+                {
+                    ++score.hotPixels;
+                    if (z2 > peak2)
+                    {
+                        peak2 = z2;
+                        score.peakPixel = static_cast<uint16_t>(i);
+                    }
+                }
+
+                const float step = x - float(previous_[i]);
+                change2 += step * step;
+                noise2 += 2.0f * v;
+                previous_[i] = raw;
+
+                mean_[i] += alpha * d;
+                variance_[i] = (1.0f - alpha) * (variance_[i] + alpha * d * d);
+            }
+        }
+
+        if (frames_ > 0)
+        {
+            score.peakSigma = std::sqrt(peak2);
+            score.changeSigma = std::sqrt(change2 / noise2);
+        }
+        if (frames_ >= config_.warmupFrames)
+        {
+            const float hotSpot = score.hotPixels >= config_.minHotPixels ? score.peakSigma : 0.0f;
+            score.significance = hotSpot > score.changeSigma ? hotSpot : score.changeSigma;
+        }
+        ++frames_;
+        last_ = score;
+        return score;
+    }
+
+    // FrameSelectorConcept: scores the frame, tags meta.significance and decides whether to keep it
+    bool select(const uint16_t *frame, ImageMetadata &meta)
+    {
+        const Score score = update(frame);
+        const float scaled = score.significance * SIGNIFICANCE_SCALE;
+        meta.significance = scaled >= 65535.0f ? uint16_t(65535) : static_cast<uint16_t>(scaled + 0.5f);
+
+        const bool event = score.significance >= config_.threshold;
+        const bool baseline = sinceKept_ + 1 >= config_.baselineEvery || frames_ == 1;
+        if (event || baseline)
+        {
+            sinceKept_ = 0;
+            ++kept_;
+            return true;
+        }
+        ++sinceKept_;
+        return false;
+    }
+
+    // Forgets the scene, e.g. after the sensor was power cycled
+    void reset()
+    {
+        frames_ = 0;
+        sinceKept_ = 0;
+        kept_ = 0;
+        last_ = Score{};
+    }
+
+    const Score &lastScore() const { return last_; }
+    uint32_t frames() const { return frames_; }
+    uint32_t kept() const { return kept_; }
+    float mean(std::size_t pixel) const { return mean_[pixel]; }
+    float variance(std::size_t pixel) const { return variance_[pixel]; }
+
+private:
+    Config config_{};
+    std::array<float, PIXELS> mean_{};
+    std::array<float, PIXELS> variance_{};
+    std::array<int16_t, PIXELS> previous_{};
+    Score last_{};
+    uint32_t frames_ = 0;
+    uint32_t sinceKept_ = 0;
+    uint32_t kept_ = 0;
+};
+
+#endif // THERMAL_EVENT_DETECTOR_HPP
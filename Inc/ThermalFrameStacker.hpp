@@ -0,0 +1,240 @@
+#ifndef THERMAL_FRAME_STACKER_HPP
+#define THERMAL_FRAME_STACKER_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "ImageBufferConcept.hpp"
+
+// Temporal accumulator for MLX90640 temperature images. Frames taken while the spacecraft
+// drifts are registered to the attitude of the first frame of each product and drizzled into
+// an accumulator SCALE times finer than the sensor: every pixel is projected through the
+// relative rotation onto the output grid and deposited with bilinear weights. SCALE = 1 is an
+// aligned average, SCALE = 2 reconstructs 64x48 from the sub-pixel pointing jitter.
+//
+// Attitudes are the OrientationSolution::q quaternions (w, x, y, z) rotating body vectors
+// into NED. Camera axes: x along the columns, y along the rows, z out of the lens.
+template <std::size_t SCALE>
+class ThermalFrameStacker
+{
+public:
+    static_assert(SCALE >= 1, "SCALE is the output cells per sensor pixel along each axis");
+
+    static constexpr std::size_t WIDTH = 32;
+    static constexpr std::size_t HEIGHT = 24;
+    static constexpr std::size_t PIXELS = WIDTH * HEIGHT;
+    static constexpr std::size_t OUT_WIDTH = WIDTH * SCALE;
+    static constexpr std::size_t OUT_HEIGHT = HEIGHT * SCALE;
+    static constexpr std::size_t OUT_PIXELS = OUT_WIDTH * OUT_HEIGHT;
+
+    using Image = std::array<float, PIXELS>;       // MLX90640ImageProcessor::TempImage
+    using Product = std::array<float, OUT_PIXELS>; // NaN where no frame contributed
+    using Quaternion = std::array<float, 4>;       // w, x, y, z
+
+    // Cells with less total weight stay NaN: a sliver of a neighbouring pixel is no estimate
+    static constexpr float MIN_WEIGHT = 0.25f;
+
+    struct Config
+    {
+        float fov_x_deg = 55.0f;                      // MLX90640BAA, 110 for the BAB variant
+        float fov_y_deg = 35.0f;                      // 75 for the BAB variant
+        Quaternion camera_to_body = {1.f, 0.f, 0.f, 0.f};
+        uint32_t frames_per_product = 16;
+    };
+
+    explicit ThermalFrameStacker(const Config &config = Config{})
+        : config_(config)
+    {
+        constexpr float DEG_TO_RAD = 0.017453292519943295f;
+        fx_ = 0.5f * float(WIDTH) / std::tan(0.5f * config.fov_x_deg * DEG_TO_RAD);
+        fy_ = 0.5f * float(HEIGHT) / std::tan(0.5f * config.fov_y_deg * DEG_TO_RAD);
+        for (std::size_t col = 0; col < WIDTH; ++col)
+            rayX_[col] = (float(col) - CX) / fx_;
+        for (std::size_t row = 0; row < HEIGHT; ++row)
+            rayY_[row] = (float(row) - CY) / fy_;
+        mounting_ = rotation(config.camera_to_body);
+    }
+
+    // Adds a frame taken at attitude q. Returns true when it completes a product, which then
+    // stays readable through product() until the next add().
+    bool add(const Image &temps, const Quaternion &q)
+    {
+        const Matrix camera = multiply(rotation(q), mounting_);
+        if (frames_ == 0)
+        {
+            sum_.fill(0.0f);
+            weight_.fill(0.0f);
+            reference_ = camera;
+        }
+
+        // Rotation from this frame's camera axes into the reference camera axes
+        const Matrix r = multiplyTransposed(reference_, camera);
+
+        for (std::size_t row = 0; row < HEIGHT; ++row)
+        {
+            const float ry = rayY_[row];
+            const float bx = r[0][1] * ry + r[0][2];
+            const float by = r[1][1] * ry + r[1][2];
+            const float bz = r[2][1] * ry + r[2][2];
+            const float *line = &temps[row * WIDTH];
+
+            for (std::size_t col = 0; col < WIDTH; ++col)
+            {
+                const float t = line[col];
+                const float rx = rayX_[col];
+                const float pz = r[2][0] * rx + bz;
+                if (!(pz > 0.0f) || std::isnan(t))
+                    continue;
+
+                // Pixel position in the reference frame, then in output cells
+                const float inv = 1.0f / pz;
+                const float u = fx_ * (r[0][0] * rx + bx) * inv + CX;
+                const float v = fy_ * (r[1][0] * rx + by) * inv + CY;
+                deposit((u + 0.5f) * float(SCALE) - 0.5f, (v + 0.5f) * float(SCALE) - 0.5f, t);
+            }
+        }
+
+        if (++frames_ < config_.frames_per_product)
+            return false;
+
+        // Normalise in place: the accumulator becomes the product
+        covered_ = 0;
+        for (std::size_t i = 0; i < OUT_PIXELS; ++i)
+        {
+            if (weight_[i] >= MIN_WEIGHT)
+            {
+                sum_[i] /= weight_[i];
+                ++covered_;
+            }
+            else
+            {
+                sum_[i] = std::numeric_limits<float>::quiet_NaN();
+            }
+        }
+        frames_ = 0;
+        ++products_;
+        return true;
+    }
+
+    const Product &product() const { return sum_; }
+
+    // Fraction of output cells that received data in the last product
+    float coverage() const { return float(covered_) / float(OUT_PIXELS); }
+
+    uint32_t frames() const { return frames_; }
+    uint32_t products() const { return products_; }
+
+    // Drops a partially accumulated product, e.g. when the attitude solution was lost
+    void reset() { frames_ = 0; }
+
+    // Stores the last product as OUT_WIDTH x OUT_HEIGHT floats in degC
+    template <ImageBufferConcept BufferT>
+    ImageBufferError store(BufferT &buffer, uint64_t timestamp) const
+    {
+        ImageMetadata meta{};
+        meta.timestamp = timestamp;
+        meta.payload_size = static_cast<uint32_t>(sizeof(Product));
+        meta.dimensions = {static_cast<uint16_t>(OUT_WIDTH), static_cast<uint16_t>(OUT_HEIGHT), 1};
+        meta.producer = METADATA_PRODUCER::THERMAL;
+        meta.format = METADATA_FORMAT::UNKN;
+
+        ImageBufferError err = buffer.add_image(meta);
+        if (err != ImageBufferError::NO_ERROR)
+            return err;
+
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(sum_.data());
+        std::size_t remaining = sizeof(Product);
+        while (remaining > 0)
+        {
+            std::size_t chunk = remaining;
+            err = buffer.add_data_chunk(bytes, chunk);
+            if (err != ImageBufferError::NO_ERROR)
+                return err;
+            bytes += chunk;
+            remaining -= chunk;
+        }
+        return buffer.push_image();
+    }
+
+private:
+    using Matrix = std::array<std::array<float, 3>, 3>;
+
+    static constexpr float CX = 0.5f * float(WIDTH - 1);
+    static constexpr float CY = 0.5f * float(HEIGHT - 1);
+
+    static Matrix rotation(const Quaternion &q)
+    {
+        const float w = q[0], x = q[1], y = q[2], z = q[3];
+        return {{{1.f - 2.f * (y * y + z * z), 2.f * (x * y - w * z), 2.f * (x * z + w * y)},
+                 {2.f * (x * y + w * z), 1.f - 2.f * (x * x + z * z), 2.f * (y * z - w * x)},
+                 {2.f * (x * z - w * y), 2.f * (y * z + w * x), 1.f - 2.f * (x * x + y * y)}}};
+    }
+
+    static Matrix multiply(const Matrix &a, const Matrix &b)
+    {
+        Matrix m{};
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                m[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+        return m;
+    }
+
+    // a^T b
+    static Matrix multiplyTransposed(const Matrix &a, const Matrix &b)
+    {
+        Matrix m{};
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                m[i][j] = a[0][i] * b[0][j] + a[1][i] * b[1][j] + a[2][i] * b[2][j];
+        return m;
+    }
+
+    void deposit(float x, float y, float t)
+    {
+        const float xf = std::floor(x);
+        const float yf = std::floor(y);
+        if (xf < -1.0f || yf < -1.0f || xf >= float(OUT_WIDTH) || yf >= float(OUT_HEIGHT))
+            return;
+
+        const int x0 = static_cast<int>(xf);
+        const int y0 = static_cast<int>(yf);
+        const float ax = x - xf;
+        const float ay = y - yf;
+        const float w[2][2] = {{(1.f - ax) * (1.f - ay), ax * (1.f - ay)},
+                               {(1.f - ax) * ay, ax * ay}};
+
+        for (int dy = 0; dy < 2; ++dy)
+        {
+            const int yy = y0 + dy;
+            if (yy < 0 || yy >= int(OUT_HEIGHT))
+                continue;
+            for (int dx = 0; dx < 2; ++dx)
+            {
+                const int xx = x0 + dx;
+                if (xx < 0 || xx >= int(OUT_WIDTH))
+                    continue;
+                const std::size_t i = static_cast<std::size_t>(yy) * OUT_WIDTH + static_cast<std::size_t>(xx);
+                sum_[i] += w[dy][dx] * t;
+                weight_[i] += w[dy][dx];
+            }
+        }
+    }
+
+    Config config_;
+    float fx_ = 1.0f;
+    float fy_ = 1.0f;
+    std::array<float, WIDTH> rayX_{};
+    std::array<float, HEIGHT> rayY_{};
+    Matrix mounting_{};
+    Matrix reference_{};
+    Product sum_{};
+    std::array<float, OUT_PIXELS> weight_{};
+    uint32_t frames_ = 0;
+    uint32_t products_ = 0;
+    std::size_t covered_ = 0;
+};
+
+#endif // THERMAL_FRAME_STACKER_HPP
@@ -0,0 +1,372 @@
+#ifndef THUMBNAIL_CATALOGUE_HPP
+#define THUMBNAIL_CATALOGUE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "CameraDriver.hpp" // PixelFormat
+#include "ImageBufferConcept.hpp"
+#include "InputOutputStream.hpp" // NAME_LENGTH, formatValues
+#include "SampleLayout.hpp"
+
+// Thumbnails of the raw frames stored in an ImageBuffer, made at ingest so that the ground can
+// pick the frames worth downlinking for a few kilobytes:
+//
+//   - ThumbnailBuilder box-filters one channel of a frame while its payload streams past
+//   - ThumbnailImageBuffer wraps an ImageBuffer and feeds every raw frame added to it through a
+//     builder; the thumbnail is stored in the same buffer, as a record right after its frame, so
+//     the producers stay unchanged
+//   - ThumbnailCatalogue lists the thumbnail records of the buffer through uavcan.file.List
+//     (TaskRespondList) and reads them through uavcan.file.Read (TaskRespondRead)
+//
+// A thumbnail record is the ImageMetadata of its frame, with format THUMBNAIL, the thumbnail
+// dimensions and payload size, followed by the 8-bit grey pixels. The timestamp, producer and
+// significance stay those of the frame: they link the thumbnail to it.
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Box filter
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Shrinks a frame by the smallest square box that fits it into MAX_WIDTH x MAX_HEIGHT. Each
+// thumbnail pixel is the rounded mean of its box; the boxes at the right and bottom edges may
+// be partial. Holds one row of box sums and the thumbnail.
+template <size_t MAX_WIDTH, size_t MAX_HEIGHT>
+class ThumbnailBuilder
+{
+public:
+    static constexpr size_t MAX_BYTES = MAX_WIDTH * MAX_HEIGHT;
+
+    // Starts a frame; false for an empty layout
+    bool begin(const SampleLayout &layout)
+    {
+        layout_ = layout;
+        active_ = layout.width > 0 && layout.height > 0 && layout.stride > 0 &&
+                  layout.rowBytes >= (layout.width - 1) * layout.stride + 1;
+        if (!active_)
+            return false;
+
+        const size_t fx = (layout.width + MAX_WIDTH - 1) / MAX_WIDTH;
+        const size_t fy = (layout.height + MAX_HEIGHT - 1) / MAX_HEIGHT;
+        factor_ = fx > fy ? fx : fy;
+        width_ = (layout.width + factor_ - 1) / factor_;
+        height_ = (layout.height + factor_ - 1) / factor_;
+
+        sums_.fill(0);
+        skip_ = layout.offset;
+        x_ = 0;
+        y_ = 0;
+        return true;
+    }
+
+    // StripConsumerConcept: the payload in order, in chunks of any size
+    bool operator()(const uint8_t *data, size_t size)
+    {
+        while (active_ && size > 0 && y_ < layout_.height)
+        {
+            if (skip_ > 0)
+            {
+                const size_t n = size < skip_ ? size : skip_;
+                data += n;
+                size -= n;
+                skip_ -= n;
+                continue;
+            }
+
+            // data[0] is sample x_ of row y_
+            size_t samples = (size - 1) / layout_.stride + 1;
+            if (samples > layout_.width - x_)
+                samples = layout_.width - x_;
+            accumulate(data, samples);
+            x_ += samples;
+
+            if (x_ < layout_.width)
+            {
+                // The chunk ends between two samples of the row
+                skip_ = samples * layout_.stride - size;
+                break;
+            }
+
+            const size_t used = (samples - 1) * layout_.stride + 1;
+            data += used;
+            size -= used;
+            skip_ = layout_.rowBytes - ((layout_.width - 1) * layout_.stride + 1);
+            endRow();
+        }
+        return true;
+    }
+
+    // Every sample of the frame has been seen
+    bool complete() const { return active_ && y_ == layout_.height; }
+
+    size_t width() const { return width_; }
+    size_t height() const { return height_; }
+    size_t factor() const { return factor_; }
+    const uint8_t *pixels() const { return pixels_.data(); }
+
+private:
+    void accumulate(const uint8_t *data, size_t samples)
+    {
+        size_t column = x_ / factor_;
+        size_t inBox = x_ % factor_;
+        for (size_t i = 0; i < samples; ++i)
+        {
+            sums_[column] += data[i * layout_.stride];
+            if (++inBox == factor_)
+            {
+                inBox = 0;
+                ++column;
+            }
+        }
+    }
+
+    void endRow()
+    {
+        x_ = 0;
+        ++y_;
+        if (y_ % factor_ != 0 && y_ != layout_.height)
+            return;
+
+        const size_t row = (y_ - 1) / factor_;
+        const size_t rows = y_ - row * factor_;
+        uint8_t *out = &pixels_[row * width_];
+        for (size_t c = 0; c < width_; ++c)
+        {
+            const size_t columns = layout_.width - c * factor_ < factor_ ? layout_.width - c * factor_ : factor_;
+            const uint32_t count = static_cast<uint32_t>(columns * rows);
+            out[c] = static_cast<uint8_t>((sums_[c] + count / 2) / count);
+            sums_[c] = 0;
+        }
+    }
+
+    SampleLayout layout_{};
+    size_t factor_ = 1;
+    size_t width_ = 0;
+    size_t height_ = 0;
+    size_t skip_ = 0; // payload bytes before the next sample
+    size_t x_ = 0;
+    size_t y_ = 0;
+    bool active_ = false;
+    std::array<uint32_t, MAX_WIDTH> sums_{};
+    std::array<uint8_t, MAX_BYTES> pixels_{};
+};
+
+// Raw frames carry their size in the metadata: n1 x n2 pixels of n3 bytes, but not their pixel
+// format, which comes from the capture configuration. One byte per pixel is taken as grey; two
+// are thumbnailed on the luma of YUV422. RGB565 has no plain 8-bit channel and, like compressed
+// formats and frames without dimensions, gets no thumbnail.
+inline bool thumbnailLayout(const ImageMetadata &meta, PixelFormat pixelFormat, SampleLayout &layout)
+{
+    if (meta.format != METADATA_FORMAT::UNKN)
+        return false;
+
+    const size_t width = meta.dimensions.n1;
+    const size_t height = meta.dimensions.n2;
+    const size_t bytesPerPixel = meta.dimensions.n3;
+    if (width == 0 || height == 0 || width * height * bytesPerPixel > meta.payload_size)
+        return false;
+
+    if (bytesPerPixel == 1)
+        layout = SampleLayout::gray8(width, height);
+    else if (bytesPerPixel == 2 && pixelFormat == PixelFormat::YUV422)
+        layout = SampleLayout::yuv422Luma(width, height);
+    else
+        return false;
+    return true;
+}
+
+// The record stored for a thumbnail of width x height of the frame described by source;
+// version, metadata size and CRC are filled in by the buffer
+inline ImageMetadata thumbnailMetadata(const ImageMetadata &source, size_t width, size_t height)
+{
+    ImageMetadata meta = source;
+    meta.payload_size = static_cast<uint32_t>(width * height);
+    meta.dimensions = {static_cast<uint16_t>(width), static_cast<uint16_t>(height), 1};
+    meta.format = METADATA_FORMAT::THUMBNAIL;
+    meta.part = 0;
+    meta.part_flags = METADATA_PART_LAST;
+    return meta;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Catalogue
+// ─────────────────────────────────────────────────────────────────────────────
+
+// The THUMBNAIL records of a buffer, oldest first. Nothing is held here: a thumbnail is listed
+// for as long as its record is in the buffer, and goes when the consumer pops it after its
+// frame. Entries are named after the timestamp and producer of their frame, as 18 hex digits:
+// one less than formatValues, so that the name survives convertPath on its way back in a Read
+// request. Each call walks the entry headers from the oldest, which is cheap next to the
+// Cyphal round trip of a List or Read request.
+template <ImageBufferPeekConcept BufferT>
+class ThumbnailCatalogue
+{
+public:
+    explicit ThumbnailCatalogue(BufferT &buffer) : buffer_(buffer) {}
+
+    static std::array<char, NAME_LENGTH> nameOf(const ImageMetadata &meta)
+    {
+        std::array<char, NAME_LENGTH> name = formatValues(meta.timestamp, static_cast<uint8_t>(meta.producer));
+        name[16] = name[17];
+        name[17] = name[18];
+        name[18] = '\0';
+        return name;
+    }
+
+    size_t count()
+    {
+        size_t thumbnails = 0;
+        ImageMetadata meta{};
+        for (size_t i = 0; i < buffer_.count(); ++i)
+        {
+            if (thumbnailAt(i, meta))
+                ++thumbnails;
+        }
+        return thumbnails;
+    }
+
+    // FileListConcept, oldest first
+    bool list(size_t index, std::array<char, NAME_LENGTH> &name)
+    {
+        ImageMetadata meta{};
+        for (size_t i = 0; i < buffer_.count(); ++i)
+        {
+            if (thumbnailAt(i, meta) && index-- == 0)
+            {
+                name = nameOf(meta);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // FileAccessConcept: reads past the end return 0 bytes, an unknown name fails
+    bool read(const std::array<char, NAME_LENGTH> &path, size_t offset, uint8_t *buffer, size_t &size)
+    {
+        ImageMetadata meta{};
+        size_t entry = 0;
+        if (!find(path, entry, meta))
+        {
+            size = 0;
+            return false;
+        }
+
+        const size_t total = METADATA_SIZE + meta.payload_size;
+        size = offset < total ? (size < total - offset ? size : total - offset) : 0;
+
+        size_t done = 0;
+        if (offset < METADATA_SIZE && size > 0)
+        {
+            done = METADATA_SIZE - offset < size ? METADATA_SIZE - offset : size;
+            std::memcpy(buffer, reinterpret_cast<const uint8_t *>(&meta) + offset, done);
+        }
+        if (done < size)
+        {
+            size_t rest = size - done;
+            if (buffer_.peek_data(entry, offset + done - METADATA_SIZE, buffer + done, rest) != ImageBufferError::NO_ERROR ||
+                rest != size - done)
+            {
+                size = 0;
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    bool thumbnailAt(size_t index, ImageMetadata &meta)
+    {
+        return buffer_.peek_image(index, meta) == ImageBufferError::NO_ERROR && meta.format == METADATA_FORMAT::THUMBNAIL;
+    }
+
+    bool find(const std::array<char, NAME_LENGTH> &path, size_t &entry, ImageMetadata &meta)
+    {
+        // Newest first, should a frame ever be named twice
+        for (size_t i = buffer_.count(); i-- > 0;)
+        {
+            if (thumbnailAt(i, meta) && std::strncmp(nameOf(meta).data(), path.data(), NAME_LENGTH) == 0)
+            {
+                entry = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    BufferT &buffer_;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Ingest
+// ─────────────────────────────────────────────────────────────────────────────
+
+// ImageBuffer that thumbnails the raw frames written through it. The frame is stored unchanged;
+// once it has been pushed in full its thumbnail follows as a record of its own. Without room
+// for that record the frame is kept and the thumbnail dropped. pixelFormat is the format the
+// camera was configured with, and applies to the frames added after it is set.
+template <ImageBufferConcept BufferT, size_t MAX_WIDTH, size_t MAX_HEIGHT>
+class ThumbnailImageBuffer
+{
+public:
+    ThumbnailImageBuffer(BufferT &buffer, PixelFormat pixelFormat)
+        : buffer_(buffer), pixelFormat_(pixelFormat) {}
+
+    void setPixelFormat(PixelFormat pixelFormat) { pixelFormat_ = pixelFormat; }
+
+    bool is_empty() const { return buffer_.is_empty(); }
+    size_t count() const { return buffer_.count(); }
+    bool has_room_for(size_t size) const { return buffer_.has_room_for(size); }
+
+    ImageBufferError add_image(const ImageMetadata &meta)
+    {
+        const ImageBufferError err = buffer_.add_image(meta);
+        SampleLayout layout{};
+        building_ = err == ImageBufferError::NO_ERROR && thumbnailLayout(meta, pixelFormat_, layout) && builder_.begin(layout);
+        meta_ = meta;
+        return err;
+    }
+
+    ImageBufferError add_data_chunk(const uint8_t *data, size_t size)
+    {
+        const ImageBufferError err = buffer_.add_data_chunk(data, size);
+        if (err != ImageBufferError::NO_ERROR)
+            building_ = false;
+        else if (building_)
+            (void)builder_(data, size);
+        return err;
+    }
+
+    ImageBufferError push_image()
+    {
+        const ImageBufferError err = buffer_.push_image();
+        if (err == ImageBufferError::NO_ERROR && building_ && builder_.complete())
+            (void)addThumbnail();
+        building_ = false;
+        return err;
+    }
+
+    ImageBufferError get_image(ImageMetadata &meta) { return buffer_.get_image(meta); }
+    ImageBufferError get_data_chunk(uint8_t *data, size_t &size) { return buffer_.get_data_chunk(data, size); }
+    ImageBufferError pop_image() { return buffer_.pop_image(); }
+
+private:
+    ImageBufferError addThumbnail()
+    {
+        const ImageMetadata meta = thumbnailMetadata(meta_, builder_.width(), builder_.height());
+        ImageBufferError err = buffer_.add_image(meta);
+        if (err == ImageBufferError::NO_ERROR)
+            err = buffer_.add_data_chunk(builder_.pixels(), meta.payload_size);
+        if (err == ImageBufferError::NO_ERROR)
+            err = buffer_.push_image();
+        return err;
+    }
+
+    BufferT &buffer_;
+    ThumbnailBuilder<MAX_WIDTH, MAX_HEIGHT> builder_;
+    PixelFormat pixelFormat_;
+    ImageMetadata meta_{};
+    bool building_ = false;
+};
+
+#endif // THUMBNAIL_CATALOGUE_HPP
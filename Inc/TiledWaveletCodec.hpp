@@ -0,0 +1,549 @@
+#ifndef TILED_WAVELET_CODEC_HPP
+#define TILED_WAVELET_CODEC_HPP
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "BinaryRangeCoder.hpp"
+#include "ImageBufferConcept.hpp"
+#include "SampleLayout.hpp"
+#include "imagebuffer/accessor.hpp"
+
+// Progressive codec for raw camera frames, one 8-bit channel at a time.
+//
+// The frame is cut into TILE x TILE tiles, each transformed by LEVELS of the reversible 5/3
+// integer wavelet (JPEG 2000 lossless) and coded bit-plane by bit-plane with an adaptive binary
+// range coder. The bit-planes are grouped into LAYERS quality layers and every (layer, tile) is
+// a self-contained packet, stored as one ImageBuffer record. Records go out layer by layer:
+// whatever drains the ImageBuffer sends a preview of the whole frame first and refines it
+// afterwards. A decoder needs the layers of a tile in order, but the tiles are independent, so
+// an interrupted downlink or encoder resumes at the next packet.
+//
+// The encoder holds one tile: it reads the tile from its FrameSource, transforms it, and codes
+// only the planes of the current layer. Going layer-major costs one transform per layer and
+// tile, but keeps the RAM at one tile of coefficients plus one packet.
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Frame sources
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Reads count samples of row y starting at column x
+template <typename T>
+concept FrameSourceConcept = requires(T s, size_t x, size_t y, size_t count, uint8_t *out) {
+    { s.width() } -> std::convertible_to<size_t>;
+    { s.height() } -> std::convertible_to<size_t>;
+    { s.read(x, y, count, out) } -> std::convertible_to<bool>;
+};
+
+// Frame in addressable memory, e.g. RAM or memory-mapped OCTOSPI flash
+class MemoryFrameSource
+{
+public:
+    MemoryFrameSource(const uint8_t *frame, const SampleLayout &layout) : frame_(frame), layout_(layout) {}
+
+    size_t width() const { return layout_.width; }
+    size_t height() const { return layout_.height; }
+
+    bool read(size_t x, size_t y, size_t count, uint8_t *out) const
+    {
+        const uint8_t *p = frame_ + layout_.offset + y * layout_.rowBytes + x * layout_.stride;
+        for (size_t i = 0; i < count; ++i)
+            out[i] = p[i * layout_.stride];
+        return true;
+    }
+
+private:
+    const uint8_t *frame_;
+    SampleLayout layout_;
+};
+
+// Frame stored through a flash Accessor at a fixed address, read a row segment at a time
+template <Accessor AccessorT>
+class AccessorFrameSource
+{
+public:
+    AccessorFrameSource(AccessorT &accessor, size_t address, const SampleLayout &layout)
+        : accessor_(accessor), address_(address), layout_(layout) {}
+
+    size_t width() const { return layout_.width; }
+    size_t height() const { return layout_.height; }
+
+    bool read(size_t x, size_t y, size_t count, uint8_t *out)
+    {
+        constexpr size_t SCRATCH = 64;
+        uint8_t scratch[SCRATCH];
+        const size_t perRead = (SCRATCH - 1) / layout_.stride + 1;
+
+        size_t address = address_ + layout_.offset + y * layout_.rowBytes + x * layout_.stride;
+        while (count > 0)
+        {
+            const size_t n = count < perRead ? count : perRead;
+            const size_t bytes = (n - 1) * layout_.stride + 1;
+            if (accessor_.read(address, scratch, bytes) != AccessorError::NO_ERROR)
+                return false;
+            for (size_t i = 0; i < n; ++i)
+                out[i] = scratch[i * layout_.stride];
+            out += n;
+            count -= n;
+            address += n * layout_.stride;
+        }
+        return true;
+    }
+
+private:
+    AccessorT &accessor_;
+    size_t address_;
+    SampleLayout layout_;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Transform and bit-plane scan shared by encoder and decoder
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace tiled_wavelet
+{
+    // Packet header: tile log2, levels, layer, lowest plane, plane count, top plane, tile (LE)
+    constexpr size_t HEADER_BYTES = 8;
+
+    inline uint32_t magnitude(int32_t v) { return static_cast<uint32_t>(v < 0 ? -v : v); }
+
+    // Reversible 5/3 lifting over n (even) samples spaced by stride, symmetric extension.
+    // Lows end up in the first half, highs in the second.
+    inline void forward53(int32_t *x, size_t n, size_t stride, int32_t *tmp)
+    {
+        for (size_t i = 1; i < n; i += 2)
+        {
+            const int32_t right = i + 1 < n ? x[(i + 1) * stride] : x[(i - 1) * stride];
+            x[i * stride] -= (x[(i - 1) * stride] + right) >> 1;
+        }
+        for (size_t i = 0; i < n; i += 2)
+        {
+            const int32_t right = x[(i + 1) * stride];
+            const int32_t left = i > 0 ? x[(i - 1) * stride] : right;
+            x[i * stride] += (left + right + 2) >> 2;
+        }
+        const size_t half = n / 2;
+        for (size_t i = 0; i < half; ++i)
+        {
+            tmp[i] = x[2 * i * stride];
+            tmp[half + i] = x[(2 * i + 1) * stride];
+        }
+        for (size_t i = 0; i < n; ++i)
+            x[i * stride] = tmp[i];
+    }
+
+    inline void inverse53(int32_t *x, size_t n, size_t stride, int32_t *tmp)
+    {
+        const size_t half = n / 2;
+        for (size_t i = 0; i < half; ++i)
+        {
+            tmp[2 * i] = x[i * stride];
+            tmp[2 * i + 1] = x[(half + i) * stride];
+        }
+        for (size_t i = 0; i < n; i += 2)
+        {
+            const int32_t right = tmp[i + 1];
+            const int32_t left = i > 0 ? tmp[i - 1] : right;
+            tmp[i] -= (left + right + 2) >> 2;
+        }
+        for (size_t i = 1; i < n; i += 2)
+        {
+            const int32_t right = i + 1 < n ? tmp[i + 1] : tmp[i - 1];
+            tmp[i] += (tmp[i - 1] + right) >> 1;
+        }
+        for (size_t i = 0; i < n; ++i)
+            x[i * stride] = tmp[i];
+    }
+
+    template <size_t TILE, size_t LEVELS>
+    void forward(int32_t *coef, int32_t *tmp)
+    {
+        for (size_t level = 0; level < LEVELS; ++level)
+        {
+            const size_t n = TILE >> level;
+            for (size_t row = 0; row < n; ++row)
+                forward53(coef + row * TILE, n, 1, tmp);
+            for (size_t col = 0; col < n; ++col)
+                forward53(coef + col, n, TILE, tmp);
+        }
+    }
+
+    template <size_t TILE, size_t LEVELS>
+    void inverse(int32_t *coef, int32_t *tmp)
+    {
+        for (size_t level = LEVELS; level-- > 0;)
+        {
+            const size_t n = TILE >> level;
+            for (size_t col = 0; col < n; ++col)
+                inverse53(coef + col, n, TILE, tmp);
+            for (size_t row = 0; row < n; ++row)
+                inverse53(coef + row * TILE, n, 1, tmp);
+        }
+    }
+
+    // Subband rectangle and context class: 0 LL, 1 coarsest details, 2 middle, 3 finest
+    struct Band
+    {
+        size_t x0, y0, size;
+        size_t cls;
+    };
+
+    template <size_t TILE, size_t LEVELS>
+    constexpr std::array<Band, 1 + 3 * LEVELS> bands()
+    {
+        std::array<Band, 1 + 3 * LEVELS> b{};
+        const size_t ll = TILE >> LEVELS;
+        b[0] = {0, 0, ll, 0};
+        size_t i = 1;
+        for (size_t level = LEVELS; level >= 1; --level)
+        {
+            const size_t s = TILE >> level;
+            const size_t cls = level == LEVELS ? 1 : (level == 1 ? 3 : 2);
+            b[i++] = {s, 0, s, cls}; // HL
+            b[i++] = {0, s, s, cls}; // LH
+            b[i++] = {s, s, s, cls}; // HH
+        }
+        return b;
+    }
+
+    // Adaptive contexts, reset for every packet
+    struct Contexts
+    {
+        range_coder::Probability significance[4][3];
+        range_coder::Probability refinement[2];
+
+        Contexts()
+        {
+            for (auto &band : significance)
+                for (auto &p : band)
+                    p = range_coder::PROB_INIT;
+            refinement[0] = refinement[1] = range_coder::PROB_INIT;
+        }
+    };
+
+    // Visits the planes hi..lo of a tile in coding order. Code(index, plane, context) codes one
+    // coefficient; the context is chosen from the neighbours already coded in this plane.
+    template <size_t TILE, size_t LEVELS, typename Code>
+    void scanPlanes(const int32_t *coef, int hi, int lo, Code &&code)
+    {
+        static constexpr auto BANDS = bands<TILE, LEVELS>();
+        for (int plane = hi; plane >= lo; --plane)
+        {
+            const uint32_t p = static_cast<uint32_t>(plane);
+            for (const Band &band : BANDS)
+            {
+                for (size_t y = band.y0; y < band.y0 + band.size; ++y)
+                {
+                    for (size_t x = band.x0; x < band.x0 + band.size; ++x)
+                    {
+                        const size_t i = y * TILE + x;
+                        size_t neighbours = 0;
+                        if (x > band.x0 && (magnitude(coef[i - 1]) >> p) != 0)
+                            ++neighbours;
+                        if (y > band.y0 && (magnitude(coef[i - TILE]) >> p) != 0)
+                            ++neighbours;
+                        code(i, p, band.cls, neighbours);
+                    }
+                }
+            }
+        }
+    }
+
+} // namespace tiled_wavelet
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Encoder
+// ─────────────────────────────────────────────────────────────────────────────
+
+template <FrameSourceConcept SourceT, size_t TILE = 64, size_t LEVELS = 3, size_t LAYERS = 4>
+class TiledWaveletEncoder
+{
+public:
+    static_assert(TILE >= 8 && (TILE & (TILE - 1)) == 0, "TILE must be a power of two");
+    static_assert(LEVELS >= 1 && (TILE >> (LEVELS - 1)) >= 2, "too many levels for the tile");
+    static_assert(LAYERS >= 1, "at least one layer");
+
+    // Worst case of a packet: 16 bits per coefficient
+    static constexpr size_t PACKET_CAPACITY = tiled_wavelet::HEADER_BYTES + 2 * TILE * TILE;
+
+    struct Config
+    {
+        // Lowest bit-plane of each layer, decreasing. The last layer at plane 0 is lossless.
+        std::array<uint8_t, LAYERS> lastPlane = defaultPlanes();
+    };
+
+    explicit TiledWaveletEncoder(SourceT &source, const Config &config = Config{})
+        : source_(source), config_(config)
+    {
+        tilesX_ = (source_.width() + TILE - 1) / TILE;
+        tilesY_ = (source_.height() + TILE - 1) / TILE;
+    }
+
+    // Starts a frame at packet firstPacket, 0 or where an interrupted pass stopped. meta
+    // supplies timestamp, position, producer and the channel in dimensions.n3.
+    void begin(const ImageMetadata &meta, size_t firstPacket = 0)
+    {
+        meta_ = meta;
+        meta_.format = METADATA_FORMAT::TILED_WAVELET;
+        meta_.dimensions.n1 = static_cast<uint16_t>(source_.width());
+        meta_.dimensions.n2 = static_cast<uint16_t>(source_.height());
+        next_ = firstPacket;
+        loaded_ = SIZE_MAX;
+        bytes_ = 0;
+    }
+
+    // Encodes and stores the next packet
+    template <ImageBufferConcept BufferT>
+    ImageBufferError step(BufferT &buffer)
+    {
+        if (done())
+            return ImageBufferError::NO_ERROR;
+        if (packets() > 0xFFFF)
+            return ImageBufferError::OUT_OF_BOUNDS;
+
+        const size_t layer = next_ / tiles();
+        const size_t tile = next_ % tiles();
+        if (loaded_ != tile)
+        {
+            if (!loadTile(tile))
+                return ImageBufferError::READ_ERROR;
+            tiled_wavelet::forward<TILE, LEVELS>(coef_.data(), tmp_.data());
+            top_ = topPlane();
+            loaded_ = tile;
+        }
+
+        const size_t size = encodePacket(layer, tile);
+        if (size == 0)
+            return ImageBufferError::OUT_OF_BOUNDS;
+
+        ImageMetadata meta = meta_;
+        meta.payload_size = static_cast<uint32_t>(size);
+        meta.part = static_cast<uint16_t>(next_);
+        meta.part_flags = next_ + 1 == packets() ? METADATA_PART_LAST : 0;
+
+        ImageBufferError err = buffer.add_image(meta);
+        if (err == ImageBufferError::NO_ERROR)
+        {
+            size_t chunk = size;
+            err = buffer.add_data_chunk(packet_.data(), chunk);
+        }
+        if (err == ImageBufferError::NO_ERROR)
+            err = buffer.push_image();
+        if (err != ImageBufferError::NO_ERROR)
+            return err;
+
+        bytes_ += size;
+        ++next_;
+        return ImageBufferError::NO_ERROR;
+    }
+
+    bool done() const { return next_ >= packets(); }
+    size_t nextPacket() const { return next_; }
+    size_t packets() const { return tiles() * LAYERS; }
+    size_t tiles() const { return tilesX_ * tilesY_; }
+    size_t bytes() const { return bytes_; }
+
+private:
+    // ..., 6, 4, 2, 1, 0: fine steps near lossless, where each plane costs the most bytes, and
+    // a first layer down to plane 4 that already makes a usable preview
+    static constexpr std::array<uint8_t, LAYERS> defaultPlanes()
+    {
+        std::array<uint8_t, LAYERS> planes{};
+        for (size_t l = 0; l < LAYERS; ++l)
+        {
+            const size_t r = LAYERS - 1 - l;
+            planes[l] = static_cast<uint8_t>(r <= 2 ? r : 2 * (r - 1));
+        }
+        return planes;
+    }
+
+    // Level-shifted samples; the tile is padded by repeating the last column and row
+    bool loadTile(size_t tile)
+    {
+        const size_t x0 = (tile % tilesX_) * TILE;
+        const size_t y0 = (tile / tilesX_) * TILE;
+        const size_t w = source_.width() - x0 < TILE ? source_.width() - x0 : TILE;
+        const size_t h = source_.height() - y0 < TILE ? source_.height() - y0 : TILE;
+
+        std::array<uint8_t, TILE> row;
+        for (size_t y = 0; y < TILE; ++y)
+        {
+            int32_t *out = &coef_[y * TILE];
+            if (y < h)
+            {
+                if (!source_.read(x0, y0 + y, w, row.data()))
+                    return false;
+                for (size_t x = 0; x < TILE; ++x)
+                    out[x] = int32_t(row[x < w ? x : w - 1]) - 128;
+            }
+            else
+            {
+                std::memcpy(out, &coef_[(h - 1) * TILE], TILE * sizeof(int32_t));
+            }
+        }
+        return true;
+    }
+
+    int topPlane() const
+    {
+        uint32_t max = 0;
+        for (int32_t v : coef_)
+            max |= tiled_wavelet::magnitude(v);
+        int plane = 0;
+        while ((max >> (plane + 1)) != 0)
+            ++plane;
+        return plane;
+    }
+
+    size_t encodePacket(size_t layer, size_t tile)
+    {
+        const int lo = config_.lastPlane[layer];
+        const int above = layer == 0 ? top_ : config_.lastPlane[layer - 1] - 1;
+        const int hi = above < top_ ? above : top_;
+        const int planes = hi >= lo ? hi - lo + 1 : 0;
+
+        uint8_t *header = packet_.data();
+        header[0] = static_cast<uint8_t>(std::countr_zero(TILE));
+        header[1] = static_cast<uint8_t>(LEVELS);
+        header[2] = static_cast<uint8_t>(layer);
+        header[3] = static_cast<uint8_t>(lo);
+        header[4] = static_cast<uint8_t>(planes);
+        header[5] = static_cast<uint8_t>(top_);
+        header[6] = static_cast<uint8_t>(tile);
+        header[7] = static_cast<uint8_t>(tile >> 8);
+        if (planes == 0)
+            return tiled_wavelet::HEADER_BYTES;
+
+        range_coder::Encoder rc(packet_.data() + tiled_wavelet::HEADER_BYTES, PACKET_CAPACITY - tiled_wavelet::HEADER_BYTES);
+        tiled_wavelet::Contexts ctx;
+        tiled_wavelet::scanPlanes<TILE, LEVELS>(coef_.data(), hi, lo, [&](size_t i, uint32_t p, size_t cls, size_t neighbours) {
+            const uint32_t a = tiled_wavelet::magnitude(coef_[i]);
+            if ((a >> (p + 1)) != 0)
+            {
+                rc.encode(ctx.refinement[(a >> (p + 2)) != 0 ? 1 : 0], (a >> p) & 1u);
+            }
+            else
+            {
+                const uint32_t significant = (a >> p) & 1u;
+                rc.encode(ctx.significance[cls][neighbours], significant);
+                if (significant)
+                    rc.encodeDirect(coef_[i] < 0 ? 1u : 0u);
+            }
+        });
+        const size_t size = rc.finish();
+        return size == 0 ? 0 : tiled_wavelet::HEADER_BYTES + size;
+    }
+
+    SourceT &source_;
+    Config config_;
+    ImageMetadata meta_{};
+    size_t tilesX_ = 0;
+    size_t tilesY_ = 0;
+    size_t next_ = 0;
+    size_t loaded_ = SIZE_MAX;
+    size_t bytes_ = 0;
+    int top_ = 0;
+    std::array<int32_t, TILE * TILE> coef_{};
+    std::array<int32_t, TILE> tmp_{};
+    std::array<uint8_t, PACKET_CAPACITY> packet_{};
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Decoder, for the ground segment and the tests: holds the whole frame
+// ─────────────────────────────────────────────────────────────────────────────
+
+template <size_t TILE = 64, size_t LEVELS = 3>
+class TiledWaveletDecoder
+{
+public:
+    TiledWaveletDecoder(size_t width, size_t height)
+        : width_(width), height_(height),
+          tilesX_((width + TILE - 1) / TILE), tilesY_((height + TILE - 1) / TILE),
+          coef_(tilesX_ * tilesY_ * TILE * TILE, 0),
+          layers_(tilesX_ * tilesY_, 0),
+          lowest_(tilesX_ * tilesY_, 0xFF) {}
+
+    // Adds a packet; returns false if it is malformed or the tile misses an earlier layer
+    bool addPacket(const uint8_t *data, size_t size)
+    {
+        if (size < tiled_wavelet::HEADER_BYTES || data[0] != std::countr_zero(TILE) || data[1] != LEVELS)
+            return false;
+        const size_t layer = data[2];
+        const int lo = data[3];
+        const int planes = data[4];
+        const size_t tile = size_t(data[6]) | (size_t(data[7]) << 8);
+        if (tile >= layers_.size() || layer != layers_[tile])
+            return false;
+
+        ++layers_[tile];
+        lowest_[tile] = static_cast<uint8_t>(lo);
+        if (planes == 0)
+            return true;
+
+        int32_t *coef = &coef_[tile * TILE * TILE];
+        range_coder::Decoder rc(data + tiled_wavelet::HEADER_BYTES, size - tiled_wavelet::HEADER_BYTES);
+        tiled_wavelet::Contexts ctx;
+        tiled_wavelet::scanPlanes<TILE, LEVELS>(coef, lo + planes - 1, lo, [&](size_t i, uint32_t p, size_t cls, size_t neighbours) {
+            const uint32_t a = tiled_wavelet::magnitude(coef[i]);
+            if ((a >> (p + 1)) != 0)
+            {
+                if (rc.decode(ctx.refinement[(a >> (p + 2)) != 0 ? 1 : 0]))
+                    coef[i] += coef[i] < 0 ? -int32_t(1u << p) : int32_t(1u << p);
+            }
+            else if (rc.decode(ctx.significance[cls][neighbours]))
+            {
+                coef[i] = rc.decodeDirect() ? -int32_t(1u << p) : int32_t(1u << p);
+            }
+        });
+        return !rc.overrun();
+    }
+
+    // Layers received for a tile
+    uint8_t layers(size_t tile) const { return layers_[tile]; }
+
+    // Reconstruction from what has arrived; tiles without data are mid-grey
+    std::vector<uint8_t> image() const
+    {
+        std::vector<uint8_t> out(width_ * height_, 128);
+        std::array<int32_t, TILE * TILE> work;
+        std::array<int32_t, TILE> tmp;
+
+        for (size_t tile = 0; tile < layers_.size(); ++tile)
+        {
+            if (lowest_[tile] == 0xFF)
+                continue;
+            // Coefficients known down to plane lo sit in the middle of their interval
+            const int32_t *coef = &coef_[tile * TILE * TILE];
+            const int32_t mid = lowest_[tile] > 0 ? int32_t(1u << (lowest_[tile] - 1)) : 0;
+            for (size_t i = 0; i < work.size(); ++i)
+                work[i] = coef[i] == 0 ? 0 : (coef[i] < 0 ? coef[i] - mid : coef[i] + mid);
+            tiled_wavelet::inverse<TILE, LEVELS>(work.data(), tmp.data());
+
+            const size_t x0 = (tile % tilesX_) * TILE;
+            const size_t y0 = (tile / tilesX_) * TILE;
+            for (size_t y = 0; y < TILE && y0 + y < height_; ++y)
+            {
+                for (size_t x = 0; x < TILE && x0 + x < width_; ++x)
+                {
+                    const int32_t v = work[y * TILE + x] + 128;
+                    out[(y0 + y) * width_ + x0 + x] = static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+                }
+            }
+        }
+        return out;
+    }
+
+private:
+    size_t width_, height_;
+    size_t tilesX_, tilesY_;
+    std::vector<int32_t> coef_;
+    std::vector<uint8_t> layers_;
+    std::vector<uint8_t> lowest_;
+};
+
+#endif // TILED_WAVELET_CODEC_HPP
@@ -172,14 +172,15 @@ public:
     explicit SCCB_Register_Transport(Bus& bus)
         : bus_(bus) {}
 
+    // len > 1 is a sequential write, for sensors that auto-increment the register address
     bool write_reg(uint16_t reg, const uint8_t* data, uint16_t len) const
     {
-        if (len != 1) return false;
+        if (len == 0) return false;
 
         SCCB_Core::start(bus_);
         SCCB_Core::write_byte(bus_, Config::address << 1); // write
         write_reg_addr(reg);
-        SCCB_Core::write_byte(bus_, *data);
+        SCCB_Core::write_bytes(bus_, data, len);
         SCCB_Core::stop(bus_);
         return true;
     }
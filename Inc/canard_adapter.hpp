@@ -42,7 +42,7 @@ struct CanardAdapter
     static constexpr uint8_t SUBSCRIPTIONS = 32;
     CanardInstance ins;
     CanardTxQueue que;
-    BoxSet<CanardRxSubscription, SUBSCRIPTIONS> subscriptions;
+    BoxSet<CanardRxSubscription, SUBSCRIPTIONS, PortIdKey> subscriptions;
 };
 
 template <>
@@ -99,18 +99,14 @@ public:
     {
         CanardRxSubscription stub = {};
         stub.port_id = port_id;
-        CanardRxSubscription *subscription = adapter_->subscriptions.find_or_create(stub, [](const CanardRxSubscription &a, const CanardRxSubscription &b)
-                                                                                    { return a.port_id == b.port_id; });
+        CanardRxSubscription *subscription = adapter_->subscriptions.find_or_create_by_key(stub);
         return canardRxSubscribe(&adapter_->ins, static_cast<CanardTransferKind>(transfer_kind), port_id, extent, transfer_id_timeout_usec, subscription);
     }
 
     int8_t cyphalRxUnsubscribe(const CyphalTransferKind transfer_kind,
                                const CyphalPortID port_id)
     {
-        CanardRxSubscription stub = {};
-        stub.port_id = port_id;
-        CanardRxSubscription *subscription = adapter_->subscriptions.find(stub, [](const CanardRxSubscription &a, const CanardRxSubscription &b)
-                                                                          { return a.port_id == b.port_id; });
+        CanardRxSubscription *subscription = adapter_->subscriptions.find_by_key(port_id);
         auto result = canardRxUnsubscribe(&adapter_->ins, static_cast<CanardTransferKind>(transfer_kind), port_id);
         if (subscription)
             adapter_->subscriptions.remove(subscription);
@@ -3,7 +3,9 @@
 
 #include <cmath>
 #include <array>
+#include <cstdint>
 #include <numbers>
+#include <span>
 #include "au.hpp"
 
 namespace coordinate_transformations
@@ -81,6 +83,50 @@ namespace coordinate_transformations
     struct PolarMotion { float x, y; };
     PolarMotion polarmMJD2000(float jd2000, float pm[3][3]);
 
+    // TEME to ECEF rotation for a stream of epochs, given in milliseconds since the TimeUtils
+    // epoch (2000-01-01 00:00). GMST is anchored in double precision once per bucket and then
+    // advanced linearly at the sidereal rate, the polar motion matrix is kept per bucket, and the
+    // combined matrix is applied to any number of vectors. This avoids the float jd2000 of
+    // temeToecef, which quantises GMST to about a minute in the 2020s.
+    class TemeToEcefRotation
+    {
+    public:
+        using Vector = std::array<float, 3>;
+
+        static constexpr uint64_t BUCKET_MS = 86400000;          // polar motion and GMST anchor refresh
+        static constexpr double EARTH_RATE_RAD_PER_MS = 7.2921158553e-8; // 1.00273790935 * 2 pi / 86400 s
+
+        TemeToEcefRotation() = default;
+
+        // Moves the rotation to a new epoch; within the current bucket this costs one sin/cos pair
+        void update(uint64_t ms_since_epoch);
+
+        Vector apply(const Vector &teme) const;
+        void apply(std::span<const Vector> teme, std::span<Vector> ecef) const;
+
+        // Rotates one vector per epoch for epochs start, start + step, ..., advancing the GMST
+        // rotation by angle addition instead of evaluating sin/cos per sample
+        void applySeries(uint64_t start_ms, uint32_t step_ms, std::span<const Vector> teme, std::span<Vector> ecef);
+
+        std::array<au::QuantityF<au::Kilo<au::MetersInEcefFrame>>, 3> operator()(const std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &teme) const;
+        std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInEcefFrame>>, 3> operator()(const std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &teme) const;
+
+        float gmst() const { return gmst_; }
+        uint64_t epoch() const { return current_ms_; }
+
+    private:
+        void anchor(uint64_t ms_since_epoch);
+        void assemble(float cos_gmst, float sin_gmst);
+
+        uint64_t anchor_ms_ = 0;
+        uint64_t current_ms_ = 0;
+        bool anchored_ = false;
+        double gmst_anchor_ = 0.0;
+        float gmst_ = 0.0f;
+        float pm_[3][3] = {};
+        float matrix_[3][3] = {};
+    };
+
 } /* namespace coordinate_transformations */
 
 #endif // COORDINATE_TRANSFORMATIONS_HPP
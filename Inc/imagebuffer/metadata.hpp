@@ -22,6 +22,9 @@ enum class METADATA_PRODUCER : uint8_t
 enum class METADATA_FORMAT : uint16_t
 {
     MX2F = 1,
+    JPEG = 2,   // baseline JPEG, possibly split in parts at restart markers
+    TILED_WAVELET = 3, // TiledWaveletEncoder packets, one per part
+    THUMBNAIL = 4, // 8-bit grey box-filtered preview of a raw frame
     UNKN = 0xFFFF,
 };
 
@@ -50,7 +53,10 @@ struct ImageMetadata
     METADATA_FORMAT format;   // payload record format
     METADATA_PRODUCER producer;// payload producer identity
 
-    uint8_t  reserved[8];     // reserved for future expansion
+    uint16_t significance;    // event score in 1/100 sigma, 0 = not scored
+    uint16_t part;            // index of this record in a payload split over several, 0 = first
+    uint8_t  part_flags;      // METADATA_PART_* bits
+    uint8_t  reserved[3];     // reserved for future expansion
 
     crc_t    meta_crc;        // CRC over all previous fields
 };
@@ -70,11 +76,19 @@ static_assert(
         sizeof(Dimensions) + // dimensions
         sizeof(METADATA_FORMAT) + // format
         sizeof(METADATA_PRODUCER)  + // producer
-        sizeof(uint8_t) * 8 +// reserved
+        sizeof(uint16_t) +   // significance
+        sizeof(uint16_t) +   // part
+        sizeof(uint8_t) +    // part_flags
+        sizeof(uint8_t) * 3 +// reserved
         sizeof(crc_t),       // meta_crc
     "Unexpected ImageMetadata size"
 );
 
+// ImageMetadata::part_flags
+constexpr uint8_t METADATA_PART_LAST      = 0x01; // final record of the payload
+constexpr uint8_t METADATA_PART_UNALIGNED = 0x02; // the next part does not start at a restart marker
+constexpr uint8_t METADATA_PART_TRUNCATED = 0x04; // the source ended before the payload was complete
+
 // Convenience constants
 constexpr size_t METADATA_SIZE = sizeof(ImageMetadata);
 constexpr size_t METADATA_SIZE_WO_CRC = offsetof(ImageMetadata, meta_crc);
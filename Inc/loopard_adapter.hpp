@@ -24,7 +24,7 @@ struct LoopardAdapter
     static constexpr uint8_t SUBSCRIPTIONS = 32;
     static constexpr size_t BUFFER = 32;
     CircularBuffer<CyphalTransfer, BUFFER> buffer;
-    BoxSet<uint8_t, SUBSCRIPTIONS> subscriptions;
+    BoxSet<uint8_t, SUBSCRIPTIONS, IdentityKey> subscriptions;
     CyphalNodeID node_id = CYPHAL_NODE_ID_UNSET;
 
     LoopardMemoryAllocate memory_allocate;
@@ -75,16 +75,14 @@ public:
                              const size_t /*t extent*/,
                              const CyphalMicrosecond /*transfer_id_timeout_usec*/)
     {
-        adapter_->subscriptions.find_or_create(static_cast<uint8_t>(port_id), [](const uint8_t &a, const uint8_t &b)
-                                               { return a == b; });
+        adapter_->subscriptions.find_or_create_by_key(static_cast<uint8_t>(port_id));
         return 1;
     }
 
     int8_t cyphalRxUnsubscribe(const CyphalTransferKind /*transfer_kind*/,
                                const CyphalPortID port_id)
     {
-        uint8_t *subscription = adapter_->subscriptions.find(static_cast<uint8_t>(port_id), [](const uint8_t &a, const uint8_t &b)
-                                                             { return a == b; });
+        uint8_t *subscription = adapter_->subscriptions.find_by_key(static_cast<uint8_t>(port_id));
         if (subscription)
             adapter_->subscriptions.remove(subscription);
         return 1;
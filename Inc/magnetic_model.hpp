@@ -48,12 +48,13 @@ namespace magnetic_model
 
     constexpr float epsilon = 1e-6f;
 
+    // Epoch of the bundled IGRF-14 and WMM2025 coefficients; g_dot / h_dot apply from here
+    constexpr int MODEL_EPOCH_YEAR = 2025;
+
     // Function to calculate the magnetic field components
     template <size_t NMAX>
     MagneticField calculateMagneticField(float latitude_deg, float longitude_deg, float radius_m, int year, const std::array<GaussCoefficient, (NMAX + 1) * (NMAX + 2) / 2 - 1> &coefficients)
     {
-        const int irgf_year = 2025; // Base year for coefficients
-
         float latitude_rad = latitude_deg * DEG_TO_RAD;
         float longitude_rad = longitude_deg * DEG_TO_RAD;
 
@@ -66,46 +67,53 @@ namespace magnetic_model
         std::array<float, NTERMS> dP_vector{};
 
         (void)wmm_model::MAG_PcupLow<NMAX, NTERMS>(P_vector, dP_vector, sin_latitude);
-        float X = 0.0f, Y = 0.0f, Z = 0.0f;
 
-        for (size_t i = 0; i < coefficients.size(); ++i)
+        // cos(m * longitude) and sin(m * longitude) by the angle addition recurrence
+        std::array<float, NMAX + 1> cos_m_longitude{};
+        std::array<float, NMAX + 1> sin_m_longitude{};
+        cos_m_longitude[0] = 1.0f;
+        sin_m_longitude[0] = 0.0f;
+        cos_m_longitude[1] = cosf(longitude_rad);
+        sin_m_longitude[1] = sinf(longitude_rad);
+        for (size_t m = 2; m <= NMAX; ++m)
         {
-            const GaussCoefficient coeff = coefficients[i];
-            float P = P_vector[i + 1];
-            float dP = dP_vector[i + 1];
+            cos_m_longitude[m] = cos_m_longitude[m - 1] * cos_m_longitude[1] - sin_m_longitude[m - 1] * sin_m_longitude[1];
+            sin_m_longitude[m] = sin_m_longitude[m - 1] * cos_m_longitude[1] + cos_m_longitude[m - 1] * sin_m_longitude[1];
+        }
 
-            int n = coeff.n;
-            int m = coeff.m;
-            float g = coeff.g;
-            float h = coeff.h;
+        // Radial distance factor (R_EARTH / r)^(n + 2) by repeated multiplication
+        const float ratio = R_EARTH / radius_m;
+        std::array<float, NMAX + 1> radial{};
+        radial[0] = ratio * ratio;
+        for (size_t n = 1; n <= NMAX; ++n)
+            radial[n] = radial[n - 1] * ratio;
 
-            float cos_m_longitude = cosf(static_cast<float>(m) * longitude_rad);
-            float sin_m_longitude = sinf(static_cast<float>(m) * longitude_rad);
+        // Secular variation: coefficients are linear in time around the model epoch
+        const float time_diff = static_cast<float>(year - MODEL_EPOCH_YEAR);
+
+        float X = 0.0f, Y = 0.0f, Z = 0.0f;
+
+        for (size_t i = 0; i < coefficients.size(); ++i)
+        {
+            const GaussCoefficient &coeff = coefficients[i];
+            const float P = P_vector[i + 1];
+            const float dP = dP_vector[i + 1];
 
-            // Time adjustment (linear interpolation)
-            float time_diff = (float)(year - irgf_year); // Example: Adjust based on the file
-            (void)time_diff;
-            // g += coeff.g_dot * time_diff;
-            // h += coeff.h_dot * time_diff;
+            const size_t n = static_cast<size_t>(coeff.n);
+            const size_t m = static_cast<size_t>(coeff.m);
+            const float g = coeff.g + coeff.g_dot * time_diff;
+            const float h = coeff.h + coeff.h_dot * time_diff;
 
-            // Radial distance factor
-            float ratio = R_EARTH / radius_m;
-            float power = static_cast<float>(n + 2);
-            float term = powf(ratio, power);
+            const float term = radial[n];
+            const float g_cos_h_sin = g * cos_m_longitude[m] + h * sin_m_longitude[m];
 
             // Calculate X, Y, and Z components
-            if (m == 0)
-            {
-                X += term * g * cos_m_longitude * dP;
-                Z += term * static_cast<float>(n + 1) * g * cos_m_longitude * P;
-            }
-            else
-            {
-                X += term * (g * cos_m_longitude + h * sin_m_longitude) * dP;
-                Y += term * static_cast<float>(m) * (g * sin_m_longitude - h * cos_m_longitude) * P / cos_latitude;
-                Z += term * static_cast<float>(n + 1) * (g * cos_m_longitude + h * sin_m_longitude) * P;
-            }
+            X += term * g_cos_h_sin * dP;
+            Z += term * static_cast<float>(n + 1) * g_cos_h_sin * P;
+            if (m != 0)
+                Y += term * static_cast<float>(m) * (g * sin_m_longitude[m] - h * cos_m_longitude[m]) * P;
         }
+        Y /= cos_latitude;
 
         MagneticField result;
         result.X = -X;
@@ -13,6 +13,7 @@ extern "C" {
 
 //--- DCMI Defines ---
 #define DCMI_MODE_CONTINUOUS      0x00000000U  // Example: Continuous capture mode
+#define DCMI_MODE_SNAPSHOT        0x00000002U  // Single frame, capture stops at VSYNC
 #define DCMI_SYNCHRO_HARDWARE     0x00000001U  // Example: Hardware synchronization
 
 //--- DCMI Structures ---
@@ -35,7 +36,10 @@ typedef struct {
     uint32_t ExtendedDataMode;    // Example: Extended Data Mode
 } DCMI_InitTypeDef;
 
-typedef struct {
+typedef struct __DCMI_HandleTypeDef DCMI_HandleTypeDef;
+typedef void (*pDCMI_CallbackTypeDef)(DCMI_HandleTypeDef *hdcmi);
+
+struct __DCMI_HandleTypeDef {
     void *Instance;               // DCMI peripheral instance (e.g., DCMI)
     DCMI_InitTypeDef Init;          // DCMI initialization structure
     HAL_LockTypeDef Lock;           // If you need to mock locking
@@ -44,7 +48,19 @@ typedef struct {
     uint8_t *pFrameBuffer;          // Pointer to frame buffer (added for testing)
     uint32_t FrameWidth;            // Frame width (added for testing)
     uint32_t FrameHeight;           // Frame height (added for testing)
-} DCMI_HandleTypeDef;
+
+    // Circular DMA simulation (added for testing): the DMA target is split in two halves that
+    // the mock fills from the source frame one per mock_dcmi_dma_step
+    uint32_t *pDmaBuffer;           // DMA target, DmaLength words
+    uint32_t DmaLength;             // words, both halves
+    uint32_t DmaPosition;           // next word the DMA writes
+    const uint8_t *pSource;         // frame streamed by the simulated sensor
+    uint32_t SourceSize;            // bytes
+    uint32_t SourceOffset;          // bytes already transferred
+    pDCMI_CallbackTypeDef XferHalfCpltCallback; // first half filled
+    pDCMI_CallbackTypeDef XferCpltCallback;     // second half filled, DMA wrapped
+    pDCMI_CallbackTypeDef FrameEventCallback;   // end of frame (VSYNC)
+};
 
 //--- DCMI Mock Function Prototypes ---
 HAL_StatusTypeDef HAL_DCMI_Init(DCMI_HandleTypeDef *hdcmi);
@@ -54,10 +70,25 @@ HAL_StatusTypeDef HAL_DCMI_Stop(DCMI_HandleTypeDef *hdcmi);
 HAL_DCMI_StateTypeDef HAL_DCMI_GetState(DCMI_HandleTypeDef *hdcmi);
 uint32_t HAL_DCMI_GetError(DCMI_HandleTypeDef *hdcmi); //return ErrorCode
 
+// Circular DMA of Length words into pData (pointer instead of the target's uint32_t address)
+HAL_StatusTypeDef HAL_DCMI_Start_DMA(DCMI_HandleTypeDef *hdcmi, uint32_t DCMI_Mode, uint32_t *pData, uint32_t Length);
+
 //--- DCMI Access/Helper Function Prototypes ---
 void set_dcmi_frame_buffer(DCMI_HandleTypeDef *hdcmi, uint8_t *buffer, uint32_t width, uint32_t height);
 uint8_t* get_dcmi_frame_buffer(DCMI_HandleTypeDef *hdcmi); // Added getter
 
+// Strip streaming simulation
+void set_dcmi_stream_source(DCMI_HandleTypeDef *hdcmi, const uint8_t *frame, uint32_t bytes);
+void set_dcmi_stream_callbacks(DCMI_HandleTypeDef *hdcmi,
+                               pDCMI_CallbackTypeDef half,
+                               pDCMI_CallbackTypeDef complete,
+                               pDCMI_CallbackTypeDef frame);
+// Transfers up to the next half buffer of the source and raises the matching callback, then the
+// frame event once the source is exhausted. Returns false when the frame has ended.
+bool mock_dcmi_dma_step(DCMI_HandleTypeDef *hdcmi);
+// Words left before the DMA wraps, as read from CNDTR
+uint32_t mock_dcmi_dma_remaining(DCMI_HandleTypeDef *hdcmi);
+
 #ifdef __cplusplus
 }
 #endif
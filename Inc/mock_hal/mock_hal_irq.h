@@ -120,6 +120,18 @@ typedef enum
 void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
 void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
 
+//--- Mock Helpers ---
+// Interrupt context emulation: code under test asks get_isr_context() where the target reads IPSR
+void set_isr_context(bool in_isr);
+bool get_isr_context(void);
+
+// Per-IRQ masking statistics, masked time is measured on the host monotonic clock
+bool get_irq_enabled(IRQn_Type IRQn);
+uint32_t get_irq_disable_count(IRQn_Type IRQn);
+uint64_t get_irq_max_masked_ns(IRQn_Type IRQn);
+uint64_t get_irq_total_masked_ns(IRQn_Type IRQn);
+void clear_irq_statistics(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,7 +19,7 @@ struct SerardAdapter
     struct SerardReassembler reass;
     SerardTxEmit emitter;
     void *user_reference;
-    BoxSet<SerardRxSubscription, SUBSCRIPTIONS> subscriptions;
+    BoxSet<SerardRxSubscription, SUBSCRIPTIONS, PortIdKey> subscriptions;
 };
 
 inline SerardNodeID cyphalNodeIdToSerard(const CyphalNodeID node_id) { return node_id == CYPHAL_NODE_ID_UNSET ? SERARD_NODE_ID_UNSET : static_cast<SerardNodeID>(node_id); }
@@ -143,18 +143,14 @@ public:
     {
         SerardRxSubscription stub{};
         stub.port_id = port_id;
-        SerardRxSubscription *subscription = adapter_->subscriptions.find_or_create(stub, [port_id](const SerardRxSubscription &a, const SerardRxSubscription &b)
-                                                                                    { return a.port_id == b.port_id; });
+        SerardRxSubscription *subscription = adapter_->subscriptions.find_or_create_by_key(stub);
         return serardRxSubscribe(&adapter_->ins, static_cast<SerardTransferKind>(transfer_kind), port_id, extent, transfer_id_timeout_usec, subscription);
     }
 
     int8_t cyphalRxUnsubscribe(const CyphalTransferKind transfer_kind,
                                const CyphalPortID port_id)
     {
-        SerardRxSubscription stub{};
-        stub.port_id = port_id;
-        auto it = adapter_->subscriptions.find(stub, [port_id](const SerardRxSubscription &a, const SerardRxSubscription &b)
-                                               { return a.port_id == b.port_id; });
+        auto it = adapter_->subscriptions.find_by_key(port_id);
         auto result = serardRxUnsubscribe(&adapter_->ins, static_cast<SerardTransferKind>(transfer_kind), port_id);
         if (it)
             adapter_->subscriptions.remove(it);
@@ -18,7 +18,7 @@ struct UdpardAdapter
     struct UdpardTx ins;
     UdpardRxMemoryResources memory_resources;
     void *user_transfer_reference;
-    BoxSet<UdpardPortSubscription, SUBSCRIPTIONS> subscriptions;
+    BoxSet<UdpardPortSubscription, SUBSCRIPTIONS, PortIdKey> subscriptions;
 };
 
 struct UdpardHeader
@@ -102,8 +102,7 @@ public:
                              const CyphalMicrosecond /*transfer_id_timeout_usec*/)
     {
         UdpardPortSubscription stub = {port_id, {}};
-        UdpardPortSubscription *subscription = adapter_->subscriptions.find_or_create(stub, [](const UdpardPortSubscription &a, const UdpardPortSubscription &b)
-                                                                                      { return a.port_id == b.port_id; });
+        UdpardPortSubscription *subscription = adapter_->subscriptions.find_or_create_by_key(stub);
         if (!subscription)
             return -4;
         int_fast8_t result = udpardRxSubscriptionInit(&subscription->subscription, port_id, extent, adapter_->memory_resources);
@@ -113,9 +112,7 @@ public:
     int8_t cyphalRxUnsubscribe(const CyphalTransferKind /*transfer_kind*/,
                                const CyphalPortID port_id)
     {
-        UdpardPortSubscription stub = {port_id, {}};
-        UdpardPortSubscription *subscription = adapter_->subscriptions.find_or_create(stub, [](const UdpardPortSubscription &a, const UdpardPortSubscription &b)
-                                                                                      { return a.port_id == b.port_id; });
+        UdpardPortSubscription *subscription = adapter_->subscriptions.find_by_key(port_id);
         if (!subscription)
             return 0;
 
@@ -127,9 +124,7 @@ public:
     int32_t cyphalRxReceive(size_t *frame_size, const uint8_t *const frame, CyphalTransfer *out_transfer)
     {
         const UdpardHeader *header = reinterpret_cast<const UdpardHeader *>(frame);
-        struct UdpardPortSubscription stub = {header->data_specifier_snm, {}};
-        UdpardPortSubscription *subpair = adapter_->subscriptions.find(stub, [](const UdpardPortSubscription &a, const UdpardPortSubscription &b)
-                                                                       { return a.port_id == b.port_id; });
+        UdpardPortSubscription *subpair = adapter_->subscriptions.find_by_key(header->data_specifier_snm);
         UdpardMutablePayload payload = {*frame_size, static_cast<void *>(const_cast<uint8_t *>(frame))};
 
         UdpardRxTransfer udpard_transfer;
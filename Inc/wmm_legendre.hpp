@@ -11,6 +11,58 @@
 namespace wmm_model
 {
 
+    /* Square root usable in constant expressions (Newton iteration in double) */
+    constexpr double constexprSqrt(double value)
+    {
+        if (value <= 0.0)
+            return 0.0;
+        double root = value > 1.0 ? value : 1.0;
+        for (int i = 0; i < 64; ++i)
+        {
+            const double next = 0.5 * (root + value / root);
+            if (next == root)
+                break;
+            root = next;
+        }
+        return root;
+    }
+
+    /* Degree-only constants of MAG_PcupLow, indexed like Pcup (n * (n + 1) / 2 + m):
+       the ratio between the Schmidt quasi-normalized and the Gauss-normalized functions,
+       and the recursion factor ((n-1)^2 - m^2) / ((2n-1)(2n-3)). Neither depends on the
+       latitude, so they are evaluated once by the compiler instead of on every call. */
+    template <uint16_t nMax>
+    struct LegendreTables
+    {
+        static constexpr size_t N = (nMax + 1) * (nMax + 2) / 2;
+
+        std::array<float, N> schmidtQuasiNorm{};
+        std::array<float, N> recursion{};
+
+        constexpr LegendreTables()
+        {
+            std::array<double, N> norm{};
+            norm[0] = 1.0;
+            for (size_t n = 1; n <= nMax; n++)
+            {
+                const size_t index = n * (n + 1) / 2;
+                const size_t index1 = (n - 1) * n / 2;
+                /* for m = 0 */
+                norm[index] = norm[index1] * static_cast<double>(2 * n - 1) / static_cast<double>(n);
+
+                for (size_t m = 1; m <= n; m++)
+                    norm[index + m] = norm[index + m - 1] *
+                                      constexprSqrt(static_cast<double>((n - m + 1) * (m == 1 ? 2 : 1)) / static_cast<double>(n + m));
+
+                for (size_t m = 0; m + 2 <= n; m++)
+                    recursion[index + m] = static_cast<float>(static_cast<double>((n - 1) * (n - 1) - m * m) /
+                                                              static_cast<double>((2 * n - 1) * (2 * n - 3)));
+            }
+            for (size_t i = 0; i < N; i++)
+                schmidtQuasiNorm[i] = static_cast<float>(norm[i]);
+        }
+    };
+
     template <uint16_t nMax, size_t N>
     bool MAG_PcupLow(std::array<float, N> &Pcup, std::array<float, N> &dPcup, float x);
 
@@ -45,14 +97,13 @@ namespace wmm_model
      */
     {
         static_assert((nMax + 1) * (nMax + 2) / 2 == N);
+        static constexpr LegendreTables<nMax> tables{};
         uint16_t n, m, index, index1, index2;
-        float k, z;
+        float z;
         Pcup[0] = 1.0f;
         dPcup[0] = 0.0f;
         z = sqrtf((1.0f - x) * (1.0f + x));
 
-        std::array<float, N + 1> schmidtQuasiNorm;
-
         /*	 First,	Compute the Gauss-normalized associated Legendre  functions*/
 
         for (n = 1; n <= nMax; n++)
@@ -84,46 +135,24 @@ namespace wmm_model
                     }
                     else
                     {
-                        k = (float)(((n - 1) * (n - 1)) - (m * m)) / (float)((2 * n - 1) * (2 * n - 3));
+                        const float k = tables.recursion[index];
                         Pcup[index] = x * Pcup[index2] - k * Pcup[index1];
                         dPcup[index] = x * dPcup[index2] - z * Pcup[index2] - k * dPcup[index1];
                     }
                 }
             }
         }
-        /* Compute the ration between the the Schmidt quasi-normalized associated Legendre
-         * functions and the Gauss-normalized version. */
-
-        schmidtQuasiNorm[0] = 1.0;
-        for (n = 1; n <= nMax; n++)
-        {
-            index = static_cast<uint16_t>((n * (n + 1) / 2));
-            index1 = static_cast<uint16_t>((n - 1) * n / 2);
-            /* for m = 0 */
-            schmidtQuasiNorm[index] = schmidtQuasiNorm[index1] * (float)(2 * n - 1) / (float)n;
-
-            for (m = 1; m <= n; m++)
-            {
-                index = static_cast<uint16_t>((n * (n + 1) / 2 + m));
-                index1 = static_cast<uint16_t>((n * (n + 1) / 2 + m - 1));
-                schmidtQuasiNorm[index] = schmidtQuasiNorm[index1] * sqrtf((float)((n - m + 1) * (m == 1 ? 2 : 1)) / (float)(n + m));
-            }
-        }
 
         /* Converts the  Gauss-normalized associated Legendre
-                  functions to the Schmidt quasi-normalized version using pre-computed
-                  relation stored in the variable schmidtQuasiNorm */
+                  functions to the Schmidt quasi-normalized version using the
+                  relation pre-computed at compile time in LegendreTables */
 
-        for (n = 1; n <= nMax; n++)
+        for (index = 1; index < N; index++)
         {
-            for (m = 0; m <= n; m++)
-            {
-                index = static_cast<uint16_t>((n * (n + 1) / 2 + m));
-                Pcup[index] = Pcup[index] * schmidtQuasiNorm[index];
-                dPcup[index] = -dPcup[index] * schmidtQuasiNorm[index];
-                /* The sign is changed since the new WMM routines use derivative with respect to latitude
-                insted of co-latitude */
-            }
+            Pcup[index] = Pcup[index] * tables.schmidtQuasiNorm[index];
+            dPcup[index] = -dPcup[index] * tables.schmidtQuasiNorm[index];
+            /* The sign is changed since the new WMM routines use derivative with respect to latitude
+            insted of co-latitude */
         }
 
         return true;
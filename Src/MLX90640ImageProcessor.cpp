@@ -1,27 +1,26 @@
 #include "MLX90640ImageProcessor.hpp"
 #include "MLX90640Calibration.hpp"
+#include "FloatVector.hpp"
 #include <cmath>
 
 bool MLX90640ImageProcessor::demultiplexFrame(const uint16_t* frame,
                                               RawImage& outRaw) const
 {
-    const uint16_t* sub0 = frame;
-    const uint16_t* sub1 = frame + 834;
+    constexpr std::size_t SUBPAGE_WORDS = 834;
 
     for (std::size_t row = 0; row < HEIGHT; ++row)
     {
-        for (std::size_t col = 0; col < WIDTH; ++col)
-        {
-            std::size_t idx = row * WIDTH + col;
-
-            // Checkerboard pattern:
-            // subpage 0: (row + col) even
-            // subpage 1: (row + col) odd
-            bool useSub1 = ((row + col) & 1u) != 0;
+        // Checkerboard pattern: subpage 0 where (row + col) is even, subpage 1 where it is odd.
+        // Each row starts in the subpage of its parity and alternates, so the source is
+        // selected by offsetting into the second subpage instead of branching per pixel.
+        const uint16_t* evenColumns = frame + (row & 1u) * SUBPAGE_WORDS;
+        const uint16_t* oddColumns = frame + ((row + 1u) & 1u) * SUBPAGE_WORDS;
+        const std::size_t base = row * WIDTH;
 
-            outRaw[idx] = useSub1
-                ? int16_t(sub1[idx])
-                : int16_t(sub0[idx]);
+        for (std::size_t col = 0; col < WIDTH; col += 2)
+        {
+            outRaw[base + col] = int16_t(evenColumns[base + col]);
+            outRaw[base + col + 1] = int16_t(oddColumns[base + col + 1]);
         }
     }
 
@@ -67,3 +66,195 @@ bool MLX90640ImageProcessor::computeTemperatures(const RawImage& raw,
 
     return true;
 }
+
+namespace
+{
+    using float_vector::broadcast;
+    using float_vector::Float4;
+    using float_vector::Int4;
+    using float_vector::LANES;
+    using float_vector::fourthRoot;
+    using float_vector::load;
+    using float_vector::store;
+
+    static_assert(MLX90640ImageProcessor::PIXELS % (2 * LANES) == 0 && LANES == 4, "the pixel loops have no scalar tail");
+}
+
+const MLX90640ImageProcessor::PixelCoefficients& MLX90640ImageProcessor::coefficients(float Ta)
+{
+    const int32_t bucket = static_cast<int32_t>(std::lround(Ta / TA_BUCKET));
+    if (coefficientsValid_ && bucket == bucket_)
+    {
+        return coefficients_;
+    }
+
+    const auto& P = MLX90640_CAL;
+    const float taBucket = static_cast<float>(bucket) * TA_BUCKET;
+    const float Vdd = (taBucket - 25.0f) * P.KvPTAT + float(P.vdd25);
+    const float alphaTa = 1.0f + P.KsTa * (taBucket - 25.0f);
+
+    for (std::size_t i = 0; i < PIXELS; ++i)
+    {
+        const float alphaComp = float(P.alpha[i]) * alphaTa;
+        coefficients_.offset[i] = float(P.offset[i]);
+        coefficients_.scale[i] = 1.0f / (float(P.gainEE) *
+                                         (1.0f + float(P.kta[i]) * (taBucket - 25.0f)) *
+                                         (1.0f + float(P.kv[i]) * (Vdd - 3.3f)));
+        coefficients_.alphaTgc[i] = alphaComp * (1.0f - P.tgc);
+        coefficients_.sxFactor[i] = P.ksTo[1] * std::sqrt(std::sqrt(alphaComp));
+    }
+
+    bucket_ = bucket;
+    coefficientsValid_ = true;
+    ++coefficientUpdates_;
+    return coefficients_;
+}
+
+bool MLX90640ImageProcessor::computeTemperaturesFast(const RawImage& raw,
+                                                     TempImage& outTemps,
+                                                     float Ta)
+{
+    const PixelCoefficients& C = coefficients(Ta);
+
+    for (std::size_t i = 0; i < PIXELS; i += LANES)
+    {
+        const Float4 rawPix = {float(raw[i]), float(raw[i + 1]), float(raw[i + 2]), float(raw[i + 3])};
+
+        // Offset, gain, Kta and Kv compensation in one multiply
+        const Float4 kvComp = (rawPix - load(&C.offset[i])) * load(&C.scale[i]);
+
+        // Sx = ksTo[1] (alphaComp kvComp)^(1/4)
+        const Float4 Sx = load(&C.sxFactor[i]) * fourthRoot(kvComp);
+
+        store(&outTemps[i], fourthRoot(kvComp / (load(&C.alphaTgc[i]) + Sx)));
+    }
+
+    return true;
+}
+
+namespace
+{
+    constexpr std::size_t AUX_TA_VBE    = 768;
+    constexpr std::size_t AUX_CP_SP0    = 776;
+    constexpr std::size_t AUX_GAIN      = 778;
+    constexpr std::size_t AUX_TA_PTAT   = 800;
+    constexpr std::size_t AUX_CP_SP1    = 808;
+    constexpr std::size_t AUX_VDD_PIX   = 810;
+    constexpr std::size_t CONTROL_WORD  = 832;
+    constexpr std::size_t SUBPAGE_WORD  = 833;
+
+    constexpr float KELVIN = 273.15f;
+
+    inline float signedWord(uint16_t word)
+    {
+        return float(int16_t(word));
+    }
+}
+
+float MLX90640ImageProcessor::supplyVoltage(const uint16_t* subpage)
+{
+    const auto& P = MLX90640_CAL;
+    const int resolutionRAM = (subpage[CONTROL_WORD] >> 10) & 0x3;
+    const float resolutionCorrection = pow2f(P.resolutionEE) / pow2f(resolutionRAM);
+    return (resolutionCorrection * signedWord(subpage[AUX_VDD_PIX]) - float(P.vdd25)) / float(P.kVdd) + 3.3f;
+}
+
+float MLX90640ImageProcessor::ambientTemperature(const uint16_t* subpage)
+{
+    const auto& P = MLX90640_CAL;
+    const float vdd = supplyVoltage(subpage);
+    const float ptat = signedWord(subpage[AUX_TA_PTAT]);
+    const float ptatArt = ptat / (ptat * P.alphaPTAT + signedWord(subpage[AUX_TA_VBE])) * pow2f(18);
+    return (ptatArt / (1.0f + P.KvPTAT * (vdd - 3.3f)) - float(P.vPTAT25)) / P.KtPTAT + 25.0f;
+}
+
+bool MLX90640ImageProcessor::computeObjectTemperatures(const uint16_t* subpage,
+                                                       TempImage& outTemps,
+                                                       float emissivity,
+                                                       float tr) const
+{
+    const auto& P = MLX90640_CAL;
+    const auto& K = MLX90640_PIXEL_CONSTANTS;
+
+    const uint16_t subPage = subpage[SUBPAGE_WORD];
+    if (subPage > 1 || emissivity <= 0.0f)
+    {
+        return false;
+    }
+
+    // ---- Per-subpage terms ----
+    const float vdd = supplyVoltage(subpage);
+    const float ta = ambientTemperature(subpage);
+    const float dTa = ta - 25.0f;
+    const float dVdd = vdd - 3.3f;
+
+    float ta4 = ta + KELVIN;
+    ta4 = ta4 * ta4;
+    ta4 = ta4 * ta4;
+    float tr4 = tr + KELVIN;
+    tr4 = tr4 * tr4;
+    tr4 = tr4 * tr4;
+    const float taTr = tr4 - (tr4 - ta4) / emissivity;
+
+    const float gain = float(P.gainEE) / signedWord(subpage[AUX_GAIN]);
+
+    const uint8_t mode = uint8_t((subpage[CONTROL_WORD] & 0x1000u) >> 5);
+    const bool calibratedMode = mode == P.calibrationModeEE;
+    const float cpDrift = (1.0f + P.cpKta * dTa) * (1.0f + P.cpKv * dVdd);
+    const float cpOffset = subPage == 0 || calibratedMode ? float(P.cpOffset[subPage])
+                                                          : float(P.cpOffset[1]) + P.ilChessC[0];
+    const float irDataCP = signedWord(subpage[subPage == 0 ? AUX_CP_SP0 : AUX_CP_SP1]) * gain - cpOffset * cpDrift;
+
+    const float tgcCP = P.tgc * irDataCP;
+    const float inverseEmissivity = 1.0f / emissivity;
+    const float alphaTa = 1.0f + P.KsTa * dTa;
+    const float sxBase = 1.0f - P.ksTo[1] * KELVIN;
+    const float ilChess = calibratedMode ? 0.0f : 1.0f;
+
+    // ---- Pixels of this subpage, four per vector ----
+    const uint16_t* pixels = K.subpagePixels[mode == 0 ? 0 : 1][subPage];
+    for (std::size_t n = 0; n < PIXELS / 2; n += LANES)
+    {
+        // Gathered in registers; writing single lanes would round-trip through the stack
+        const uint16_t* pix = &pixels[n];
+        auto gather = [pix](const float* table)
+        {
+            return Float4{table[pix[0]], table[pix[1]], table[pix[2]], table[pix[3]]};
+        };
+        const Float4 raw = {signedWord(subpage[pix[0]]), signedWord(subpage[pix[1]]),
+                            signedWord(subpage[pix[2]]), signedWord(subpage[pix[3]])};
+        const Float4 offset = gather(K.offset);
+        const Float4 kta = gather(K.kta);
+        const Float4 kv = gather(K.kv);
+        const Float4 alpha = gather(K.alpha);
+        const Float4 correction = gather(K.ilChessCorrection);
+
+        Float4 irData = raw * gain - offset * (1.0f + kta * dTa) * (1.0f + kv * dVdd);
+        irData = (irData + ilChess * correction - tgcCP) * inverseEmissivity;
+
+        const Float4 alphaCompensated = alpha * alphaTa;
+        const Float4 Sx = P.ksTo[1] * fourthRoot(alphaCompensated * alphaCompensated * alphaCompensated *
+                                                 (irData + alphaCompensated * taTr));
+        const Float4 To = fourthRoot(irData / (alphaCompensated * sxBase + Sx) + taTr) - KELVIN;
+
+        // Extended temperature range: pick the ksTo segment the first estimate falls in
+        const Int4 above1 = To >= float(P.ct[1]);
+        const Int4 above2 = To >= float(P.ct[2]);
+        const Int4 above3 = To >= float(P.ct[3]);
+        auto segment = [&](float range0, float range1, float range2, float range3)
+        {
+            return above3 ? broadcast(range3) : above2 ? broadcast(range2) : above1 ? broadcast(range1) : broadcast(range0);
+        };
+        const Float4 alphaCorr = segment(K.alphaCorrR[0], K.alphaCorrR[1], K.alphaCorrR[2], K.alphaCorrR[3]);
+        const Float4 ksTo = segment(P.ksTo[0], P.ksTo[1], P.ksTo[2], P.ksTo[3]);
+        const Float4 ct = segment(float(P.ct[0]), float(P.ct[1]), float(P.ct[2]), float(P.ct[3]));
+
+        const Float4 result = fourthRoot(irData / (alphaCompensated * alphaCorr * (1.0f + ksTo * (To - ct))) + taTr) - KELVIN;
+        for (std::size_t lane = 0; lane < LANES; ++lane)
+        {
+            outTemps[pixels[n + lane]] = result[lane];
+        }
+    }
+
+    return true;
+}
@@ -1,4 +1,5 @@
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <iostream>
@@ -450,6 +451,125 @@ namespace coordinate_transformations
         };    
     }
 
+    // --- Cached TEME to ECEF rotation ---
 
+    void TemeToEcefRotation::anchor(uint64_t ms_since_epoch)
+    {
+        // Same GMST model as TimeUtils::gsTimeJ2000, evaluated in double at the anchor only
+        const double jd2000 = (static_cast<double>(ms_since_epoch) - 43200000.0) / 86400000.0;
+        const double midnight = std::floor(jd2000) + 0.5;
+        const double hours_since_midnight = (jd2000 - midnight) * 24.0;
+        const double centuries_since_epoch = jd2000 / 36525.0;
+        double gmst_hours = 6.697374558 + 0.06570982441908 * midnight + 1.00273790935 * hours_since_midnight + 0.000026 * centuries_since_epoch * centuries_since_epoch;
+        gmst_hours -= 24.0 * std::floor(gmst_hours / 24.0);
+
+        gmst_anchor_ = gmst_hours * 2.0 * std::numbers::pi / 24.0;
+        (void)polarmMJD2000(static_cast<float>(jd2000), pm_);
+        anchor_ms_ = ms_since_epoch;
+        anchored_ = true;
+    }
+
+    void TemeToEcefRotation::assemble(float cos_gmst, float sin_gmst)
+    {
+        // ECEF = PM^T * ST^T * TEME, as in teme2ecef
+        for (size_t i = 0; i < 3; ++i)
+        {
+            matrix_[i][0] = pm_[0][i] * cos_gmst - pm_[1][i] * sin_gmst;
+            matrix_[i][1] = pm_[0][i] * sin_gmst + pm_[1][i] * cos_gmst;
+            matrix_[i][2] = pm_[2][i];
+        }
+    }
+
+    void TemeToEcefRotation::update(uint64_t ms_since_epoch)
+    {
+        if (!anchored_ || ms_since_epoch < anchor_ms_ || ms_since_epoch - anchor_ms_ >= BUCKET_MS)
+        {
+            anchor(ms_since_epoch);
+        }
+        const double gmst = gmst_anchor_ + EARTH_RATE_RAD_PER_MS * static_cast<double>(ms_since_epoch - anchor_ms_);
+        gmst_ = static_cast<float>(gmst - 2.0 * std::numbers::pi * std::floor(gmst / (2.0 * std::numbers::pi)));
+        current_ms_ = ms_since_epoch;
+        assemble(cosf(gmst_), sinf(gmst_));
+    }
+
+    TemeToEcefRotation::Vector TemeToEcefRotation::apply(const Vector &teme) const
+    {
+        return {matrix_[0][0] * teme[0] + matrix_[0][1] * teme[1] + matrix_[0][2] * teme[2],
+                matrix_[1][0] * teme[0] + matrix_[1][1] * teme[1] + matrix_[1][2] * teme[2],
+                matrix_[2][0] * teme[0] + matrix_[2][1] * teme[1] + matrix_[2][2] * teme[2]};
+    }
+
+    void TemeToEcefRotation::apply(std::span<const Vector> teme, std::span<Vector> ecef) const
+    {
+        const size_t count = std::min(teme.size(), ecef.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+            ecef[i] = apply(teme[i]);
+        }
+    }
+
+    void TemeToEcefRotation::applySeries(uint64_t start_ms, uint32_t step_ms, std::span<const Vector> teme, std::span<Vector> ecef)
+    {
+        // Exact sin/cos every RESYNC samples keeps the recurrence on the unit circle
+        constexpr size_t RESYNC = 64;
+
+        const size_t count = std::min(teme.size(), ecef.size());
+        const float step_angle = static_cast<float>(EARTH_RATE_RAD_PER_MS * static_cast<double>(step_ms));
+        // 1 - cos(step) written as 2 sin^2(step / 2), cosf(step) rounds to within a few ulp of 1
+        const float half_step = sinf(0.5f * step_angle);
+        const float versine_step = 2.0f * half_step * half_step;
+        const float sin_step = sinf(step_angle);
+        float cos_gmst = 1.0f, sin_gmst = 0.0f;
+        bool recurred = false;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint64_t t_ms = start_ms + static_cast<uint64_t>(i) * step_ms;
+            if (i % RESYNC == 0 || t_ms - anchor_ms_ >= BUCKET_MS)
+            {
+                update(t_ms);
+                cos_gmst = cosf(gmst_);
+                sin_gmst = sinf(gmst_);
+                recurred = false;
+            }
+            else
+            {
+                const float c = cos_gmst - (versine_step * cos_gmst + sin_step * sin_gmst);
+                sin_gmst = sin_gmst - (versine_step * sin_gmst - sin_step * cos_gmst);
+                cos_gmst = c;
+                assemble(cos_gmst, sin_gmst);
+                current_ms_ = t_ms;
+                recurred = true;
+            }
+            ecef[i] = apply(teme[i]);
+        }
+
+        // The angle itself is only needed once the series has ended on a recurrence step
+        if (recurred)
+        {
+            const float gmst = atan2f(sin_gmst, cos_gmst);
+            gmst_ = gmst < 0.0f ? gmst + 2.0f * std::numbers::pi_v<float> : gmst;
+        }
+    }
+
+    std::array<au::QuantityF<au::Kilo<au::MetersInEcefFrame>>, 3> TemeToEcefRotation::operator()(const std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &teme) const
+    {
+        const Vector ecef = apply({teme[0].in(au::kilo(au::meters * au::temes)),
+                                   teme[1].in(au::kilo(au::meters * au::temes)),
+                                   teme[2].in(au::kilo(au::meters * au::temes))});
+        return {au::make_quantity<au::Kilo<au::MetersInEcefFrame>>(ecef[0]),
+                au::make_quantity<au::Kilo<au::MetersInEcefFrame>>(ecef[1]),
+                au::make_quantity<au::Kilo<au::MetersInEcefFrame>>(ecef[2])};
+    }
+
+    std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInEcefFrame>>, 3> TemeToEcefRotation::operator()(const std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &teme) const
+    {
+        const Vector ecef = apply({teme[0].in(au::kilo(au::meters * au::temes / au::seconds)),
+                                   teme[1].in(au::kilo(au::meters * au::temes / au::seconds)),
+                                   teme[2].in(au::kilo(au::meters * au::temes / au::seconds))});
+        return {au::make_quantity<au::Kilo<au::MetersPerSecondInEcefFrame>>(ecef[0]),
+                au::make_quantity<au::Kilo<au::MetersPerSecondInEcefFrame>>(ecef[1]),
+                au::make_quantity<au::Kilo<au::MetersPerSecondInEcefFrame>>(ecef[2])};
+    }
 
 } // namespace coordinate_transformations
@@ -37,6 +37,17 @@ HAL_StatusTypeDef HAL_DCMI_Start(DCMI_HandleTypeDef *hdcmi, uint32_t /*Mode*/, u
     return HAL_OK;
 }
 
+HAL_StatusTypeDef HAL_DCMI_Start_DMA(DCMI_HandleTypeDef *hdcmi, uint32_t /*DCMI_Mode*/, uint32_t *pData, uint32_t Length) {
+    if (hdcmi == NULL || pData == NULL || Length < 2 || (Length & 1U) != 0) return HAL_ERROR;
+
+    hdcmi->pDmaBuffer = pData;
+    hdcmi->DmaLength = Length;
+    hdcmi->DmaPosition = 0;
+    hdcmi->SourceOffset = 0;
+    hdcmi->State = HAL_DCMI_STATE_BUSY;
+    return HAL_OK;
+}
+
 HAL_StatusTypeDef HAL_DCMI_Stop(DCMI_HandleTypeDef *hdcmi) {
     if (hdcmi == NULL) return HAL_ERROR;
 
@@ -73,4 +84,59 @@ uint8_t* get_dcmi_frame_buffer(DCMI_HandleTypeDef *hdcmi) {
     return NULL;
 }
 
-#endif
\ No newline at end of file
+// Set the frame the simulated sensor streams through the circular DMA
+void set_dcmi_stream_source(DCMI_HandleTypeDef *hdcmi, const uint8_t *frame, uint32_t bytes) {
+    if (hdcmi != NULL) {
+        hdcmi->pSource = frame;
+        hdcmi->SourceSize = bytes;
+        hdcmi->SourceOffset = 0;
+    }
+}
+
+void set_dcmi_stream_callbacks(DCMI_HandleTypeDef *hdcmi,
+                               pDCMI_CallbackTypeDef half,
+                               pDCMI_CallbackTypeDef complete,
+                               pDCMI_CallbackTypeDef frame) {
+    if (hdcmi != NULL) {
+        hdcmi->XferHalfCpltCallback = half;
+        hdcmi->XferCpltCallback = complete;
+        hdcmi->FrameEventCallback = frame;
+    }
+}
+
+bool mock_dcmi_dma_step(DCMI_HandleTypeDef *hdcmi) {
+    if (hdcmi == NULL || hdcmi->pDmaBuffer == NULL || hdcmi->State != HAL_DCMI_STATE_BUSY) return false;
+
+    const uint32_t half = hdcmi->DmaLength / 2U;
+    const uint32_t left = hdcmi->SourceSize - hdcmi->SourceOffset;
+    if (left == 0U) {
+        // VSYNC after the last word
+        hdcmi->State = HAL_DCMI_STATE_READY;
+        if (hdcmi->FrameEventCallback != NULL) hdcmi->FrameEventCallback(hdcmi);
+        return false;
+    }
+
+    // Up to the end of the current half, whole words as the DCMI packs them
+    const uint32_t room = (half - hdcmi->DmaPosition % half) * 4U;
+    const uint32_t bytes = left < room ? left : room;
+    uint8_t *dst = (uint8_t *)(hdcmi->pDmaBuffer + hdcmi->DmaPosition);
+    memcpy(dst, hdcmi->pSource + hdcmi->SourceOffset, bytes);
+    if ((bytes & 3U) != 0U) memset(dst + bytes, 0, 4U - (bytes & 3U));
+    hdcmi->SourceOffset += bytes;
+    hdcmi->DmaPosition += (bytes + 3U) / 4U;
+
+    if (hdcmi->DmaPosition == half) {
+        if (hdcmi->XferHalfCpltCallback != NULL) hdcmi->XferHalfCpltCallback(hdcmi);
+    } else if (hdcmi->DmaPosition == hdcmi->DmaLength) {
+        hdcmi->DmaPosition = 0;
+        if (hdcmi->XferCpltCallback != NULL) hdcmi->XferCpltCallback(hdcmi);
+    }
+    return true;
+}
+
+uint32_t mock_dcmi_dma_remaining(DCMI_HandleTypeDef *hdcmi) {
+    if (hdcmi == NULL) return 0;
+    return hdcmi->DmaLength - hdcmi->DmaPosition;
+}
+
+#endif
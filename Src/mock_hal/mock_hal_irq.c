@@ -1,8 +1,107 @@
 #ifdef __x86_64__
 
 #include "mock_hal/mock_hal_irq.h"
+#include <string.h>
+#include <time.h>
 
-void HAL_NVIC_EnableIRQ(IRQn_Type /*IRQn*/) {}
-void HAL_NVIC_DisableIRQ(IRQn_Type /*IRQn*/) {}
+//------------------------------------------------------------------------------
+//  GLOBAL MOCKED VARIABLES - State
+//------------------------------------------------------------------------------
 
-#endif
\ No newline at end of file
+#define IRQ_OFFSET 16
+#define IRQ_COUNT 128
+
+typedef struct
+{
+    bool disabled;
+    uint32_t disable_count;
+    uint64_t masked_since_ns;
+    uint64_t max_masked_ns;
+    uint64_t total_masked_ns;
+} IrqState_t;
+
+static IrqState_t irq_state[IRQ_COUNT];
+static bool isr_context = false;
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static IrqState_t *irq_slot(IRQn_Type IRQn)
+{
+    int index = (int)IRQn + IRQ_OFFSET;
+    if (index < 0 || index >= IRQ_COUNT)
+        return NULL;
+    return &irq_state[index];
+}
+
+//------------------------------------------------------------------------------
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    IrqState_t *state = irq_slot(IRQn);
+    if (state == NULL || !state->disabled)
+        return;
+
+    uint64_t masked = monotonic_ns() - state->masked_since_ns;
+    state->total_masked_ns += masked;
+    if (masked > state->max_masked_ns)
+        state->max_masked_ns = masked;
+    state->disabled = false;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    IrqState_t *state = irq_slot(IRQn);
+    if (state == NULL || state->disabled)
+        return;
+
+    state->disabled = true;
+    state->disable_count++;
+    state->masked_since_ns = monotonic_ns();
+}
+
+void set_isr_context(bool in_isr)
+{
+    isr_context = in_isr;
+}
+
+bool get_isr_context(void)
+{
+    return isr_context;
+}
+
+bool get_irq_enabled(IRQn_Type IRQn)
+{
+    IrqState_t *state = irq_slot(IRQn);
+    return state == NULL || !state->disabled;
+}
+
+uint32_t get_irq_disable_count(IRQn_Type IRQn)
+{
+    IrqState_t *state = irq_slot(IRQn);
+    return (state == NULL) ? 0 : state->disable_count;
+}
+
+uint64_t get_irq_max_masked_ns(IRQn_Type IRQn)
+{
+    IrqState_t *state = irq_slot(IRQn);
+    return (state == NULL) ? 0 : state->max_masked_ns;
+}
+
+uint64_t get_irq_total_masked_ns(IRQn_Type IRQn)
+{
+    IrqState_t *state = irq_slot(IRQn);
+    return (state == NULL) ? 0 : state->total_masked_ns;
+}
+
+void clear_irq_statistics(void)
+{
+    memset(irq_state, 0, sizeof(irq_state));
+    isr_context = false;
+}
+
+#endif
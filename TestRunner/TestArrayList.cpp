@@ -564,4 +564,84 @@ TEST_CASE("ArrayList removeIf - Complex Predicate") {
 	list.removeIf([](const MyStruct& s) { return s.id > 2; });
 	CHECK(list.size() == 1);
 	CHECK(list[0].id == 2);
-}
\ No newline at end of file
+}
+TEST_CASE("ArrayList removeUnordered") {
+    ArrayList<int, 5> list;
+    for (int i = 1; i <= 5; ++i) list.push(i);
+
+    list.removeUnordered(1); // last element fills the hole
+    CHECK(list.size() == 4);
+    CHECK(list[0] == 1);
+    CHECK(list[1] == 5);
+    CHECK(list[2] == 3);
+    CHECK(list[3] == 4);
+
+    list.removeUnordered(3); // removing the last element
+    CHECK(list.size() == 3);
+    CHECK(list[2] == 3);
+
+    list.removeUnordered(10); // out of bounds is ignored
+    CHECK(list.size() == 3);
+}
+
+TEST_CASE("ArrayList removeIfUnordered") {
+    ArrayList<int, 8> list;
+    for (int i = 1; i <= 8; ++i) list.push(i);
+
+    list.removeIfUnordered([](int x) { return x % 2 == 0; });
+    CHECK(list.size() == 4);
+    CHECK_FALSE(list.containsIf([](int x) { return x % 2 == 0; }));
+    for (int odd : {1, 3, 5, 7})
+        CHECK(list.containsIf([odd](int x) { return x == odd; }));
+
+    list.removeIfUnordered([](int) { return true; });
+    CHECK(list.empty());
+}
+
+#include <memory>
+
+TEST_CASE("ArrayList removal releases owned resources") {
+    auto resource = std::make_shared<int>(42);
+    ArrayList<std::shared_ptr<int>, 4> list;
+    list.push(resource);
+    list.push(resource);
+    list.push(resource);
+    CHECK(resource.use_count() == 4);
+
+    list.remove(0);
+    CHECK(resource.use_count() == 3);
+    list.removeUnordered(0);
+    CHECK(resource.use_count() == 2);
+    list.removeIf([](const std::shared_ptr<int> &) { return true; });
+    CHECK(resource.use_count() == 1);
+}
+
+#include <chrono>
+
+TEST_CASE("ArrayList remove vs removeUnordered benchmark") {
+    constexpr size_t N = 64;
+    constexpr size_t ROUNDS = 2000;
+    ArrayList<std::string, N> list;
+
+    auto fill = [&]() {
+        while (!list.full()) list.push("subscription-" + std::to_string(list.size()));
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < ROUNDS; ++r) {
+        fill();
+        while (!list.empty()) list.remove(0);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < ROUNDS; ++r) {
+        fill();
+        while (!list.empty()) list.removeUnordered(0);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    auto ordered_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    auto unordered_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+    MESSAGE("remove(0): " << ordered_ns / static_cast<long long>(ROUNDS * N) << " ns/op (incl. fill), removeUnordered(0): "
+                          << unordered_ns / static_cast<long long>(ROUNDS * N) << " ns/op (incl. fill)");
+    CHECK(list.empty());
+}
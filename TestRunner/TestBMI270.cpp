@@ -5,6 +5,8 @@
 #include "mock_hal.h"
 #include "Transport.hpp"
 
+#include <vector>
+
 SPI_HandleTypeDef mock_spi;
 GPIO_TypeDef mock_gpio;
 
@@ -385,7 +387,9 @@ TEST_CASE("BMI270 configure succeeds when all register writes succeed")
         0xFF, 0x00,   // ACC_RANGE
         0xFF, 0x08,   // GYR_CONF
         0xFF, 0x00,   // GYR_RANGE
-        0xFF, 0x0E    // PWR_CTRL
+        0xFF, 0x0E,   // PWR_CTRL
+        0xFF, 0x02,   // FIFO_CONFIG_0
+        0xFF, 0xD0    // FIFO_CONFIG_1
     };
     inject_spi_rx_data(raw, sizeof(raw));
 
@@ -456,3 +460,154 @@ TEST_CASE("BMI270 initialize fails when chip ID never matches")
 
     CHECK(imu.initialize() == false);
 }
+
+// Header mode FIFO frame with gyro and accel payload (aux, gyro, accel order)
+static void appendFifoFrame(std::vector<uint8_t> &fifo, int16_t gx, int16_t ax)
+{
+    const int16_t words[6] = {gx, 0, 0, ax, 0, 0};
+    fifo.push_back(0x8C);
+    for (int16_t w : words)
+    {
+        fifo.push_back(static_cast<uint8_t>(static_cast<uint16_t>(w) & 0xFF));
+        fifo.push_back(static_cast<uint8_t>(static_cast<uint16_t>(w) >> 8));
+    }
+}
+
+TEST_CASE("BMI270 parseFifo decodes regular, skip and sensortime frames")
+{
+    Config config(&mock_gpio);
+    Transport transport(config);
+    BMI270<Transport> imu(transport);
+
+    std::vector<uint8_t> fifo;
+    appendFifoFrame(fifo, 164, 16384);
+    fifo.insert(fifo.end(), {0x40, 0x02});            // skip frame: two frames lost
+    fifo.insert(fifo.end(), {0x88, 0x5C, 0xFF, 0, 0, 0, 0}); // gyro only, X = -164
+    appendFifoFrame(fifo, 328, -16384);
+    fifo.insert(fifo.end(), {0x44, 0x00, 0x10, 0x00});  // sensortime 0x001000
+    fifo.push_back(0x80);                               // over-read
+
+    std::array<BMI270_FIFO_SAMPLE, 8> samples{};
+    BMI270_FIFO_PARSE parsed = imu.parseFifo(fifo.data(), static_cast<uint16_t>(fifo.size()), samples);
+
+    REQUIRE(parsed.samples == 3);
+    REQUIRE(parsed.sensor_time.has_value());
+    CHECK(parsed.sensor_time.value() == 0x001000);
+    CHECK(parsed.consumed == fifo.size() - 1);
+
+    CHECK(samples[0].has_gyr);
+    CHECK(samples[0].has_acc);
+    CHECK(samples[0].gyr[0].in(au::degreesPerSecondInBodyFrame) == doctest::Approx(10.0f));
+    CHECK(samples[0].acc[0].in(au::metersPerSecondSquaredInBodyFrame) == doctest::Approx(-9.80665f));
+    CHECK(samples[1].has_gyr);
+    CHECK_FALSE(samples[1].has_acc);
+    CHECK(samples[1].gyr[0].in(au::degreesPerSecondInBodyFrame) == doctest::Approx(-10.0f));
+    CHECK(samples[2].gyr[0].in(au::degreesPerSecondInBodyFrame) == doctest::Approx(20.0f));
+    CHECK(samples[2].acc[0].in(au::metersPerSecondSquaredInBodyFrame) == doctest::Approx(9.80665f));
+}
+
+TEST_CASE("BMI270 parseFifo stops at a partial frame and at the output capacity")
+{
+    Config config(&mock_gpio);
+    Transport transport(config);
+    BMI270<Transport> imu(transport);
+
+    std::vector<uint8_t> fifo;
+    appendFifoFrame(fifo, 1, 1);
+    appendFifoFrame(fifo, 2, 2);
+    appendFifoFrame(fifo, 3, 3);
+
+    std::array<BMI270_FIFO_SAMPLE, 8> samples{};
+    BMI270_FIFO_PARSE partial = imu.parseFifo(fifo.data(), static_cast<uint16_t>(fifo.size() - 5), samples);
+    CHECK(partial.samples == 2);
+    CHECK(partial.consumed == 26);
+    CHECK_FALSE(partial.sensor_time.has_value());
+
+    BMI270_FIFO_PARSE capped = imu.parseFifo(fifo.data(), static_cast<uint16_t>(fifo.size()), std::span(samples).first(1));
+    CHECK(capped.samples == 1);
+    CHECK(capped.consumed == 13);
+}
+
+TEST_CASE("BMI270 readFifo drains all frames in one burst and timestamps them")
+{
+    clear_spi_tx_buffer();
+    clear_spi_rx_buffer();
+
+    constexpr int FRAMES = 5;
+    std::vector<uint8_t> fifo;
+    for (int i = 0; i < FRAMES; ++i)
+        appendFifoFrame(fifo, static_cast<int16_t>(164 * (i + 1)), 16384);
+    const uint16_t length = static_cast<uint16_t>(fifo.size());
+    fifo.insert(fifo.end(), {0x44, 0x00, 0x20, 0x00}); // sensortime 0x2000 after the last frame
+
+    uint8_t length_rx[] = {0xFF, static_cast<uint8_t>(length & 0xFF), static_cast<uint8_t>(length >> 8)};
+    inject_spi_rx_data(length_rx, sizeof(length_rx));
+    std::vector<uint8_t> data_rx{0xFF};
+    data_rx.insert(data_rx.end(), fifo.begin(), fifo.end());
+    inject_spi_rx_data(data_rx.data(), data_rx.size());
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    BMI270<Transport> imu(transport);
+
+    std::array<BMI270_FIFO_SAMPLE, 16> samples{};
+    uint32_t read_time = 0;
+    const size_t count = imu.readFifo(samples, read_time);
+
+    REQUIRE(count == FRAMES);
+    CHECK(read_time == 0x2000U);
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        CHECK(samples[static_cast<size_t>(i)].gyr[0].in(au::degreesPerSecondInBodyFrame) == doctest::Approx(10.0f * static_cast<float>(i + 1)));
+        CHECK(samples[static_cast<size_t>(i)].sensor_time == 0x2000U - static_cast<uint32_t>(FRAMES - 1 - i) * IMUType::FIFO_FRAME_TICKS);
+    }
+
+    // Two transactions: the FIFO length and a single FIFO_DATA burst
+    const size_t expected_tx = (1 + 3) + (1 + length + 4 + 1);
+    CHECK(get_spi_tx_buffer_count() == expected_tx);
+    CHECK(get_spi_tx_buffer()[0] == (static_cast<uint8_t>(BMI270_REGISTERS::FIFO_LENGTH_0) | 0x80));
+    CHECK(get_spi_tx_buffer()[4] == (static_cast<uint8_t>(BMI270_REGISTERS::FIFO_DATA) | 0x80));
+}
+
+TEST_CASE("BMI270 FIFO sample period follows the configured ODR")
+{
+    static_assert(IMUType::odrPeriodTicks(0x08) == 256);
+    static_assert(IMUType::odrPeriodTicks(0x0C) == 16);
+    CHECK(IMUType::FIFO_SAMPLE_PERIOD == doctest::Approx(0.01f));
+    static_assert(HasGyroscopeFifo<IMUType>);
+}
+
+TEST_CASE("BMI270 readFifo leaves frames beyond the capacity and dates them from SENSOR_TIME")
+{
+    clear_spi_tx_buffer();
+    clear_spi_rx_buffer();
+
+    std::vector<uint8_t> fifo;
+    for (int i = 0; i < 5; ++i)
+        appendFifoFrame(fifo, static_cast<int16_t>(164 * (i + 1)), 16384);
+    const uint16_t length = static_cast<uint16_t>(fifo.size());
+
+    // Capacity 2: the burst covers two frames and the first bytes of the third
+    uint8_t length_rx[] = {0xFF, static_cast<uint8_t>(length & 0xFF), static_cast<uint8_t>(length >> 8)};
+    inject_spi_rx_data(length_rx, sizeof(length_rx));
+    std::vector<uint8_t> data_rx{0xFF};
+    data_rx.insert(data_rx.end(), fifo.begin(), fifo.begin() + 2 * 13 + 4);
+    inject_spi_rx_data(data_rx.data(), data_rx.size());
+    uint8_t time_rx[] = {0xFF, 0x00, 0x40, 0x00}; // SENSOR_TIME = 0x4000
+    inject_spi_rx_data(time_rx, sizeof(time_rx));
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    BMI270<Transport> imu(transport);
+
+    std::array<BMI270_FIFO_SAMPLE, 2> samples{};
+    uint32_t read_time = 0;
+    REQUIRE(imu.readFifo(samples, read_time) == 2);
+    CHECK(read_time == 0x4000U);
+
+    // Three frames are still queued behind the second one
+    const uint32_t last = 0x4000U - 3U * IMUType::FIFO_FRAME_TICKS;
+    CHECK(samples[1].sensor_time == last);
+    CHECK(samples[0].sensor_time == last - IMUType::FIFO_FRAME_TICKS);
+    CHECK(samples[1].gyr[0].in(au::degreesPerSecondInBodyFrame) == doctest::Approx(20.0f));
+}
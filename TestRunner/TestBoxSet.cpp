@@ -468,4 +468,143 @@ TEST_CASE("BoxSet find check")
         std::vector<std::string> items = {"apple", "banana", "cherry"};
         testFind<std::string, static_cast<uint8_t>(64)>(box, items);
     }
-}
\ No newline at end of file
+}
+struct PortSubscription
+{
+    uint16_t port_id;
+    int payload;
+};
+
+TEST_CASE("BoxSet keyed lookup by port id")
+{
+    BoxSet<PortSubscription, 32, PortIdKey> box;
+
+    for (uint16_t port = 0; port < 32; ++port)
+    {
+        PortSubscription *sub = box.find_or_create_by_key(PortSubscription{static_cast<uint16_t>(7000 + port * 3), port});
+        REQUIRE(sub != nullptr);
+    }
+    CHECK(box.is_full());
+    CHECK(box.find_or_create_by_key(PortSubscription{9999, 0}) == nullptr);
+
+    for (uint16_t port = 0; port < 32; ++port)
+    {
+        PortSubscription *sub = box.find_by_key(static_cast<uint16_t>(7000 + port * 3));
+        REQUIRE(sub != nullptr);
+        CHECK(sub->payload == port);
+    }
+    CHECK(box.find_by_key(static_cast<uint16_t>(7001)) == nullptr);
+
+    // find_or_create_by_key returns the existing slot instead of a duplicate
+    PortSubscription *existing = box.find_by_key(static_cast<uint16_t>(7003));
+    box.remove(box.find_by_key(static_cast<uint16_t>(7000)));
+    CHECK(box.find_or_create_by_key(PortSubscription{7003, -1}) == existing);
+    CHECK(box.size() == 31);
+
+    // a freed slot is reused and indexed under its new key
+    PortSubscription *fresh = box.find_or_create_by_key(PortSubscription{1234, -2});
+    REQUIRE(fresh != nullptr);
+    CHECK(box.find_by_key(static_cast<uint16_t>(1234)) == fresh);
+    CHECK(box.find_by_key(static_cast<uint16_t>(7000)) == nullptr);
+
+    // the comparator API keeps working on a keyed BoxSet
+    CHECK(box.find(PortSubscription{7003, 0}, [](const PortSubscription &a, const PortSubscription &b)
+                   { return a.port_id == b.port_id; }) == existing);
+
+    box.clear();
+    CHECK(box.find_by_key(static_cast<uint16_t>(1234)) == nullptr);
+}
+
+TEST_CASE("BoxSet keyed lookup tolerates a key rewritten before removal")
+{
+    BoxSet<PortSubscription, 8, PortIdKey> box;
+    PortSubscription *sub = box.find_or_create_by_key(PortSubscription{42, 1});
+    REQUIRE(sub != nullptr);
+
+    sub->port_id = 43; // e.g. a transport library scribbling over the struct
+    box.remove(sub);
+    CHECK(box.is_empty());
+
+    PortSubscription *other = box.find_or_create_by_key(PortSubscription{42, 2});
+    REQUIRE(other != nullptr);
+    CHECK(box.find_by_key(static_cast<uint16_t>(42)) == other);
+    CHECK(box.size() == 1);
+}
+
+TEST_CASE("BoxSet IdentityKey on integral content")
+{
+    BoxSet<uint8_t, 16, IdentityKey> box;
+    CHECK(box.find_or_create_by_key(5) != nullptr);
+    CHECK(box.find_or_create_by_key(5) == box.find_by_key(static_cast<uint8_t>(5)));
+    CHECK(box.size() == 1);
+    box.remove(box.find_by_key(static_cast<uint8_t>(5)));
+    CHECK(box.is_empty());
+}
+
+TEST_CASE("BoxSet iteration skips gaps in the occupancy bitmap")
+{
+    BoxSet<int, 64> box;
+    for (int i = 0; i < 64; ++i)
+        box.add(i);
+    for (uint8_t i = 0; i < 64; ++i)
+        if (i % 7 != 0)
+            box.remove(i);
+
+    std::vector<int> seen;
+    for (int value : box)
+        seen.push_back(value);
+
+    std::vector<int> expected;
+    for (int i = 0; i < 64; i += 7)
+        expected.push_back(i);
+    CHECK(seen == expected);
+
+    box.remove(static_cast<uint8_t>(63));
+    box.add(100); // lowest free slot is 1
+    CHECK(box.is_used(1));
+}
+
+TEST_CASE("BoxSet remove by pointer ignores foreign pointers")
+{
+    BoxSet<int, 8> box;
+    box.add(1);
+    int outside = 1;
+    box.remove(&outside);
+    CHECK(box.size() == 1);
+}
+
+#include <chrono>
+
+TEST_CASE("BoxSet comparator scan vs keyed lookup benchmark")
+{
+    constexpr size_t ROUNDS = 20000;
+    BoxSet<PortSubscription, 32> scanned;
+    BoxSet<PortSubscription, 32, PortIdKey> keyed;
+    for (uint16_t port = 0; port < 32; ++port)
+    {
+        scanned.add(PortSubscription{static_cast<uint16_t>(100 + port), port});
+        keyed.add(PortSubscription{static_cast<uint16_t>(100 + port), port});
+    }
+
+    auto same_port = [](const PortSubscription &a, const PortSubscription &b)
+    { return a.port_id == b.port_id; };
+
+    long long sum_scanned = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < ROUNDS; ++r)
+        for (uint16_t port = 0; port < 32; ++port)
+            sum_scanned += scanned.find(PortSubscription{static_cast<uint16_t>(100 + port), 0}, same_port)->payload;
+    auto t1 = std::chrono::steady_clock::now();
+
+    long long sum_keyed = 0;
+    for (size_t r = 0; r < ROUNDS; ++r)
+        for (uint16_t port = 0; port < 32; ++port)
+            sum_keyed += keyed.find_by_key(static_cast<uint16_t>(100 + port))->payload;
+    auto t2 = std::chrono::steady_clock::now();
+
+    auto scan_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    auto keyed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+    MESSAGE("find (comparator scan): " << scan_ns / static_cast<long long>(ROUNDS * 32)
+                                       << " ns/lookup, find_by_key: " << keyed_ns / static_cast<long long>(ROUNDS * 32) << " ns/lookup");
+    CHECK(sum_scanned == sum_keyed);
+}
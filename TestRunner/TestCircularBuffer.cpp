@@ -317,4 +317,362 @@ TEST_CASE("CircularBuffer - Clear Functionality")
         CHECK(cbf.pop() == 40);
         CHECK(cbf.is_empty());
     }
-}
\ No newline at end of file
+}
+TEST_CASE("CircularBuffer - Bulk push_n and pop_n")
+{
+    SUBCASE("push_n stops at capacity instead of dropping entries")
+    {
+        CircularBuffer<int, 5> cbf;
+        int values[] = {1, 2, 3, 4, 5, 6, 7};
+
+        CHECK(cbf.push_n(values, 3) == 3);
+        CHECK(cbf.push_n(values + 3, 4) == 2);
+        CHECK(cbf.is_full());
+
+        int out[7] = {};
+        CHECK(cbf.pop_n(out, 7) == 5);
+        for (int i = 0; i < 5; ++i)
+            CHECK(out[i] == i + 1);
+        CHECK(cbf.is_empty());
+    }
+
+    SUBCASE("bulk operations across the wrap-around point")
+    {
+        CircularBuffer<int, 4> cbf;
+        cbf.push(0);
+        cbf.push(0);
+        cbf.push(0);
+        cbf.pop();
+        cbf.pop();
+        cbf.pop();
+
+        int values[] = {10, 20, 30, 40};
+        CHECK(cbf.push_n(values, 4) == 4);
+        CHECK(cbf.size() == 4);
+        CHECK(cbf.peek() == 10);
+
+        int out[2] = {};
+        CHECK(cbf.pop_n(out, 2) == 2);
+        CHECK(out[0] == 10);
+        CHECK(out[1] == 20);
+
+        CHECK(cbf.pop() == 30);
+        CHECK(cbf.pop() == 40);
+        CHECK(cbf.is_empty());
+    }
+
+    SUBCASE("pop_n on an empty buffer")
+    {
+        CircularBuffer<int, 3> cbf;
+        int out[3] = {};
+        CHECK(cbf.pop_n(out, 3) == 0);
+        CHECK(cbf.is_empty());
+    }
+
+    SUBCASE("pop_n moves elements out")
+    {
+        CircularBuffer<std::string, 3> cbf;
+        cbf.push("Hello");
+        cbf.push("World");
+
+        std::string out[2];
+        CHECK(cbf.pop_n(out, 2) == 2);
+        CHECK(out[0] == "Hello");
+        CHECK(out[1] == "World");
+    }
+}
+
+TEST_CASE("CircularBuffer - read_span and release")
+{
+    SUBCASE("contiguous region")
+    {
+        CircularBuffer<int, 5> cbf;
+        cbf.push(1);
+        cbf.push(2);
+        cbf.push(3);
+
+        auto spans = cbf.read_span();
+        CHECK(spans.size() == 3);
+        CHECK(spans.second.empty());
+        CHECK(spans.first[0] == 1);
+        CHECK(spans.first[2] == 3);
+
+        cbf.release(2);
+        CHECK(cbf.size() == 1);
+        CHECK(cbf.peek() == 3);
+    }
+
+    SUBCASE("wrapped region yields two spans in order")
+    {
+        CircularBuffer<int, 4> cbf;
+        for (int i = 0; i < 6; ++i)
+            cbf.push(i); // 0 and 1 are dropped, head wraps
+
+        auto spans = cbf.read_span();
+        REQUIRE(spans.size() == 4);
+        CHECK_FALSE(spans.second.empty());
+
+        int expected = 2;
+        for (auto run : {spans.first, spans.second})
+            for (int &value : run)
+                CHECK(value == expected++);
+
+        cbf.release(spans.size());
+        CHECK(cbf.is_empty());
+        CHECK(cbf.read_span().empty());
+    }
+
+    SUBCASE("release is clamped to the readable size")
+    {
+        CircularBuffer<int, 3> cbf;
+        cbf.push(7);
+        cbf.release(10);
+        CHECK(cbf.is_empty());
+        cbf.push(8);
+        CHECK(cbf.pop() == 8);
+    }
+}
+
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    struct LargeFrame
+    {
+        size_t size;
+        uint8_t data[640];
+    };
+
+    template <typename T, size_t N, typename Fill>
+    void benchmarkDrain(const char *label, Fill fill)
+    {
+        constexpr size_t ROUNDS = 2000;
+        constexpr size_t BATCH = 32;
+        CircularBuffer<T, N> cbf;
+        std::array<T, BATCH> batch{};
+        for (size_t i = 0; i < BATCH; ++i)
+            fill(batch[i], i);
+
+        size_t checksum_single = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < ROUNDS; ++r)
+        {
+            for (size_t i = 0; i < BATCH; ++i)
+                cbf.push(batch[i]);
+            for (size_t i = 0; i < BATCH; ++i)
+            {
+                T value = cbf.pop();
+                checksum_single += reinterpret_cast<const uint8_t *>(&value)[0];
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+
+        size_t checksum_bulk = 0;
+        for (size_t r = 0; r < ROUNDS; ++r)
+        {
+            cbf.push_n(batch.data(), BATCH);
+            auto spans = cbf.read_span();
+            for (auto run : {spans.first, spans.second})
+                for (const T &value : run)
+                    checksum_bulk += reinterpret_cast<const uint8_t *>(&value)[0];
+            cbf.release(spans.size());
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        auto single_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        auto bulk_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+        MESSAGE(label << ": element-wise " << single_ns / static_cast<long long>(ROUNDS * BATCH)
+                      << " ns/elem, bulk " << bulk_ns / static_cast<long long>(ROUNDS * BATCH) << " ns/elem");
+        CHECK(checksum_single == checksum_bulk);
+        CHECK(cbf.is_empty());
+    }
+}
+
+TEST_CASE("CircularBuffer - Bulk vs element-wise drain benchmark")
+{
+    benchmarkDrain<uint32_t, 64>("uint32_t", [](uint32_t &v, size_t i) { v = static_cast<uint32_t>(i); });
+    benchmarkDrain<LargeFrame, 64>("640-byte frame", [](LargeFrame &f, size_t i)
+                                   {
+                                       f.size = i;
+                                       std::memset(f.data, static_cast<int>(i), sizeof(f.data));
+                                   });
+}
+
+TEST_CASE("PaddedCircularBuffer - matches CircularBuffer semantics")
+{
+    SUBCASE("capacity is exact although storage is a power of two")
+    {
+        PaddedCircularBuffer<int, 5> cbf;
+        CHECK(cbf.capacity() == 5);
+        for (int i = 0; i < 5; ++i)
+            cbf.push(i);
+        CHECK(cbf.is_full());
+        CHECK(cbf.size() == 5);
+    }
+
+    SUBCASE("overflow drops the oldest entry")
+    {
+        PaddedCircularBuffer<int, 3> cbf;
+        for (int i = 1; i <= 5; ++i)
+            cbf.push(i);
+
+        CHECK(cbf.size() == 3);
+        CHECK(cbf.peek() == 3);
+        CHECK(cbf.pop() == 3);
+        CHECK(cbf.pop() == 4);
+        CHECK(cbf.pop() == 5);
+        CHECK(cbf.is_empty());
+        CHECK(cbf.pop() == 0);
+    }
+
+    SUBCASE("bulk operations and spans across the wrap-around point")
+    {
+        PaddedCircularBuffer<int, 6> cbf;
+        int values[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        int out[9] = {};
+
+        CHECK(cbf.push_n(values, 5) == 5);
+        CHECK(cbf.pop_n(out, 4) == 4);
+        CHECK(cbf.push_n(values + 5, 4) == 4);
+        CHECK(cbf.push_n(values, 9) == 1);
+
+        auto spans = cbf.read_span();
+        CHECK(spans.size() == 6);
+        CHECK_FALSE(spans.second.empty());
+
+        int expected[] = {5, 6, 7, 8, 9, 1};
+        size_t i = 0;
+        for (auto run : {spans.first, spans.second})
+            for (int &value : run)
+                CHECK(value == expected[i++]);
+
+        cbf.release(4);
+        CHECK(cbf.pop_n(out, 9) == 2);
+        CHECK(out[0] == 9);
+        CHECK(out[1] == 1);
+        CHECK(cbf.is_empty());
+    }
+
+    SUBCASE("pop after overflow with a stale cached head")
+    {
+        PaddedCircularBuffer<int, 2> cbf;
+        cbf.push(1);
+        CHECK(cbf.pop() == 1);
+        cbf.push(2);
+        cbf.push(3);
+        cbf.push(4); // drops 2 from the producer side
+        CHECK(cbf.pop() == 3);
+        CHECK(cbf.pop() == 4);
+        CHECK(cbf.is_empty());
+    }
+
+    SUBCASE("clear and reuse")
+    {
+        PaddedCircularBuffer<int, 3> cbf;
+        cbf.push(1);
+        cbf.push(2);
+        cbf.clear();
+        CHECK(cbf.is_empty());
+        cbf.push(3);
+        CHECK(cbf.pop() == 3);
+    }
+
+    SUBCASE("indices do not share a cache line")
+    {
+        CHECK(alignof(PaddedSPSCBuffer<uint8_t, 4>) >= SPSC_CACHE_LINE_SIZE);
+        CHECK(sizeof(PaddedSPSCBuffer<uint8_t, 4>) >= 3 * SPSC_CACHE_LINE_SIZE);
+    }
+}
+
+#include <thread>
+
+namespace
+{
+    constexpr uint32_t THROUGHPUT_ITEMS = 1u << 18;
+
+    struct ThroughputResult
+    {
+        uint32_t received;        // items popped by the consumer
+        uint32_t first_misplaced; // index of the first item out of order, received if none
+        uint64_t sum;
+        bool drained;             // buffer empty once the producer is done
+        long long items_per_us;
+    };
+
+    template <typename Buffer>
+    ThroughputResult twoThreadThroughput(size_t batch)
+    {
+        static Buffer buffer;
+        buffer.clear();
+
+        ThroughputResult result{0, 0, 0, false, 0};
+        bool ordered = true;
+
+        auto t0 = std::chrono::steady_clock::now();
+        std::thread producer([&]()
+                             {
+            std::array<uint32_t, 64> chunk{};
+            uint32_t next = 0;
+            while (next < THROUGHPUT_ITEMS)
+            {
+                size_t n = std::min<size_t>(batch, THROUGHPUT_ITEMS - next);
+                for (size_t i = 0; i < n; ++i)
+                    chunk[i] = next + static_cast<uint32_t>(i);
+                size_t written = buffer.push_n(chunk.data(), n);
+                if (written == 0)
+                    std::this_thread::yield();
+                next += static_cast<uint32_t>(written);
+            } });
+
+        std::array<uint32_t, 64> out{};
+        while (result.received < THROUGHPUT_ITEMS)
+        {
+            size_t n = buffer.pop_n(out.data(), batch);
+            if (n == 0)
+                std::this_thread::yield();
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (ordered && out[i] != result.received)
+                {
+                    ordered = false;
+                    result.first_misplaced = result.received;
+                }
+                result.sum += out[i];
+                ++result.received;
+            }
+        }
+        producer.join();
+        auto t1 = std::chrono::steady_clock::now();
+
+        if (ordered)
+            result.first_misplaced = result.received;
+        result.drained = buffer.is_empty();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        result.items_per_us = ns > 0 ? static_cast<long long>(THROUGHPUT_ITEMS) * 1000 / ns : 0;
+        return result;
+    }
+
+    void checkThroughputResult(const ThroughputResult &result)
+    {
+        CHECK(result.received == THROUGHPUT_ITEMS);
+        CHECK(result.first_misplaced == THROUGHPUT_ITEMS);
+        CHECK(result.sum == static_cast<uint64_t>(THROUGHPUT_ITEMS) * (THROUGHPUT_ITEMS - 1) / 2);
+        CHECK(result.drained);
+    }
+}
+
+TEST_CASE("SPSCBuffer vs PaddedSPSCBuffer two-thread throughput")
+{
+    for (size_t batch : {static_cast<size_t>(1), static_cast<size_t>(16)})
+    {
+        CAPTURE(batch);
+        ThroughputResult plain = twoThreadThroughput<SPSCBuffer<uint32_t, 255>>(batch);
+        ThroughputResult padded = twoThreadThroughput<PaddedSPSCBuffer<uint32_t, 255>>(batch);
+
+        // Every item arrives exactly once and in order, padded or not
+        checkThroughputResult(plain);
+        checkThroughputResult(padded);
+        MESSAGE("batch " << batch << ": SPSCBuffer " << plain.items_per_us << " items/us, PaddedSPSCBuffer " << padded.items_per_us << " items/us");
+    }
+}
@@ -0,0 +1,207 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "ContextHeapAllocation.hpp"
+#include "HeapAllocation.hpp"
+#include "mock_hal.h"
+#include <vector>
+
+using ContextHeap = ContextHeapAllocation<8192, 4096, 8>;
+
+TEST_CASE("CrossContextFreeQueue is FIFO and bounded")
+{
+    CrossContextFreeQueue<3> queue;
+    int a, b, c, d;
+
+    CHECK(queue.is_empty());
+    CHECK(queue.pop() == nullptr);
+
+    CHECK(queue.push(&a));
+    CHECK(queue.push(&b));
+    CHECK(queue.push(&c));
+    CHECK_FALSE(queue.push(&d));
+
+    CHECK(queue.pop() == &a);
+    CHECK(queue.push(&d));
+    CHECK(queue.pop() == &b);
+    CHECK(queue.pop() == &c);
+    CHECK(queue.pop() == &d);
+    CHECK(queue.is_empty());
+}
+
+TEST_CASE("ContextHeapAllocation allocates from the heap of the calling context")
+{
+    clear_irq_statistics();
+    ContextHeap::initialize();
+
+    void *main_block = ContextHeap::canardMemoryAllocate(nullptr, 64);
+    REQUIRE(main_block != nullptr);
+
+    set_isr_context(true);
+    void *isr_block = ContextHeap::canardMemoryAllocate(nullptr, 64);
+    set_isr_context(false);
+    REQUIRE(isr_block != nullptr);
+
+    auto diag = ContextHeap::getContextDiagnostics();
+    CHECK(diag.main.allocated >= 64);
+    CHECK(diag.isr.allocated >= 64);
+
+    ContextHeap::canardMemoryDeallocate(nullptr, main_block);
+    set_isr_context(true);
+    ContextHeap::canardMemoryDeallocate(nullptr, isr_block);
+    set_isr_context(false);
+
+    diag = ContextHeap::getContextDiagnostics();
+    CHECK(diag.main.allocated == 0);
+    CHECK(diag.isr.allocated == 0);
+    CHECK(diag.deferred_to_main == 0);
+    CHECK(diag.deferred_to_isr == 0);
+}
+
+TEST_CASE("ContextHeapAllocation defers cross-context frees to the owner")
+{
+    clear_irq_statistics();
+    ContextHeap::initialize();
+
+    // RX interrupt allocates a frame, main loop consumes and frees it
+    set_isr_context(true);
+    void *rx_block = ContextHeap::serardMemoryAllocate(nullptr, 100);
+    set_isr_context(false);
+    REQUIRE(rx_block != nullptr);
+
+    ContextHeap::serardMemoryDeallocate(nullptr, 100, rx_block);
+    auto diag = ContextHeap::getContextDiagnostics();
+    CHECK(diag.deferred_to_isr == 1);
+    CHECK(diag.isr.allocated >= 100);
+
+    // Main loop allocates, TX-complete interrupt frees
+    void *tx_block = ContextHeap::serardMemoryAllocate(nullptr, 100);
+    REQUIRE(tx_block != nullptr);
+    set_isr_context(true);
+    ContextHeap::serardMemoryDeallocate(nullptr, 100, tx_block);
+
+    // Next ISR allocation reclaims the block the main loop handed back
+    void *probe = ContextHeap::serardMemoryAllocate(nullptr, 16);
+    ContextHeap::serardMemoryDeallocate(nullptr, 16, probe);
+    set_isr_context(false);
+
+    diag = ContextHeap::getContextDiagnostics();
+    CHECK(diag.deferred_to_main == 1);
+    CHECK(diag.isr.allocated == 0);
+    CHECK(diag.main.allocated >= 100);
+
+    ContextHeap::collect();
+    diag = ContextHeap::getContextDiagnostics();
+    CHECK(diag.main.allocated == 0);
+    CHECK(diag.masked_fallbacks == 0);
+    CHECK(diag.lost_frees == 0);
+
+    CHECK(get_irq_disable_count(CAN1_TX_IRQn) == 0);
+    CHECK(get_irq_disable_count(CAN1_RX0_IRQn) == 0);
+    CHECK(get_irq_disable_count(CAN1_RX1_IRQn) == 0);
+}
+
+TEST_CASE("ContextHeapAllocation masks only when the ISR free queue overflows")
+{
+    clear_irq_statistics();
+    ContextHeap::initialize();
+
+    std::vector<void *> blocks;
+    set_isr_context(true);
+    for (size_t i = 0; i < ContextHeap::getContextDiagnostics().isr.capacity; ++i)
+    {
+        void *p = ContextHeap::heapAllocate(nullptr, 32);
+        if (p == nullptr || blocks.size() == 10)
+        {
+            ContextHeap::heapFree(nullptr, p);
+            break;
+        }
+        blocks.push_back(p);
+    }
+    set_isr_context(false);
+    REQUIRE(blocks.size() == 10);
+
+    for (void *p : blocks)
+        ContextHeap::heapFree(nullptr, p);
+
+    // 8 blocks fill the queue, the 9th drains it under the mask, the 10th is queued again
+    auto diag = ContextHeap::getContextDiagnostics();
+    CHECK(diag.deferred_to_isr == 9);
+    CHECK(diag.masked_fallbacks == 1);
+    CHECK(diag.isr.allocated > 0);
+    CHECK(get_irq_disable_count(CAN1_RX0_IRQn) == 1);
+    CHECK(get_irq_enabled(CAN1_RX0_IRQn));
+
+    set_isr_context(true);
+    ContextHeap::heapFree(nullptr, ContextHeap::heapAllocate(nullptr, 32));
+    set_isr_context(false);
+    CHECK(ContextHeap::getContextDiagnostics().isr.allocated == 0);
+}
+
+TEST_CASE("ContextHeapAllocation masks every IRQ named in IsrLocks")
+{
+    using TimerLock = IrqLock<EXTI0_IRQn>;
+    using SharedHeap = ContextHeapAllocation<8192, 4096, 1, IrqLockSet<CanRx0IrqLock, TimerLock>>;
+
+    clear_irq_statistics();
+    SharedHeap::initialize();
+
+    set_isr_context(true);
+    void *a = SharedHeap::heapAllocate(nullptr, 32);
+    void *b = SharedHeap::heapAllocate(nullptr, 32);
+    set_isr_context(false);
+
+    // The first fills the queue, the second is freed under the mask
+    SharedHeap::heapFree(nullptr, a);
+    SharedHeap::heapFree(nullptr, b);
+    CHECK(SharedHeap::getContextDiagnostics().masked_fallbacks == 1);
+    CHECK(get_irq_disable_count(EXTI0_IRQn) == 1);
+    CHECK(get_irq_disable_count(CAN1_RX0_IRQn) == 1);
+    CHECK(get_irq_disable_count(CAN1_TX_IRQn) == 0);
+    CHECK(get_irq_enabled(EXTI0_IRQn));
+    CHECK(get_irq_enabled(CAN1_RX0_IRQn));
+}
+
+TEST_CASE("Worst-case CAN interrupt masking during main-loop allocation bursts")
+{
+    using LegacyHeap = HeapAllocation<8192>;
+    constexpr size_t ROUNDS = 2000;
+    constexpr size_t BURST = 16;
+
+    auto burst = [&](auto allocate, auto deallocate)
+    {
+        std::vector<void *> blocks(BURST);
+        for (size_t round = 0; round < ROUNDS; ++round)
+        {
+            for (size_t i = 0; i < BURST; ++i)
+                blocks[i] = allocate(16 + 8 * i);
+            for (size_t i = 0; i < BURST; ++i)
+                deallocate(blocks[i]);
+        }
+    };
+
+    clear_irq_statistics();
+    LegacyHeap::initialize();
+    burst([](size_t n) { return LegacyHeap::heapAllocate(nullptr, n); },
+          [](void *p) { LegacyHeap::heapFree(nullptr, p); });
+    const uint32_t legacy_masks = get_irq_disable_count(CAN1_RX0_IRQn);
+    const uint64_t legacy_worst_ns = get_irq_max_masked_ns(CAN1_RX0_IRQn);
+    const uint64_t legacy_total_ns = get_irq_total_masked_ns(CAN1_RX0_IRQn);
+
+    clear_irq_statistics();
+    ContextHeap::initialize();
+    burst([](size_t n) { return ContextHeap::heapAllocate(nullptr, n); },
+          [](void *p) { ContextHeap::heapFree(nullptr, p); });
+    const uint32_t context_masks = get_irq_disable_count(CAN1_RX0_IRQn);
+    const uint64_t context_worst_ns = get_irq_max_masked_ns(CAN1_RX0_IRQn);
+
+    MESSAGE("HeapAllocation: " << legacy_masks << " masks, worst " << legacy_worst_ns
+                               << " ns, total " << legacy_total_ns << " ns");
+    MESSAGE("ContextHeapAllocation: " << context_masks << " masks, worst " << context_worst_ns << " ns");
+
+    CHECK(legacy_masks == 2 * ROUNDS * BURST);
+    CHECK(legacy_worst_ns > 0);
+    CHECK(context_masks == 0);
+    CHECK(context_worst_ns == 0);
+    CHECK(ContextHeap::getDiagnostics().allocated == 0);
+}
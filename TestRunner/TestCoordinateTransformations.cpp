@@ -2,7 +2,10 @@
 #include "doctest.h"
 #include "coordinate_transformations.hpp"
 #include "TimeUtils.hpp"
+#include <chrono>
+#include <numbers>
 #include <random>
+#include <vector>
 #include <limits> // For NaN
 #include <cmath>  // For std::isnan
 #include "au.hpp"
@@ -1044,3 +1047,186 @@ TEST_CASE("Polar Motion")
         CHECK(polarotion.y == doctest::Approx(0.4221f).epsilon(1e-1f));
     }
 }
+
+// TEME to ECEF in double precision with the same GMST and polar motion models
+static std::array<double, 3> temeToEcefReference(const std::array<float, 3> &teme, uint64_t ms_since_epoch)
+{
+    const double jd2000 = (static_cast<double>(ms_since_epoch) - 43200000.0) / 86400000.0;
+    const double midnight = std::floor(jd2000) + 0.5;
+    const double centuries = jd2000 / 36525.0;
+    double gmst = 6.697374558 + 0.06570982441908 * midnight + 1.00273790935 * (jd2000 - midnight) * 24.0 + 0.000026 * centuries * centuries;
+    gmst = std::fmod(gmst, 24.0) * std::numbers::pi / 12.0;
+
+    float pm[3][3];
+    (void)polarmMJD2000(static_cast<float>(jd2000), pm);
+    const double pef[3] = {std::cos(gmst) * teme[0] + std::sin(gmst) * teme[1], -std::sin(gmst) * teme[0] + std::cos(gmst) * teme[1], teme[2]};
+    std::array<double, 3> ecef{};
+    for (size_t i = 0; i < 3; ++i)
+        ecef[i] = pm[0][i] * pef[0] + pm[1][i] * pef[1] + pm[2][i] * pef[2];
+    return ecef;
+}
+
+static uint64_t epochMs(uint16_t year, uint8_t month, uint8_t day, uint8_t hour)
+{
+    return static_cast<uint64_t>(TimeUtils::to_epoch_duration(TimeUtils::DateTimeComponents{
+                                                                  .year = year,
+                                                                  .month = month,
+                                                                  .day = day,
+                                                                  .hour = hour,
+                                                                  .minute = 0,
+                                                                  .second = 0,
+                                                                  .millisecond = 0})
+                                     .count());
+}
+
+static double distanceKm(const TemeToEcefRotation::Vector &a, const std::array<double, 3> &b)
+{
+    return std::hypot(a[0] - b[0], a[1] - b[1], a[2] - b[2]);
+}
+
+static std::array<float, 3> temeToEcefKm(const TemeToEcefRotation::Vector &teme, float jd2000)
+{
+    const auto ecef = temeToecef(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3>{
+                                     au::make_quantity<au::Kilo<au::MetersInTemeFrame>>(teme[0]),
+                                     au::make_quantity<au::Kilo<au::MetersInTemeFrame>>(teme[1]),
+                                     au::make_quantity<au::Kilo<au::MetersInTemeFrame>>(teme[2])},
+                                 jd2000);
+    return {ecef[0].in(au::kilo(au::meters * au::ecefs)), ecef[1].in(au::kilo(au::meters * au::ecefs)), ecef[2].in(au::kilo(au::meters * au::ecefs))};
+}
+
+TEST_CASE("TemeToEcefRotation error budget")
+{
+    const TemeToEcefRotation::Vector teme{-3006.1573609732827f, 4331.221049310724f, -4290.439626312989f};
+    const uint64_t start = epochMs(2025, 6, 25, 0);
+    TemeToEcefRotation rotation;
+
+    SUBCASE("Matches temeToecef where the float jd2000 is exact")
+    {
+        // jd2000 on a 1/1024 day grid (84375 ms) is representable, so both see the same epoch
+        double max_error = 0.0;
+        for (uint64_t k = (start - 43200000) / 84375 + 1; k * 84375 + 43200000 < start + 2 * 86400000ULL; k += 7)
+        {
+            const uint64_t t = k * 84375 + 43200000;
+            rotation.update(t);
+            const std::array<float, 3> old = temeToEcefKm(teme, static_cast<float>(k) / 1024.f);
+            max_error = std::max(max_error, distanceKm(rotation.apply(teme), {old[0], old[1], old[2]}));
+        }
+        MESSAGE("cached rotation vs temeToecef at float-exact epochs: " << 1000.0 * max_error << " m");
+        // Bounded by the float GMST of gsTimeJ2000, about 0.2 s of Earth rotation
+        CHECK(max_error < 0.2);
+    }
+
+    SUBCASE("Tracks a double-precision reference at arbitrary epochs")
+    {
+        double max_error = 0.0, max_error_old = 0.0;
+        for (uint64_t t = start; t < start + 3 * 86400000ULL; t += 1009)
+        {
+            rotation.update(t);
+            const std::array<double, 3> reference = temeToEcefReference(teme, t);
+            max_error = std::max(max_error, distanceKm(rotation.apply(teme), reference));
+            const float jd2000 = static_cast<float>((static_cast<double>(t) - 43200000.0) / 86400000.0);
+            max_error_old = std::max(max_error_old, distanceKm(temeToEcefKm(teme, jd2000), reference));
+        }
+        MESSAGE("vs double reference: cached rotation " << 1000.0 * max_error << " m, temeToecef with float jd2000 " << 1000.0 * max_error_old << " m");
+        CHECK(max_error < 0.005);
+        CHECK(max_error < max_error_old);
+    }
+}
+
+TEST_CASE("TemeToEcefRotation incremental, batch and series agree")
+{
+    const uint64_t start = epochMs(2026, 1, 1, 6);
+    std::vector<TemeToEcefRotation::Vector> teme(500), single(500), batch(500), series(500);
+    for (size_t i = 0; i < teme.size(); ++i)
+    {
+        const float u = 0.0125f * static_cast<float>(i);
+        teme[i] = {6778.f * std::cos(u), 6778.f * 0.62f * std::sin(u), 6778.f * 0.78f * std::sin(u)};
+    }
+
+    // Stepping across bucket boundaries gives the same rotation as a fresh instance
+    TemeToEcefRotation incremental;
+    for (uint64_t t = start; t < start + 2 * 86400000ULL; t += 3600000)
+    {
+        incremental.update(t);
+        TemeToEcefRotation fresh;
+        fresh.update(t);
+        const auto a = incremental.apply(teme[0]);
+        const auto b = fresh.apply(teme[0]);
+        CHECK(std::hypot(a[0] - b[0], a[1] - b[1], a[2] - b[2]) < 1e-3f);
+    }
+
+    // One matrix for a batch
+    TemeToEcefRotation rotation;
+    rotation.update(start);
+    rotation.apply(teme, batch);
+    for (size_t i = 0; i < teme.size(); ++i)
+        REQUIRE(batch[i] == rotation.apply(teme[i]));
+
+    // A time series at 10 s spacing
+    for (size_t i = 0; i < teme.size(); ++i)
+    {
+        rotation.update(start + i * 10000);
+        single[i] = rotation.apply(teme[i]);
+    }
+    rotation.applySeries(start, 10000, teme, series);
+    float max_error = 0.f;
+    for (size_t i = 0; i < teme.size(); ++i)
+        max_error = std::max(max_error, std::hypot(series[i][0] - single[i][0], series[i][1] - single[i][1], series[i][2] - single[i][2]));
+    MESSAGE("series recurrence vs per-sample update: " << 1000.f * max_error << " m");
+    CHECK(max_error < 0.005f);
+    CHECK(rotation.epoch() == start + 499 * 10000);
+    TemeToEcefRotation last;
+    last.update(start + 499 * 10000);
+    CHECK(rotation.gmst() == doctest::Approx(last.gmst()).epsilon(1e-5));
+
+    // au overloads
+    const auto ecef = rotation(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3>{
+        au::make_quantity<au::Kilo<au::MetersInTemeFrame>>(teme[499][0]),
+        au::make_quantity<au::Kilo<au::MetersInTemeFrame>>(teme[499][1]),
+        au::make_quantity<au::Kilo<au::MetersInTemeFrame>>(teme[499][2])});
+    CHECK(ecef[0].in(au::kilo(au::meters * au::ecefs)) == doctest::Approx(series[499][0]));
+    CHECK(ecef[2].in(au::kilo(au::meters * au::ecefs)) == doctest::Approx(series[499][2]));
+}
+
+TEST_CASE("Benchmark cached TEME to ECEF rotation")
+{
+    constexpr size_t samples = 5000;
+    const uint64_t start = epochMs(2025, 7, 6, 20);
+    std::vector<TemeToEcefRotation::Vector> teme(samples), ecef(samples);
+    for (size_t i = 0; i < samples; ++i)
+        teme[i] = {-3006.f + static_cast<float>(i % 100), 4331.f, -4290.f};
+
+    auto time = [&](auto transform)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        transform();
+        const auto end = std::chrono::steady_clock::now();
+        float sink = 0.f;
+        for (const auto &v : ecef)
+            sink += v[0];
+        CHECK(std::isfinite(sink));
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / samples;
+    };
+
+    const double old_ns = time([&]
+                               {
+        for (size_t i = 0; i < samples; ++i)
+        {
+            const float jd2000 = static_cast<float>((static_cast<double>(start + i * 1000) - 43200000.0) / 86400000.0);
+            ecef[i] = temeToEcefKm(teme[i], jd2000);
+        } });
+    TemeToEcefRotation rotation;
+    const double update_ns = time([&]
+                                  {
+        for (size_t i = 0; i < samples; ++i)
+        {
+            rotation.update(start + i * 1000);
+            ecef[i] = rotation.apply(teme[i]);
+        } });
+    const double series_ns = time([&]
+                                  { rotation.applySeries(start, 1000, teme, ecef); });
+    const double batch_ns = time([&]
+                                 { rotation.apply(teme, ecef); });
+
+    MESSAGE("TEME to ECEF per vector: temeToecef " << old_ns << " ns, update+apply " << update_ns << " ns, series " << series_ns << " ns, one-epoch batch " << batch_ns << " ns");
+}
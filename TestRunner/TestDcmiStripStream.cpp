@@ -0,0 +1,202 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mock_hal.h"
+#include "DcmiStripStream.hpp"
+#include "ImageBuffer.hpp"
+#include "imagebuffer/DirectMemoryAccessor.hpp"
+
+// The mock calls plain C callbacks: they forward to the stream under test, as the IRQ handlers
+// forward to DcmiCapture on the target
+template <size_t STRIP_WORDS>
+struct StreamHarness
+{
+    static inline DcmiStripStream<STRIP_WORDS> *stream = nullptr;
+
+    DCMI_HandleTypeDef hdcmi{};
+
+    StreamHarness(DcmiStripStream<STRIP_WORDS> &s, const std::vector<uint8_t> &frame)
+    {
+        stream = &s;
+        HAL_DCMI_Init(&hdcmi);
+        set_dcmi_stream_callbacks(&hdcmi, halfComplete, complete, frameEvent);
+        set_dcmi_stream_source(&hdcmi, frame.data(), static_cast<uint32_t>(frame.size()));
+        REQUIRE(HAL_DCMI_Start_DMA(&hdcmi, DCMI_MODE_SNAPSHOT, s.begin(), DcmiStripStream<STRIP_WORDS>::RING_WORDS) == HAL_OK);
+    }
+
+    static void halfComplete(DCMI_HandleTypeDef *) { stream->onHalfTransfer(); }
+    static void complete(DCMI_HandleTypeDef *) { stream->onTransferComplete(); }
+    static void frameEvent(DCMI_HandleTypeDef *h) { stream->onFrameEnd(mock_dcmi_dma_remaining(h)); }
+};
+
+static std::vector<uint8_t> makeFrame(size_t bytes)
+{
+    std::vector<uint8_t> frame(bytes);
+    uint32_t x = 0x12345678u;
+    for (auto &b : frame)
+    {
+        x = x * 1664525u + 1013904223u;
+        b = static_cast<uint8_t>(x >> 24);
+    }
+    return frame;
+}
+
+// Streams one frame into the buffer, draining after every DMA event
+template <size_t STRIP_WORDS, typename BufferT>
+static bool streamFrame(DcmiStripStream<STRIP_WORDS> &stream, BufferT &buffer, const std::vector<uint8_t> &frame)
+{
+    ImageMetadata meta{};
+    meta.timestamp = 1;
+    meta.payload_size = static_cast<uint32_t>(frame.size());
+    meta.producer = METADATA_PRODUCER::CAMERA_1;
+    meta.format = METADATA_FORMAT::UNKN;
+    if (buffer.add_image(meta) != ImageBufferError::NO_ERROR)
+        return false;
+
+    StreamHarness<STRIP_WORDS> harness(stream, frame);
+    ImageBufferStripWriter<BufferT> writer(buffer, frame.size());
+    while (mock_dcmi_dma_step(&harness.hdcmi))
+    {
+        if (!stream.drain(writer))
+            return false;
+    }
+    if (!stream.drain(writer) || !stream.complete() || writer.remaining() != 0)
+        return false;
+    return buffer.push_image() == ImageBufferError::NO_ERROR;
+}
+
+template <typename BufferT>
+static std::vector<uint8_t> readBack(BufferT &buffer)
+{
+    ImageMetadata meta{};
+    REQUIRE(buffer.get_image(meta) == ImageBufferError::NO_ERROR);
+    std::vector<uint8_t> data(meta.payload_size);
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        size_t size = std::min<size_t>(4096, data.size() - offset);
+        REQUIRE(buffer.get_data_chunk(data.data() + offset, size) == ImageBufferError::NO_ERROR);
+        REQUIRE(size > 0);
+        offset += size;
+    }
+    return data;
+}
+
+TEST_CASE("DcmiStripStream stores a frame many times larger than its ring")
+{
+    constexpr size_t STRIP = 512; // 2 KiB strips, 4 KiB of RAM
+    auto stream = std::make_unique<DcmiStripStream<STRIP>>();
+    const auto frame = makeFrame(320 * 240 * 2);
+    REQUIRE(frame.size() > 30 * sizeof(uint32_t) * DcmiStripStream<STRIP>::RING_WORDS);
+
+    DirectMemoryAccessor accessor(0x90000000, 256 * 1024);
+    ImageBuffer<DirectMemoryAccessor> buffer(accessor);
+    REQUIRE(streamFrame(*stream, buffer, frame));
+
+    CHECK(stream->bytes() == frame.size());
+    CHECK_FALSE(stream->overrun());
+    CHECK(readBack(buffer) == frame);
+}
+
+TEST_CASE("DcmiStripStream flushes the partial last strip at the frame end")
+{
+    constexpr size_t STRIP = 64;
+    DcmiStripStream<STRIP> stream;
+    DirectMemoryAccessor accessor(0x90000000, 64 * 1024);
+    ImageBuffer<DirectMemoryAccessor> buffer(accessor);
+
+    SUBCASE("in the middle of a strip")
+    {
+        // Three full strips, then 10 words and a byte into the second half
+        const auto frame = makeFrame(3 * DcmiStripStream<STRIP>::STRIP_BYTES + 41);
+        REQUIRE(streamFrame(stream, buffer, frame));
+        CHECK(stream.bytes() == 3 * DcmiStripStream<STRIP>::STRIP_BYTES + 44); // padded to words
+        CHECK(readBack(buffer) == frame);
+    }
+
+    SUBCASE("on a strip boundary")
+    {
+        const auto frame = makeFrame(4 * DcmiStripStream<STRIP>::STRIP_BYTES);
+        REQUIRE(streamFrame(stream, buffer, frame));
+        CHECK(stream.bytes() == frame.size());
+        CHECK(readBack(buffer) == frame);
+    }
+}
+
+TEST_CASE("DcmiStripStream detects a consumer that falls behind the DMA")
+{
+    constexpr size_t STRIP = 64;
+    DcmiStripStream<STRIP> stream;
+    const auto frame = makeFrame(8 * DcmiStripStream<STRIP>::STRIP_BYTES);
+    StreamHarness<STRIP> harness(stream, frame);
+
+    size_t delivered = 0;
+    auto consumer = [&](const uint8_t *, size_t size) { delivered += size; return true; };
+
+    // The first strip is still pending when the DMA wraps back into it
+    CHECK(mock_dcmi_dma_step(&harness.hdcmi));
+    CHECK_FALSE(stream.overrun());
+    CHECK(mock_dcmi_dma_step(&harness.hdcmi));
+    CHECK(stream.overrun());
+    CHECK_FALSE(stream.drain(consumer));
+    CHECK(delivered == 0);
+
+    // A new frame starts clean
+    stream.begin();
+    CHECK_FALSE(stream.failed());
+}
+
+TEST_CASE("DcmiStripStream stops when the consumer fails")
+{
+    constexpr size_t STRIP = 64;
+    DcmiStripStream<STRIP> stream;
+    const auto frame = makeFrame(4 * DcmiStripStream<STRIP>::STRIP_BYTES);
+    StreamHarness<STRIP> harness(stream, frame);
+
+    int calls = 0;
+    auto consumer = [&](const uint8_t *, size_t) { return ++calls < 2; };
+    while (mock_dcmi_dma_step(&harness.hdcmi))
+        stream.drain(consumer);
+
+    CHECK(calls == 2);
+    CHECK(stream.failed());
+    CHECK(stream.bytes() == DcmiStripStream<STRIP>::STRIP_BYTES);
+}
+
+template <size_t STRIP_WORDS>
+static double streamThroughput(const std::vector<uint8_t> &frame, int frames)
+{
+    auto stream = std::make_unique<DcmiStripStream<STRIP_WORDS>>();
+    DirectMemoryAccessor accessor(0x90000000, 2 * frame.size() + 4096);
+    ImageBuffer<DirectMemoryAccessor> buffer(accessor);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < frames; ++n)
+    {
+        REQUIRE(streamFrame(*stream, buffer, frame));
+        REQUIRE(readBack(buffer).size() == frame.size());
+        REQUIRE(buffer.pop_image() == ImageBufferError::NO_ERROR);
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+    return static_cast<double>(frame.size()) * frames / seconds / 1e6;
+}
+
+TEST_CASE("Benchmark DcmiStripStream throughput into the ImageBuffer")
+{
+    // A 640x480 RGB565 frame, 600 KiB, far beyond what a single DMA buffer could hold in SRAM
+    const auto frame = makeFrame(640 * 480 * 2);
+    constexpr int frames = 8;
+
+    const double small = streamThroughput<256>(frame, frames);
+    const double medium = streamThroughput<1024>(frame, frames);
+    const double large = streamThroughput<4096>(frame, frames);
+    MESSAGE("strip streaming MB/s, stored and read back: 1 KiB strips " << small << ", 4 KiB " << medium << ", 16 KiB " << large);
+    CHECK(small > 0.0);
+}
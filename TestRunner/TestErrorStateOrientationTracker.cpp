@@ -0,0 +1,220 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include "ErrorStateOrientationTracker.hpp"
+#include "OrientationTracker.hpp"
+#include <Eigen/Dense>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+constexpr float m_mpif = static_cast<float>(std::numbers::pi);
+
+static au::QuantityU64<au::Milli<au::Seconds>> ms(uint64_t value)
+{
+    return au::make_quantity<au::Milli<au::Seconds>>(value);
+}
+
+static float angleBetween(const Eigen::Quaternionf &a, const Eigen::Quaternionf &b)
+{
+    const Eigen::Quaternionf d = a.conjugate() * b;
+    return 2.f * std::atan2(d.vec().norm(), std::abs(d.w()));
+}
+
+TEST_CASE("ErrorStateAccGyrMagOrientationTracker initializes with identity quaternion and zero bias")
+{
+    ErrorStateAccGyrMagOrientationTracker tracker;
+    CHECK(tracker.getOrientation().isApprox(Eigen::Quaternionf::Identity(), 1e-6f));
+    CHECK(tracker.getGyroBias().isZero());
+}
+
+TEST_CASE("ErrorState predictTo integrates the nominal quaternion using gyro rate")
+{
+    ErrorStateGyrMagOrientationTracker tracker;
+    tracker.setGyroAngularRate(Eigen::Vector3f(0.f, 0.f, m_mpif / 2.f));
+    tracker.predictTo(ms(1000));
+
+    const float yaw = tracker.getYawPitchRoll()(0);
+    CHECK(std::abs(yaw - m_mpif / 2.f) < 1e-4f);
+    CHECK(std::abs(tracker.getOrientation().norm() - 1.f) < 1e-6f);
+}
+
+TEST_CASE("AttitudeErrorTransition matches the dense Phi P Phi^T")
+{
+    std::srand(34);
+    const Eigen::Vector3f omega(0.4f, -1.1f, 2.3f);
+    const float dt = 0.01f;
+    const AttitudeErrorTransition transition(omega, dt);
+
+    Eigen::Matrix<float, 6, 6> phi = Eigen::Matrix<float, 6, 6>::Identity();
+    phi.topLeftCorner<3, 3>() = Eigen::AngleAxisf(omega.norm() * dt, omega.normalized()).toRotationMatrix().transpose();
+    phi.topRightCorner<3, 3>() = -dt * Eigen::Matrix3f::Identity();
+
+    const Eigen::Matrix<float, 6, 6> root = Eigen::Matrix<float, 6, 6>::Random();
+    Eigen::Matrix<float, 6, 6> P = root * root.transpose();
+    Eigen::Matrix<float, 6, 1> x = Eigen::Matrix<float, 6, 1>::Random();
+
+    const Eigen::Matrix<float, 6, 6> expected_P = phi * P * phi.transpose();
+    const Eigen::Matrix<float, 6, 1> expected_x = phi * x;
+    transition.propagate(x, P);
+
+    CHECK((P - expected_P).cwiseAbs().maxCoeff() < 1e-5f);
+    CHECK((x - expected_x).cwiseAbs().maxCoeff() < 1e-6f);
+    CHECK((P - P.transpose()).cwiseAbs().maxCoeff() == 0.f);
+}
+
+TEST_CASE("ErrorStateAccGyrMagOrientationTracker converges from a large attitude error")
+{
+    ErrorStateAccGyrMagOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(0.0f, 0.0f, 9.81f), Eigen::Vector3f(1.0f, 0.0f, 0.0f));
+
+    const Eigen::Quaternionf q_true = Eigen::AngleAxisf(m_mpif / 4.f, Eigen::Vector3f::UnitZ()) *
+                                      Eigen::AngleAxisf(0.3f, Eigen::Vector3f::UnitY()) *
+                                      Eigen::AngleAxisf(-0.4f, Eigen::Vector3f::UnitX());
+    const Eigen::Vector3f accel_body = q_true.conjugate() * Eigen::Vector3f(0.0f, 0.0f, 9.81f);
+    const Eigen::Vector3f mag_body = q_true.conjugate() * Eigen::Vector3f(1.0f, 0.0f, 0.0f);
+
+    for (uint64_t i = 1; i <= 50; ++i)
+        tracker.updateSensorFusion(Eigen::Vector3f::Zero(), accel_body, mag_body, ms(10 * i));
+
+    CHECK(angleBetween(tracker.getOrientation(), q_true) < 0.01f);
+}
+
+TEST_CASE("ErrorStateAccGyrMagOrientationTracker estimates a constant gyro bias")
+{
+    ErrorStateAccGyrMagOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(0.0f, 0.0f, 9.81f), Eigen::Vector3f(1.0f, 0.0f, 0.0f));
+
+    // Stationary, level and facing north while the gyro reports its bias
+    const Eigen::Vector3f bias(0.02f, -0.01f, 0.015f);
+    const Eigen::Vector3f accel_body(0.0f, 0.0f, 9.81f);
+    const Eigen::Vector3f mag_body(1.0f, 0.0f, 0.0f);
+
+    for (uint64_t i = 1; i <= 3000; ++i)
+        tracker.updateSensorFusion(bias, accel_body, mag_body, ms(10 * i));
+
+    MESSAGE("estimated bias " << tracker.getGyroBias().transpose());
+    CHECK((tracker.getGyroBias() - bias).norm() < 2e-3f);
+    CHECK(angleBetween(tracker.getOrientation(), Eigen::Quaternionf::Identity()) < 0.01f);
+
+    // The covariance stays symmetric with positive variances
+    const auto &P = tracker.getCovariance();
+    CHECK((P - P.transpose()).cwiseAbs().maxCoeff() < 1e-9f);
+    CHECK(P.diagonal().minCoeff() > 0.f);
+}
+
+TEST_CASE("ErrorStateGyrMagOrientationTracker follows a yaw rotation with magnetometer corrections")
+{
+    ErrorStateGyrMagOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(1.0f, 0.0f, 0.0f));
+
+    const float rate = 30.f * m_mpif / 180.f;
+    Eigen::Quaternionf q_true = Eigen::Quaternionf::Identity();
+    for (uint64_t i = 1; i <= 200; ++i)
+    {
+        q_true = q_true * Eigen::Quaternionf(Eigen::AngleAxisf(rate * 0.02f, Eigen::Vector3f::UnitZ()));
+        tracker.updateSensorFusion(Eigen::Vector3f(0.f, 0.f, rate), q_true.conjugate() * Eigen::Vector3f(1.0f, 0.0f, 0.0f), ms(20 * i));
+    }
+
+    CHECK(angleBetween(tracker.getOrientation(), q_true) < 0.01f);
+}
+
+TEST_CASE("ErrorStateAccGyrOrientationTracker stabilizes pitch and roll from accelerometer")
+{
+    ErrorStateAccGyrOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(0.0f, 0.0f, 9.81f));
+
+    const Eigen::Quaternionf q_true = Eigen::AngleAxisf(0.2f, Eigen::Vector3f::UnitY()) *
+                                      Eigen::AngleAxisf(-0.3f, Eigen::Vector3f::UnitX());
+    const Eigen::Vector3f accel_body = q_true.conjugate() * Eigen::Vector3f(0.0f, 0.0f, 9.81f);
+
+    for (uint64_t i = 1; i <= 50; ++i)
+        tracker.updateSensorFusion(Eigen::Vector3f::Zero(), accel_body, ms(10 * i));
+
+    const Eigen::Vector3f ypr = tracker.getYawPitchRoll();
+    CHECK(std::abs(ypr(1) - 0.2f) < 0.01f);
+    CHECK(std::abs(ypr(2) + 0.3f) < 0.01f);
+}
+
+struct ImuSample
+{
+    Eigen::Vector3f gyro;
+    Eigen::Vector3f accel;
+    Eigen::Vector3f mag;
+    Eigen::Quaternionf truth;
+    au::QuantityU64<au::Milli<au::Seconds>> timestamp;
+};
+
+// Yaw spin then a tumble sampled at the IMU rate, with a biased gyro and noisy references
+static std::vector<ImuSample> makeImuTrajectory(uint64_t period_ms, int steps, const Eigen::Vector3f &bias)
+{
+    std::srand(34);
+    const Eigen::Vector3f accel_ned(0.0f, 0.0f, 9.81f);
+    const Eigen::Vector3f mag_ned(1.0f, 0.0f, 0.0f);
+    const float dt = 0.001f * static_cast<float>(period_ms);
+
+    std::vector<ImuSample> samples;
+    Eigen::Quaternionf q_true = Eigen::Quaternionf::Identity();
+    for (int step = 1; step <= steps; ++step)
+    {
+        const Eigen::Vector3f omega = step < steps / 2 ? Eigen::Vector3f(0.f, 0.f, 30.f * m_mpif / 180.f)
+                                                       : Eigen::Vector3f(0.2f, -0.15f, 0.05f);
+        q_true = (q_true * Eigen::Quaternionf(Eigen::AngleAxisf(omega.norm() * dt, omega.normalized()))).normalized();
+
+        samples.push_back({omega + bias,
+                           q_true.conjugate() * accel_ned + Eigen::Vector3f::Random() * 0.01f,
+                           q_true.conjugate() * mag_ned + Eigen::Vector3f::Random() * 0.01f,
+                           q_true,
+                           ms(static_cast<uint64_t>(step) * period_ms)});
+    }
+    return samples;
+}
+
+TEST_CASE("ErrorStateAccGyrMagOrientationTracker tracks a tumbling trajectory with a biased gyro")
+{
+    const Eigen::Vector3f bias(0.01f, -0.02f, 0.01f);
+    const std::vector<ImuSample> samples = makeImuTrajectory(10, 2000, bias);
+
+    ErrorStateAccGyrMagOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(0.0f, 0.0f, 9.81f), Eigen::Vector3f(1.0f, 0.0f, 0.0f));
+
+    float max_error = 0.f;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const ImuSample &sample = samples[i];
+        tracker.updateSensorFusion(sample.gyro, sample.accel, sample.mag, sample.timestamp);
+        if (i >= samples.size() / 10)
+            max_error = std::max(max_error, angleBetween(tracker.getOrientation(), sample.truth));
+    }
+
+    MESSAGE("max error after settling " << max_error << " rad, bias " << tracker.getGyroBias().transpose());
+    CHECK(max_error < 0.02f);
+    CHECK((tracker.getGyroBias() - bias).norm() < 5e-3f);
+}
+
+TEST_CASE("Benchmark error-state versus additive quaternion tracker per IMU sample")
+{
+    const std::vector<ImuSample> samples = makeImuTrajectory(5, 1000, Eigen::Vector3f::Zero());
+
+    auto run = [&](auto &tracker)
+    {
+        tracker.setReferenceVectors(Eigen::Vector3f(0.0f, 0.0f, 9.81f), Eigen::Vector3f(1.0f, 0.0f, 0.0f));
+        const auto start = std::chrono::steady_clock::now();
+        for (const ImuSample &sample : samples)
+            tracker.updateSensorFusion(sample.gyro, sample.accel, sample.mag, sample.timestamp);
+        const auto stop = std::chrono::steady_clock::now();
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+               static_cast<double>(samples.size());
+    };
+
+    AccGyrMagOrientationTracker additive;
+    ErrorStateAccGyrMagOrientationTracker error_state;
+    const double additive_ns = run(additive);
+    const double error_state_ns = run(error_state);
+
+    MESSAGE("updateSensorFusion: additive 7-state " << additive_ns << " ns, error-state 6-state "
+                                                    << error_state_ns << " ns per sample");
+    CHECK(additive_ns > 0.0);
+    CHECK(error_state_ns > 0.0);
+    CHECK(angleBetween(error_state.getOrientation(), samples.back().truth) < 0.02f);
+}
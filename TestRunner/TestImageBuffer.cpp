@@ -368,6 +368,66 @@ TEST_CASE("ImageBuffer chunk read")
 }
 
 
+TEST_CASE("ImageBuffer peeks entries by index across the wrap without consuming them")
+{
+    MockAccessor accessor(0, 512);
+    SimpleImageBuffer<MockAccessor> buffer(accessor);
+
+    auto add = [&](uint64_t timestamp, size_t payload_size) {
+        ImageMetadata metadata{};
+        metadata.timestamp = timestamp;
+        metadata.payload_size = static_cast<uint32_t>(payload_size);
+        std::vector<uint8_t> data(payload_size);
+        for (size_t i = 0; i < payload_size; ++i)
+            data[i] = static_cast<uint8_t>(timestamp + i);
+        REQUIRE(buffer.add_image(metadata) == ImageBufferError::NO_ERROR);
+        REQUIRE(buffer.add_data_chunk(data.data(), data.size()) == ImageBufferError::NO_ERROR);
+        REQUIRE(buffer.push_image() == ImageBufferError::NO_ERROR);
+    };
+
+    // Pop the first entry so that the third one wraps around the end of the ring
+    add(1, 200);
+    ImageMetadata metadata{};
+    std::vector<uint8_t> scratch(200);
+    size_t size = scratch.size();
+    REQUIRE(buffer.get_image(metadata) == ImageBufferError::NO_ERROR);
+    REQUIRE(buffer.get_data_chunk(scratch.data(), size) == ImageBufferError::NO_ERROR);
+    REQUIRE(buffer.pop_image() == ImageBufferError::NO_ERROR);
+    add(2, 100);
+    add(3, 150);
+    REQUIRE(buffer.count() == 2);
+    REQUIRE(buffer.get_head() > buffer.get_tail());
+
+    // Start consuming the head, then peek in between
+    REQUIRE(buffer.get_image(metadata) == ImageBufferError::NO_ERROR);
+    CHECK(metadata.timestamp == 2);
+
+    REQUIRE(buffer.peek_image(1, metadata) == ImageBufferError::NO_ERROR);
+    CHECK(metadata.timestamp == 3);
+    CHECK(metadata.payload_size == 150);
+    CHECK(buffer.peek_image(2, metadata) == ImageBufferError::OUT_OF_BOUNDS);
+
+    std::vector<uint8_t> peeked(150);
+    size = 200;
+    REQUIRE(buffer.peek_data(1, 0, peeked.data(), size) == ImageBufferError::NO_ERROR);
+    CHECK(size == 150);
+    for (size_t i = 0; i < peeked.size(); ++i)
+        CHECK(peeked[i] == static_cast<uint8_t>(3 + i));
+
+    size = 10;
+    REQUIRE(buffer.peek_data(1, 145, peeked.data(), size) == ImageBufferError::NO_ERROR);
+    CHECK(size == 5);
+    CHECK(peeked[0] == static_cast<uint8_t>(3 + 145));
+
+    // The consumer carries on where it was, payload CRC included
+    size = scratch.size();
+    REQUIRE(buffer.get_data_chunk(scratch.data(), size) == ImageBufferError::NO_ERROR);
+    CHECK(size == 100);
+    CHECK(scratch[99] == static_cast<uint8_t>(2 + 99));
+    CHECK(buffer.pop_image() == ImageBufferError::NO_ERROR);
+    CHECK(buffer.count() == 1);
+}
+
 TEST_CASE("ImageBuffer with DirectMemoryAccessor")
 {
     DirectMemoryAccessor accessor(0x8000000, 4096); // Flash starts at 0x8000000, size 4096
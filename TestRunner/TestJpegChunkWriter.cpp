@@ -0,0 +1,249 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "mock_hal.h"
+#include "DcmiStripStream.hpp"
+#include "JpegChunkWriter.hpp"
+#include "ImageBuffer.hpp"
+#include "imagebuffer/DirectMemoryAccessor.hpp"
+
+using Buffer = ImageBuffer<DirectMemoryAccessor>;
+constexpr size_t CHUNK = 512;
+constexpr size_t STRIP = 64;
+using Writer = JpegChunkWriter<Buffer, CHUNK>;
+
+// Baseline JPEG with the marker layout of the OV5640 output. The tables are filler, but the
+// quantisation table holds FF D0 to catch a parser that looks for markers inside segments.
+static std::vector<uint8_t> cannedJpeg(size_t intervals, size_t intervalBytes, bool restartMarkers, bool eoi = true)
+{
+    std::vector<uint8_t> j = {0xFF, 0xD8};
+    auto segment = [&](uint8_t marker, std::vector<uint8_t> payload) {
+        const size_t length = payload.size() + 2;
+        j.insert(j.end(), {0xFF, marker, uint8_t(length >> 8), uint8_t(length)});
+        j.insert(j.end(), payload.begin(), payload.end());
+    };
+
+    segment(0xE0, {'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0});
+    std::vector<uint8_t> dqt(65, 0x10);
+    dqt[0] = 0;
+    dqt[20] = 0xFF;
+    dqt[21] = 0xD0;
+    segment(0xDB, dqt);
+    segment(0xC0, {8, 0x01, 0xE0, 0x02, 0x80, 3, 1, 0x21, 0, 2, 0x11, 1, 3, 0x11, 1});
+    segment(0xC4, std::vector<uint8_t>(29, 0x01));
+    if (restartMarkers)
+        segment(0xDD, {0x00, 0x28});
+    segment(0xDA, {3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0});
+
+    uint32_t x = 0xC0FFEEu;
+    for (size_t n = 0; n < intervals; ++n)
+    {
+        if (n > 0 && restartMarkers)
+            j.insert(j.end(), {0xFF, uint8_t(0xD0 + (n - 1) % 8)});
+        for (size_t i = 0; i < intervalBytes; ++i)
+        {
+            x = x * 1664525u + 1013904223u;
+            const uint8_t b = uint8_t(x >> 24);
+            j.push_back(b);
+            if (b == 0xFF)
+                j.push_back(0x00); // byte stuffing
+        }
+    }
+    if (eoi)
+        j.insert(j.end(), {0xFF, 0xD9});
+    return j;
+}
+
+struct Part
+{
+    ImageMetadata meta;
+    std::vector<uint8_t> data;
+};
+
+static std::vector<Part> readParts(Buffer &buffer)
+{
+    std::vector<Part> parts;
+    while (!buffer.is_empty())
+    {
+        Part part{};
+        REQUIRE(buffer.get_image(part.meta) == ImageBufferError::NO_ERROR);
+        part.data.resize(part.meta.payload_size);
+        size_t size = part.data.size();
+        REQUIRE(buffer.get_data_chunk(part.data.data(), size) == ImageBufferError::NO_ERROR);
+        REQUIRE(size == part.data.size());
+        REQUIRE(buffer.pop_image() == ImageBufferError::NO_ERROR);
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+static std::vector<uint8_t> join(const std::vector<Part> &parts)
+{
+    std::vector<uint8_t> all;
+    for (const auto &part : parts)
+        all.insert(all.end(), part.data.begin(), part.data.end());
+    return all;
+}
+
+static bool startsWithRestart(const Part &part)
+{
+    return part.data.size() >= 2 && part.data[0] == 0xFF && part.data[1] >= 0xD0 && part.data[1] <= 0xD7;
+}
+
+// The sensor stream through the mock DCMI: strips are drained into the writer after every DMA event
+static bool capture(const std::vector<uint8_t> &stream, Writer &writer)
+{
+    static DcmiStripStream<STRIP> strips;
+    static DcmiStripStream<STRIP> *active;
+    active = &strips;
+
+    DCMI_HandleTypeDef hdcmi{};
+    HAL_DCMI_Init(&hdcmi);
+    set_dcmi_stream_callbacks(
+        &hdcmi,
+        [](DCMI_HandleTypeDef *) { active->onHalfTransfer(); },
+        [](DCMI_HandleTypeDef *) { active->onTransferComplete(); },
+        [](DCMI_HandleTypeDef *h) { active->onFrameEnd(mock_dcmi_dma_remaining(h)); });
+    set_dcmi_stream_source(&hdcmi, stream.data(), static_cast<uint32_t>(stream.size()));
+    REQUIRE(HAL_DCMI_Start_DMA(&hdcmi, DCMI_MODE_SNAPSHOT, strips.begin(), strips.RING_WORDS) == HAL_OK);
+
+    ImageMetadata meta{};
+    meta.timestamp = 42;
+    meta.dimensions = {640, 480, 2};
+    meta.producer = METADATA_PRODUCER::CAMERA_2;
+    writer.begin(meta);
+
+    while (mock_dcmi_dma_step(&hdcmi))
+        REQUIRE(strips.drain(writer));
+    REQUIRE(strips.drain(writer));
+    REQUIRE(strips.complete());
+    return writer.finish();
+}
+
+TEST_CASE("JpegChunkWriter cuts a captured JPEG at restart markers")
+{
+    DirectMemoryAccessor accessor(0x90000000, 256 * 1024);
+    Buffer buffer(accessor);
+    Writer writer(buffer);
+
+    const auto jpeg = cannedJpeg(120, 150, true);
+    auto stream = jpeg;
+    stream.insert(stream.end(), 37, 0x00); // DCMI padding after EOI
+
+    REQUIRE(capture(stream, writer));
+    CHECK(writer.done());
+    CHECK(writer.bytes() == jpeg.size());
+
+    const auto parts = readParts(buffer);
+    REQUIRE(parts.size() == writer.parts());
+    REQUIRE(parts.size() > 30);
+    CHECK(join(parts) == jpeg);
+
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        const auto &meta = parts[i].meta;
+        CHECK(meta.part == i);
+        CHECK(meta.format == METADATA_FORMAT::JPEG);
+        CHECK(meta.timestamp == 42);
+        CHECK(meta.producer == METADATA_PRODUCER::CAMERA_2);
+        CHECK(parts[i].data.size() <= CHUNK);
+        CHECK((meta.part_flags & METADATA_PART_UNALIGNED) == 0);
+        CHECK((meta.part_flags & METADATA_PART_TRUNCATED) == 0);
+        CHECK(((meta.part_flags & METADATA_PART_LAST) != 0) == (i + 1 == parts.size()));
+        // Every part a decoder can start on
+        if (i > 0)
+            CHECK(startsWithRestart(parts[i]));
+    }
+
+    // The headers, including the FF D0 inside the quantisation table, stay together in part 0
+    CHECK(parts[0].data[0] == 0xFF);
+    CHECK(parts[0].data[1] == 0xD8);
+    CHECK(parts[0].data.size() > 200);
+    CHECK(parts.back().data.end()[-2] == 0xFF);
+    CHECK(parts.back().data.end()[-1] == 0xD9);
+}
+
+TEST_CASE("JpegChunkWriter skips bytes before SOI")
+{
+    DirectMemoryAccessor accessor(0x90000000, 64 * 1024);
+    Buffer buffer(accessor);
+    Writer writer(buffer);
+
+    const auto jpeg = cannedJpeg(10, 100, true);
+    std::vector<uint8_t> stream = {0x00, 0xFF, 0x12, 0xFF, 0xFF};
+    stream.insert(stream.end(), jpeg.begin(), jpeg.end());
+
+    REQUIRE(capture(stream, writer));
+    CHECK(join(readParts(buffer)) == jpeg);
+}
+
+TEST_CASE("JpegChunkWriter falls back to plain cuts without restart markers")
+{
+    DirectMemoryAccessor accessor(0x90000000, 64 * 1024);
+    Buffer buffer(accessor);
+    Writer writer(buffer);
+
+    const auto jpeg = cannedJpeg(1, 3000, false);
+    REQUIRE(capture(jpeg, writer));
+
+    const auto parts = readParts(buffer);
+    REQUIRE(parts.size() == (jpeg.size() + CHUNK - 1) / CHUNK);
+    CHECK(join(parts) == jpeg);
+    for (size_t i = 0; i + 1 < parts.size(); ++i)
+    {
+        CHECK(parts[i].data.size() == CHUNK);
+        CHECK((parts[i].meta.part_flags & METADATA_PART_UNALIGNED) != 0);
+    }
+    CHECK(parts.back().meta.part_flags == METADATA_PART_LAST);
+}
+
+TEST_CASE("JpegChunkWriter keeps a stream cut off before EOI")
+{
+    DirectMemoryAccessor accessor(0x90000000, 64 * 1024);
+    Buffer buffer(accessor);
+    Writer writer(buffer);
+
+    const auto jpeg = cannedJpeg(20, 100, true, false);
+    REQUIRE(capture(jpeg, writer));
+    CHECK(writer.done());
+
+    // Without EOI the DCMI word padding cannot be told apart from data
+    const auto parts = readParts(buffer);
+    const auto all = join(parts);
+    REQUIRE(all.size() >= jpeg.size());
+    CHECK(all.size() - jpeg.size() < 4);
+    CHECK(std::equal(jpeg.begin(), jpeg.end(), all.begin()));
+    CHECK(parts.back().meta.part_flags == (METADATA_PART_LAST | METADATA_PART_TRUNCATED));
+}
+
+TEST_CASE("JpegChunkWriter reports frames without JPEG and a full buffer")
+{
+    SUBCASE("no SOI")
+    {
+        DirectMemoryAccessor accessor(0x90000000, 64 * 1024);
+        Buffer buffer(accessor);
+        Writer writer(buffer);
+        CHECK_FALSE(capture(std::vector<uint8_t>(1000, 0x55), writer));
+        CHECK(writer.parts() == 0);
+        CHECK(buffer.is_empty());
+    }
+
+    SUBCASE("full buffer")
+    {
+        DirectMemoryAccessor accessor(0x90000000, 4 * 1024);
+        Buffer buffer(accessor);
+        Writer writer(buffer);
+
+        ImageMetadata meta{};
+        writer.begin(meta);
+        const auto jpeg = cannedJpeg(100, 150, true);
+        CHECK_FALSE(writer(jpeg.data(), jpeg.size()));
+        CHECK(writer.error() == ImageBufferError::FULL_BUFFER);
+        CHECK_FALSE(writer.finish());
+        CHECK(writer.parts() > 0);
+    }
+}
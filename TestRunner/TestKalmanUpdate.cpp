@@ -0,0 +1,342 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <Eigen/Dense>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "Kalman.hpp"
+
+#ifdef __x86_64__
+#include <x86intrin.h>
+#endif
+
+// Textbook update as implemented before: explicit inverse and the (I - K H) P covariance form
+template <int N, int M>
+void legacyUpdate(KalmanFilter<N, M> &kf, const Eigen::Matrix<float, M, N> &H, const Eigen::Matrix<float, M, 1> &z)
+{
+    Eigen::Matrix<float, M, 1> innovation = z - H * kf.stateVector;
+    Eigen::Matrix<float, M, M> S = H * kf.stateCovarianceMatrix * H.transpose() + kf.measurementNoiseCovarianceMatrix;
+    Eigen::Matrix<float, N, M> K = kf.stateCovarianceMatrix * H.transpose() * S.inverse();
+    kf.stateVector = kf.stateVector + K * innovation;
+    kf.stateCovarianceMatrix = (Eigen::Matrix<float, N, N>::Identity() - K * H) * kf.stateCovarianceMatrix;
+}
+
+template <int N>
+Eigen::Matrix<float, N, N> randomSpd(float floor)
+{
+    const Eigen::Matrix<float, N, N> A = Eigen::Matrix<float, N, N>::Random();
+    return A * A.transpose() + Eigen::Matrix<float, N, N>::Identity() * floor;
+}
+
+template <int N, int M>
+KalmanFilter<N, M> makeFilter()
+{
+    return KalmanFilter<N, M>(Eigen::Matrix<float, N, N>::Identity() * 1e-3f,
+                              Eigen::Matrix<float, M, M>::Identity() * 0.05f,
+                              randomSpd<N>(0.1f),
+                              Eigen::Matrix<float, N, 1>::Random());
+}
+
+template <int N, int Offset, int M>
+Eigen::Matrix<float, M, N> selector()
+{
+    Eigen::Matrix<float, M, N> H = Eigen::Matrix<float, M, N>::Zero();
+    H.template block<M, M>(0, Offset).setIdentity();
+    return H;
+}
+
+template <int N, int M>
+void checkMatchesLegacy(bool sequential)
+{
+    KalmanFilter<N, M> kf = makeFilter<N, M>();
+    kf.sequentialWhenDiagonal = sequential;
+    KalmanFilter<N, M> reference = kf;
+    const Eigen::Matrix<float, M, N> H = Eigen::Matrix<float, M, N>::Random();
+    const Eigen::Matrix<float, M, 1> z = Eigen::Matrix<float, M, 1>::Random();
+
+    REQUIRE(kf.update(H, z));
+    legacyUpdate(reference, H, z);
+
+    CHECK((kf.stateVector - reference.stateVector).norm() < 1e-4f * (1.f + reference.stateVector.norm()));
+    CHECK((kf.stateCovarianceMatrix - reference.stateCovarianceMatrix).norm() <
+          1e-3f * (1.f + reference.stateCovarianceMatrix.norm()));
+    CHECK((kf.stateCovarianceMatrix - kf.stateCovarianceMatrix.transpose()).norm() == 0.f);
+}
+
+TEST_CASE("Cholesky update matches the textbook update")
+{
+    std::srand(31);
+    for (bool sequential : {false, true})
+    {
+        CAPTURE(sequential);
+        checkMatchesLegacy<6, 3>(sequential);
+        checkMatchesLegacy<7, 3>(sequential);
+        checkMatchesLegacy<7, 6>(sequential);
+        checkMatchesLegacy<9, 3>(sequential);
+        checkMatchesLegacy<2, 1>(sequential);
+    }
+}
+
+TEST_CASE("Sequential scalar updates reproduce the batch update")
+{
+    std::srand(34);
+    KalmanFilter<7, 6> batch = makeFilter<7, 6>();
+    batch.measurementNoiseCovarianceMatrix.diagonal() << 0.01f, 0.02f, 0.03f, 0.1f, 0.2f, 0.3f;
+    batch.sequentialWhenDiagonal = false;
+    KalmanFilter<7, 6> sequential = batch;
+    sequential.sequentialWhenDiagonal = true;
+
+    const Eigen::Matrix<float, 6, 7> H = Eigen::Matrix<float, 6, 7>::Random();
+    const Eigen::Matrix<float, 6, 1> z = Eigen::Matrix<float, 6, 1>::Random();
+    auto h = [&](const Eigen::Matrix<float, 7, 1> &x) -> Eigen::Matrix<float, 6, 1>
+    { return H * x + Eigen::Matrix<float, 6, 1>::Constant(0.1f); };
+
+    REQUIRE(batch.updateEKF(h, H, z));
+    REQUIRE(sequential.updateEKF(h, H, z));
+    CHECK((batch.stateVector - sequential.stateVector).norm() < 1e-4f * (1.f + batch.stateVector.norm()));
+    CHECK((batch.stateCovarianceMatrix - sequential.stateCovarianceMatrix).norm() < 1e-4f * batch.stateCovarianceMatrix.norm());
+
+    REQUIRE(batch.template updateSelected<1>(z));
+    REQUIRE(sequential.template updateSelected<1>(z));
+    CHECK((batch.stateVector - sequential.stateVector).norm() < 1e-4f * (1.f + batch.stateVector.norm()));
+    CHECK((batch.stateCovarianceMatrix - sequential.stateCovarianceMatrix).norm() < 1e-4f * batch.stateCovarianceMatrix.norm());
+
+    // A correlated R is always processed as a batch
+    KalmanFilter<7, 6> correlated = batch;
+    correlated.measurementNoiseCovarianceMatrix(0, 1) = correlated.measurementNoiseCovarianceMatrix(1, 0) = 0.005f;
+    correlated.sequentialWhenDiagonal = true;
+    KalmanFilter<7, 6> reference = correlated;
+    reference.sequentialWhenDiagonal = false;
+    REQUIRE(correlated.update(H, z));
+    REQUIRE(reference.update(H, z));
+    CHECK(correlated.stateVector == reference.stateVector);
+}
+
+TEST_CASE("Sequential update with a negative row variance leaves the state untouched")
+{
+    std::srand(33);
+    KalmanFilter<6, 3> kf = makeFilter<6, 3>();
+    kf.sequentialWhenDiagonal = true;
+    // The first two rows are fine, the last cannot be applied
+    kf.measurementNoiseCovarianceMatrix(2, 2) = -1e3f;
+    const Eigen::Vector3f z(1.f, -2.f, 0.5f);
+
+    const KalmanFilter<6, 3> before = kf;
+    CHECK_FALSE(kf.update(selector<6, 1, 3>(), z));
+    CHECK(kf.stateVector == before.stateVector);
+    CHECK(kf.stateCovarianceMatrix == before.stateCovarianceMatrix);
+
+    CHECK_FALSE(kf.updateSelected<1>(z));
+    CHECK(kf.stateVector == before.stateVector);
+    CHECK(kf.stateCovarianceMatrix == before.stateCovarianceMatrix);
+}
+
+TEST_CASE("Selector update equals the dense update with H = [0 I 0]")
+{
+    std::srand(32);
+    KalmanFilter<9, 3> dense = makeFilter<9, 3>();
+    KalmanFilter<9, 3> blocks = dense;
+    const Eigen::Vector3f z(1.f, -2.f, 0.5f);
+
+    REQUIRE(dense.update(selector<9, 6, 3>(), z));
+    REQUIRE(blocks.updateSelected<6>(z));
+
+    CHECK((dense.stateVector - blocks.stateVector).norm() < 1e-5f);
+    CHECK((dense.stateCovarianceMatrix - blocks.stateCovarianceMatrix).norm() < 1e-5f);
+
+    // Size smaller than MeasurementSize with its own noise
+    Eigen::Matrix<float, 1, 1> r;
+    r << 0.2f;
+    Eigen::Matrix<float, 1, 1> scalar;
+    scalar << 3.f;
+    KalmanFilter<9, 1> single(dense.processNoiseCovarianceMatrix, r, dense.stateCovarianceMatrix, dense.stateVector);
+    REQUIRE(single.update(selector<9, 4, 1>(), scalar));
+    REQUIRE(dense.updateSelected<4, 1>(scalar, r));
+    CHECK((dense.stateVector - single.stateVector).norm() < 1e-5f);
+}
+
+TEST_CASE("Covariance stays symmetric and positive definite over long runs")
+{
+    constexpr float dt = 0.01f;
+    Eigen::Matrix<float, 9, 9> A = Eigen::Matrix<float, 9, 9>::Identity();
+    for (int i = 0; i < 3; ++i)
+    {
+        A(i, i + 3) = dt;
+        A(i, i + 6) = 0.5f * dt * dt;
+        A(i + 3, i + 6) = dt;
+    }
+
+    auto make = []
+    {
+        return KalmanFilter<9, 3>(Eigen::Matrix<float, 9, 9>::Identity() * 1e-4f,
+                                  Eigen::Matrix3f::Identity() * 5e-3f,
+                                  Eigen::Matrix<float, 9, 9>::Identity() * 1e-4f,
+                                  Eigen::Matrix<float, 9, 1>::Zero());
+    };
+    KalmanFilter<9, 3> kf = make();
+    KalmanFilter<9, 3> legacy = make();
+    const Eigen::Matrix<float, 3, 9> H_gps = selector<9, 0, 3>();
+    const Eigen::Matrix<float, 3, 9> H_acc = selector<9, 6, 3>();
+
+    float legacy_asymmetry = 0.f;
+    for (int step = 0; step < 5000; ++step)
+    {
+        const float t = static_cast<float>(step) * dt;
+        const Eigen::Vector3f position(std::sin(t), std::cos(t), 0.1f * t);
+        const Eigen::Vector3f accel(-std::sin(t), -std::cos(t), 0.f);
+
+        kf.predict(A);
+        legacy.predict(A);
+        REQUIRE(kf.updateSelected<6>(accel));
+        legacyUpdate(legacy, H_acc, accel);
+        if (step % 10 == 0)
+        {
+            REQUIRE(kf.updateSelected<0>(position));
+            legacyUpdate(legacy, H_gps, position);
+        }
+        legacy_asymmetry = std::max(legacy_asymmetry,
+                                    (legacy.stateCovarianceMatrix - legacy.stateCovarianceMatrix.transpose()).cwiseAbs().maxCoeff());
+    }
+
+    MESSAGE("max |P - P^T|: legacy " << legacy_asymmetry << ", joseph 0");
+    CHECK((kf.stateCovarianceMatrix - kf.stateCovarianceMatrix.transpose()).cwiseAbs().maxCoeff() == 0.f);
+    CHECK(Eigen::LLT<Eigen::Matrix<float, 9, 9>>(kf.stateCovarianceMatrix).info() == Eigen::Success);
+    CHECK((kf.stateVector - legacy.stateVector).norm() < 1e-2f);
+}
+
+TEST_CASE("Joseph update keeps an ill-conditioned covariance positive semi-definite")
+{
+    // Eigenvalues from 1e2 down to 1e-4 in a random basis, with the two large directions
+    // measured to 1e-6: P - K S K^T cancels 1e2 down to 1e-6 and goes indefinite in float
+    const Eigen::Matrix<float, 6, 6> Q = Eigen::HouseholderQR<Eigen::Matrix<float, 6, 6>>(
+                                             Eigen::Matrix<float, 6, 6>::Random())
+                                             .householderQ();
+    Eigen::Matrix<float, 6, 1> spectrum;
+    spectrum << 1e2f, 10.f, 1.f, 1e-2f, 1e-3f, 1e-4f;
+    const Eigen::Matrix<float, 6, 6> P = Q * spectrum.asDiagonal() * Q.transpose();
+    const Eigen::Matrix<float, 2, 6> H = Q.leftCols<2>().transpose();
+
+    for (const bool sequential : {false, true})
+    {
+        KalmanFilter<6, 2> kf(Eigen::Matrix<float, 6, 6>::Zero(), Eigen::Matrix2f::Identity() * 1e-6f,
+                              0.5f * (P + P.transpose()), Eigen::Matrix<float, 6, 1>::Zero());
+        kf.sequentialWhenDiagonal = sequential;
+
+        float worst = 1.f;
+        for (int step = 0; step < 50; ++step)
+        {
+            REQUIRE(kf.update(H, Eigen::Vector2f::Random()));
+            const Eigen::Matrix<float, 6, 1> eigenvalues =
+                Eigen::SelfAdjointEigenSolver<Eigen::Matrix<float, 6, 6>>(kf.stateCovarianceMatrix).eigenvalues();
+            worst = std::min(worst, eigenvalues.minCoeff() / eigenvalues.maxCoeff());
+        }
+        MESSAGE((sequential ? "sequential" : "batch") << " min/max eigenvalue of P: " << worst);
+        // Semi-definite to working precision
+        CHECK(worst > -6.f * std::numeric_limits<float>::epsilon());
+    }
+}
+
+TEST_CASE("Semi-definite innovation covariance falls back to LDLT and the Joseph form")
+{
+    // Exact measurement of x0 together with an element that has no uncertainty: S = diag(1, 0)
+    Eigen::Matrix3f P = Eigen::Vector3f(1.f, 0.f, 1.f).asDiagonal();
+    P(0, 2) = P(2, 0) = 0.5f;
+    KalmanFilter<3, 2> kf(Eigen::Matrix3f::Identity(), Eigen::Matrix2f::Zero(), P, Eigen::Vector3f::Zero());
+    kf.sequentialWhenDiagonal = false;
+
+    KalmanFilter<3, 2> sequential = kf;
+    sequential.sequentialWhenDiagonal = true;
+
+    for (KalmanFilter<3, 2> *filter : {&kf, &sequential})
+    {
+        REQUIRE(filter->updateSelected<0>(Eigen::Vector2f(2.f, 0.f)));
+        CHECK(filter->stateVector(0) == doctest::Approx(2.f));
+        CHECK(filter->stateVector(2) == doctest::Approx(1.f));
+        CHECK(filter->stateCovarianceMatrix(0, 0) == doctest::Approx(0.f));
+        CHECK(filter->stateCovarianceMatrix(2, 2) == doctest::Approx(0.75f));
+        CHECK((filter->stateCovarianceMatrix - filter->stateCovarianceMatrix.transpose()).norm() == 0.f);
+    }
+}
+
+TEST_CASE("Update is rejected when the innovation covariance is not positive definite")
+{
+    Eigen::Matrix<float, 3, 3> P = Eigen::Matrix3f::Identity();
+    Eigen::Matrix<float, 1, 1> R;
+    R << -2.f;
+    KalmanFilter<3, 1> kf(Eigen::Matrix3f::Identity(), R, P, Eigen::Vector3f(1.f, 2.f, 3.f));
+
+    Eigen::Matrix<float, 1, 1> z;
+    z << 10.f;
+    CHECK_FALSE(kf.updateSelected<0>(z));
+    CHECK(kf.stateVector == Eigen::Vector3f(1.f, 2.f, 3.f));
+    CHECK(kf.stateCovarianceMatrix == P);
+}
+
+struct UpdateTiming
+{
+    double ns;
+    double ticks;
+};
+
+template <typename Fn>
+UpdateTiming timeUpdates(size_t iterations, Fn fn)
+{
+#ifdef __x86_64__
+    const uint64_t tsc_start = __rdtsc();
+#endif
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        fn();
+    const auto stop = std::chrono::steady_clock::now();
+#ifdef __x86_64__
+    const double ticks = static_cast<double>(__rdtsc() - tsc_start) / static_cast<double>(iterations);
+#else
+    const double ticks = 0.0;
+#endif
+    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+    return UpdateTiming{ns / static_cast<double>(iterations), ticks};
+}
+
+template <int N, int M, int Offset>
+void benchmarkFilter(const char *label)
+{
+    constexpr size_t ITERATIONS = 1000;
+    const KalmanFilter<N, M> initial = makeFilter<N, M>();
+    const Eigen::Matrix<float, M, N> H = selector<N, Offset, M>();
+    const Eigen::Matrix<float, M, 1> z = Eigen::Matrix<float, M, 1>::Random();
+
+    // Re-seed P every iteration so each variant does identical work on a well-conditioned P
+    KalmanFilter<N, M> kf = initial;
+    const UpdateTiming legacy = timeUpdates(ITERATIONS, [&]
+                                            { kf.stateCovarianceMatrix = initial.stateCovarianceMatrix; legacyUpdate(kf, H, z); });
+
+    kf.sequentialWhenDiagonal = false;
+    const UpdateTiming dense = timeUpdates(ITERATIONS, [&]
+                                           { kf.stateCovarianceMatrix = initial.stateCovarianceMatrix; kf.update(H, z); });
+    const UpdateTiming blocks = timeUpdates(ITERATIONS, [&]
+                                            { kf.stateCovarianceMatrix = initial.stateCovarianceMatrix; kf.template updateSelected<Offset>(z); });
+
+    kf.sequentialWhenDiagonal = true;
+    const UpdateTiming dense_sequential = timeUpdates(ITERATIONS, [&]
+                                                      { kf.stateCovarianceMatrix = initial.stateCovarianceMatrix; kf.update(H, z); });
+    const UpdateTiming blocks_sequential = timeUpdates(ITERATIONS, [&]
+                                                       { kf.stateCovarianceMatrix = initial.stateCovarianceMatrix; kf.template updateSelected<Offset>(z); });
+
+    MESSAGE(label << ": inverse " << legacy.ns << " ns (" << legacy.ticks << " tsc), "
+                  << "cholesky " << dense.ns << " ns (" << dense.ticks << " tsc), "
+                  << "selector " << blocks.ns << " ns (" << blocks.ticks << " tsc), "
+                  << "sequential " << dense_sequential.ns << " ns (" << dense_sequential.ticks << " tsc), "
+                  << "sequential selector " << blocks_sequential.ns << " ns (" << blocks_sequential.ticks << " tsc) per update");
+    CHECK(kf.stateVector.allFinite());
+}
+
+TEST_CASE("Benchmark update cost for the 6-, 7- and 9-state filters")
+{
+    std::srand(33);
+    benchmarkFilter<6, 3, 0>("Sgp4PositionTracker 6x3");
+    benchmarkFilter<7, 3, 4>("GyrMagOrientationTracker 7x3");
+    benchmarkFilter<7, 6, 0>("AccGyrMagOrientationTracker 7x6");
+    benchmarkFilter<9, 3, 6>("PositionTracker9D 9x3");
+}
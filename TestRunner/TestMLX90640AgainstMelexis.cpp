@@ -1,8 +1,12 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
 
+#include <cmath>
+#include <cstring>
+
 #include "MLX90640Calibration.hpp"   // your constexpr parser
 #include "MLX90640EEPROM.h"
+#include "MLX90640ImageProcessor.hpp"
 #include "3rdParty/MLX90640_API.h"            // Melexis reference
 
 TEST_CASE("MLX90640: our calibration matches Melexis ExtractParameters")
@@ -96,3 +100,125 @@ TEST_CASE("MLX90640: our calibration matches Melexis ExtractParameters")
         CHECK(ours.outlierPixels[i] == ref.outlierPixels[i]);
     }
 }
+
+static paramsMLX90640 melexisParameters()
+{
+    uint16_t ee[832];
+    std::memcpy(ee, MLX90640_EEPROM, sizeof(ee));
+    paramsMLX90640 params{};
+    REQUIRE(MLX90640_ExtractParameters(ee, &params) == MLX90640_NO_ERROR);
+    return params;
+}
+
+// Subpage with datasheet-like auxiliary data (Ta near 40 degC, Vdd 3.3 V) and a pixel
+// signal ramp that spans the cold, ambient and hot ksTo ranges
+static void buildSubpage(uint16_t* frame, uint16_t subPage, bool chessMode, int16_t vbe)
+{
+    const auto& P = MLX90640_CAL;
+    for (int pix = 0; pix < 768; ++pix)
+    {
+        const int signal = -2400 + (pix * 97) % 12000;
+        frame[pix] = uint16_t(int16_t(P.offset[pix] + signal / 4));
+    }
+    for (int i = 768; i < 832; ++i)
+        frame[i] = 0;
+    frame[768] = uint16_t(vbe);
+    frame[776] = uint16_t(int16_t(P.cpOffset[0] + 10));
+    frame[778] = uint16_t(P.gainEE - 120);
+    frame[800] = 1711;
+    frame[808] = uint16_t(int16_t(P.cpOffset[1] + 12));
+    frame[810] = uint16_t(P.vdd25 + 40);
+    frame[832] = uint16_t((chessMode ? 0x1000 : 0) | (P.resolutionEE << 10) | 0x0180 | 0x0001);
+    frame[833] = subPage;
+}
+
+// The per-pixel constants are folded by the compiler
+static_assert(MLX90640_PIXEL_CONSTANTS.subpagePixels[1][0][0] == 0);
+static_assert(MLX90640_PIXEL_CONSTANTS.subpagePixels[1][1][0] == 1);
+static_assert(MLX90640_PIXEL_CONSTANTS.subpagePixels[0][1][0] == 32);
+static_assert(MLX90640_PIXEL_CONSTANTS.alphaCorrR[1] == 1.0f);
+
+TEST_CASE("MLX90640: computeObjectTemperatures matches Melexis CalculateTo per pixel")
+{
+    const paramsMLX90640 params = melexisParameters();
+    MLX90640ImageProcessor proc;
+
+    for (bool chessMode : {true, false})
+    {
+        for (uint16_t subPage : {uint16_t(0), uint16_t(1)})
+        {
+            for (int16_t vbe : {int16_t(19442), int16_t(18500)})
+            {
+                CAPTURE(chessMode);
+                CAPTURE(subPage);
+                uint16_t frame[834];
+                buildSubpage(frame, subPage, chessMode, vbe);
+
+                CHECK(MLX90640ImageProcessor::supplyVoltage(frame) == doctest::Approx(MLX90640_GetVdd(frame, &params)).epsilon(1e-5));
+                CHECK(MLX90640ImageProcessor::ambientTemperature(frame) == doctest::Approx(MLX90640_GetTa(frame, &params)).epsilon(1e-4));
+
+                float reference[768];
+                MLX90640ImageProcessor::TempImage ours{};
+                for (int i = 0; i < 768; ++i)
+                {
+                    reference[i] = -1000.0f;
+                    ours[size_t(i)] = -1000.0f;
+                }
+                MLX90640_CalculateTo(frame, &params, 0.95f, 23.15f, reference);
+                REQUIRE(proc.computeObjectTemperatures(frame, ours, 0.95f, 23.15f));
+
+                int written = 0;
+                int ranges[4] = {};
+                float worst = 0.0f;
+                for (int i = 0; i < 768; ++i)
+                {
+                    CAPTURE(i);
+                    REQUIRE((reference[i] == -1000.0f) == (ours[size_t(i)] == -1000.0f));
+                    if (reference[i] == -1000.0f)
+                        continue;
+                    ++written;
+                    REQUIRE(std::isnan(reference[i]) == std::isnan(ours[size_t(i)]));
+                    if (std::isnan(reference[i]))
+                        continue;
+                    worst = std::max(worst, std::fabs(ours[size_t(i)] - reference[i]));
+                    ranges[reference[i] < params.ct[1] ? 0 : reference[i] < params.ct[2] ? 1 : reference[i] < params.ct[3] ? 2 : 3]++;
+                }
+                MESSAGE("max |To - Melexis| " << worst << " degC, pixels per ksTo range " << ranges[0] << "/" << ranges[1] << "/" << ranges[2] << "/" << ranges[3]);
+                CHECK(written == 384);
+                CHECK(worst < 1e-3f);
+                CHECK(ranges[0] > 0);
+                CHECK(ranges[1] > 0);
+                CHECK(ranges[2] > 0);
+                CHECK(ranges[3] > 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("MLX90640: computeObjectTemperatures applies emissivity and reflected temperature")
+{
+    const paramsMLX90640 params = melexisParameters();
+    MLX90640ImageProcessor proc;
+    uint16_t frame[834];
+    buildSubpage(frame, 1, true, 19442);
+
+    for (float emissivity : {1.0f, 0.8f})
+    {
+        for (float tr : {-20.0f, 35.0f})
+        {
+            float reference[768] = {};
+            MLX90640ImageProcessor::TempImage ours{};
+            MLX90640_CalculateTo(frame, &params, emissivity, tr, reference);
+            REQUIRE(proc.computeObjectTemperatures(frame, ours, emissivity, tr));
+            for (uint16_t pix : MLX90640_PIXEL_CONSTANTS.subpagePixels[1][1])
+            {
+                if (!std::isnan(reference[pix]))
+                    REQUIRE(ours[pix] == doctest::Approx(reference[pix]).epsilon(1e-4));
+            }
+        }
+    }
+
+    frame[833] = 2;
+    MLX90640ImageProcessor::TempImage ours{};
+    CHECK_FALSE(proc.computeObjectTemperatures(frame, ours, 0.95f, 23.15f));
+}
@@ -4,9 +4,14 @@
 #include <cstdint>
 #include <cstring>
 #include <array>
+#include <chrono>
+#include <cmath>
 
+#include "FloatVector.hpp"
 #include "MLX90640ImageProcessor.hpp"
 #include "MLX90640Calibration.hpp"
+#include "MLX90640EEPROM.h"
+#include "3rdParty/MLX90640_API.h"            // Melexis reference
 
 // Helper: build a synthetic frame with predictable values
 static void build_test_frame(uint16_t* frame)
@@ -75,3 +80,166 @@ TEST_CASE("MLX90640 computeTemperatures runs without crashing")
     // Instead, we only check that the function executed and filled the array.
     CHECK(temps.size() == MLX90640ImageProcessor::PIXELS);
 }
+
+// Raw image the simplified model maps to finite temperatures at Ta: the offset plus a signal
+// whose sign makes the gain, Kta and Kv compensated value positive
+static MLX90640ImageProcessor::RawImage build_scene(float Ta)
+{
+    const auto& P = MLX90640_CAL;
+    const float Vdd = (Ta - 25.0f) * P.KvPTAT + float(P.vdd25);
+    MLX90640ImageProcessor::RawImage raw{};
+    for (size_t i = 0; i < MLX90640ImageProcessor::PIXELS; ++i)
+    {
+        const float gain = float(P.gainEE) * (1.0f + float(P.kta[i]) * (Ta - 25.0f)) * (1.0f + float(P.kv[i]) * (Vdd - 3.3f));
+        const int16_t signal = int16_t(200 + (i * 37) % 900);
+        raw[i] = int16_t(P.offset[i] + (gain > 0.0f ? signal : -signal));
+    }
+    return raw;
+}
+
+TEST_CASE("MLX90640 computeTemperaturesFast matches computeTemperatures")
+{
+    MLX90640ImageProcessor proc;
+
+    for (float Ta : {-10.0f, 12.34f, 25.0f, 31.7f})
+    {
+        CAPTURE(Ta);
+        const MLX90640ImageProcessor::RawImage raw = build_scene(Ta);
+        // The coefficients are evaluated at the centre of the Ta bucket
+        const float bucketCentre = std::round(Ta / MLX90640ImageProcessor::TA_BUCKET) * MLX90640ImageProcessor::TA_BUCKET;
+
+        MLX90640ImageProcessor::TempImage reference{}, atCentre{}, fast{};
+        REQUIRE(proc.computeTemperatures(raw, reference, Ta));
+        REQUIRE(proc.computeTemperatures(raw, atCentre, bucketCentre));
+        REQUIRE(proc.computeTemperaturesFast(raw, fast, Ta));
+
+        float arithmetic = 0.0f, bucket = 0.0f;
+        for (size_t i = 0; i < MLX90640ImageProcessor::PIXELS; ++i)
+        {
+            REQUIRE(std::isfinite(reference[i]));
+            REQUIRE(std::isfinite(atCentre[i]));
+            arithmetic = std::max(arithmetic, std::fabs(fast[i] / atCentre[i] - 1.0f));
+            bucket = std::max(bucket, std::fabs(fast[i] / reference[i] - 1.0f));
+        }
+        MESSAGE("max relative difference: vectorised arithmetic " << arithmetic << ", Ta bucket " << bucket);
+        CHECK(arithmetic < 1e-5f);
+        CHECK(bucket < 2e-3f);
+    }
+
+    // Flipping the sign of the compensated signal flips the pixel between finite and NaN
+    MLX90640ImageProcessor::RawImage flipped = build_scene(25.0f);
+    flipped[5] = int16_t(2 * MLX90640_CAL.offset[5] - flipped[5]);
+    MLX90640ImageProcessor::TempImage reference{}, fast{};
+    proc.computeTemperatures(flipped, reference, 25.0f);
+    proc.computeTemperaturesFast(flipped, fast, 25.0f);
+    CHECK(std::isnan(reference[5]));
+    CHECK(std::isnan(fast[5]));
+    CHECK(std::isfinite(fast[4]));
+}
+
+TEST_CASE("MLX90640 coefficients are rebuilt only when Ta leaves its bucket")
+{
+    MLX90640ImageProcessor proc;
+    const MLX90640ImageProcessor::RawImage raw = build_scene(25.0f);
+    MLX90640ImageProcessor::TempImage temps{};
+
+    CHECK(proc.coefficientUpdates() == 0);
+    proc.computeTemperaturesFast(raw, temps, 24.96f);
+    proc.computeTemperaturesFast(raw, temps, 25.0f);
+    proc.computeTemperaturesFast(raw, temps, 25.04f);
+    CHECK(proc.coefficientUpdates() == 1);
+
+    proc.computeTemperaturesFast(raw, temps, 25.06f);
+    CHECK(proc.coefficientUpdates() == 2);
+    proc.computeTemperaturesFast(raw, temps, -3.02f);
+    proc.computeTemperaturesFast(raw, temps, -2.97f);
+    CHECK(proc.coefficientUpdates() == 3);
+
+    const auto& C = proc.coefficients(-3.01f);
+    CHECK(proc.coefficientUpdates() == 3);
+    CHECK(C.offset[7] == float(MLX90640_CAL.offset[7]));
+}
+
+TEST_CASE("FloatVector Newton fourth root used on targets without vector sqrt")
+{
+    float worst = 0.0f;
+    for (float x = 1e-6f; x < 1e12f; x *= 1.37f)
+    {
+        const float_vector::Float4 root = float_vector::fourthRootNewton(float_vector::Float4{x, 2.0f * x, 0.5f * x, 3.0f * x});
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            const float input = x * (lane == 0 ? 1.0f : lane == 1 ? 2.0f : lane == 2 ? 0.5f : 3.0f);
+            const float exact = std::sqrt(std::sqrt(input));
+            worst = std::max(worst, std::fabs(root[lane] - exact) / exact);
+        }
+    }
+    MESSAGE("max relative error " << worst);
+    CHECK(worst < 1e-6f);
+
+    const float_vector::Float4 mixed = float_vector::fourthRootNewton(float_vector::Float4{-16.0f, 16.0f, -1e-30f, 0.0f});
+    CHECK(std::isnan(mixed[0]));
+    CHECK(mixed[1] == doctest::Approx(2.0f));
+    CHECK(std::isnan(mixed[2]));
+    CHECK(mixed[3] == 0.0f);
+}
+
+TEST_CASE("Benchmark MLX90640 frames per second")
+{
+    constexpr int frames = 200;
+    MLX90640ImageProcessor proc;
+    const MLX90640ImageProcessor::RawImage raw = build_scene(25.0f);
+    MLX90640ImageProcessor::TempImage temps{};
+
+    // Subpage for the full compensation paths: nominal auxiliary data (Ta near 40 degC,
+    // Vdd 3.3 V) and a scene from about -20 to 250 degC
+    uint16_t ee[832];
+    std::memcpy(ee, MLX90640_EEPROM, sizeof(ee));
+    paramsMLX90640 params{};
+    REQUIRE(MLX90640_ExtractParameters(ee, &params) == MLX90640_NO_ERROR);
+    uint16_t frame[834]{};
+    for (size_t i = 0; i < MLX90640ImageProcessor::PIXELS; ++i)
+        frame[i] = uint16_t(int16_t(MLX90640_CAL.offset[i] + (int(i * 97 % 12000) - 2400) / 4));
+    frame[768] = 19442;
+    frame[776] = uint16_t(params.cpOffset[0]);
+    frame[778] = uint16_t(params.gainEE);
+    frame[800] = 1711;
+    frame[808] = uint16_t(params.cpOffset[1]);
+    frame[810] = uint16_t(params.vdd25);
+    frame[832] = uint16_t(0x1000 | (params.resolutionEE << 10) | 0x0181);
+    float melexis[768];
+
+    auto time = [&](auto process)
+    {
+        float sink = 0.0f;
+        const auto start = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; ++f)
+        {
+            process(f);
+            sink += temps[size_t(f) % temps.size()];
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        CHECK(!std::isinf(sink));
+        return frames / std::chrono::duration<double>(stop - start).count();
+    };
+
+    const double simplified_fps = time([&](int)
+                                       { proc.computeTemperatures(raw, temps, 25.0f); });
+    const double fast_fps = time([&](int f)
+                                 { proc.computeTemperaturesFast(raw, temps, 25.0f + 0.0001f * float(f)); });
+    // Both subpages per frame for the full compensation paths
+    const double melexis_fps = time([&](int)
+                                    {
+        frame[833] = 0;
+        MLX90640_CalculateTo(frame, &params, 0.95f, 23.15f, melexis);
+        frame[833] = 1;
+        MLX90640_CalculateTo(frame, &params, 0.95f, 23.15f, melexis); });
+    const double full_fps = time([&](int)
+                                 {
+        frame[833] = 0;
+        proc.computeObjectTemperatures(frame, temps, 0.95f, 23.15f);
+        frame[833] = 1;
+        proc.computeObjectTemperatures(frame, temps, 0.95f, 23.15f); });
+
+    MESSAGE("frames/s: computeTemperatures " << simplified_fps << ", computeTemperaturesFast " << fast_fps
+                                             << ", computeObjectTemperatures " << full_fps << ", Melexis CalculateTo " << melexis_fps);
+}
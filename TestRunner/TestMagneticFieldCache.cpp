@@ -0,0 +1,220 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "MagneticFieldCache.hpp"
+
+#undef MAX_ORDER
+#include "igrf_coefficients_14.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <numbers>
+
+using namespace magnetic_model;
+
+constexpr float ALTITUDE_M = 420000.f;
+
+static au::QuantityU64<au::Milli<au::Seconds>> ms(uint64_t value)
+{
+    return au::make_quantity<au::Milli<au::Seconds>>(value);
+}
+
+// Circular 51.6 degree orbit over a rotating Earth, standing in for the SGP4 ground track
+struct CircularTrack
+{
+    float ascending_node_deg = 0.0f;
+    int calls = 0;
+
+    bool operator()(au::QuantityU64<au::Milli<au::Seconds>> timestamp, GeocentricPosition &position)
+    {
+        constexpr float pi = std::numbers::pi_v<float>;
+        constexpr float inclination = 51.6f * DEG_TO_RAD;
+        constexpr float period_s = 92.7f * 60.0f;
+        constexpr float earth_rate = 2.0f * pi / 86164.0f;
+
+        ++calls;
+        const float t = 0.001f * static_cast<float>(timestamp.in(au::milli(au::seconds)));
+        const float u = 2.0f * pi * std::fmod(t, period_s) / period_s;
+        position.latitude_deg = std::asin(std::sin(inclination) * std::sin(u)) * RAD_TO_DEG;
+        float longitude = std::atan2(std::cos(inclination) * std::sin(u), std::cos(u)) * RAD_TO_DEG +
+                          ascending_node_deg - std::fmod(t * earth_rate, 2.0f * pi) * RAD_TO_DEG;
+        longitude = std::fmod(longitude + 540.0f, 360.0f) - 180.0f;
+        position.longitude_deg = longitude;
+        position.radius_m = R_EARTH + ALTITUDE_M;
+        return true;
+    }
+};
+
+static SGP4TwoLineElement makeTle(uint16_t element_number)
+{
+    SGP4TwoLineElement tle{};
+    tle.satelliteNumber = 25544;
+    tle.elementNumber = element_number;
+    tle.epochYear = 25;
+    tle.epochDay = 100.5f;
+    return tle;
+}
+
+using Grid = MagneticFieldGrid<MAX_ORDER, 37, 73, 3>;
+using Track = MagneticFieldTrackCache<MAX_ORDER, 300>;
+
+TEST_CASE("MagneticFieldGrid interpolates within its validated bound")
+{
+    const Grid::Config config{R_EARTH + 300000.f, R_EARTH + 600000.f, 2026, 250.f};
+    auto grid = std::make_unique<Grid>(config, magneticGaussCoefficients);
+    grid->build();
+
+    MESSAGE("5 degree grid, 300-600 km: max error at cell centres " << grid->maxError() << " nT");
+    CHECK(grid->withinBound());
+    CHECK(grid->maxError() == doctest::Approx(grid->validate()));
+
+    std::srand(37);
+    for (int i = 0; i < 500; ++i)
+    {
+        const GeocentricPosition position{static_cast<float>(std::rand() % 17000) / 100.f - 85.f,
+                                          static_cast<float>(std::rand() % 36000) / 100.f - 180.f,
+                                          R_EARTH + 300000.f + static_cast<float>(std::rand() % 300000)};
+        const FieldNED error = grid->field(position) - calculateFieldNED<MAX_ORDER>(position, 2026, magneticGaussCoefficients);
+        REQUIRE(error.cwiseAbs().maxCoeff() <= config.max_error_nT);
+    }
+}
+
+TEST_CASE("MagneticFieldGrid falls back to the model outside its range or bound")
+{
+    const GeocentricPosition low{10.f, 20.f, R_EARTH + 100000.f};
+    const GeocentricPosition inside{12.5f, 22.5f, R_EARTH + 450000.f};
+
+    auto grid = std::make_unique<Grid>(Grid::Config{R_EARTH + 300000.f, R_EARTH + 600000.f, 2026, 250.f}, magneticGaussCoefficients);
+    grid->build();
+    CHECK(grid->field(low) == calculateFieldNED<MAX_ORDER>(low, 2026, magneticGaussCoefficients));
+    CHECK(grid->field(inside) != calculateFieldNED<MAX_ORDER>(inside, 2026, magneticGaussCoefficients));
+
+    auto strict = std::make_unique<Grid>(Grid::Config{R_EARTH + 300000.f, R_EARTH + 600000.f, 2026, 1.f}, magneticGaussCoefficients);
+    strict->build();
+    CHECK_FALSE(strict->withinBound());
+    CHECK(strict->field(inside) == calculateFieldNED<MAX_ORDER>(inside, 2026, magneticGaussCoefficients));
+}
+
+TEST_CASE("MagneticFieldTrackCache follows the ground track with Hermite interpolation")
+{
+    Track cache(Track::Config{20000, 2026, 5.f}, magneticGaussCoefficients);
+    CircularTrack track;
+    const SGP4TwoLineElement tle = makeTle(1);
+
+    REQUIRE(cache.refresh(tle, ms(0), track));
+    MESSAGE("20 s samples over one orbit: max error at midpoints " << cache.maxError() << " nT");
+    CHECK(cache.withinBound());
+
+    float max_error = 0.f;
+    for (uint64_t t = 0; t < 5900000; t += 7919)
+    {
+        GeocentricPosition position;
+        track(ms(t), position);
+        const auto field = cache.field(tle, ms(t), track);
+        REQUIRE(field.has_value());
+        max_error = std::max(max_error, (*field - calculateFieldNED<MAX_ORDER>(position, 2026, magneticGaussCoefficients)).cwiseAbs().maxCoeff());
+    }
+    CHECK(max_error <= 5.f);
+    CHECK(cache.refreshCount() == 1);
+}
+
+TEST_CASE("MagneticFieldTrackCache refreshes lazily on a new TLE or outside its window")
+{
+    Track cache(Track::Config{20000, 2026, 5.f}, magneticGaussCoefficients);
+    CircularTrack track;
+
+    REQUIRE(cache.field(makeTle(1), ms(1000), track).has_value());
+    CHECK(cache.refreshCount() == 1);
+
+    const int calls = track.calls;
+    REQUIRE(cache.field(makeTle(1), ms(60000), track).has_value());
+    CHECK(cache.refreshCount() == 1);
+    CHECK(track.calls == calls);
+
+    // New element set: the ground track is resampled from the lookup time
+    track.ascending_node_deg = 40.f;
+    const auto updated = cache.field(makeTle(2), ms(60000), track);
+    REQUIRE(updated.has_value());
+    CHECK(cache.refreshCount() == 2);
+    GeocentricPosition position;
+    track(ms(60000), position);
+    CHECK((*updated - calculateFieldNED<MAX_ORDER>(position, 2026, magneticGaussCoefficients)).cwiseAbs().maxCoeff() < 1.f);
+
+    // Past the end of the sampled orbit
+    REQUIRE(cache.field(makeTle(2), ms(60000 + 300 * 20000), track).has_value());
+    CHECK(cache.refreshCount() == 3);
+}
+
+TEST_CASE("MagneticFieldTrackCache uses the model while the samples miss the bound")
+{
+    Track cache(Track::Config{600000, 2026, 5.f}, magneticGaussCoefficients);
+    CircularTrack track;
+    const SGP4TwoLineElement tle = makeTle(1);
+
+    REQUIRE(cache.refresh(tle, ms(0), track));
+    CHECK_FALSE(cache.withinBound());
+
+    GeocentricPosition position;
+    track(ms(123456), position);
+    const auto field = cache.field(tle, ms(123456), track);
+    REQUIRE(field.has_value());
+    CHECK(*field == calculateFieldNED<MAX_ORDER>(position, 2026, magneticGaussCoefficients));
+
+    auto failing = [](au::QuantityU64<au::Milli<au::Seconds>>, GeocentricPosition &)
+    { return false; };
+    CHECK_FALSE(cache.field(makeTle(3), ms(0), failing).has_value());
+}
+
+TEST_CASE("MagneticFieldTrackCache stays invalid when the track fails during validation")
+{
+    Track cache(Track::Config{20000, 2026, 5.f}, magneticGaussCoefficients);
+    CircularTrack track;
+    const SGP4TwoLineElement tle = makeTle(1);
+
+    // Every sample succeeds, then the first midpoint check fails
+    auto fails_at_midpoints = [&track](au::QuantityU64<au::Milli<au::Seconds>> timestamp, GeocentricPosition &position)
+    { return track.calls < 300 && track(timestamp, position); };
+    CHECK_FALSE(cache.refresh(tle, ms(0), fails_at_midpoints));
+    CHECK_FALSE(cache.withinBound());
+
+    // The next lookup resamples instead of trusting the half-validated window
+    REQUIRE(cache.field(tle, ms(1000), track).has_value());
+    CHECK(cache.refreshCount() == 2);
+    CHECK(cache.withinBound());
+}
+
+TEST_CASE("Benchmark cached versus full model field lookups")
+{
+    constexpr int iterations = 2000;
+    auto grid = std::make_unique<Grid>(Grid::Config{R_EARTH + 300000.f, R_EARTH + 600000.f, 2026, 250.f}, magneticGaussCoefficients);
+    grid->build();
+    Track cache(Track::Config{20000, 2026, 5.f}, magneticGaussCoefficients);
+    CircularTrack track;
+    const SGP4TwoLineElement tle = makeTle(1);
+    REQUIRE(cache.refresh(tle, ms(0), track));
+
+    std::array<GeocentricPosition, iterations> positions;
+    for (size_t i = 0; i < positions.size(); ++i)
+        track(ms(i * 2000), positions[i]);
+
+    auto time = [&](auto lookup)
+    {
+        float sink = 0.f;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < positions.size(); ++i)
+            sink += lookup(i).z();
+        const auto stop = std::chrono::steady_clock::now();
+        CHECK(std::isfinite(sink));
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) / iterations;
+    };
+
+    const double model_ns = time([&](size_t i)
+                                 { return calculateFieldNED<MAX_ORDER>(positions[i], 2026, magneticGaussCoefficients); });
+    const double grid_ns = time([&](size_t i)
+                                { return grid->field(positions[i]); });
+    const double track_ns = time([&](size_t i)
+                                 { return *cache.field(tle, ms(i * 2000), track); });
+
+    MESSAGE("field lookup: model " << model_ns << " ns, grid " << grid_ns << " ns, track " << track_ns << " ns");
+    CHECK(cache.refreshCount() == 1);
+}
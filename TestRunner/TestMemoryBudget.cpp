@@ -0,0 +1,93 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "MemoryBudget.hpp"
+#include "CircularBuffer.hpp"
+#include "MessageAccumulator.hpp"
+#include "TrivialImageBuffer.hpp"
+#include "InputOutputStream.hpp"
+#include "imagebuffer/MT29F4G01Accessor.hpp"
+#include "Transport.hpp"
+
+#include <cstring>
+
+struct BudgetSPITransport
+{
+    using config_type = struct
+    {
+        using mode_tag = stream_mode_tag;
+    };
+
+    bool write(const uint8_t *, uint16_t) { return true; }
+    bool read(uint8_t *, uint16_t) { return true; }
+};
+
+// Mirrors the shape of the serial RX ring without pulling in the Cyphal adapters
+struct BudgetSerialFrame
+{
+    size_t size;
+    uint8_t data[640];
+};
+
+using NandAccessor = MT29F4G01Accessor<BudgetSPITransport>;
+using ThermalImageBuffer = TrivialImageBuffer<4096>;
+using ThermalStream = ImageInputStream<ThermalImageBuffer>;
+
+constexpr auto sample_node = makeMemoryBudget(64 * 1024,
+    MEMORY_BUDGET_STATIC(CircularBuffer<BudgetSerialFrame, 8>),
+    MEMORY_BUDGET_STATIC(MessageAccumulator<1024>),
+    MEMORY_BUDGET_STATIC(NandAccessor),
+    MEMORY_BUDGET_STATIC(ThermalImageBuffer),
+    MEMORY_BUDGET_STATIC_N(2, CircularBuffer<uint32_t, 64>),
+    MEMORY_BUDGET_STACK("ImageInputStream::initialize", ThermalStream::STACK_BUFFER_BYTES));
+
+STATIC_ASSERT_MEMORY_BUDGET(sample_node);
+
+TEST_CASE("MemoryBudget sums sizeof of every registered entry")
+{
+    constexpr size_t expected_static =
+        sizeof(CircularBuffer<BudgetSerialFrame, 8>) +
+        sizeof(MessageAccumulator<1024>) +
+        sizeof(NandAccessor) +
+        sizeof(ThermalImageBuffer) +
+        2 * sizeof(CircularBuffer<uint32_t, 64>);
+
+    static_assert(sample_node.total(MemoryRegion::STATIC) == expected_static);
+    static_assert(sample_node.total(MemoryRegion::STACK) == 4096);
+    static_assert(sample_node.total() == expected_static + 4096);
+    static_assert(sample_node.fits());
+
+    CHECK(sample_node.entries().size() == 6);
+    CHECK(sample_node.entries()[4].count == 2);
+    CHECK(sample_node.entries()[4].bytes() == 2 * sizeof(CircularBuffer<uint32_t, 64>));
+    CHECK(sample_node.headroom() == sample_node.budget() - sample_node.total());
+}
+
+TEST_CASE("MemoryBudget keeps the type spelling as the entry name")
+{
+    CHECK(std::strcmp(sample_node.entries()[0].name, "CircularBuffer<BudgetSerialFrame, 8>") == 0);
+    CHECK(std::strcmp(sample_node.entries()[2].name, "NandAccessor") == 0);
+    CHECK(sample_node.entries()[5].region == MemoryRegion::STACK);
+}
+
+TEST_CASE("MemoryBudget finds the largest contributor")
+{
+    // The NAND page cache alone is 4352 bytes
+    static_assert(sizeof(NandAccessor) > NandAccessor::PAGE_TOTAL_SIZE);
+    CHECK(std::strcmp(sample_node.largest().name, "CircularBuffer<BudgetSerialFrame, 8>") == 0);
+    CHECK(sample_node.largest().bytes() >= 8 * sizeof(BudgetSerialFrame));
+}
+
+TEST_CASE("MemoryBudget reports an exceeded budget")
+{
+    constexpr auto tight = makeMemoryBudget(1024,
+        MEMORY_BUDGET_STATIC(MessageAccumulator<1024>));
+
+    static_assert(!tight.fits());
+    static_assert(MemoryBudgetCheck<1024, 1024>::value);
+    CHECK(tight.headroom() == 0);
+    CHECK(tight.total() > tight.budget());
+
+    tight.report();
+    sample_node.report();
+}
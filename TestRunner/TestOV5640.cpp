@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <utility>
 
 // Dummy config for RegisterModeTransport concept
 struct DummyConfig
@@ -24,6 +25,9 @@ public:
     {
         last_reg  = reg;
         last_write.assign(data, data + size);
+        for (size_t i = 0; i < size; ++i)
+            writes.emplace_back(static_cast<uint16_t>(reg + i), data[i]);
+        ++transactions;
         return write_ok;
     }
 
@@ -48,6 +52,8 @@ public:
     std::vector<uint8_t>  last_write;
     std::vector<uint8_t>  last_read;
     std::vector<uint8_t>  mock_response;
+    std::vector<std::pair<uint16_t, uint8_t>> writes; // register by register
+    size_t                transactions{0};
     bool                  write_ok{true};
     bool                  read_ok{true};
 };
@@ -184,6 +190,122 @@ TEST_CASE("setFormat writes correct register values")
     CHECK(transport.last_write[0] == 0x03);
 }
 
+TEST_CASE("setFormat(JPEG) enables the compressor and sets the quality")
+{
+    MockTransport transport;
+    OV5640<MockTransport> cam(transport);
+
+    transport.setMockResponse({0x1C}); // every read: JPEG resets held, clocks off
+    REQUIRE(cam.setFormat(PixelFormat::JPEG));
+
+    auto written = [&](OV5640_Register reg) -> int {
+        for (auto it = transport.writes.rbegin(); it != transport.writes.rend(); ++it)
+            if (it->first == static_cast<uint16_t>(reg))
+                return it->second;
+        return -1;
+    };
+    CHECK(written(OV5640_Register::FORMAT_CONTROL00) == 0x30);
+    CHECK(written(OV5640_Register::ISP_FORMAT_MUX_CTRL) == 0x00);
+    CHECK(written(OV5640_Register::TIMING_TC_REG21) == (0x1C | 0x20));
+    CHECK(written(OV5640_Register::SYS_RESET02) == 0x00);
+    CHECK(written(OV5640_Register::SYS_CLOCK_ENABLE02) == (0x1C | 0x28));
+    CHECK(written(OV5640_Register::JPEG_CTRL07) == 4);
+    CHECK(transport.last_reg == static_cast<uint16_t>(OV5640_Register::JPG_MODE_SELECT));
+
+    // Back to raw output turns the compressor off again
+    transport.setMockResponse({0x20});
+    transport.writes.clear();
+    REQUIRE(cam.setFormat(PixelFormat::YUV422));
+    CHECK(written(OV5640_Register::TIMING_TC_REG21) == 0x00);
+}
+
+TEST_CASE("JPEG quality is clamped and steered towards a frame size")
+{
+    MockTransport transport;
+    OV5640<MockTransport> cam(transport);
+
+    CHECK(cam.setJpegQuality(0));
+    CHECK(cam.jpegQuality() == OV5640<MockTransport>::JPEG_QUALITY_MIN);
+    CHECK(cam.setJpegQuality(200));
+    CHECK(cam.jpegQuality() == OV5640<MockTransport>::JPEG_QUALITY_MAX);
+    CHECK(transport.last_reg == static_cast<uint16_t>(OV5640_Register::JPEG_CTRL07));
+    CHECK(transport.last_write[0] == 63);
+
+    REQUIRE(cam.setJpegQuality(8));
+    // Twice the target: twice the quantisation
+    CHECK(cam.adjustJpegQuality(80000, 40000));
+    CHECK(cam.jpegQuality() == 16);
+    // Within 1/8 of the target: unchanged
+    transport.writes.clear();
+    CHECK(cam.adjustJpegQuality(42000, 40000));
+    CHECK(cam.jpegQuality() == 16);
+    CHECK(transport.writes.empty());
+    // Small frames lower it in proportion, slightly small ones by at least one step
+    CHECK(cam.adjustJpegQuality(34000, 40000));
+    CHECK(cam.jpegQuality() == 14);
+    REQUIRE(cam.setJpegQuality(2));
+    CHECK(cam.adjustJpegQuality(34000, 40000));
+    CHECK(cam.jpegQuality() == 1);
+    CHECK(cam.adjustJpegQuality(34000, 40000));
+    CHECK(cam.jpegQuality() == 1);
+    CHECK_FALSE(cam.adjustJpegQuality(0, 40000));
+
+    // A failing bus keeps the old setting
+    transport.write_ok = false;
+    CHECK_FALSE(cam.setJpegQuality(30));
+    CHECK(cam.jpegQuality() == 1);
+}
+
+TEST_CASE("Register_Runs splits a table into runs of consecutive registers")
+{
+    static constexpr Word_Byte_t table[] = {
+        {0x3000, 1}, {0x3001, 2}, {0x3002, 3}, {0x3010, 4}, {0x300F, 5}, {0x3010, 6}, {0x3011, 7}, {0x3012, 8}};
+
+    using Runs = Register_Runs<table, 8>;
+    static_assert(Runs::size == 3);
+    CHECK(Runs::runs[0].addr == 0x3000);
+    CHECK(Runs::runs[0].count == 3);
+    CHECK(Runs::runs[1].addr == 0x3010);
+    CHECK(Runs::runs[1].count == 1);
+    CHECK(Runs::runs[2].addr == 0x300F);
+    CHECK(Runs::runs[2].first == 4);
+    CHECK(Runs::runs[2].count == 4);
+
+    // Capped runs
+    using Capped = Register_Runs<table, 2>;
+    static_assert(Capped::size == 5);
+    CHECK(Capped::runs[1].addr == 0x3002);
+    CHECK(Capped::runs[1].first == 2);
+    CHECK(Capped::runs[2].count == 1);
+    CHECK(Capped::runs[4].addr == 0x3011);
+}
+
+TEST_CASE("init() writes the table in sequential bursts")
+{
+    MockTransport transport;
+    OV5640<MockTransport> cam(transport);
+
+    REQUIRE(cam.init());
+
+    // Every register of the table, in order
+    REQUIRE(transport.writes.size() == std::size(cfg_init_));
+    for (size_t i = 0; i < std::size(cfg_init_); ++i)
+    {
+        CAPTURE(i);
+        CHECK(transport.writes[i].first == cfg_init_[i].addr);
+        CHECK(transport.writes[i].second == cfg_init_[i].data);
+    }
+
+    // One transaction per run instead of one per register
+    MESSAGE("cfg_init_: " << transport.transactions << " transactions for " << std::size(cfg_init_) << " registers");
+    CHECK(transport.transactions == 43);
+    CHECK(std::size(cfg_init_) == 63);
+    CHECK(Register_Runs<OV5640_Common_STM, OV5640<MockTransport>::MAX_BURST>::size < std::size(OV5640_Common_STM) / 3);
+
+    transport.write_ok = false;
+    CHECK_FALSE(cam.init());
+}
+
 TEST_CASE("enableTestPattern writes correct register")
 {
     MockTransport transport;
@@ -2,9 +2,13 @@
 #include "doctest/doctest.h"
 
 #include "OrientationTracker.hpp"
+#include "ErrorStateOrientationTracker.hpp"
 #include "OrientationService.hpp"
 #include "mock_hal.h"
 
+#include <algorithm>
+#include <vector>
+
 constexpr float m_pif = static_cast<float>(std::numbers::pi);
 
 // Mock IMU class
@@ -63,6 +67,7 @@ public:
     
     std::optional<MagneticFieldInBodyFrame> readMagnetometer()
     {
+        ++mag_reads;
         if (has_mag_data)
         {
             return magnetometer;
@@ -73,6 +78,8 @@ public:
         }
     }
 
+    int mag_reads = 0;
+
 private:
     AccelerationInBodyFrame acceleration;
     AngularVelocityInBodyFrame gyroscope;
@@ -230,3 +237,171 @@ TEST_CASE("AccGyrOrientation returns valid OrientationSolution with static input
     REQUIRE_FALSE(sol.has_valid(OrientationSolution::Validity::MAGNETIC_FIELD));
     REQUIRE(std::abs(sol.q[0] - 1.f) < 1e-3f);
 }
+
+TEST_CASE("Error-state trackers drop into the orientation services")
+{
+    RTC_HandleTypeDef rtc{};
+    rtc.Init.SynchPrediv = 255;
+
+    set_mocked_rtc_time({12, 0, 0, RTC_HOURFORMAT12_AM, 0, 255, RTC_DAYLIGHTSAVING_NONE, RTC_STOREOPERATION_RESET});
+    set_mocked_rtc_date({RTC_WEEKDAY_MONDAY, 1, 1, 24});
+
+    MockIMUinBodyFrame imu;
+    imu.setGyroscope(0.f, 0.f, 0.f);
+    imu.setAcceleration(0.f, 0.f, 9.81f);
+    imu.setMagnetometer(1.f, 0.f, 0.f);
+
+    ErrorStateGyrMagOrientationTracker gyr_mag_tracker;
+    gyr_mag_tracker.setReferenceVectors(Eigen::Vector3f(1.f, 0.f, 0.f));
+    GyrMagOrientation<ErrorStateGyrMagOrientationTracker, MockIMUinBodyFrame, MockIMUinBodyFrame> gyr_mag(&rtc, gyr_mag_tracker, imu, imu);
+    OrientationSolution gyr_mag_sol = gyr_mag.predict();
+    REQUIRE(gyr_mag_sol.has_valid(OrientationSolution::Validity::QUATERNION));
+    REQUIRE(std::abs(gyr_mag_sol.q[0] - 1.f) < 1e-3f);
+
+    ErrorStateAccGyrMagOrientationTracker acc_gyr_mag_tracker;
+    acc_gyr_mag_tracker.setReferenceVectors(Eigen::Vector3f(0.f, 0.f, 9.81f), Eigen::Vector3f(1.f, 0.f, 0.f));
+    AccGyrMagOrientation<ErrorStateAccGyrMagOrientationTracker, MockIMUinBodyFrame, MockIMUinBodyFrame> acc_gyr_mag(&rtc, acc_gyr_mag_tracker, imu, imu);
+    OrientationSolution acc_gyr_mag_sol = acc_gyr_mag.predict();
+    REQUIRE(acc_gyr_mag_sol.has_valid(OrientationSolution::Validity::QUATERNION));
+    REQUIRE(acc_gyr_mag_sol.has_valid(OrientationSolution::Validity::MAGNETIC_FIELD));
+    REQUIRE(std::abs(acc_gyr_mag_sol.q[0] - 1.f) < 1e-3f);
+
+    ErrorStateAccGyrOrientationTracker acc_gyr_tracker;
+    acc_gyr_tracker.setReferenceVectors(Eigen::Vector3f(0.f, 0.f, 9.81f));
+    AccGyrOrientation<ErrorStateAccGyrOrientationTracker, MockIMUinBodyFrame> acc_gyr(&rtc, acc_gyr_tracker, imu);
+    OrientationSolution acc_gyr_sol = acc_gyr.predict();
+    REQUIRE(acc_gyr_sol.has_valid(OrientationSolution::Validity::QUATERNION));
+    REQUIRE(std::abs(acc_gyr_sol.q[0] - 1.f) < 1e-3f);
+}
+
+// Mock IMU with a FIFO of gyro/accel frames
+class MockFifoIMUinBodyFrame : public MockIMUinBodyFrame
+{
+public:
+    struct FifoSample
+    {
+        AngularVelocityInBodyFrame gyr;
+        AccelerationInBodyFrame acc;
+        uint32_t sensor_time;
+        bool has_gyr;
+        bool has_acc;
+    };
+    static constexpr float FIFO_SAMPLE_PERIOD = 0.01f;
+    static constexpr float SENSOR_TIME_TICK = 39.0625e-6f;
+    static constexpr uint32_t SENSOR_TIME_MASK = 0xFFFFFF;
+
+    // Frames are stamped frame_ticks apart on a 24-bit sensor clock
+    void pushFifo(float gx, float gy, float gz, float ax, float ay, float az)
+    {
+        clock = (clock + frame_ticks) & SENSOR_TIME_MASK;
+        fifo.push_back({{au::make_quantity<au::DegreesPerSecondInBodyFrame>(gx),
+                         au::make_quantity<au::DegreesPerSecondInBodyFrame>(gy),
+                         au::make_quantity<au::DegreesPerSecondInBodyFrame>(gz)},
+                        {au::make_quantity<au::MetersPerSecondSquaredInBodyFrame>(ax),
+                         au::make_quantity<au::MetersPerSecondSquaredInBodyFrame>(ay),
+                         au::make_quantity<au::MetersPerSecondSquaredInBodyFrame>(az)},
+                        clock, true, true});
+    }
+
+    // Frames lost to an overflow: the clock runs on without them
+    void dropFrames(uint32_t frames)
+    {
+        clock = (clock + frames * frame_ticks) & SENSOR_TIME_MASK;
+    }
+
+    size_t readFifo(std::span<FifoSample> samples, uint32_t &read_time)
+    {
+        read_time = clock;
+        const size_t count = std::min(samples.size(), fifo.size());
+        std::copy_n(fifo.begin(), count, samples.begin());
+        fifo.erase(fifo.begin(), fifo.begin() + static_cast<std::ptrdiff_t>(count));
+        ++bursts;
+        return count;
+    }
+
+    std::vector<FifoSample> fifo;
+    int bursts = 0;
+    uint32_t frame_ticks = 256; // 100 Hz
+    uint32_t clock = SENSOR_TIME_MASK - 1000; // wraps within the tests
+};
+static_assert(HasGyroscopeFifo<MockFifoIMUinBodyFrame>);
+static_assert(BatchGyroTracker<AccGyrMagOrientationTracker<7, 6>>);
+static_assert(BatchGyroTracker<ErrorStateAccGyrMagOrientationTracker>);
+
+TEST_CASE("AccGyrMagOrientation integrates every FIFO frame buffered between ticks")
+{
+    RTC_HandleTypeDef rtc{};
+    rtc.Init.SynchPrediv = 255;
+
+    set_mocked_rtc_time({12, 0, 0, RTC_HOURFORMAT12_AM, 0, 255, RTC_DAYLIGHTSAVING_NONE, RTC_STOREOPERATION_RESET});
+    set_mocked_rtc_date({RTC_WEEKDAY_MONDAY, 1, 1, 24});
+
+    // 10 frames of a 90 deg/s yaw turn; the separate magnetometer agrees with the 9 deg reached
+    const float yaw = 9.f * m_pif / 180.f;
+    MockFifoIMUinBodyFrame imu;
+    for (int i = 0; i < 10; ++i)
+        imu.pushFifo(0.f, 0.f, 90.f, 0.f, 0.f, 9.81f);
+    MockIMUinBodyFrame mag;
+    mag.setMagnetometer(std::cos(yaw), -std::sin(yaw), 0.f);
+
+    ErrorStateAccGyrMagOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(0.f, 0.f, 9.81f), Eigen::Vector3f(1.f, 0.f, 0.f));
+    AccGyrMagOrientation<ErrorStateAccGyrMagOrientationTracker, MockFifoIMUinBodyFrame, MockIMUinBodyFrame> service(&rtc, tracker, imu, mag);
+
+    OrientationSolution sol = service.predict();
+
+    CHECK(imu.bursts == 1);
+    CHECK(imu.fifo.empty());
+    // The sample predict read for the solution is the one fused; nothing is read twice
+    CHECK(mag.mag_reads == 1);
+    CHECK(imu.mag_reads == 0);
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::MAGNETIC_FIELD));
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::QUATERNION));
+    CHECK(std::abs(tracker.getYawPitchRoll()(0) - yaw) < 0.01f);
+}
+
+TEST_CASE("FIFO frames are integrated over their sensortime spacing")
+{
+    RTC_HandleTypeDef rtc{};
+    rtc.Init.SynchPrediv = 255;
+
+    set_mocked_rtc_time({12, 0, 0, RTC_HOURFORMAT12_AM, 0, 255, RTC_DAYLIGHTSAVING_NONE, RTC_STOREOPERATION_RESET});
+    set_mocked_rtc_date({RTC_WEEKDAY_MONDAY, 1, 1, 24});
+
+    // 200 Hz frames, half the nominal FIFO_SAMPLE_PERIOD; yaw is only seen by the gyro
+    MockFifoIMUinBodyFrame imu;
+    imu.frame_ticks = 128;
+    ErrorStateAccGyrOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(0.f, 0.f, 9.81f));
+    AccGyrOrientation<ErrorStateAccGyrOrientationTracker, MockFifoIMUinBodyFrame> service(&rtc, tracker, imu);
+
+    // The first frame has no predecessor and is still at rest
+    imu.pushFifo(0.f, 0.f, 0.f, 0.f, 0.f, 9.81f);
+    service.predict();
+
+    // 16 frames of 90 deg/s over 0.08 s
+    const float deg = m_pif / 180.f;
+    for (int i = 0; i < 16; ++i)
+        imu.pushFifo(0.f, 0.f, 90.f, 0.f, 0.f, 9.81f);
+    service.predict();
+    CHECK(tracker.getYawPitchRoll()(0) == doctest::Approx(7.2f * deg).epsilon(0.01));
+
+    // An overflow lost 16 frames of the same turn; the next frame spans them
+    imu.dropFrames(16);
+    for (int i = 0; i < 16; ++i)
+        imu.pushFifo(0.f, 0.f, 90.f, 0.f, 0.f, 9.81f);
+    service.predict();
+    CHECK(tracker.getYawPitchRoll()(0) == doctest::Approx(21.6f * deg).epsilon(0.01));
+
+    // More frames than a batch: the tracker stops at the newest frame read and the rest follow
+    // on the next tick, without being counted twice
+    for (int i = 0; i < 20; ++i)
+        imu.pushFifo(0.f, 0.f, 90.f, 0.f, 0.f, 9.81f);
+    service.predict();
+    CHECK(imu.fifo.size() == 4);
+    CHECK(tracker.getYawPitchRoll()(0) == doctest::Approx(28.8f * deg).epsilon(0.01));
+    service.predict();
+    CHECK(imu.fifo.empty());
+    CHECK(tracker.getYawPitchRoll()(0) == doctest::Approx(30.6f * deg).epsilon(0.01));
+    CHECK(imu.bursts == 5);
+}
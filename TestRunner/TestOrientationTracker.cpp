@@ -5,6 +5,8 @@
 #include <Eigen/Dense>
 #include <iostream>
 #include <cmath>
+#include <chrono>
+#include <vector>
 
 constexpr float m_mpif = static_cast<float>(std::numbers::pi);
 
@@ -351,3 +353,172 @@ TEST_CASE("AccGyrOrientationTracker stabilizes pitch and roll from accelerometer
     Eigen::Vector3f ypr = tracker.getYawPitchRoll();
     REQUIRE(std::abs(ypr.y() - m_mpif / 6.0f) < 0.05f); // ✅ ~30° pitch
 }
+
+class UpdateModeAccGyrMagOrientationTracker : public AccGyrMagOrientationTracker<>
+{
+public:
+    explicit UpdateModeAccGyrMagOrientationTracker(bool sequential)
+    {
+        this->ekf.sequentialWhenDiagonal = sequential;
+    }
+};
+
+struct OrientationSample
+{
+    Eigen::Vector3f gyro;
+    Eigen::Vector3f accel;
+    Eigen::Vector3f mag;
+    Eigen::Quaternionf truth;
+    au::QuantityU64<au::Milli<au::Seconds>> timestamp;
+};
+
+// Yaw spin followed by a roll/pitch tumble with noisy accelerometer and magnetometer
+static std::vector<OrientationSample> makeOrientationTrajectory()
+{
+    std::srand(33);
+    const Eigen::Vector3f accel_ned(0.0f, 0.0f, 9.81f);
+    const Eigen::Vector3f mag_ned(1.0f, 0.0f, 0.0f);
+    constexpr float dt = 0.05f;
+
+    std::vector<OrientationSample> samples;
+    Eigen::Quaternionf q_true = Eigen::Quaternionf::Identity();
+    for (int step = 1; step <= 400; ++step)
+    {
+        const Eigen::Vector3f omega = step < 200 ? Eigen::Vector3f(0.f, 0.f, 30.f * m_mpif / 180.f)
+                                                 : Eigen::Vector3f(0.2f, -0.15f, 0.05f);
+        q_true = (q_true * Eigen::Quaternionf(Eigen::AngleAxisf(omega.norm() * dt, omega.normalized()))).normalized();
+
+        samples.push_back({omega,
+                           q_true.conjugate() * accel_ned + Eigen::Vector3f::Random() * 0.01f,
+                           q_true.conjugate() * mag_ned + Eigen::Vector3f::Random() * 0.01f,
+                           q_true,
+                           au::make_quantity<au::Milli<au::Seconds>>(static_cast<uint64_t>(step) * 50U)});
+    }
+    return samples;
+}
+
+static float angleBetween(const Eigen::Quaternionf &a, const Eigen::Quaternionf &b)
+{
+    // atan2 keeps resolution for small angles where acos(|a.b|) is quantised
+    const Eigen::Quaternionf d = a.conjugate() * b;
+    return 2.f * std::atan2(d.vec().norm(), std::abs(d.w()));
+}
+
+TEST_CASE("Sequential scalar EKF updates track the batch update on the orientation trajectory")
+{
+    const std::vector<OrientationSample> samples = makeOrientationTrajectory();
+    UpdateModeAccGyrMagOrientationTracker batch(false);
+    UpdateModeAccGyrMagOrientationTracker sequential(true);
+    batch.setReferenceVectors(Eigen::Vector3f(0.0f, 0.0f, 9.81f), Eigen::Vector3f(1.0f, 0.0f, 0.0f));
+    sequential.setReferenceVectors(Eigen::Vector3f(0.0f, 0.0f, 9.81f), Eigen::Vector3f(1.0f, 0.0f, 0.0f));
+
+    float max_divergence = 0.f;
+    float max_batch_error = 0.f;
+    float max_sequential_error = 0.f;
+    for (const OrientationSample &sample : samples)
+    {
+        batch.updateSensorFusion(sample.gyro, sample.accel, sample.mag, sample.timestamp);
+        sequential.updateSensorFusion(sample.gyro, sample.accel, sample.mag, sample.timestamp);
+
+        max_divergence = std::max(max_divergence, angleBetween(batch.getOrientation(), sequential.getOrientation()));
+        max_batch_error = std::max(max_batch_error, angleBetween(batch.getOrientation(), sample.truth));
+        max_sequential_error = std::max(max_sequential_error, angleBetween(sequential.getOrientation(), sample.truth));
+    }
+
+    MESSAGE("max error vs truth: batch " << max_batch_error << " rad, sequential " << max_sequential_error
+                                         << " rad, batch vs sequential " << max_divergence << " rad");
+    CHECK(max_divergence < 1e-3f);
+    CHECK(max_sequential_error < max_batch_error + 1e-3f);
+}
+
+TEST_CASE("Benchmark batch versus sequential accelerometer/magnetometer update")
+{
+    const std::vector<OrientationSample> samples = makeOrientationTrajectory();
+
+    auto run = [&](bool sequential)
+    {
+        UpdateModeAccGyrMagOrientationTracker tracker(sequential);
+        tracker.setReferenceVectors(Eigen::Vector3f(0.0f, 0.0f, 9.81f), Eigen::Vector3f(1.0f, 0.0f, 0.0f));
+        const auto start = std::chrono::steady_clock::now();
+        for (const OrientationSample &sample : samples)
+            tracker.updateSensorFusion(sample.gyro, sample.accel, sample.mag, sample.timestamp);
+        const auto stop = std::chrono::steady_clock::now();
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) /
+               static_cast<double>(samples.size());
+    };
+
+    const double batch_ns = run(false);
+    const double sequential_ns = run(true);
+    MESSAGE("AccGyrMagOrientationTracker::updateSensorFusion: batch " << batch_ns << " ns, sequential "
+                                                                        << sequential_ns << " ns per sample");
+    CHECK(batch_ns > 0.0);
+    CHECK(sequential_ns > 0.0);
+}
+
+TEST_CASE("Batched predictTo matches per-sample predictTo at a constant rate")
+{
+    const Eigen::Vector3f omega(0.3f, -0.2f, 0.5f);
+    GyrMagOrientationTracker single;
+    GyrMagOrientationTracker batched;
+    single.setGyroAngularRate(omega);
+    batched.setGyroAngularRate(omega);
+
+    std::vector<Eigen::Vector3f> rates(10, omega);
+    for (uint64_t i = 1; i <= rates.size(); ++i)
+        single.predictTo(au::make_quantity<au::Milli<au::Seconds>>(10 * i));
+    batched.predictTo(rates, 0.01f, au::make_quantity<au::Milli<au::Seconds>>(100));
+
+    CHECK(angleBetween(single.getOrientation(), batched.getOrientation()) < 1e-5f);
+
+    // The next single step continues from the end of the batch
+    single.predictTo(au::make_quantity<au::Milli<au::Seconds>>(110));
+    batched.predictTo(au::make_quantity<au::Milli<au::Seconds>>(110));
+    CHECK(angleBetween(single.getOrientation(), batched.getOrientation()) < 1e-5f);
+}
+
+TEST_CASE("Batched predictTo coning correction reduces drift under coning motion")
+{
+    // Body axis precessing on a cone: q(t) = Exp(theta (cos wt, sin wt, 0))
+    constexpr float theta = 0.1f;
+    constexpr float cone_rate = 2.f * m_mpif * 2.f;
+    constexpr float dt = 0.01f;
+    constexpr int samples = 100;
+    constexpr int substeps = 50;
+    auto attitude = [&](float t)
+    {
+        const Eigen::Vector3f axis(std::cos(cone_rate * t), std::sin(cone_rate * t), 0.f);
+        return Eigen::Quaternionf(Eigen::AngleAxisf(theta, axis));
+    };
+
+    // Gyro samples are the mean rate over each period, as a filtered sensor reports
+    std::vector<Eigen::Vector3f> rates;
+    for (int k = -1; k < samples; ++k)
+    {
+        Eigen::Vector3f increment = Eigen::Vector3f::Zero();
+        for (int j = 0; j < substeps; ++j)
+        {
+            const float t0 = (static_cast<float>(k) + static_cast<float>(j) / substeps) * dt;
+            const Eigen::Quaternionf dq = attitude(t0).conjugate() * attitude(t0 + dt / substeps);
+            increment += 2.f * dq.vec() * (dq.w() < 0.f ? -1.f : 1.f);
+        }
+        rates.push_back(increment / dt);
+    }
+
+    GyrMagOrientationTracker tracker;
+    tracker.setOrientation(attitude(0.f));
+    tracker.setGyroAngularRate(rates.front());
+    tracker.predictTo(std::span<const Eigen::Vector3f>(rates).subspan(1), dt, au::make_quantity<au::Milli<au::Seconds>>(1000));
+
+    Eigen::Quaternionf uncorrected = attitude(0.f);
+    for (size_t k = 1; k < rates.size(); ++k)
+    {
+        const Eigen::Vector3f alpha = rates[k] * dt;
+        uncorrected = (uncorrected * Eigen::Quaternionf(Eigen::AngleAxisf(alpha.norm(), alpha.normalized()))).normalized();
+    }
+
+    const Eigen::Quaternionf truth = attitude(samples * dt);
+    const float coning_error = angleBetween(tracker.getOrientation(), truth);
+    const float plain_error = angleBetween(uncorrected, truth);
+    MESSAGE("attitude error after 1 s of coning: corrected " << coning_error << " rad, uncorrected " << plain_error << " rad");
+    CHECK(coning_error < 0.2f * plain_error);
+}
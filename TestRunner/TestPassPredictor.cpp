@@ -0,0 +1,161 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "PassPredictor.hpp"
+
+#include "TimeUtils.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "au.hpp"
+
+static au::QuantityU64<au::Milli<au::Seconds>> ms(uint64_t value)
+{
+    return au::make_quantity<au::Milli<au::Seconds>>(value);
+}
+
+// ISS (ZARYA)
+static SGP4TwoLineElement issTle()
+{
+    auto parsed = sgp4_utils::parseTLE("1 25544U 98067A   25176.73245655  .00008102  00000-0  14854-3 0  9994",
+                                       "2 25544  51.6390 264.7180 0001990 278.3788 217.2311 15.50240116516482");
+    REQUIRE(parsed.has_value());
+    return parsed.value();
+}
+
+static uint64_t startMs()
+{
+    return static_cast<uint64_t>(TimeUtils::to_epoch_duration(TimeUtils::DateTimeComponents{
+                                                                  .year = 2025,
+                                                                  .month = 6,
+                                                                  .day = 25,
+                                                                  .hour = 18,
+                                                                  .minute = 0,
+                                                                  .second = 0,
+                                                                  .millisecond = 0})
+                                     .count());
+}
+
+static coordinate_transformations::Geodetic station()
+{
+    // Mid-latitude station the ISS passes several times a day
+    return coordinate_transformations::Geodetic{
+        au::make_quantity<au::DegreesInGeodeticFrame>(47.4f),
+        au::make_quantity<au::DegreesInGeodeticFrame>(8.5f),
+        au::make_quantity<au::MetersInGeodeticFrame>(400.f)};
+}
+
+struct BruteForcePass
+{
+    uint64_t aos;
+    uint64_t los;
+    float max_elevation_deg;
+};
+
+// Direct propagation at a fixed fine step, the reference for the coarse-to-fine search
+template <typename Predictor>
+static std::vector<BruteForcePass> bruteForce(Predictor &predictor, SGP4Propagator &propagator, uint64_t start, uint64_t end, uint64_t step, float min_elevation)
+{
+    std::vector<BruteForcePass> passes;
+    bool visible = false;
+    for (uint64_t t = start; t <= end; t += step)
+    {
+        const float elevation = predictor.elevation(propagator, ms(t));
+        if (elevation >= min_elevation && !visible)
+            passes.push_back({t, t, elevation});
+        if (elevation >= min_elevation)
+        {
+            passes.back().los = t;
+            passes.back().max_elevation_deg = std::max(passes.back().max_elevation_deg, elevation);
+        }
+        visible = elevation >= min_elevation;
+    }
+    return passes;
+}
+
+TEST_CASE("PassPredictor finds the same windows as a fine brute-force scan")
+{
+    SGP4Propagator propagator;
+    propagator.setTLE(issTle());
+    PassPredictor<64, 16> predictor(station(), 10.f);
+
+    const uint64_t start = startMs();
+    const size_t count = predictor.predict(propagator, ms(start), 15.f);
+    const uint64_t end = start + static_cast<uint64_t>(15.f * 86400000.f / issTle().meanMotion);
+    MESSAGE(count << " passes above 10 degrees in 15 orbits");
+    REQUIRE(count >= 2);
+
+    const std::vector<BruteForcePass> reference = bruteForce(predictor, propagator, start, end, 1000, 10.f);
+    REQUIRE(reference.size() == count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const PassWindow &pass = predictor[i];
+        const uint64_t aos = pass.aos.in(au::milli(au::seconds));
+        const uint64_t los = pass.los.in(au::milli(au::seconds));
+        const uint64_t culmination = pass.max_elevation_at.in(au::milli(au::seconds));
+        MESSAGE("pass " << i << ": " << (los - aos) / 1000 << " s, max elevation " << pass.max_elevation_deg);
+
+        CHECK(aos < culmination);
+        CHECK(culmination < los);
+        CHECK(std::llabs(static_cast<long long>(aos) - static_cast<long long>(reference[i].aos)) <= 1000);
+        CHECK(std::llabs(static_cast<long long>(los) - static_cast<long long>(reference[i].los)) <= 1000);
+        CHECK(pass.max_elevation_deg >= reference[i].max_elevation_deg - 0.05f);
+        CHECK(pass.max_elevation_deg <= reference[i].max_elevation_deg + 0.5f);
+
+        // Crossings land on the horizon mask
+        CHECK(std::abs(predictor.elevation(propagator, pass.aos) - 10.f) < 0.05f);
+        CHECK(std::abs(predictor.elevation(propagator, pass.los) - 10.f) < 0.05f);
+    }
+}
+
+TEST_CASE("PassPredictor exposes the next contact to tasks")
+{
+    SGP4Propagator propagator;
+    propagator.setTLE(issTle());
+    PassPredictor<64, 16> predictor(station(), 10.f);
+    REQUIRE(predictor.predict(propagator, ms(startMs()), 15.f) >= 2);
+
+    const PassWindow first = predictor[0];
+    const PassWindow second = predictor[1];
+
+    const auto before = ms(first.aos.in(au::milli(au::seconds)) - 60000);
+    CHECK_FALSE(predictor.inContact(before));
+    CHECK(predictor.timeUntilContact(before) == std::optional<uint64_t>(60000));
+    CHECK(predictor.nextPass(before)->aos == first.aos);
+
+    CHECK(predictor.inContact(first.max_elevation_at));
+    CHECK(predictor.timeUntilContact(first.max_elevation_at) == std::optional<uint64_t>(0));
+
+    CHECK(predictor.nextPass(first.los)->aos == second.aos);
+    CHECK_FALSE(predictor.timeUntilContact(ms(startMs() + 86400000ULL * 2)).has_value());
+}
+
+TEST_CASE("PassPredictor without a TLE predicts nothing")
+{
+    SGP4Propagator propagator;
+    PassPredictor<16, 4> predictor(station());
+    CHECK(predictor.predict(propagator, ms(startMs()), 1.f) == 0);
+    CHECK_FALSE(predictor.nextPass(ms(startMs())).has_value());
+    CHECK_FALSE(predictor.inContact(ms(startMs())));
+}
+
+TEST_CASE("Benchmark pass prediction versus a 1 s brute-force scan")
+{
+    SGP4Propagator propagator;
+    propagator.setTLE(issTle());
+    PassPredictor<64, 16> predictor(station(), 10.f);
+    const uint64_t start = startMs();
+    const uint64_t end = start + static_cast<uint64_t>(15.f * 86400000.f / issTle().meanMotion);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const size_t count = predictor.predict(propagator, ms(start), 15.f);
+    const auto t1 = std::chrono::steady_clock::now();
+    const size_t reference = bruteForce(predictor, propagator, start, end, 1000, 10.f).size();
+    const auto t2 = std::chrono::steady_clock::now();
+
+    MESSAGE("15 orbits: coarse-to-fine " << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count()
+                                         << " us, brute force " << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << " us");
+    CHECK(count == reference);
+}
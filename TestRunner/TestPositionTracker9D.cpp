@@ -5,6 +5,7 @@
 #include "PositionTracker9D.hpp"
 #include <Eigen/Dense>
 #include <Eigen/Geometry>
+#include <chrono>
 #include <iostream>
 #include <optional>
 
@@ -258,6 +259,63 @@ TEST_CASE("Transition matrix A updates correctly for nonzero dt")
     CHECK(A(3, 6) == doctest::Approx(dt));
 }
 
+TEST_CASE("Closed-form constant-acceleration predict matches the dense A P A^T")
+{
+    std::srand(32);
+    MockPositionTracker9D tracker;
+
+    for (float dt : {0.001f, 0.01f, 0.1f, 1.f})
+    {
+        const Eigen::Matrix<float, 9, 9> M = Eigen::Matrix<float, 9, 9>::Random();
+        const Eigen::Matrix<float, 9, 9> P0 = M * M.transpose() + Eigen::Matrix<float, 9, 9>::Identity();
+        const Eigen::Matrix<float, 9, 1> x0 = Eigen::Matrix<float, 9, 1>::Random();
+        const Eigen::Matrix<float, 9, 9> Q = Eigen::Matrix<float, 9, 9>::Identity() * 1e-4f;
+
+        tracker.updateTransitionMatrix(dt);
+        KalmanFilter<9, 3> dense(Q, Eigen::Matrix3f::Identity(), P0, x0);
+        KalmanFilter<9, 3> blocks = dense;
+
+        dense.predict(tracker.transitionMatrix());
+        blocks.predictWith(ConstantAccelerationTransition(dt));
+
+        CHECK((dense.stateVector - blocks.stateVector).norm() < 1e-5f * (1.f + dense.stateVector.norm()));
+        CHECK((dense.stateCovarianceMatrix - blocks.stateCovarianceMatrix).norm() <
+              1e-5f * (1.f + dense.stateCovarianceMatrix.norm()));
+    }
+}
+
+TEST_CASE("Benchmark dense versus closed-form predict")
+{
+    constexpr size_t ITERATIONS = 2000;
+    constexpr float dt = 0.01f;
+    MockPositionTracker9D tracker;
+    tracker.updateTransitionMatrix(dt);
+    const Eigen::Matrix<float, 9, 9> A = tracker.transitionMatrix();
+
+    const Eigen::Matrix<float, 9, 9> Q = Eigen::Matrix<float, 9, 9>::Identity() * 1e-4f;
+    const Eigen::Matrix<float, 9, 9> P0 = Eigen::Matrix<float, 9, 9>::Identity() * 1e-2f;
+    KalmanFilter<9, 3> dense(Q, Eigen::Matrix3f::Identity(), P0, Eigen::Matrix<float, 9, 1>::Ones());
+    KalmanFilter<9, 3> blocks = dense;
+
+    auto time = [&](auto &&predict)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ITERATIONS; ++i)
+            predict();
+        const auto stop = std::chrono::steady_clock::now();
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) / ITERATIONS;
+    };
+
+    const double dense_ns = time([&]
+                                 { dense.predict(A); });
+    const double blocks_ns = time([&]
+                                  { blocks.predictWith(ConstantAccelerationTransition(dt)); });
+
+    MESSAGE("9-state predict: dense " << dense_ns << " ns, closed-form " << blocks_ns << " ns");
+    CHECK((dense.stateVector - blocks.stateVector).norm() < 1e-3f * dense.stateVector.norm());
+    CHECK((dense.stateCovarianceMatrix - blocks.stateCovarianceMatrix).norm() < 1e-3f * dense.stateCovarianceMatrix.norm());
+}
+
 #
 #
 #
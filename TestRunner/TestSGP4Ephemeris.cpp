@@ -0,0 +1,182 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "SGP4Propagator.hpp"
+
+#include "TimeUtils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include "au.hpp"
+
+static au::QuantityU64<au::Milli<au::Seconds>> ms(uint64_t value)
+{
+    return au::make_quantity<au::Milli<au::Seconds>>(value);
+}
+
+// ISS (ZARYA)
+static SGP4TwoLineElement issTle()
+{
+    auto parsed = sgp4_utils::parseTLE("1 25544U 98067A   25176.73245655  .00008102  00000-0  14854-3 0  9994",
+                                       "2 25544  51.6390 264.7180 0001990 278.3788 217.2311 15.50240116516482");
+    REQUIRE(parsed.has_value());
+    return parsed.value();
+}
+
+static uint64_t timestampMs(uint8_t hour, uint8_t minute)
+{
+    return static_cast<uint64_t>(TimeUtils::to_epoch_duration(TimeUtils::DateTimeComponents{
+                                                                  .year = 2025,
+                                                                  .month = 6,
+                                                                  .day = 25,
+                                                                  .hour = hour,
+                                                                  .minute = minute,
+                                                                  .second = 0,
+                                                                  .millisecond = 0})
+                                     .count());
+}
+
+static float distance(const SGP4Propagator::Vector &a, const SGP4Propagator::Vector &b)
+{
+    return std::hypot(a[0] - b[0], a[1] - b[1], a[2] - b[2]);
+}
+
+TEST_CASE("SGP4Propagator initialises once per TLE")
+{
+    SGP4Propagator propagator;
+    SGP4Propagator::Vector r, v;
+    CHECK_FALSE(propagator.propagate(ms(timestampMs(18, 0)), r, v));
+
+    propagator.setTLE(issTle());
+    REQUIRE(propagator.propagate(ms(timestampMs(18, 0)), r, v));
+    CHECK(r[0] == doctest::Approx(-3006.157f).epsilon(0.01));
+    CHECK(r[1] == doctest::Approx(4331.221f).epsilon(0.01));
+    CHECK(r[2] == doctest::Approx(-4290.440f).epsilon(0.01));
+    CHECK(v[0] == doctest::Approx(-3.3808f).epsilon(0.01));
+    CHECK(v[1] == doctest::Approx(-5.8729f).epsilon(0.01));
+    CHECK(v[2] == doctest::Approx(-3.5610f).epsilon(0.01));
+
+    for (uint8_t minute = 1; minute < 60; ++minute)
+        REQUIRE(propagator.propagate(ms(timestampMs(18, minute)), r, v));
+    CHECK(propagator.initialisations() == 1);
+
+    // Reusing the initialised state gives the same answer as a fresh sgp4init
+    SGP4Propagator fresh;
+    fresh.setTLE(issTle());
+    SGP4Propagator::Vector r_fresh, v_fresh;
+    REQUIRE(fresh.propagate(ms(timestampMs(18, 59)), r_fresh, v_fresh));
+    CHECK(r == r_fresh);
+    CHECK(v == v_fresh);
+
+    propagator.setTLE(issTle());
+    REQUIRE(propagator.propagate(ms(timestampMs(18, 0)), r, v));
+    CHECK(propagator.initialisations() == 2);
+}
+
+TEST_CASE("SGP4Propagator recovers from a failed propagation")
+{
+    SGP4Propagator propagator;
+    propagator.setTLE(issTle());
+    SGP4Propagator::Vector r, v;
+
+    // Decades past the epoch the ISS elements have decayed and sgp4 reports an error
+    CHECK_FALSE(propagator.propagate(1.0e7f, r, v));
+
+    // The next step is propagated again rather than rejected with the stale error
+    REQUIRE(propagator.propagate(ms(timestampMs(18, 0)), r, v));
+    CHECK(r[0] == doctest::Approx(-3006.157f).epsilon(0.01));
+    CHECK(propagator.initialisations() == 1);
+}
+
+TEST_CASE("SGP4Ephemeris interpolates between batch-propagated nodes")
+{
+    SGP4Propagator propagator;
+    propagator.setTLE(issTle());
+
+    // One orbit at one minute spacing
+    SGP4Ephemeris<96> ephemeris;
+    const uint64_t start = timestampMs(18, 0);
+    REQUIRE(ephemeris.generate(propagator, ms(start), 60000));
+    CHECK(ephemeris.end().in(au::milli(au::seconds)) == start + 95 * 60000);
+
+    float max_position_error = 0.f, max_velocity_error = 0.f;
+    for (uint64_t t = start; t <= start + 95 * 60000; t += 7333)
+    {
+        SGP4Propagator::Vector r, v, r_direct, v_direct;
+        REQUIRE(ephemeris.interpolate(ms(t), r, v));
+        REQUIRE(propagator.propagate(ms(t), r_direct, v_direct));
+        max_position_error = std::max(max_position_error, distance(r, r_direct));
+        max_velocity_error = std::max(max_velocity_error, distance(v, v_direct));
+    }
+    MESSAGE("60 s nodes: max position error " << 1000.f * max_position_error << " m, velocity " << 1000.f * max_velocity_error << " m/s");
+    // The float SGP4 itself is only self-consistent to a few metres and its velocity differs from
+    // the derivative of its position by up to ~1 m/s, which sets the floor here
+    CHECK(max_position_error < 0.05f);
+    CHECK(max_velocity_error < 0.001f);
+
+    // Nodes are returned exactly
+    std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> r_node;
+    std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> v_node;
+    REQUIRE(ephemeris.interpolate(ephemeris.timestampAt(10), r_node, v_node));
+    CHECK(r_node[0].in(au::kilo(au::metersInTemeFrame)) == doctest::Approx(ephemeris.position(10)[0]));
+    CHECK(v_node[2].in(au::kilo(au::metersPerSecondInTemeFrame)) == doctest::Approx(ephemeris.velocity(10)[2]));
+
+    SGP4Propagator::Vector r, v;
+    CHECK_FALSE(ephemeris.interpolate(ms(start - 1), r, v));
+    CHECK_FALSE(ephemeris.interpolate(ms(start + 95 * 60000 + 1), r, v));
+    CHECK(propagator.initialisations() == 1);
+}
+
+TEST_CASE("SGP4Ephemeris rejects an invalid batch")
+{
+    SGP4Propagator propagator;
+    SGP4Ephemeris<8> ephemeris;
+    CHECK_FALSE(ephemeris.generate(propagator, ms(timestampMs(18, 0)), 60000));
+    CHECK_FALSE(ephemeris.valid());
+
+    propagator.setTLE(issTle());
+    CHECK_FALSE(ephemeris.generate(propagator, ms(timestampMs(18, 0)), 0));
+    CHECK(ephemeris.generate(propagator, ms(timestampMs(18, 0)), 60000));
+    CHECK(ephemeris.covers(ms(timestampMs(18, 7))));
+}
+
+TEST_CASE("Benchmark per-call sgp4init, cached propagator and ephemeris lookups")
+{
+    constexpr int iterations = 200;
+    const SGP4TwoLineElement tle = issTle();
+    const uint64_t start = timestampMs(18, 0);
+
+    auto time = [&](auto lookup)
+    {
+        float sink = 0.f;
+        const auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            SGP4Propagator::Vector r, v;
+            lookup(ms(start + static_cast<uint64_t>(i) * 1000), r, v);
+            sink += r[0];
+        }
+        const auto end = std::chrono::steady_clock::now();
+        CHECK(std::isfinite(sink));
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / iterations;
+    };
+
+    SGP4Propagator cached;
+    cached.setTLE(tle);
+    SGP4Ephemeris<8> ephemeris;
+    REQUIRE(ephemeris.generate(cached, ms(start), 60000));
+
+    const double init_ns = time([&](auto t, auto &r, auto &v)
+                                {
+                                    SGP4Propagator propagator;
+                                    propagator.setTLE(tle);
+                                    return propagator.propagate(t, r, v); });
+    const double cached_ns = time([&](auto t, auto &r, auto &v)
+                                  { return cached.propagate(t, r, v); });
+    const double ephemeris_ns = time([&](auto t, auto &r, auto &v)
+                                     { return ephemeris.interpolate(t, r, v); });
+
+    MESSAGE("TEME state: sgp4init per call " << init_ns << " ns, cached " << cached_ns << " ns, ephemeris " << ephemeris_ns << " ns");
+    CHECK(cached.initialisations() == 1);
+}
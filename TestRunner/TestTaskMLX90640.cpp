@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <vector>
 #include "mock_hal.h"
 
 #include "TaskMLX90640.hpp"
@@ -26,6 +27,7 @@ struct MockMLX
     bool sleep_called = false;
     int isReady_calls = 0;
     int readSubpage_calls = 0;
+    std::vector<int> subpages; // subpage IDs to report in order, alternating 0/1 once exhausted
 
     bool wakeUp(MLX90640_RefreshRate = MLX90640_RefreshRate::Hz4)
     {
@@ -45,18 +47,20 @@ struct MockMLX
         return true;    // Always ready for tests
     }
 
-    bool readSubpage(uint16_t* buf, int& sp)
+    // Fills the subpage's slot with a stamp identifying the read that produced it
+    bool readSubpageIntoFrame(uint16_t* frame, int& sp)
     {
         readSubpage_calls++;
-        sp = (readSubpage_calls % 2 == 1 ? 0 : 1);
-        buf[0] = 0xABCD;
+        const size_t n = static_cast<size_t>(readSubpage_calls - 1);
+        sp = n < subpages.size() ? subpages[n] : (readSubpage_calls % 2 == 1 ? 0 : 1);
+        for (size_t i = 0; i < MLX90640_SUBPAGE_WORDS; ++i)
+            frame[static_cast<size_t>(sp) * MLX90640_SUBPAGE_WORDS + i] = stamp(sp, readSubpage_calls);
         return true;
     }
 
-    void createFrame(const uint16_t* a, const uint16_t* b, uint16_t* out)
+    static uint16_t stamp(int sp, int call)
     {
-        out[0] = a[0];
-        out[1] = b[0];
+        return static_cast<uint16_t>(0x1000 * (sp + 1) + call);
     }
 };
 
@@ -90,6 +94,7 @@ struct MockImageBuffer
     int push_image_calls     = 0;   // how many frames successfully stored
     int add_chunk_calls      = 0;   // how many chunks were written
     size_t total_chunk_bytes = 0;   // total bytes written
+    std::vector<uint8_t> payload;   // bytes of all chunks, in order
 
     // ------------------------------------------------------------
     // Reset between tests
@@ -100,6 +105,7 @@ struct MockImageBuffer
         push_image_calls     = 0;
         add_chunk_calls      = 0;
         total_chunk_bytes    = 0;
+        payload.clear();
     }
 
     // ------------------------------------------------------------
@@ -139,10 +145,11 @@ struct MockImageBuffer
         return ImageBufferError::NO_ERROR;
     }
 
-    ImageBufferError add_data_chunk(const uint8_t*, size_t size)
+    ImageBufferError add_data_chunk(const uint8_t* data, size_t size)
     {
         ++add_chunk_calls;
         total_chunk_bytes += size;
+        payload.insert(payload.end(), data, data + size);
         return ImageBufferError::NO_ERROR;
     }
 
@@ -318,3 +325,110 @@ CHECK(imgBuf->add_image_calls > 1);   // multiple acquisition events happened
 CHECK(mlx->readSubpage_calls >= 2 * imgBuf->add_image_calls);
 CHECK(imgBuf->push_image_calls == 5);
 }
+
+static uint16_t payloadWord(const MockImageBuffer& buffer, size_t word)
+{
+    uint16_t value;
+    std::memcpy(&value, buffer.payload.data() + word * sizeof(uint16_t), sizeof(value));
+    return value;
+}
+
+TEST_CASE("TaskMLX90640 assembles subpages in place regardless of read order")
+{
+    HAL_SetTick(0);
+
+    RegistrationManager mgr;
+    auto pwr = std::make_shared<MockPower>();
+    auto mlx = std::make_shared<MockMLX>();
+    auto imgBuf = std::make_shared<MockImageBuffer>();
+
+    // Subpage 1 arrives first, then again before subpage 0: the repeat replaces the first read
+    mlx->subpages = {1, 1, 0};
+
+    OnceTrigger trig;
+    auto task = std::make_shared<TaskMLX90640<MockPower, MockMLX, MockImageBuffer, OnceTrigger>>(
+        *pwr,
+        CIRCUITS::CIRCUIT_0,
+        *mlx,
+        *imgBuf,
+        trig,
+        MLXMode::OneShot,
+        1,
+        0, 0, 0
+    );
+
+    mgr.add(task);
+
+    for (int i = 0; i < 5000; i++) {
+        advance_time_ms(1);
+        task->handleTask();
+    }
+
+    CHECK(mlx->readSubpage_calls == 3);
+    REQUIRE(imgBuf->push_image_calls == 1);
+    REQUIRE(imgBuf->payload.size() == MLX90640_FRAME_SIZE);
+
+    CHECK(payloadWord(*imgBuf, 0) == MockMLX::stamp(0, 3));
+    CHECK(payloadWord(*imgBuf, MLX90640_SUBPAGE_WORDS - 1) == MockMLX::stamp(0, 3));
+    CHECK(payloadWord(*imgBuf, MLX90640_SUBPAGE_WORDS) == MockMLX::stamp(1, 2));
+    CHECK(payloadWord(*imgBuf, MLX90640_FRAME_WORDS - 1) == MockMLX::stamp(1, 2));
+}
+
+TEST_CASE("TaskMLX90640 holds a single frame slot and no subpage buffers")
+{
+    using TaskT = TaskMLX90640<MockPower, MockMLX, MockImageBuffer, OnceTrigger>;
+    MESSAGE("sizeof(TaskMLX90640) = " << sizeof(TaskT) << " bytes");
+    CHECK(sizeof(TaskT) >= MLX90640_FRAME_SIZE);
+    CHECK(sizeof(TaskT) < MLX90640_FRAME_SIZE + MLX90640_SUBPAGE_SIZE);
+}
+
+struct MockSelectorEveryOther
+{
+    int calls = 0;
+    bool select(const uint16_t*, ImageMetadata& meta)
+    {
+        meta.significance = static_cast<uint16_t>(++calls);
+        return calls % 2 == 1;
+    }
+};
+
+TEST_CASE("TaskMLX90640 stores only the frames its selector keeps")
+{
+    HAL_SetTick(0);
+
+    RegistrationManager mgr;
+    auto pwr = std::make_shared<MockPower>();
+    auto mlx = std::make_shared<MockMLX>();
+    auto imgBuf = std::make_shared<MockImageBuffer>();
+    MockSelectorEveryOther selector;
+
+    OnceTrigger trig;
+    auto task = std::make_shared<TaskMLX90640<MockPower, MockMLX, MockImageBuffer, OnceTrigger, MockSelectorEveryOther>>(
+        *pwr,
+        CIRCUITS::CIRCUIT_0,
+        *mlx,
+        *imgBuf,
+        trig,
+        MLXMode::Burst,
+        4,
+        0, 0, 0,
+        selector
+    );
+
+    mgr.add(task);
+
+    for (int i = 0; i < 5000; i++) {
+        advance_time_ms(1);
+        task->handleTask();
+    }
+
+    CHECK(selector.calls == 4);
+    CHECK(imgBuf->add_image_calls == 2);
+    CHECK(imgBuf->push_image_calls == 2);
+    CHECK(task->getFramesDropped() == 2);
+    CHECK(task->getState() == MLXState::Waiting);
+
+    // The detector satisfies the same hook
+    static_assert(FrameSelectorConcept<ThermalEventDetector>);
+    static_assert(FrameSelectorConcept<KeepAllFrames>);
+}
@@ -0,0 +1,136 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <array>
+#include <cstring>
+#include <string>
+
+#include "TaskRespondList.hpp"
+#include "ThumbnailCatalogue.hpp"
+#include "ImageBuffer.hpp"
+#include "imagebuffer/DirectMemoryAccessor.hpp"
+#include "Task.hpp"
+#include "cyphal.hpp"
+#include "loopard_adapter.hpp"
+#include "RegistrationManager.hpp"
+#include "FileAccess.hpp"
+#include "uavcan/file/List_0_2.h"
+
+void *loopardMemoryAllocate(size_t amount) { return static_cast<void *>(malloc(amount)); };
+void loopardMemoryFree(void *pointer) { free(pointer); };
+
+using Buffer = ImageBuffer<DirectMemoryAccessor>;
+using Catalogue = ThumbnailCatalogue<Buffer>;
+
+template <typename... Adapters>
+class MockTaskRespondList : public TaskRespondList<Catalogue, Adapters...>
+{
+public:
+    MockTaskRespondList(Catalogue &catalogue, uint32_t interval, uint32_t tick, std::tuple<Adapters...> &adapters)
+        : TaskRespondList<Catalogue, Adapters...>(catalogue, interval, tick, adapters) {}
+
+    using TaskRespondList<Catalogue, Adapters...>::handleMessage;
+    using TaskRespondList<Catalogue, Adapters...>::handleTaskImpl;
+};
+
+std::shared_ptr<CyphalTransfer> createListRequest(uint32_t entry_index, CyphalTransferID transfer_id)
+{
+    uavcan_file_List_Request_0_2 request = {};
+    request.entry_index = entry_index;
+
+    static uint8_t buffer[uavcan_file_List_Request_0_2_SERIALIZATION_BUFFER_SIZE_BYTES_];
+    size_t size = sizeof(buffer);
+    REQUIRE(uavcan_file_List_Request_0_2_serialize_(&request, buffer, &size) >= 0);
+
+    auto transfer = std::make_shared<CyphalTransfer>();
+    transfer->metadata.transfer_kind = CyphalTransferKindRequest;
+    transfer->metadata.port_id = uavcan_file_List_0_2_FIXED_PORT_ID_;
+    transfer->metadata.remote_node_id = 42;
+    transfer->metadata.transfer_id = transfer_id;
+    transfer->payload_size = size;
+    transfer->payload = buffer;
+    return transfer;
+}
+
+std::string listEntry(MockTaskRespondList<Cyphal<LoopardAdapter>> &task, LoopardAdapter &loopard, uint32_t entry_index)
+{
+    task.handleMessage(createListRequest(entry_index, static_cast<CyphalTransferID>(entry_index)));
+    task.handleTaskImpl();
+
+    REQUIRE(loopard.buffer.size() == 1);
+    CyphalTransfer response = loopard.buffer.pop();
+    CHECK(response.metadata.port_id == uavcan_file_List_0_2_FIXED_PORT_ID_);
+    CHECK(response.metadata.transfer_kind == CyphalTransferKindResponse);
+
+    uavcan_file_List_Response_0_2 data;
+    size_t size = response.payload_size;
+    REQUIRE(uavcan_file_List_Response_0_2_deserialize_(&data, static_cast<const uint8_t *>(response.payload), &size) >= 0);
+    loopardMemoryFree(response.payload);
+    return std::string(reinterpret_cast<const char *>(data.entry_base_name.path.elements), data.entry_base_name.path.count);
+}
+
+static void addRecord(Buffer &buffer, const ImageMetadata &meta)
+{
+    const std::array<uint8_t, 16> pixels{};
+    REQUIRE(buffer.add_image(meta) == ImageBufferError::NO_ERROR);
+    REQUIRE(buffer.add_data_chunk(pixels.data(), meta.payload_size) == ImageBufferError::NO_ERROR);
+    REQUIRE(buffer.push_image() == ImageBufferError::NO_ERROR);
+}
+
+TEST_CASE("TaskRespondList: lists the thumbnail records of the buffer by index")
+{
+    LoopardAdapter loopard;
+    loopard.memory_allocate = loopardMemoryAllocate;
+    loopard.memory_free = loopardMemoryFree;
+    Cyphal<LoopardAdapter> loopard_cyphal(&loopard);
+    loopard_cyphal.setNodeID(11);
+    std::tuple<Cyphal<LoopardAdapter>> adapters(loopard_cyphal);
+
+    DirectMemoryAccessor accessor(0x90000000, 4096);
+    Buffer buffer(accessor);
+    Catalogue catalogue(buffer);
+    ImageMetadata meta{};
+    meta.producer = METADATA_PRODUCER::CAMERA_1;
+    meta.timestamp = 0x1234;
+    addRecord(buffer, thumbnailMetadata(meta, 4, 4));
+    meta.timestamp = 0x1236;
+    meta.payload_size = 16;
+    addRecord(buffer, meta); // A frame, not listed
+    meta.timestamp = 0x1235;
+    addRecord(buffer, thumbnailMetadata(meta, 4, 4));
+
+    MockTaskRespondList<Cyphal<LoopardAdapter>> task(catalogue, 1000, 0, adapters);
+
+    CHECK(listEntry(task, loopard, 0) == "000000000000123400");
+    CHECK(listEntry(task, loopard, 1) == "000000000000123500");
+    CHECK(listEntry(task, loopard, 2).empty());
+}
+
+TEST_CASE("TaskRespondList: Registers and Unregisters correctly")
+{
+    LoopardAdapter loopard;
+    loopard.memory_allocate = loopardMemoryAllocate;
+    loopard.memory_free = loopardMemoryFree;
+    Cyphal<LoopardAdapter> cy(&loopard);
+    cy.setNodeID(11);
+    std::tuple<Cyphal<LoopardAdapter>> adapters(cy);
+
+    DirectMemoryAccessor accessor(0x90000000, 4096);
+    Buffer buffer(accessor);
+    Catalogue catalogue(buffer);
+    RegistrationManager reg;
+    auto task = std::make_shared<TaskRespondList<Catalogue, Cyphal<LoopardAdapter>>>(catalogue, 1000, 0, adapters);
+
+    CHECK(reg.getServers().size() == 0);
+    task->registerTask(&reg, task);
+    CHECK(reg.getServers().size() == 1);
+    CHECK(reg.getServers().containsIf([](CyphalPortID id){
+        return id == uavcan_file_List_0_2_FIXED_PORT_ID_;
+    }));
+
+    task->unregisterTask(&reg, task);
+    CHECK(reg.getServers().size() == 0);
+}
@@ -0,0 +1,192 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+#include "ThermalEventDetector.hpp"
+
+using Frame = std::array<uint16_t, MLX90640_FRAME_WORDS>;
+
+constexpr float NOISE_COUNTS = 3.0f;
+
+// Raw frame of a static scene with Gaussian read noise, plus an optional warm square
+struct SceneGenerator
+{
+    std::mt19937 rng{1234};
+    std::normal_distribution<float> noise{0.0f, NOISE_COUNTS};
+
+    Frame next(float offset = 0.0f, std::size_t hotRow = 0, std::size_t hotCol = 0, std::size_t hotSize = 0, float hotCounts = 0.0f)
+    {
+        Frame frame{};
+        for (std::size_t row = 0; row < ThermalEventDetector::HEIGHT; ++row)
+        {
+            for (std::size_t col = 0; col < ThermalEventDetector::WIDTH; ++col)
+            {
+                const std::size_t i = row * ThermalEventDetector::WIDTH + col;
+                float value = -1200.0f + 5.0f * float(i % 37) + offset + noise(rng);
+                if (row >= hotRow && row < hotRow + hotSize && col >= hotCol && col < hotCol + hotSize)
+                    value += hotCounts;
+                const int16_t raw = static_cast<int16_t>(std::lround(value));
+                // The pixel lives in the subpage of its checkerboard parity
+                frame[i + ((row + col) & 1u) * MLX90640_SUBPAGE_WORDS] = static_cast<uint16_t>(raw);
+            }
+        }
+        return frame;
+    }
+};
+
+TEST_CASE("ThermalEventDetector learns the per-pixel noise of a static scene")
+{
+    ThermalEventDetector detector;
+    SceneGenerator scene;
+
+    float worst = 0.0f;
+    for (int n = 0; n < 200; ++n)
+    {
+        const auto score = detector.update(scene.next().data());
+        if (n >= 64)
+            worst = std::max(worst, score.significance);
+    }
+    MESSAGE("static scene: max significance " << worst << ", change " << detector.lastScore().changeSigma);
+
+    CHECK(worst < ThermalEventDetector::Config{}.threshold);
+    CHECK(detector.lastScore().changeSigma == doctest::Approx(1.0f).epsilon(0.25));
+
+    float variance = 0.0f;
+    for (std::size_t i = 0; i < ThermalEventDetector::PIXELS; ++i)
+        variance += detector.variance(i);
+    variance /= float(ThermalEventDetector::PIXELS);
+    CHECK(variance == doctest::Approx(NOISE_COUNTS * NOISE_COUNTS).epsilon(0.2));
+    CHECK(detector.mean(0) == doctest::Approx(-1200.0f).epsilon(0.01));
+}
+
+TEST_CASE("ThermalEventDetector scores hot spots and scene changes")
+{
+    ThermalEventDetector detector;
+    SceneGenerator scene;
+    for (int n = 0; n < 64; ++n)
+        detector.update(scene.next().data());
+
+    SUBCASE("hot spot")
+    {
+        const auto score = detector.update(scene.next(0.0f, 10, 20, 3, 60.0f).data());
+        MESSAGE("3x3 hot spot: peak " << score.peakSigma << " sigma, " << score.hotPixels << " hot pixels");
+        CHECK(score.hotPixels >= 9);
+        CHECK(score.significance >= ThermalEventDetector::Config{}.threshold);
+        CHECK(score.peakPixel / ThermalEventDetector::WIDTH >= 10);
+        CHECK(score.peakPixel / ThermalEventDetector::WIDTH < 13);
+        CHECK(score.peakPixel % ThermalEventDetector::WIDTH >= 20);
+        CHECK(score.peakPixel % ThermalEventDetector::WIDTH < 23);
+    }
+
+    SUBCASE("single hot pixel is treated as noise")
+    {
+        const auto score = detector.update(scene.next(0.0f, 5, 5, 1, 60.0f).data());
+        CHECK(score.hotPixels <= 1);
+        CHECK(score.significance < ThermalEventDetector::Config{}.threshold);
+    }
+
+    SUBCASE("global change")
+    {
+        const auto score = detector.update(scene.next(-40.0f).data());
+        MESSAGE("global -40 counts: change " << score.changeSigma << " sigma");
+        CHECK(score.hotPixels == 0);
+        CHECK(score.significance == doctest::Approx(score.changeSigma));
+        CHECK(score.significance >= ThermalEventDetector::Config{}.threshold);
+    }
+}
+
+TEST_CASE("ThermalEventDetector keeps events and one baseline in N frames")
+{
+    ThermalEventDetector::Config config;
+    config.baselineEvery = 10;
+    ThermalEventDetector detector(config);
+    SceneGenerator scene;
+
+    uint32_t kept = 0;
+    for (int n = 0; n < 100; ++n)
+    {
+        ImageMetadata meta{};
+        if (detector.select(scene.next().data(), meta))
+            ++kept;
+        CHECK(meta.significance < uint16_t(config.threshold * ThermalEventDetector::SIGNIFICANCE_SCALE));
+    }
+    // The first frame, then every 10th
+    CHECK(kept == 10);
+    CHECK(detector.kept() == 10);
+
+    ImageMetadata meta{};
+    CHECK(detector.select(scene.next(0.0f, 0, 0, 4, 80.0f).data(), meta));
+    CHECK(meta.significance == uint16_t(std::lround(detector.lastScore().significance * ThermalEventDetector::SIGNIFICANCE_SCALE)));
+
+    // The event restarts the baseline count
+    int sinceEvent = 0;
+    while (!detector.select(scene.next().data(), meta))
+        ++sinceEvent;
+    CHECK(sinceEvent == 9);
+}
+
+TEST_CASE("ThermalEventDetector scores nothing during warm-up and after reset")
+{
+    ThermalEventDetector detector;
+    SceneGenerator scene;
+    for (uint32_t n = 0; n < ThermalEventDetector::Config{}.warmupFrames; ++n)
+        CHECK(detector.update(scene.next(0.0f, 0, 0, 8, 500.0f * float(n % 2)).data()).significance == 0.0f);
+    CHECK(detector.update(scene.next(0.0f, 0, 0, 8, 500.0f).data()).significance > 0.0f);
+
+    detector.reset();
+    CHECK(detector.frames() == 0);
+    CHECK(detector.update(scene.next(0.0f, 0, 0, 8, 500.0f).data()).significance == 0.0f);
+}
+
+TEST_CASE("ThermalEventDetector reset clears the kept count and the baseline spacing")
+{
+    ThermalEventDetector::Config config;
+    config.baselineEvery = 10;
+    ThermalEventDetector detector(config);
+    SceneGenerator scene;
+
+    ImageMetadata meta{};
+    for (int n = 0; n < 15; ++n)
+        (void)detector.select(scene.next().data(), meta);
+    CHECK(detector.kept() == 2);
+
+    detector.reset();
+    CHECK(detector.kept() == 0);
+    CHECK(detector.frames() == 0);
+    CHECK(detector.lastScore().significance == 0.0f);
+
+    // The first frame after the reset is a baseline again, then one in every 10
+    CHECK(detector.select(scene.next().data(), meta));
+    int sinceBaseline = 0;
+    while (!detector.select(scene.next().data(), meta))
+        ++sinceBaseline;
+    CHECK(sinceBaseline == 9);
+    CHECK(detector.kept() == 2);
+}
+
+TEST_CASE("Benchmark ThermalEventDetector against the frame period")
+{
+    constexpr int frames = 200;
+    ThermalEventDetector detector;
+    SceneGenerator scene;
+    std::array<Frame, 8> inputs;
+    for (auto &frame : inputs)
+        frame = scene.next();
+
+    float sink = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < frames; ++n)
+        sink += detector.update(inputs[static_cast<std::size_t>(n) % inputs.size()].data()).changeSigma;
+    const auto stop = std::chrono::steady_clock::now();
+
+    const double us = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) / frames / 1000.0;
+    const double period_us = 1000.0 * getRefreshIntervalMs(MLX90640_RefreshRate::Hz16);
+    MESSAGE("update: " << us << " us per frame, " << 100.0 * us / period_us << "% of the 16 Hz frame period");
+    CHECK(std::isfinite(sink));
+    CHECK(us < period_us);
+}
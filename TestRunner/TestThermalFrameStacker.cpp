@@ -0,0 +1,266 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ThermalFrameStacker.hpp"
+
+using Quaternion = std::array<float, 4>;
+using Image = std::array<float, 768>;
+
+constexpr float NOISE_DEGC = 0.5f;
+constexpr float PI = 3.14159265358979f;
+
+static Quaternion multiply(const Quaternion &a, const Quaternion &b)
+{
+    return {a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3],
+            a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2],
+            a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1],
+            a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0]};
+}
+
+static Quaternion axisAngle(float x, float y, float z, float angle)
+{
+    const float s = std::sin(0.5f * angle);
+    return {std::cos(0.5f * angle), x * s, y * s, z * s};
+}
+
+// v' = q v q*
+static std::array<float, 3> rotate(const Quaternion &q, const std::array<float, 3> &v)
+{
+    const Quaternion p = multiply(multiply(q, {0.f, v[0], v[1], v[2]}), {q[0], -q[1], -q[2], -q[3]});
+    return {p[1], p[2], p[3]};
+}
+
+// Scene fixed in NED, seen by a camera whose reference attitude looks along `base`
+struct SyntheticScene
+{
+    Quaternion base = multiply(axisAngle(0.f, 0.f, 1.f, 0.7f), axisAngle(1.f, 0.f, 0.f, -0.4f));
+    float fx = 16.f / std::tan(0.5f * 55.f * PI / 180.f);
+    float fy = 12.f / std::tan(0.5f * 35.f * PI / 180.f);
+    std::mt19937 rng{42};
+    std::normal_distribution<float> noise{0.f, NOISE_DEGC};
+
+    // Temperature along a direction given in the reference camera frame
+    static float temperature(const std::array<float, 3> &d)
+    {
+        const float ax = std::atan2(d[0], d[2]);
+        const float ay = std::atan2(d[1], d[2]);
+        const float blob = 15.f * std::exp(-((ax - 0.1f) * (ax - 0.1f) + (ay + 0.05f) * (ay + 0.05f)) / (2.f * 0.04f * 0.04f));
+        const float stripes = 3.f * std::sin(ax * 45.f) * std::cos(ay * 40.f);
+        return 20.f + blob + stripes;
+    }
+
+    // Temperature seen by (fractional) reference pixel (u, v)
+    float truth(float u, float v) const
+    {
+        return temperature({(u - 15.5f) / fx, (v - 11.5f) / fy, 1.f});
+    }
+
+    Image render(const Quaternion &attitude, bool noisy = true)
+    {
+        // Reference camera axes of each ray seen at this attitude
+        const Quaternion relative = multiply({base[0], -base[1], -base[2], -base[3]}, attitude);
+        Image image{};
+        for (std::size_t row = 0; row < 24; ++row)
+            for (std::size_t col = 0; col < 32; ++col)
+            {
+                const auto d = rotate(relative, {(float(col) - 15.5f) / fx, (float(row) - 11.5f) / fy, 1.f});
+                image[row * 32 + col] = temperature(d) + (noisy ? noise(rng) : 0.f);
+            }
+        return image;
+    }
+
+    // Attitude jittered by up to `pixels` of pan/tilt and a little roll about the boresight
+    Quaternion jitter(float pixels)
+    {
+        std::uniform_real_distribution<float> u(-1.f, 1.f);
+        const float pan = u(rng) * pixels / fx;
+        const float tilt = u(rng) * pixels / fy;
+        const float roll = u(rng) * 0.01f;
+        return multiply(base, multiply(axisAngle(0.f, 1.f, 0.f, pan), multiply(axisAngle(1.f, 0.f, 0.f, tilt), axisAngle(0.f, 0.f, 1.f, roll))));
+    }
+};
+
+// RMS error against the scene over the interior of the product, NaN cells excluded
+template <std::size_t SCALE>
+static float rmsError(const typename ThermalFrameStacker<SCALE>::Product &product, const SyntheticScene &scene)
+{
+    using Stacker = ThermalFrameStacker<SCALE>;
+    const std::size_t margin = 2 * SCALE;
+    double sum = 0.0;
+    std::size_t n = 0;
+    for (std::size_t y = margin; y < Stacker::OUT_HEIGHT - margin; ++y)
+        for (std::size_t x = margin; x < Stacker::OUT_WIDTH - margin; ++x)
+        {
+            const float value = product[y * Stacker::OUT_WIDTH + x];
+            if (std::isnan(value))
+                continue;
+            const float u = (float(x) + 0.5f) / float(SCALE) - 0.5f;
+            const float v = (float(y) + 0.5f) / float(SCALE) - 0.5f;
+            const double e = value - scene.truth(u, v);
+            sum += e * e;
+            ++n;
+        }
+    return n == 0 ? INFINITY : float(std::sqrt(sum / double(n)));
+}
+
+TEST_CASE("ThermalFrameStacker averages a static scene down by sqrt(N)")
+{
+    SyntheticScene scene;
+    ThermalFrameStacker<1> stacker;
+
+    const Image single = scene.render(scene.base);
+    ThermalFrameStacker<1>::Product one{};
+    std::copy(single.begin(), single.end(), one.begin());
+
+    bool done = false;
+    for (int n = 0; n < 16; ++n)
+    {
+        CHECK_FALSE(done);
+        done = stacker.add(scene.render(scene.base), scene.base);
+    }
+    REQUIRE(done);
+    CHECK(stacker.coverage() == 1.0f);
+
+    const float before = rmsError<1>(one, scene);
+    const float after = rmsError<1>(stacker.product(), scene);
+    MESSAGE("static, 16 frames: RMS error " << before << " -> " << after << " degC");
+    CHECK(before == doctest::Approx(NOISE_DEGC).epsilon(0.15));
+    CHECK(after < 0.3f * before);
+}
+
+TEST_CASE("ThermalFrameStacker registers frames by attitude")
+{
+    SyntheticScene scene;
+    ThermalFrameStacker<1> aligned;
+    ThermalFrameStacker<1> unaligned;
+
+    for (int n = 0; n < 16; ++n)
+    {
+        const Quaternion attitude = n == 0 ? scene.base : scene.jitter(2.0f);
+        const Image frame = scene.render(attitude);
+        aligned.add(frame, attitude);
+        // Pretending the attitude never changed stacks misregistered frames
+        unaligned.add(frame, scene.base);
+    }
+
+    const float alignedError = rmsError<1>(aligned.product(), scene);
+    const float unalignedError = rmsError<1>(unaligned.product(), scene);
+    MESSAGE("+-2 px jitter, 16 frames: aligned " << alignedError << " degC, unaligned " << unalignedError << " degC");
+    CHECK(alignedError < 0.5f * unalignedError);
+    CHECK(alignedError < NOISE_DEGC);
+}
+
+TEST_CASE("ThermalFrameStacker drizzles jittered frames to 64x48")
+{
+    SyntheticScene scene;
+    auto drizzled = std::make_unique<ThermalFrameStacker<2>>(ThermalFrameStacker<2>::Config{.frames_per_product = 32});
+    auto averaged = std::make_unique<ThermalFrameStacker<1>>(ThermalFrameStacker<1>::Config{.frames_per_product = 32});
+
+    for (int n = 0; n < 32; ++n)
+    {
+        const Quaternion attitude = n == 0 ? scene.base : scene.jitter(1.0f);
+        const Image frame = scene.render(attitude);
+        drizzled->add(frame, attitude);
+        averaged->add(frame, attitude);
+    }
+    REQUIRE(drizzled->products() == 1);
+    CHECK(drizzled->coverage() > 0.99f);
+
+    // The 32x24 average upsampled bilinearly to the same grid
+    ThermalFrameStacker<2>::Product upsampled{};
+    const auto &low = averaged->product();
+    for (std::size_t y = 0; y < 48; ++y)
+        for (std::size_t x = 0; x < 64; ++x)
+        {
+            const float u = std::clamp((float(x) + 0.5f) / 2.f - 0.5f, 0.f, 30.999f);
+            const float v = std::clamp((float(y) + 0.5f) / 2.f - 0.5f, 0.f, 22.999f);
+            const std::size_t u0 = std::size_t(u), v0 = std::size_t(v);
+            const float a = u - float(u0), b = v - float(v0);
+            upsampled[y * 64 + x] = (1 - a) * (1 - b) * low[v0 * 32 + u0] + a * (1 - b) * low[v0 * 32 + u0 + 1] +
+                                    (1 - a) * b * low[(v0 + 1) * 32 + u0] + a * b * low[(v0 + 1) * 32 + u0 + 1];
+        }
+
+    const float drizzleError = rmsError<2>(drizzled->product(), scene);
+    const float upsampledError = rmsError<2>(upsampled, scene);
+    MESSAGE("64x48 from 32 frames: drizzle " << drizzleError << " degC, upsampled average " << upsampledError << " degC");
+    CHECK(drizzleError < upsampledError);
+}
+
+TEST_CASE("ThermalFrameStacker skips NaN pixels and stores products")
+{
+    struct Sink
+    {
+        ImageMetadata meta{};
+        std::vector<uint8_t> payload;
+        int pushed = 0;
+        bool is_empty() const { return true; }
+        size_t count() const { return 0; }
+        bool has_room_for(size_t) const { return true; }
+        ImageBufferError add_image(const ImageMetadata &m) { meta = m; return ImageBufferError::NO_ERROR; }
+        ImageBufferError add_data_chunk(const uint8_t *data, size_t size) { payload.insert(payload.end(), data, data + size); return ImageBufferError::NO_ERROR; }
+        ImageBufferError push_image() { ++pushed; return ImageBufferError::NO_ERROR; }
+        ImageBufferError get_image(ImageMetadata &) { return ImageBufferError::NO_ERROR; }
+        ImageBufferError get_data_chunk(uint8_t *, size_t &size) { size = 0; return ImageBufferError::NO_ERROR; }
+        ImageBufferError pop_image() { return ImageBufferError::NO_ERROR; }
+    };
+
+    SyntheticScene scene;
+    ThermalFrameStacker<1> stacker(ThermalFrameStacker<1>::Config{.frames_per_product = 2});
+    Image frame = scene.render(scene.base, false);
+    frame[5] = NAN;
+    CHECK_FALSE(stacker.add(frame, scene.base));
+    CHECK(stacker.add(frame, scene.base));
+    CHECK(std::isnan(stacker.product()[5]));
+    CHECK(stacker.product()[6] == doctest::Approx(frame[6]));
+    CHECK(stacker.coverage() == doctest::Approx(767.f / 768.f));
+
+    Sink sink;
+    REQUIRE(stacker.store(sink, 1234) == ImageBufferError::NO_ERROR);
+    CHECK(sink.pushed == 1);
+    CHECK(sink.meta.producer == METADATA_PRODUCER::THERMAL);
+    CHECK(sink.meta.dimensions.n1 == 32);
+    CHECK(sink.meta.dimensions.n2 == 24);
+    CHECK(sink.payload.size() == sizeof(ThermalFrameStacker<1>::Product));
+
+    // A partial product is dropped by reset
+    CHECK_FALSE(stacker.add(frame, scene.base));
+    stacker.reset();
+    CHECK(stacker.frames() == 0);
+}
+
+TEST_CASE("Benchmark ThermalFrameStacker frames per second")
+{
+    SyntheticScene scene;
+    std::array<Image, 8> frames;
+    std::array<Quaternion, 8> attitudes;
+    for (std::size_t i = 0; i < frames.size(); ++i)
+    {
+        attitudes[i] = scene.jitter(1.0f);
+        frames[i] = scene.render(attitudes[i]);
+    }
+
+    auto time = [&](auto &stacker)
+    {
+        constexpr int count = 256;
+        const auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < count; ++n)
+            stacker.add(frames[std::size_t(n) % frames.size()], attitudes[std::size_t(n) % frames.size()]);
+        const auto stop = std::chrono::steady_clock::now();
+        CHECK(std::isfinite(stacker.product()[400]));
+        return count / std::chrono::duration<double>(stop - start).count();
+    };
+
+    auto average = std::make_unique<ThermalFrameStacker<1>>();
+    auto drizzle = std::make_unique<ThermalFrameStacker<2>>();
+    const double averageFps = time(*average);
+    const double drizzleFps = time(*drizzle);
+    MESSAGE("frames/s: aligned average 32x24 " << averageFps << ", drizzle 64x48 " << drizzleFps);
+}
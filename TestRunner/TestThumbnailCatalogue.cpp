@@ -0,0 +1,331 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "ThumbnailCatalogue.hpp"
+#include "FileAccess.hpp"
+#include "ImageBuffer.hpp"
+#include "imagebuffer/DirectMemoryAccessor.hpp"
+
+using Buffer = ImageBuffer<DirectMemoryAccessor>;
+constexpr size_t MAX_WIDTH = 16;
+constexpr size_t MAX_HEIGHT = 12;
+using Builder = ThumbnailBuilder<MAX_WIDTH, MAX_HEIGHT>;
+using Catalogue = ThumbnailCatalogue<Buffer>;
+using Thumbnailing = ThumbnailImageBuffer<Buffer, MAX_WIDTH, MAX_HEIGHT>;
+
+static_assert(ImageBufferConcept<Thumbnailing>, "ThumbnailImageBuffer does not satisfy ImageBufferConcept");
+static_assert(ImageBufferPeekConcept<Buffer>, "ImageBuffer does not satisfy ImageBufferPeekConcept");
+static_assert(FileAccessConcept<Catalogue>, "ThumbnailCatalogue does not satisfy FileAccessConcept");
+static_assert(FileListConcept<Catalogue>, "ThumbnailCatalogue does not satisfy FileListConcept");
+
+static std::vector<uint8_t> frame(size_t bytes, uint32_t seed)
+{
+    std::vector<uint8_t> f(bytes);
+    uint32_t x = seed;
+    for (auto &b : f)
+    {
+        x = x * 1664525u + 1013904223u;
+        b = static_cast<uint8_t>(x >> 24);
+    }
+    return f;
+}
+
+// Box filter over the whole frame, straight from the definition
+static std::vector<uint8_t> reference(const std::vector<uint8_t> &f, const SampleLayout &layout, size_t factor)
+{
+    const size_t w = (layout.width + factor - 1) / factor;
+    const size_t h = (layout.height + factor - 1) / factor;
+    std::vector<uint8_t> out(w * h);
+    for (size_t ty = 0; ty < h; ++ty)
+    {
+        for (size_t tx = 0; tx < w; ++tx)
+        {
+            uint32_t sum = 0, count = 0;
+            for (size_t y = ty * factor; y < std::min(layout.height, (ty + 1) * factor); ++y)
+            {
+                for (size_t x = tx * factor; x < std::min(layout.width, (tx + 1) * factor); ++x)
+                {
+                    sum += f[layout.offset + y * layout.rowBytes + x * layout.stride];
+                    ++count;
+                }
+            }
+            out[ty * w + tx] = static_cast<uint8_t>((sum + count / 2) / count);
+        }
+    }
+    return out;
+}
+
+static ImageMetadata rawMeta(uint64_t timestamp, uint16_t width, uint16_t height, uint16_t bytesPerPixel)
+{
+    ImageMetadata meta{};
+    meta.timestamp = timestamp;
+    meta.producer = METADATA_PRODUCER::CAMERA_2;
+    meta.format = METADATA_FORMAT::UNKN;
+    meta.dimensions = {width, height, bytesPerPixel};
+    meta.payload_size = uint32_t(width) * height * bytesPerPixel;
+    meta.significance = 250;
+    return meta;
+}
+
+static std::vector<uint8_t> readFile(Catalogue &catalogue, const std::array<char, NAME_LENGTH> &name, size_t chunk)
+{
+    std::vector<uint8_t> file;
+    std::vector<uint8_t> part(chunk);
+    for (size_t offset = 0;; offset += chunk)
+    {
+        size_t n = chunk;
+        REQUIRE(catalogue.read(name, offset, part.data(), n));
+        if (n == 0)
+            break;
+        file.insert(file.end(), part.begin(), part.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    return file;
+}
+
+static void store(Thumbnailing &buffer, const ImageMetadata &meta, const std::vector<uint8_t> &payload, size_t chunk)
+{
+    REQUIRE(buffer.add_image(meta) == ImageBufferError::NO_ERROR);
+    for (size_t at = 0; at < payload.size(); at += chunk)
+        REQUIRE(buffer.add_data_chunk(payload.data() + at, std::min(chunk, payload.size() - at)) == ImageBufferError::NO_ERROR);
+    REQUIRE(buffer.push_image() == ImageBufferError::NO_ERROR);
+}
+
+TEST_CASE("ThumbnailBuilder box-filters a streamed frame in chunks of any size")
+{
+    const size_t width = 100, height = 70;
+    const auto f = frame(2 * width * height, 5);
+
+    for (auto layout : {SampleLayout::yuv422Luma(width, height), SampleLayout::yuv422Cr(width, height), SampleLayout::gray8(2 * width, height)})
+    {
+        for (size_t chunk : {size_t(1), size_t(3), size_t(7), size_t(333), f.size()})
+        {
+            CAPTURE(layout.stride);
+            CAPTURE(chunk);
+            Builder builder;
+            REQUIRE(builder.begin(layout));
+            CHECK(builder.width() <= MAX_WIDTH);
+            CHECK(builder.height() <= MAX_HEIGHT);
+
+            for (size_t at = 0; at < f.size(); at += chunk)
+            {
+                if (at < f.size() / 2)
+                    CHECK_FALSE(builder.complete());
+                builder(f.data() + at, std::min(chunk, f.size() - at));
+            }
+            REQUIRE(builder.complete());
+
+            const auto expected = reference(f, layout, builder.factor());
+            REQUIRE(expected.size() == builder.width() * builder.height());
+            CHECK(std::equal(expected.begin(), expected.end(), builder.pixels()));
+        }
+    }
+
+    // 100 x 70 needs 7 x 7 boxes for 16 x 12, leaving partial boxes at both edges
+    Builder builder;
+    REQUIRE(builder.begin(SampleLayout::yuv422Luma(width, height)));
+    CHECK(builder.factor() == 7);
+    CHECK(builder.width() == 15);
+    CHECK(builder.height() == 10);
+}
+
+TEST_CASE("ThumbnailImageBuffer stores frames unchanged, each raw one followed by its thumbnail")
+{
+    DirectMemoryAccessor accessor(0x90000000, 256 * 1024);
+    Buffer buffer(accessor);
+    Catalogue catalogue(buffer);
+    Thumbnailing thumbnailing(buffer, PixelFormat::YUV422);
+
+    const auto yuyv = frame(2 * 64 * 48, 1);
+    const auto grey = frame(40 * 30, 2);
+    ImageMetadata jpeg{};
+    jpeg.timestamp = 300;
+    jpeg.format = METADATA_FORMAT::JPEG;
+    jpeg.dimensions = {64, 48, 2};
+    jpeg.payload_size = 500;
+    ImageMetadata thermal{};
+    thermal.timestamp = 400;
+    thermal.payload_size = 1536;
+
+    store(thumbnailing, rawMeta(100, 64, 48, 2), yuyv, 1000);
+    store(thumbnailing, jpeg, frame(500, 3), 128);
+    store(thumbnailing, thermal, frame(1536, 4), 1536);
+    store(thumbnailing, rawMeta(200, 40, 30, 1), grey, 77);
+
+    // The buffer holds the four frames as they came, the raw ones each followed by a thumbnail
+    const METADATA_FORMAT formats[] = {METADATA_FORMAT::UNKN, METADATA_FORMAT::THUMBNAIL, METADATA_FORMAT::JPEG,
+                                       thermal.format, METADATA_FORMAT::UNKN, METADATA_FORMAT::THUMBNAIL};
+    REQUIRE(thumbnailing.count() == 6);
+    ImageMetadata meta{};
+    for (size_t i = 0; i < 6; ++i)
+    {
+        REQUIRE(buffer.peek_image(i, meta) == ImageBufferError::NO_ERROR);
+        CHECK(meta.format == formats[i]);
+    }
+    CHECK(buffer.peek_image(6, meta) == ImageBufferError::OUT_OF_BOUNDS);
+
+    REQUIRE(thumbnailing.get_image(meta) == ImageBufferError::NO_ERROR);
+    std::vector<uint8_t> first(meta.payload_size);
+    size_t size = first.size();
+    REQUIRE(thumbnailing.get_data_chunk(first.data(), size) == ImageBufferError::NO_ERROR);
+    CHECK(first == yuyv);
+    CHECK(thumbnailing.pop_image() == ImageBufferError::NO_ERROR);
+
+    // The thumbnails left in the buffer, listed oldest first
+    REQUIRE(catalogue.count() == 2);
+    std::array<char, NAME_LENGTH> name{};
+    REQUIRE(catalogue.list(0, name));
+    CHECK(std::strcmp(name.data(), "000000000000006401") == 0);
+    REQUIRE(catalogue.list(1, name));
+    CHECK(std::strcmp(name.data(), "00000000000000c801") == 0);
+    CHECK_FALSE(catalogue.list(2, name));
+
+    // The thumbnail file, read back under the name as a Read request carries it
+    const std::string path(name.data());
+    const auto requested = convertPath(reinterpret_cast<const uint8_t *>(path.data()), path.size());
+    const std::vector<uint8_t> file = readFile(catalogue, requested, 256);
+    REQUIRE(file.size() > METADATA_SIZE);
+    CHECK(readFile(catalogue, requested, 7) == file);
+
+    ImageMetadata thumbMeta{};
+    std::memcpy(&thumbMeta, file.data(), METADATA_SIZE);
+    CHECK(thumbMeta.format == METADATA_FORMAT::THUMBNAIL);
+    CHECK(thumbMeta.timestamp == 200);
+    CHECK(thumbMeta.producer == METADATA_PRODUCER::CAMERA_2);
+    CHECK(thumbMeta.significance == 250);
+    CHECK(thumbMeta.dimensions.n1 == 14);
+    CHECK(thumbMeta.dimensions.n2 == 10);
+    CHECK(thumbMeta.payload_size == 140);
+    CHECK(file.size() == METADATA_SIZE + 140);
+
+    DefaultChecksumPolicy cs;
+    cs.reset();
+    cs.update(file.data(), METADATA_SIZE_WO_CRC);
+    CHECK(cs.get() == thumbMeta.meta_crc);
+
+    const auto expected = reference(grey, SampleLayout::gray8(40, 30), 3);
+    CHECK(std::equal(expected.begin(), expected.end(), file.begin() + METADATA_SIZE));
+
+    size_t none = 16;
+    uint8_t scratch[16];
+    auto unknown = name;
+    unknown[0] = 'f';
+    CHECK_FALSE(catalogue.read(unknown, 0, scratch, none));
+    CHECK(none == 0);
+}
+
+TEST_CASE("A thumbnail is listed as long as its record is in the buffer")
+{
+    DirectMemoryAccessor accessor(0x90000000, 256 * 1024);
+    Buffer buffer(accessor);
+    Catalogue catalogue(buffer);
+    Thumbnailing thumbnailing(buffer, PixelFormat::YUV422);
+
+    const auto f = frame(32 * 24, 9);
+    for (uint64_t t = 1; t <= 3; ++t)
+        store(thumbnailing, rawMeta(t, 32, 24, 1), f, 100);
+    REQUIRE(catalogue.count() == 3);
+
+    // The consumer takes the first frame and its thumbnail; the listing moves up, and reading
+    // the consumer stream was not disturbed by the listing in between
+    std::array<char, NAME_LENGTH> name{};
+    ImageMetadata meta{};
+    std::vector<uint8_t> payload(f.size());
+    for (size_t record = 0; record < 2; ++record)
+    {
+        REQUIRE(thumbnailing.get_image(meta) == ImageBufferError::NO_ERROR);
+        REQUIRE(catalogue.list(0, name));
+        size_t size = payload.size();
+        REQUIRE(thumbnailing.get_data_chunk(payload.data(), size) == ImageBufferError::NO_ERROR);
+        REQUIRE(thumbnailing.pop_image() == ImageBufferError::NO_ERROR);
+    }
+    CHECK(meta.format == METADATA_FORMAT::THUMBNAIL);
+
+    REQUIRE(catalogue.count() == 2);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        REQUIRE(catalogue.list(i, name));
+        CHECK(name == Catalogue::nameOf(rawMeta(2 + i, 32, 24, 1)));
+    }
+    CHECK_FALSE(catalogue.list(2, name));
+
+    uint8_t scratch[8];
+    size_t size = sizeof(scratch);
+    CHECK_FALSE(catalogue.read(Catalogue::nameOf(rawMeta(1, 32, 24, 1)), 0, scratch, size));
+}
+
+TEST_CASE("A frame is kept when there is no room left for its thumbnail")
+{
+    // Room for the frame and its record overhead, but not for the thumbnail record as well
+    const size_t frameEntry = STORAGE_SIZE + METADATA_SIZE + 32 * 24 + sizeof(crc_t);
+    DirectMemoryAccessor accessor(0x90000000, frameEntry + 100);
+    Buffer buffer(accessor);
+    Catalogue catalogue(buffer);
+    Thumbnailing thumbnailing(buffer, PixelFormat::YUV422);
+
+    store(thumbnailing, rawMeta(1, 32, 24, 1), frame(32 * 24, 10), 100);
+    CHECK(thumbnailing.count() == 1);
+    CHECK(catalogue.count() == 0);
+}
+
+TEST_CASE("ThumbnailImageBuffer takes two-byte frames as the configured pixel format")
+{
+    DirectMemoryAccessor accessor(0x90000000, 256 * 1024);
+    Buffer buffer(accessor);
+    Catalogue catalogue(buffer);
+    Thumbnailing thumbnailing(buffer, PixelFormat::RGB565);
+
+    // RGB565 has no 8-bit channel to box-filter: stored, but not thumbnailed
+    const auto f = frame(2 * 32 * 24, 11);
+    store(thumbnailing, rawMeta(1, 32, 24, 2), f, 100);
+    CHECK(thumbnailing.count() == 1);
+    CHECK(catalogue.count() == 0);
+
+    // One byte per pixel is grey whatever the colour format
+    store(thumbnailing, rawMeta(2, 32, 24, 1), frame(32 * 24, 12), 100);
+    CHECK(catalogue.count() == 1);
+
+    thumbnailing.setPixelFormat(PixelFormat::YUV422);
+    store(thumbnailing, rawMeta(3, 32, 24, 2), f, 100);
+    REQUIRE(catalogue.count() == 2);
+
+    SampleLayout layout{};
+    REQUIRE(thumbnailLayout(rawMeta(3, 32, 24, 2), PixelFormat::YUV422, layout));
+    CHECK(layout.stride == 2);
+    CHECK_FALSE(thumbnailLayout(rawMeta(3, 32, 24, 2), PixelFormat::RGB565, layout));
+    CHECK_FALSE(thumbnailLayout(rawMeta(3, 32, 24, 2), PixelFormat::JPEG, layout));
+}
+
+TEST_CASE("Benchmark ThumbnailImageBuffer ingest")
+{
+    const size_t width = 640, height = 480;
+    const auto f = frame(2 * width * height, 13);
+    const ImageMetadata meta = rawMeta(1, width, height, 2);
+
+    auto run = [&](auto &target) {
+        const auto start = std::chrono::steady_clock::now();
+        REQUIRE(target.add_image(meta) == ImageBufferError::NO_ERROR);
+        for (size_t at = 0; at < f.size(); at += 4096)
+            REQUIRE(target.add_data_chunk(f.data() + at, std::min<size_t>(4096, f.size() - at)) == ImageBufferError::NO_ERROR);
+        REQUIRE(target.push_image() == ImageBufferError::NO_ERROR);
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(stop - start).count();
+    };
+
+    DirectMemoryAccessor plainAccessor(0x90000000, 1024 * 1024);
+    Buffer plain(plainAccessor);
+    DirectMemoryAccessor accessor(0x90000000, 1024 * 1024);
+    Buffer buffer(accessor);
+    Catalogue catalogue(buffer);
+    ThumbnailImageBuffer<Buffer, 80, 60> thumbnailing(buffer, PixelFormat::YUV422);
+
+    const double plainMs = run(plain);
+    const double thumbMs = run(thumbnailing);
+    MESSAGE("640x480 YUYV ingest: " << plainMs << " ms plain, " << thumbMs << " ms with an 80x60 thumbnail ("
+                                    << METADATA_SIZE + 80 * 60 << " bytes against " << f.size() << ")");
+    CHECK(catalogue.count() == 1);
+}
@@ -0,0 +1,257 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "TiledWaveletCodec.hpp"
+#include "ImageBuffer.hpp"
+#include "imagebuffer/DirectMemoryAccessor.hpp"
+
+using Buffer = ImageBuffer<DirectMemoryAccessor>;
+constexpr size_t TILE = 32;
+constexpr size_t LEVELS = 3;
+constexpr size_t LAYERS = 4;
+using Encoder = TiledWaveletEncoder<MemoryFrameSource, TILE, LEVELS, LAYERS>;
+using Decoder = TiledWaveletDecoder<TILE, LEVELS>;
+
+// Smooth shading, edges and texture plus sensor noise, in YUYV with the scene in the luma
+static std::vector<uint8_t> syntheticYuyv(size_t width, size_t height, uint32_t seed = 7)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.f, 2.f);
+    std::vector<uint8_t> frame(2 * width * height);
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            float v = 60.f + 100.f * float(x) / float(width) + 30.f * std::sin(float(y) * 0.05f);
+            if ((x / 40 + y / 30) % 3 == 0)
+                v += 40.f;
+            if (std::hypot(float(x) - 0.6f * float(width), float(y) - 0.4f * float(height)) < 0.15f * float(height))
+                v = 230.f + 10.f * std::sin(float(x) * 0.9f);
+            v += noise(rng);
+            frame[2 * (y * width + x)] = static_cast<uint8_t>(std::lround(std::fmin(255.f, std::fmax(0.f, v))));
+            frame[2 * (y * width + x) + 1] = static_cast<uint8_t>(128 + (x % 7));
+        }
+    }
+    return frame;
+}
+
+static std::vector<uint8_t> luma(const std::vector<uint8_t> &yuyv)
+{
+    std::vector<uint8_t> y(yuyv.size() / 2);
+    for (size_t i = 0; i < y.size(); ++i)
+        y[i] = yuyv[2 * i];
+    return y;
+}
+
+static double psnr(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b)
+{
+    double se = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+        se += (double(a[i]) - double(b[i])) * (double(a[i]) - double(b[i]));
+    return se == 0.0 ? INFINITY : 10.0 * std::log10(255.0 * 255.0 * double(a.size()) / se);
+}
+
+struct Packet
+{
+    ImageMetadata meta;
+    std::vector<uint8_t> data;
+};
+
+static std::vector<Packet> drain(Buffer &buffer)
+{
+    std::vector<Packet> packets;
+    while (!buffer.is_empty())
+    {
+        Packet packet{};
+        REQUIRE(buffer.get_image(packet.meta) == ImageBufferError::NO_ERROR);
+        packet.data.resize(packet.meta.payload_size);
+        size_t size = packet.data.size();
+        REQUIRE(buffer.get_data_chunk(packet.data.data(), size) == ImageBufferError::NO_ERROR);
+        REQUIRE(buffer.pop_image() == ImageBufferError::NO_ERROR);
+        packets.push_back(std::move(packet));
+    }
+    return packets;
+}
+
+static ImageMetadata frameMeta()
+{
+    ImageMetadata meta{};
+    meta.timestamp = 1000;
+    meta.producer = METADATA_PRODUCER::CAMERA_1;
+    return meta;
+}
+
+TEST_CASE("TiledWaveletCodec is lossless with all layers and tiles at the frame edges")
+{
+    // Neither dimension is a multiple of the tile
+    const size_t width = 100, height = 70;
+    const auto frame = syntheticYuyv(width, height);
+    MemoryFrameSource source(frame.data(), SampleLayout::yuv422Luma(width, height));
+
+    DirectMemoryAccessor accessor(0x90000000, 256 * 1024);
+    Buffer buffer(accessor);
+    Encoder encoder(source);
+    encoder.begin(frameMeta());
+    while (!encoder.done())
+        REQUIRE(encoder.step(buffer) == ImageBufferError::NO_ERROR);
+
+    const auto packets = drain(buffer);
+    REQUIRE(packets.size() == encoder.packets());
+    CHECK(encoder.tiles() == 4 * 3);
+
+    Decoder decoder(width, height);
+    for (size_t i = 0; i < packets.size(); ++i)
+    {
+        CHECK(packets[i].meta.part == i);
+        CHECK(packets[i].meta.format == METADATA_FORMAT::TILED_WAVELET);
+        CHECK(packets[i].meta.dimensions.n1 == width);
+        CHECK(packets[i].meta.dimensions.n2 == height);
+        CHECK(((packets[i].meta.part_flags & METADATA_PART_LAST) != 0) == (i + 1 == packets.size()));
+        REQUIRE(decoder.addPacket(packets[i].data.data(), packets[i].data.size()));
+    }
+    CHECK(decoder.image() == luma(frame));
+}
+
+TEST_CASE("TiledWaveletCodec refines a preview layer by layer")
+{
+    const size_t width = 320, height = 240;
+    const auto frame = syntheticYuyv(width, height);
+    const auto original = luma(frame);
+    MemoryFrameSource source(frame.data(), SampleLayout::yuv422Luma(width, height));
+
+    DirectMemoryAccessor accessor(0x90000000, 512 * 1024);
+    Buffer buffer(accessor);
+    Encoder encoder(source);
+    encoder.begin(frameMeta());
+    while (!encoder.done())
+        REQUIRE(encoder.step(buffer) == ImageBufferError::NO_ERROR);
+    const auto packets = drain(buffer);
+
+    // The packets arrive layer by layer; decode the prefix after each layer
+    Decoder decoder(width, height);
+    size_t bytes = 0;
+    double previous = 0.0;
+    for (size_t layer = 0; layer < LAYERS; ++layer)
+    {
+        for (size_t tile = 0; tile < encoder.tiles(); ++tile)
+        {
+            const Packet &packet = packets[layer * encoder.tiles() + tile];
+            REQUIRE(decoder.addPacket(packet.data.data(), packet.data.size()));
+            bytes += packet.data.size();
+        }
+        const double quality = psnr(original, decoder.image());
+        MESSAGE("layer " << layer << ": " << bytes << " bytes (" << 8.0 * double(bytes) / double(width * height)
+                         << " bit/px), PSNR " << quality << " dB");
+        CHECK(quality > previous);
+        previous = quality;
+        if (layer == 0)
+        {
+            CHECK(bytes < original.size() / 8);
+            CHECK(quality > 28.0);
+        }
+    }
+    CHECK(std::isinf(previous));
+    CHECK(bytes < original.size());
+}
+
+TEST_CASE("TiledWaveletCodec resumes an interrupted encoder and tolerates lost packets")
+{
+    const size_t width = 128, height = 96;
+    const auto frame = syntheticYuyv(width, height, 3);
+    MemoryFrameSource source(frame.data(), SampleLayout::yuv422Luma(width, height));
+
+    DirectMemoryAccessor accessor(0x90000000, 256 * 1024);
+    Buffer buffer(accessor);
+
+    // First pass stops halfway, e.g. on a power cycle; a fresh encoder picks up the next packet
+    {
+        Encoder encoder(source);
+        encoder.begin(frameMeta());
+        for (int n = 0; n < 20; ++n)
+            REQUIRE(encoder.step(buffer) == ImageBufferError::NO_ERROR);
+    }
+    Encoder resumed(source);
+    resumed.begin(frameMeta(), 20);
+    while (!resumed.done())
+        REQUIRE(resumed.step(buffer) == ImageBufferError::NO_ERROR);
+
+    const auto packets = drain(buffer);
+    REQUIRE(packets.size() == resumed.packets());
+
+    Decoder complete(width, height);
+    for (const auto &packet : packets)
+        REQUIRE(complete.addPacket(packet.data.data(), packet.data.size()));
+    CHECK(complete.image() == luma(frame));
+
+    // Losing layer 1 of tile 5 keeps that tile at the preview and rejects its later layers
+    Decoder lossy(width, height);
+    const size_t lost = 1 * resumed.tiles() + 5;
+    for (size_t i = 0; i < packets.size(); ++i)
+    {
+        if (i == lost)
+            continue;
+        const bool accepted = lossy.addPacket(packets[i].data.data(), packets[i].data.size());
+        CHECK(accepted == (i % resumed.tiles() != 5 || i < lost));
+    }
+    CHECK(lossy.layers(5) == 1);
+    CHECK(lossy.layers(4) == LAYERS);
+    CHECK(psnr(luma(frame), lossy.image()) > 30.0);
+}
+
+TEST_CASE("TiledWaveletCodec reads tiles from flash through an accessor")
+{
+    const size_t width = 96, height = 64;
+    const auto frame = syntheticYuyv(width, height, 11);
+
+    DirectMemoryAccessor flash(0x90000000, 64 * 1024);
+    REQUIRE(flash.write(0x90000000 + 256, frame.data(), frame.size()) == AccessorError::NO_ERROR);
+
+    for (auto layout : {SampleLayout::yuv422Luma(width, height), SampleLayout::yuv422Cb(width, height), SampleLayout::yuv422Cr(width, height)})
+    {
+        MemoryFrameSource memory(frame.data(), layout);
+        AccessorFrameSource<DirectMemoryAccessor> stored(flash, 0x90000000 + 256, layout);
+        REQUIRE(stored.width() == memory.width());
+
+        std::vector<uint8_t> a(layout.width), b(layout.width);
+        for (size_t y = 0; y < height; y += 7)
+        {
+            REQUIRE(stored.read(3, y, layout.width - 3, a.data()));
+            memory.read(3, y, layout.width - 3, b.data());
+            CHECK(a == b);
+        }
+    }
+}
+
+TEST_CASE("Benchmark TiledWaveletEncoder throughput")
+{
+    const size_t width = 640, height = 480;
+    const auto frame = syntheticYuyv(width, height);
+    MemoryFrameSource source(frame.data(), SampleLayout::yuv422Luma(width, height));
+
+    auto run = [&](auto &encoder) {
+        DirectMemoryAccessor accessor(0x90000000, 1024 * 1024);
+        Buffer buffer(accessor);
+        const auto start = std::chrono::steady_clock::now();
+        encoder.begin(frameMeta());
+        while (!encoder.done())
+            REQUIRE(encoder.step(buffer) == ImageBufferError::NO_ERROR);
+        const auto stop = std::chrono::steady_clock::now();
+        return double(width * height) / std::chrono::duration<double>(stop - start).count() / 1e6;
+    };
+
+    auto small = std::make_unique<TiledWaveletEncoder<MemoryFrameSource, 32, 3, 4>>(source);
+    auto large = std::make_unique<TiledWaveletEncoder<MemoryFrameSource, 64, 4, 4>>(source);
+    const double smallRate = run(*small);
+    const double largeRate = run(*large);
+    MESSAGE("640x480 luma, 4 layers: 32x32 tiles " << smallRate << " Mpx/s (" << small->bytes() << " bytes), 64x64 tiles "
+                                                   << largeRate << " Mpx/s (" << large->bytes() << " bytes)");
+    MESSAGE("encoder RAM: " << sizeof(*small) << " / " << sizeof(*large) << " bytes");
+    CHECK(smallRate > 0.0);
+}
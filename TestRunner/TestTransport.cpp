@@ -330,7 +330,10 @@ struct MockSCCBBus
 {
     std::vector<uint8_t> bits;      // sampled bits on SCL rising edge
     uint8_t last_sda = 1;           // current SDA level
+    bool scl = true;                // current SCL level
     std::queue<uint8_t> read_queue; // bits for read_byte()
+    size_t starts = 0;              // START conditions: SDA falling while SCL high
+    size_t delays = 0;
 
     // --- SCCB Core interface ---
 
@@ -338,12 +341,18 @@ struct MockSCCBBus
     {
         // sample SDA on rising edge
         bits.push_back(last_sda);
+        scl = true;
     }
 
-    void scl_low() {}
+    void scl_low() { scl = false; }
 
     void sda_high() { last_sda = 1; }
-    void sda_low() { last_sda = 0; }
+    void sda_low()
+    {
+        if (scl && last_sda)
+            ++starts;
+        last_sda = 0;
+    }
 
     void sda_as_input() {}
     void sda_as_output_od() {}
@@ -357,7 +366,7 @@ struct MockSCCBBus
         return bit;
     }
 
-    void delay() {}
+    void delay() { ++delays; }
 
     // --- Helpers for tests ---
 
@@ -376,6 +385,12 @@ struct MockSCCBBus
     }
 };
 
+// Fast path: clocked by the pin writes alone
+struct MockUnpacedSCCBBus : MockSCCBBus
+{
+    static constexpr bool paced = false;
+};
+
 using TestSCCBConfig8 = SCCBRegisterConfig<MockSCCBBus, 0x30, SCCBAddressWidth::Bits8>;
 using TestSCCBConfig16 = SCCBRegisterConfig<MockSCCBBus, 0x30, SCCBAddressWidth::Bits16>;
 
@@ -438,6 +453,58 @@ TEST_CASE("SCCB_Register_Transport read_reg() reads injected byte")
     CHECK(out == 0x5A);
 }
 
+TEST_CASE("SCCB_Register_Transport write_reg() sends a burst as one sequential write")
+{
+    MockSCCBBus bus;
+    SCCB_Register_Transport<TestSCCBConfig16, MockSCCBBus> t(bus);
+
+    const uint8_t values[] = {0x11, 0x22, 0x33, 0x44};
+    for (uint16_t i = 0; i < 4; ++i)
+        REQUIRE(t.write_reg(static_cast<uint16_t>(0x3630 + i), &values[i], 1));
+    const size_t single_bits = bus.bits.size();
+    CHECK(bus.starts == 4);
+
+    bus.clear();
+    bus.starts = 0;
+    REQUIRE(t.write_reg(0x3630, values, 4));
+    CHECK(bus.starts == 1);
+
+    // Address, register and data: 9 clocks per byte with the ACK, between the rising SCL of
+    // the START and of the STOP
+    CHECK(bus.bits.size() == 1 + 7 * 9 + 1);
+    CHECK(single_bits == 4 * (1 + 4 * 9 + 1));
+    auto byte_at = [&](size_t n) {
+        uint8_t v = 0;
+        for (size_t b = 0; b < 8; ++b)
+            v = static_cast<uint8_t>((v << 1) | bus.bits[1 + n * 9 + b]);
+        return v;
+    };
+    CHECK(byte_at(0) == 0x60);
+    CHECK(byte_at(1) == 0x36);
+    CHECK(byte_at(2) == 0x30);
+    for (size_t i = 0; i < 4; ++i)
+        CHECK(byte_at(3 + i) == values[i]);
+
+    uint8_t none = 0;
+    CHECK_FALSE(t.write_reg(0x3630, &none, 0));
+}
+
+TEST_CASE("SCCB bit loop paces each clock phase once, and not at all on an unpaced bus")
+{
+    MockSCCBBus paced;
+    SCCB_Core::write_byte(paced, 0xA5);
+    CHECK(paced.delays == 9 * 2);
+
+    MockUnpacedSCCBBus fast;
+    SCCB_Register_Transport<SCCBRegisterConfig<MockUnpacedSCCBBus, 0x30, SCCBAddressWidth::Bits16>, MockUnpacedSCCBBus> t(fast);
+    const uint8_t values[] = {0x5A, 0xC3};
+    REQUIRE(t.write_reg(0x1234, values, 2));
+    CHECK(fast.delays == 0);
+    CHECK(fast.starts == 1);
+    CHECK(fast.bits.size() == 1 + 5 * 9 + 1);
+    CHECK(contains_byte(fast.bits, 0xC3));
+}
+
 // -----------------------------------------
 // Additional Transport Tests
 // -----------------------------------------
@@ -5,6 +5,8 @@
 #undef MAX_ORDER
 #include "wmm_coefficients_2025.hpp" // Include the WMM coefficients
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 
 // https://www.ngdc.noaa.gov/geomag/calculators/magcalc.shtml#igrfwmm
@@ -178,4 +180,110 @@ TEST_CASE("Magnetic Field Calculation 85N 400km cases") {
         expected.F =  48848.9f; 
         compareMagneticFields(result, expected);
     }
-}
\ No newline at end of file
+}
+// Term-by-term evaluation with cosf/sinf/powf per coefficient, the way calculateMagneticField
+// used to be written; kept as the reference for the recurrence based implementation.
+template <size_t NMAX>
+static magnetic_model::MagneticField referenceMagneticField(float latitude_deg, float longitude_deg, float radius_m, int year,
+                                                            const std::array<magnetic_model::GaussCoefficient, (NMAX + 1) * (NMAX + 2) / 2 - 1> &coefficients)
+{
+    using namespace magnetic_model;
+    constexpr size_t NTERMS = (NMAX + 1) * (NMAX + 2) / 2;
+    const float latitude_rad = latitude_deg * DEG_TO_RAD;
+    const float longitude_rad = longitude_deg * DEG_TO_RAD;
+
+    std::array<float, NTERMS> P_vector{};
+    std::array<float, NTERMS> dP_vector{};
+    (void)wmm_model::MAG_PcupLow<NMAX, NTERMS>(P_vector, dP_vector, sinf(latitude_rad));
+
+    float X = 0.0f, Y = 0.0f, Z = 0.0f;
+    for (size_t i = 0; i < coefficients.size(); ++i)
+    {
+        const GaussCoefficient &coeff = coefficients[i];
+        const float P = P_vector[i + 1];
+        const float dP = dP_vector[i + 1];
+        const float time_diff = static_cast<float>(year - MODEL_EPOCH_YEAR);
+        const float g = coeff.g + coeff.g_dot * time_diff;
+        const float h = coeff.h + coeff.h_dot * time_diff;
+        const float cos_m = cosf(static_cast<float>(coeff.m) * longitude_rad);
+        const float sin_m = sinf(static_cast<float>(coeff.m) * longitude_rad);
+        const float term = powf(R_EARTH / radius_m, static_cast<float>(coeff.n + 2));
+
+        X += term * (g * cos_m + h * sin_m) * dP;
+        Y += term * static_cast<float>(coeff.m) * (g * sin_m - h * cos_m) * P / cosf(latitude_rad);
+        Z += term * static_cast<float>(coeff.n + 1) * (g * cos_m + h * sin_m) * P;
+    }
+
+    MagneticField result{};
+    result.X = -X;
+    result.Y = Y;
+    result.Z = -Z;
+    return result;
+}
+
+TEST_CASE("Recurrence evaluation matches the term-by-term reference over a global grid") {
+    using namespace magnetic_model;
+
+    float max_error = 0.0f;
+    for (float latitude_deg = -89.0f; latitude_deg <= 89.0f; latitude_deg += 11.0f)
+    {
+        for (float longitude_deg = -180.0f; longitude_deg < 180.0f; longitude_deg += 17.0f)
+        {
+            for (float altitude_m : {0.0f, 400000.0f, 800000.0f})
+            {
+                const MagneticField fast = calculateMagneticField<MAX_ORDER>(latitude_deg, longitude_deg, RADIUS + altitude_m, 2027, magneticGaussCoefficients);
+                const MagneticField reference = referenceMagneticField<MAX_ORDER>(latitude_deg, longitude_deg, RADIUS + altitude_m, 2027, magneticGaussCoefficients);
+                max_error = std::max({max_error, std::abs(fast.X - reference.X), std::abs(fast.Y - reference.Y), std::abs(fast.Z - reference.Z)});
+            }
+        }
+    }
+    MESSAGE("max component difference to reference " << max_error << " nT");
+    CHECK(max_error < 1.0f);
+}
+
+TEST_CASE("Secular variation advances the field linearly from the model epoch") {
+    using namespace magnetic_model;
+
+    // The field is linear in the coefficients, so one year of drift equals the field of g_dot / h_dot alone
+    std::array<GaussCoefficient, magneticGaussCoefficients.size()> rates{};
+    for (size_t i = 0; i < rates.size(); ++i)
+        rates[i] = {magneticGaussCoefficients[i].n, magneticGaussCoefficients[i].m, magneticGaussCoefficients[i].g_dot, magneticGaussCoefficients[i].h_dot, 0.0f, 0.0f};
+
+    const float latitude_deg = 30.0f, longitude_deg = -90.0f, radius_m = RADIUS + 100000;
+    const MagneticField epoch = calculateMagneticField<MAX_ORDER>(latitude_deg, longitude_deg, radius_m, 2025, magneticGaussCoefficients);
+    const MagneticField later = calculateMagneticField<MAX_ORDER>(latitude_deg, longitude_deg, radius_m, 2029, magneticGaussCoefficients);
+    const MagneticField drift = calculateMagneticField<MAX_ORDER>(latitude_deg, longitude_deg, radius_m, 2025, rates);
+
+    CHECK(std::abs(drift.X) > 1.0f);
+    CHECK(later.X - epoch.X == doctest::Approx(4.0f * drift.X).epsilon(0.01));
+    CHECK(later.Y - epoch.Y == doctest::Approx(4.0f * drift.Y).epsilon(0.01));
+    CHECK(later.Z - epoch.Z == doctest::Approx(4.0f * drift.Z).epsilon(0.01));
+}
+
+TEST_CASE("Benchmark recurrence versus term-by-term field evaluation") {
+    using namespace magnetic_model;
+    constexpr int iterations = 2000;
+
+    auto run = [&](auto evaluate)
+    {
+        float sink = 0.0f;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            const float latitude_deg = static_cast<float>(i % 170) - 85.0f;
+            const float longitude_deg = static_cast<float>((i * 7) % 360) - 180.0f;
+            sink += evaluate(latitude_deg, longitude_deg).Z;
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        CHECK(std::isfinite(sink));
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) / iterations;
+    };
+
+    const double reference_ns = run([](float latitude_deg, float longitude_deg)
+                                    { return referenceMagneticField<MAX_ORDER>(latitude_deg, longitude_deg, RADIUS + 500000, 2026, magneticGaussCoefficients); });
+    const double fast_ns = run([](float latitude_deg, float longitude_deg)
+                               { return calculateMagneticField<MAX_ORDER>(latitude_deg, longitude_deg, RADIUS + 500000, 2026, magneticGaussCoefficients); });
+
+    MESSAGE("calculateMagneticField: term-by-term " << reference_ns << " ns, recurrence " << fast_ns << " ns per call");
+    CHECK(fast_ns > 0.0);
+}
@@ -125,4 +125,47 @@ TEST_CASE("get_dcmi_frame_buffer Test")
 
     // Get the frame buffer using the getter function
     CHECK(get_dcmi_frame_buffer(&hdcmi) == frame_buffer);
-}
\ No newline at end of file
+}
+
+static int dcmi_half_events = 0;
+static int dcmi_complete_events = 0;
+static int dcmi_frame_events = 0;
+static void count_half(DCMI_HandleTypeDef *) { ++dcmi_half_events; }
+static void count_complete(DCMI_HandleTypeDef *) { ++dcmi_complete_events; }
+static void count_frame(DCMI_HandleTypeDef *) { ++dcmi_frame_events; }
+
+TEST_CASE("HAL_DCMI_Start_DMA circular strip callbacks Test")
+{
+    DCMI_HandleTypeDef hdcmi = {};
+    uint32_t ring[16] = {};
+    uint8_t frame[4 * 20 + 2];
+    for (size_t i = 0; i < sizeof(frame); ++i)
+        frame[i] = (uint8_t)(i + 1);
+
+    CHECK(HAL_DCMI_Start_DMA(&hdcmi, DCMI_MODE_SNAPSHOT, ring, 15) == HAL_ERROR); // halves must be equal
+    set_dcmi_stream_callbacks(&hdcmi, count_half, count_complete, count_frame);
+    set_dcmi_stream_source(&hdcmi, frame, sizeof(frame));
+    REQUIRE(HAL_DCMI_Start_DMA(&hdcmi, DCMI_MODE_SNAPSHOT, ring, 16) == HAL_OK);
+    CHECK(hdcmi.State == HAL_DCMI_STATE_BUSY);
+    CHECK(mock_dcmi_dma_remaining(&hdcmi) == 16);
+
+    // 20 words and 2 bytes: first half, second half, then 4 words and a padded word
+    CHECK(mock_dcmi_dma_step(&hdcmi));
+    CHECK(dcmi_half_events == 1);
+    CHECK(mock_dcmi_dma_remaining(&hdcmi) == 8);
+    CHECK(mock_dcmi_dma_step(&hdcmi));
+    CHECK(dcmi_complete_events == 1);
+    CHECK(mock_dcmi_dma_remaining(&hdcmi) == 16);
+    CHECK(mock_dcmi_dma_step(&hdcmi));
+    CHECK(dcmi_half_events == 1);
+    CHECK(mock_dcmi_dma_remaining(&hdcmi) == 11);
+    CHECK(dcmi_frame_events == 0);
+    CHECK_FALSE(mock_dcmi_dma_step(&hdcmi));
+    CHECK(dcmi_frame_events == 1);
+    CHECK(hdcmi.State == HAL_DCMI_STATE_READY);
+
+    // The wrapped tail overwrote the start of the first half
+    CHECK(memcmp(ring, frame + 64, 18) == 0);
+    CHECK(((uint8_t *)ring)[18] == 0);
+    CHECK(memcmp(ring + 5, frame + 20, 44) == 0);
+}
@@ -13,3 +13,31 @@ TEST_CASE("Test HAL IRQ Disable")
 {
     HAL_NVIC_DisableIRQ(EXTI0_IRQn);
 }
+
+TEST_CASE("Test HAL IRQ masking statistics")
+{
+    clear_irq_statistics();
+    CHECK(get_irq_enabled(CAN1_RX0_IRQn));
+
+    HAL_NVIC_DisableIRQ(CAN1_RX0_IRQn);
+    CHECK(!get_irq_enabled(CAN1_RX0_IRQn));
+    HAL_NVIC_DisableIRQ(CAN1_RX0_IRQn); // already masked, not counted twice
+    HAL_NVIC_EnableIRQ(CAN1_RX0_IRQn);
+
+    CHECK(get_irq_enabled(CAN1_RX0_IRQn));
+    CHECK(get_irq_disable_count(CAN1_RX0_IRQn) == 1);
+    CHECK(get_irq_max_masked_ns(CAN1_RX0_IRQn) <= get_irq_total_masked_ns(CAN1_RX0_IRQn));
+    CHECK(get_irq_disable_count(CAN1_TX_IRQn) == 0);
+
+    clear_irq_statistics();
+    CHECK(get_irq_disable_count(CAN1_RX0_IRQn) == 0);
+}
+
+TEST_CASE("Test HAL ISR context emulation")
+{
+    CHECK(!get_isr_context());
+    set_isr_context(true);
+    CHECK(get_isr_context());
+    set_isr_context(false);
+    CHECK(!get_isr_context());
+}
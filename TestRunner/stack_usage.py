@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Print the stack usage of every task entry point from GCC's -fstack-usage output.
+
+Build with `make STACK_USAGE=1` (host) or add `-fstack-usage -fcallgraph-info=su`
+to the firmware CFLAGS, then run:
+
+    ./stack_usage.py bin                         # handleTaskImpl and friends
+    ./stack_usage.py bin --entry 'ImageInputStream.*::initialize'
+
+Each .su line holds the frame of one function. When the matching .ci call graph
+files are present the worst-case path below each entry point is added on top of
+its own frame; calls that leave the translation unit (virtual calls, library
+functions, other objects) are resolved by name where possible and otherwise
+reported as unresolved so the number is a lower bound.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+DEFAULT_ENTRY = r"::(handleTaskImpl|handleMessageImpl|registerTask|unregisterTask)\("
+
+NODE_RE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+BYTES_RE = re.compile(r"(\d+) bytes \((\w+(?:,\w+)?)\)")
+
+
+class Function:
+    def __init__(self, title, name, location, frame, qualifier, defined=True):
+        self.title = title
+        self.name = name
+        self.location = location
+        self.frame = frame
+        self.qualifier = qualifier
+        self.defined = defined
+        self.callees = set()
+
+
+def find_files(roots, suffix):
+    for root in roots:
+        if os.path.isfile(root):
+            if root.endswith(suffix):
+                yield root
+            continue
+        for directory, _, files in os.walk(root):
+            for name in sorted(files):
+                if name.endswith(suffix):
+                    yield os.path.join(directory, name)
+
+
+def parse_su(path, functions):
+    with open(path, encoding="utf-8", errors="replace") as su:
+        for line in su:
+            fields = line.rstrip("\n").split("\t")
+            if len(fields) != 3:
+                continue
+            # file:line:col:name, where the name itself may contain ':'
+            location, _, rest = fields[0].partition(":")
+            line_no, _, rest = rest.partition(":")
+            column, _, name = rest.partition(":")
+            key = (name, "%s:%s" % (location, line_no))
+            functions.setdefault(key, Function(None, name, "%s:%s:%s" % (location, line_no, column),
+                                               int(fields[1]), fields[2]))
+
+
+def parse_ci(path, graph):
+    nodes = {}
+    edges = []
+    with open(path, encoding="utf-8", errors="replace") as ci:
+        for line in ci:
+            node = NODE_RE.match(line)
+            if node:
+                title, label = node.groups()
+                parts = label.split("\\n")
+                usage = BYTES_RE.search(label)
+                # Declarations (external or indirect callees) carry no stack figure
+                nodes[title] = Function(title, parts[0], parts[1] if len(parts) > 1 else "",
+                                        int(usage.group(1)) if usage else 0,
+                                        usage.group(2) if usage else "unknown",
+                                        usage is not None)
+                continue
+            edge = EDGE_RE.match(line)
+            if edge:
+                edges.append(edge.groups())
+
+    # Mangled names are global, so a callee declared here is merged with its definition elsewhere
+    for title, function in nodes.items():
+        existing = graph.get(title)
+        if existing is None:
+            graph[title] = function
+        elif function.defined and not existing.defined:
+            function.callees |= existing.callees
+            graph[title] = function
+    for source, target in edges:
+        if source in graph:
+            graph[source].callees.add(target)
+
+
+def worst_path(graph, title, memo, active):
+    """Returns (bytes, path, unresolved, recursive) for the deepest call chain below title."""
+    if title in memo:
+        return memo[title]
+    function = graph.get(title)
+    if function is None or not function.defined:
+        # Constructor/destructor aliases (C1/C2) are referenced without a node of their own
+        return 0, [function.name if function else title], True, False
+    if title in active:
+        return 0, [function.name], False, True
+
+    active.add(title)
+    best_depth, best_path = 0, []
+    unresolved = function.qualifier != "static"
+    recursive = False
+    for callee in sorted(function.callees):
+        depth, path, callee_unresolved, callee_recursive = worst_path(graph, callee, memo, active)
+        unresolved |= callee_unresolved
+        recursive |= callee_recursive
+        if depth > best_depth or not best_path:
+            best_depth, best_path = depth, path
+    active.discard(title)
+
+    result = (function.frame + best_depth, [function.name] + best_path, unresolved, recursive)
+    if not recursive:
+        memo[title] = result
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("paths", nargs="*", default=["bin"], help="object directories or .su/.ci files")
+    parser.add_argument("--entry", default=DEFAULT_ENTRY, help="regex selecting entry points")
+    parser.add_argument("--limit", type=int, default=0, help="fail if any entry point exceeds this many bytes")
+    parser.add_argument("--path", action="store_true", help="print the worst-case call path")
+    args = parser.parse_args()
+
+    entry = re.compile(args.entry)
+    graph = {}
+    for ci in find_files(args.paths, ".ci"):
+        parse_ci(ci, graph)
+
+    rows = []
+    if graph:
+        memo = {}
+        for title, function in graph.items():
+            if function.defined and entry.search(function.name):
+                depth, path, unresolved, recursive = worst_path(graph, title, memo, set())
+                rows.append((depth, function.frame, function.name, function.location, path, unresolved, recursive))
+    else:
+        functions = {}
+        for su in find_files(args.paths, ".su"):
+            parse_su(su, functions)
+        for function in functions.values():
+            if entry.search(function.name):
+                rows.append((function.frame, function.frame, function.name, function.location,
+                             [function.name], function.qualifier != "static", False))
+
+    if not rows:
+        print("no entry points matching %r; was the tree built with STACK_USAGE=1?" % args.entry,
+              file=sys.stderr)
+        return 1
+
+    # The same template instantiation appears in every test that includes it
+    seen = set()
+    rows.sort(key=lambda row: (-row[0], row[2]))
+    print("%8s %8s  %s" % ("worst", "frame", "entry point"))
+    over = False
+    for depth, frame, name, location, path, unresolved, recursive in rows:
+        if name in seen:
+            continue
+        seen.add(name)
+        flags = ("+" if unresolved else "") + ("R" if recursive else "")
+        print("%8d %8d  %s%s  [%s]" % (depth, frame, name, " " + flags if flags else "", location))
+        if args.path:
+            for step in path[1:]:
+                print("%19s-> %s" % ("", step))
+        over |= args.limit > 0 and depth > args.limit
+
+    print("\n+ calls outside the analysed objects (lower bound), R recursion (cycle counted once)")
+    return 2 if over else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())